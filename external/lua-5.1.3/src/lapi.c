@@ -134,6 +134,15 @@ LUA_API void lua_setbookmarkf (lua_State *L, lua_BookmarkFunction bookmarkf, voi
   lua_unlock(L);
 }
 
+LUA_API int lua_setlazyload (lua_State *L, int enable) {
+  int old;
+  lua_lock(L);
+  old = G(L)->lazyundump;
+  G(L)->lazyundump = cast_byte(enable != 0);
+  lua_unlock(L);
+  return old;
+}
+
 LUA_API void lua_setlevelid (lua_State *L, int id) {
   lua_lock(L);
   api_check(L, G(L)->bookmark);
@@ -80,6 +80,15 @@ LUALIB_API void luaL_where (lua_State *L, int level) {
 		lua_pushfstring(L, "%s:%d: ", (ar.source[0] == '@' ? ar.source+1 : ar.short_src), ar.currentline);
       return;
     }
+    else {
+      // Custom for Solar2D: stripped line info, see lua_getstrippedpc
+      int pc = lua_getstrippedpc(L, &ar);
+      if (pc >= 0) {
+        lua_pushfstring(L, "%s:<%d>+pc %d: ", (ar.source[0] == '@' ? ar.source+1 : ar.short_src), ar.linedefined, pc);
+        return;
+      }
+      // /Custom
+    }
   }
   lua_pushliteral(L, "");  /* else, no information available... */
 }
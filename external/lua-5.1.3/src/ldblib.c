@@ -360,6 +360,13 @@ static int db_errorfb (lua_State *L) {
     lua_pushfstring(L, "%s:", (ar.source[0] == '@' ? ar.source+1 : ar.short_src));
     if (ar.currentline > 0)
       lua_pushfstring(L, "%d:", ar.currentline);
+    else {
+      // Custom for Solar2D: stripped line info, see lua_getstrippedpc
+      int pc = lua_getstrippedpc(L1, &ar);
+      if (pc >= 0)
+        lua_pushfstring(L, "<%d>+pc %d:", ar.linedefined, pc);
+      // /Custom
+    }
     if (*ar.namewhat != '\0')  /* is there a name? */
         lua_pushfstring(L, " in function " LUA_QS, ar.name);
     else {
@@ -258,6 +258,23 @@ LUA_API int lua_getinfo (lua_State *L, const char *what, lua_Debug *ar) {
   return status;
 }
 
+// Custom for Solar2D:
+/* Archives can strip line info from bytecode (car -s). Such frames are located
+** by the function's first line and the pc, which the archive's line map turns
+** back into a source line. */
+LUA_API int lua_getstrippedpc (lua_State *L, const lua_Debug *ar) {
+  int pc = -1;
+  lua_lock(L);
+  if (ar->i_ci != 0) {
+    CallInfo *ci = L->base_ci + ar->i_ci;
+    if (isLua(ci) && ci_func(ci)->l.p->lineinfo == NULL)
+      pc = currentpc(L, ci);
+  }
+  lua_unlock(L);
+  return pc;
+}
+// /Custom
+
 
 /*
 ** {======================================================
@@ -611,6 +628,12 @@ static void addinfo (lua_State *L, const char *msg) {
 	char buff[BUFSIZ];  /* add file:line information */
     int line = currentline(L, ci);
 	luaO_chunkid(buff, getstr(getluaproto(ci)->source), BUFSIZ);
+    // Custom for Solar2D: stripped line info, see lua_getstrippedpc
+    if (getluaproto(ci)->lineinfo == NULL) {
+      luaO_pushfstring(L, "%s:<%d>+pc %d: %s", buff, getluaproto(ci)->linedefined, currentpc(L, ci), msg);
+      return;
+    }
+    // /Custom
     luaO_pushfstring(L, "%s:%d: %s", buff, line, msg);
   }
 }
@@ -250,6 +250,10 @@ typedef struct Proto {
   lu_byte numparams;
   lu_byte is_vararg;
   lu_byte maxstacksize;
+// Custom for Solar2D:
+  char *lazy;  /* undumped code, constants and debug info; loaded on first call */
+  int sizelazy;
+// /Custom
 } Proto;
 
 
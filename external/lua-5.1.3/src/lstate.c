@@ -175,6 +175,7 @@ LUA_API lua_State *lua_newstate (lua_Alloc f, void *ud) {
 // Custom for Solar2D:
   g->bookmark = NULL;
   g->bookmarkud = NULL;
+  g->lazyundump = 0;
 // /Custom
   g->gcstate = GCSpause;
   g->rootgc = obj2gco(L);
@@ -89,6 +89,7 @@ typedef struct global_State {
 // Custom for Solar2D:
   lua_BookmarkFunction bookmark; /* called before coroutine resumes and after yields or errors of same, or on pcall error cleanup */
   void *bookmarkud; /* auxiliary data to `bookmark' */
+  lu_byte lazyundump; /* defer undumping nested functions until they are first called */
 // /Custom
   TValue l_registry;
   struct lua_State *mainthread;
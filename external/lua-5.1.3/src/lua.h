@@ -315,6 +315,9 @@ LUA_API void lua_setbookmarkf (lua_State *L, lua_BookmarkFunction bookmarkf, voi
 LUA_API void lua_setlevelid (lua_State *L, int id);
 LUA_API void lua_getlevelcounts (lua_State *L, int *ci, int *nbookmarks);
 LUA_API int lua_getlevelid (lua_State *L, int index, int *ci);
+
+/* Precompiled chunks loaded while enabled undump nested functions on first call. Returns the previous setting. */
+LUA_API int lua_setlazyload (lua_State *L, int enable);
 // /Custom
 
 
@@ -363,6 +366,11 @@ LUA_API lua_Hook lua_gethook (lua_State *L);
 LUA_API int lua_gethookmask (lua_State *L);
 LUA_API int lua_gethookcount (lua_State *L);
 
+// Custom for Solar2D:
+/* pc of the frame in ar if its function has no line info (stripped), else -1 */
+LUA_API int lua_getstrippedpc (lua_State *L, const lua_Debug *ar);
+// /Custom
+
 
 struct lua_Debug {
   int event;
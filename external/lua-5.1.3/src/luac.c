@@ -28,24 +28,24 @@
 
 static int listing=0;			/* list bytecodes? */
 static int dumping=1;			/* dump bytecodes? */
+#ifndef Rtt_LUA_COMPILER
 static int stripping=0;			/* strip debug information? */
 static char Output[]={ OUTPUT };	/* default output file name */
 static const char* output=Output;	/* actual output file name */
 static const char* progname=PROGNAME;	/* actual program name */
 
-#ifndef Rtt_LUA_COMPILER
 static void fatal(const char* message)
 {
  fprintf(stderr,"%s: %s\n",progname,message);
  exit(EXIT_FAILURE);
 }
-#endif
 
 static void cannot(const char* what)
 {
  fprintf(stderr,"%s: cannot %s %s: %s\n",progname,what,output,strerror(errno));
  exit(EXIT_FAILURE);
 }
+#endif
 
 #if !defined( Rtt_LUA_COMPILER )
 
@@ -157,12 +157,23 @@ static int writer(lua_State* L, const void* p, size_t size, void* u)
 
 #ifdef Rtt_LUA_COMPILER
 
+// Custom for Solar2D: the output file and strip flag travel with each call,
+// rather than in globals, so separate states may compile concurrently
 struct Smain {
 	int argc;
 	const char** argv;
+	const char* output;
+	int stripping;
 	int result;
 };
 
+static int cannot(const struct Smain* s, const char* what)
+{
+	fprintf( stderr, "BUILD ERROR: cannot %s %s: %s\n", what, s->output, strerror( errno ) );
+	return LUA_ERRFILE;
+}
+// /Custom
+
 static int pmain(lua_State* L)
 {
 	int result = 0;
@@ -202,13 +213,16 @@ static int pmain(lua_State* L)
 		UNUSED(listing);
 		if (dumping)
 		{
-			FILE* D= (output==NULL) ? stdout : fopen(output,"wb");
-			if (D==NULL) cannot("open");
-			lua_lock(L);
-			luaU_dump(L,f,writer,D,stripping);
-			lua_unlock(L);
-			if (ferror(D)) cannot("write");
-			if (fclose(D)) cannot("close");
+			FILE* D= (s->output==NULL) ? stdout : fopen(s->output,"wb");
+			if (D==NULL) result = cannot(s,"open");
+			else
+			{
+				lua_lock(L);
+				luaU_dump(L,f,writer,D,s->stripping);
+				lua_unlock(L);
+				if (ferror(D)) result = cannot(s,"write");
+				if (fclose(D) && 0 == result) result = cannot(s,"close");
+			}
 		}
 	}
 
@@ -223,14 +237,26 @@ Rtt_LuaCompile( lua_State *L, int numSources, const char** sources, const char*
 	struct Smain s;
 	s.argc = numSources;
 	s.argv = sources;
+	s.output = dstFile;
+	s.stripping = stripDebug;
 	s.result = 0;
 
-	output = dstFile;
-	stripping = stripDebug;
 	status = lua_cpcall( L, pmain, &s );
 	return ( 0 == status ? s.result : status );
 }
 
+// Custom for Solar2D: lets build caches tell bytecode formats apart
+int
+Rtt_LuaBytecodeHeader( char* header, int headerSize )
+{
+	if ( headerSize >= LUAC_HEADERSIZE )
+	{
+		luaU_header( header );
+	}
+	return LUAC_HEADERSIZE;
+}
+// /Custom
+
 #else
 
 struct Smain {
@@ -217,6 +217,11 @@ LUA_API int lua_compile_files(lua_State *L, int numSources, const char **sources
 {
 	return Rtt_LuaCompile(L, numSources, sources, dstFile, stripDebug);
 }
+extern int Rtt_LuaBytecodeHeader(char *header, int headerSize);
+LUA_API int lua_bytecode_header(char *header, int headerSize)
+{
+	return Rtt_LuaBytecodeHeader(header, headerSize);
+}
 #endif
 
 #endif
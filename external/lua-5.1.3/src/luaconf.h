@@ -878,6 +878,7 @@ union luai_Cast { double l_d; long l_l; };
 	#ifdef Rtt_LUA_COMPILER
 		typedef struct lua_State lua_State;
 		LUA_API int lua_compile_files(lua_State *L, int numSources, const char **sources, const char *dstFile, int stripDebug);
+		LUA_API int lua_bytecode_header(char *header, int headerSize);
 	#endif
 #endif
 #ifdef LUA_WIN_PHONE
@@ -14,6 +14,7 @@
 #include "ldebug.h"
 #include "ldo.h"
 #include "lfunc.h"
+#include "lgc.h"
 #include "lmem.h"
 #include "lobject.h"
 #include "lstring.h"
@@ -44,6 +45,10 @@ typedef struct {
  ZIO* Z;
  Mbuffer* b;
  const char* name;
+// Custom for Solar2D:
+ int lazy;		/* defer nested functions, see LoadLazy */
+ size_t ncopy;		/* bytes of a deferred function copied to b so far */
+// /Custom
 } LoadState;
 
 #ifdef LUAC_TRUST_BINARIES
@@ -114,7 +119,7 @@ static void LoadCode(LoadState* S, Proto* f)
  LoadVector(S,f->code,n,sizeof(Instruction));
 }
 
-static Proto* LoadFunction(LoadState* S, TString* p);
+static Proto* LoadFunction(LoadState* S, TString* p, int lazy);
 
 static void LoadConstants(LoadState* S, Proto* f)
 {
@@ -150,7 +155,7 @@ static void LoadConstants(LoadState* S, Proto* f)
  f->p=luaM_newvector(S->L,n,Proto*);
  f->sizep=n;
  for (i=0; i<n; i++) f->p[i]=NULL;
- for (i=0; i<n; i++) f->p[i]=LoadFunction(S,f->source);
+ for (i=0; i<n; i++) f->p[i]=LoadFunction(S,f->source,S->lazy);
 }
 
 static void LoadDebug(LoadState* S, Proto* f)
@@ -177,7 +182,113 @@ static void LoadDebug(LoadState* S, Proto* f)
  for (i=0; i<n; i++) f->upvalues[i]=LoadString(S);
 }
 
-static Proto* LoadFunction(LoadState* S, TString* p)
+// Custom for Solar2D:
+/*
+** Lazy loading: the code, constants and debug info of a nested function
+** are copied verbatim into the Proto and only undumped by luaU_materialize
+** when the function is first called (or dumped). Deferring small functions
+** costs more than it saves.
+*/
+#define LAZY_MINSIZE	256
+
+static void CopyBlock(LoadState* S, void* b, size_t size)
+{
+ size_t n=S->ncopy+size;
+ if (luaZ_sizebuffer(S->b)<n)
+ {
+  size_t newsize=2*luaZ_sizebuffer(S->b);
+  luaZ_resizebuffer(S->L,S->b,(newsize<n) ? n : newsize);
+ }
+ LoadBlock(S,luaZ_buffer(S->b)+S->ncopy,size);
+ if (b!=NULL) memcpy(b,luaZ_buffer(S->b)+S->ncopy,size);
+ S->ncopy=n;
+}
+
+static int CopyInt(LoadState* S)
+{
+ int32_t x;
+ CopyBlock(S,&x,sizeof(x));
+ IF (x<0, "bad integer");
+ return x;
+}
+
+static void CopyString(LoadState* S)
+{
+ uint32_t size;
+ CopyBlock(S,&size,sizeof(size));
+ CopyBlock(S,NULL,size);
+}
+
+static void CopyFunction(LoadState* S);
+
+static void CopyBody(LoadState* S)
+{
+ int i,n;
+ n=CopyInt(S);					/* code */
+ CopyBlock(S,NULL,(size_t)n*sizeof(Instruction));
+ n=CopyInt(S);					/* constants */
+ for (i=0; i<n; i++)
+ {
+  char t;
+  CopyBlock(S,&t,sizeof(t));
+  switch (t)
+  {
+   case LUA_TNIL:
+	break;
+   case LUA_TBOOLEAN:
+	CopyBlock(S,NULL,sizeof(char));
+	break;
+   case LUA_TNUMBER:
+	CopyBlock(S,NULL,sizeof(lua_Number));
+	break;
+   case LUA_TSTRING:
+	CopyString(S);
+	break;
+   default:
+	error(S,"bad constant");
+	break;
+  }
+ }
+ n=CopyInt(S);					/* functions */
+ for (i=0; i<n; i++) CopyFunction(S);
+ n=CopyInt(S);					/* lineinfo */
+ CopyBlock(S,NULL,(size_t)n*sizeof(int));
+ n=CopyInt(S);					/* locvars */
+ for (i=0; i<n; i++)
+ {
+  CopyString(S);
+  CopyInt(S);
+  CopyInt(S);
+ }
+ n=CopyInt(S);					/* upvalues */
+ for (i=0; i<n; i++) CopyString(S);
+}
+
+static void CopyFunction(LoadState* S)
+{
+ if (++S->L->nCcalls > LUAI_MAXCCALLS) error(S,"code too deep");
+ CopyString(S);
+ CopyInt(S);
+ CopyInt(S);
+ CopyBlock(S,NULL,4*sizeof(lu_byte));
+ CopyBody(S);
+ S->L->nCcalls--;
+}
+
+static void LoadLazy(LoadState* S, Proto* f)
+{
+ size_t n;
+ S->ncopy=0;
+ CopyBody(S);
+ n=S->ncopy;
+ f->lazy=luaM_newvector(S->L,n,char);
+ f->sizelazy=cast_int(n);
+ memcpy(f->lazy,luaZ_buffer(S->b),n);
+ if (n<LAZY_MINSIZE) luaU_materialize(S->L,f);
+}
+// /Custom
+
+static Proto* LoadFunction(LoadState* S, TString* p, int lazy)
 {
  Proto* f;
  if (++S->L->nCcalls > LUAI_MAXCCALLS) error(S,"code too deep");
@@ -190,10 +301,15 @@ static Proto* LoadFunction(LoadState* S, TString* p)
  f->numparams=LoadByte(S);
  f->is_vararg=LoadByte(S);
  f->maxstacksize=LoadByte(S);
- LoadCode(S,f);
- LoadConstants(S,f);
- LoadDebug(S,f);
- IF (!luaG_checkcode(f), "bad code");
+ if (lazy)
+  LoadLazy(S,f);	/* Custom for Solar2D */
+ else
+ {
+  LoadCode(S,f);
+  LoadConstants(S,f);
+  LoadDebug(S,f);
+  IF (!luaG_checkcode(f), "bad code");
+ }
  S->L->top--;
  S->L->nCcalls--;
  return f;
@@ -223,9 +339,99 @@ Proto* luaU_undump (lua_State* L, ZIO* Z, Mbuffer* buff, const char* name)
  S.L=L;
  S.Z=Z;
  S.b=buff;
+ S.lazy=G(L)->lazyundump;
+ S.ncopy=0;
  LoadHeader(&S);
- return LoadFunction(&S,luaS_newliteral(L,"=?"));
+ return LoadFunction(&S,luaS_newliteral(L,"=?"),0);
+}
+
+// Custom for Solar2D:
+typedef struct {
+ Proto* f;
+ size_t size;		/* bytes not yet handed to the reader */
+} LazyLoad;
+
+static const char* ReadLazy(lua_State* L, void* ud, size_t* size)
+{
+ LazyLoad* l=(LazyLoad*)ud;
+ UNUSED(L);
+ *size=l->size;
+ l->size=0;
+ return (*size>0) ? l->f->lazy : NULL;
+}
+
+static void f_materialize(lua_State* L, void* ud)
+{
+ LazyLoad* l=(LazyLoad*)ud;
+ Proto* f=l->f;
+ const char* name=getstr(f->source);
+ ZIO z;
+ LoadState state;
+ LoadState* S=&state;
+ luaZ_init(L,&z,ReadLazy,l);
+ S->name=(*name=='@' || *name=='=') ? name+1 : name;
+ S->L=L;
+ S->Z=&z;
+ S->b=&G(L)->buff;	/* scratch space; nothing else uses it while loading */
+ S->lazy=1;
+ S->ncopy=0;
+ LoadCode(S,f);
+ LoadConstants(S,f);
+ LoadDebug(S,f);
+ IF (!luaG_checkcode(f), "bad code");
+}
+
+static void ResetProto(lua_State* L, Proto* f)
+{
+ luaM_freearray(L, f->code, f->sizecode, Instruction);
+ luaM_freearray(L, f->p, f->sizep, Proto *);
+ luaM_freearray(L, f->k, f->sizek, TValue);
+ luaM_freearray(L, f->lineinfo, f->sizelineinfo, int);
+ luaM_freearray(L, f->locvars, f->sizelocvars, struct LocVar);
+ luaM_freearray(L, f->upvalues, f->sizeupvalues, TString *);
+ f->code=NULL; f->sizecode=0;
+ f->p=NULL; f->sizep=0;
+ f->k=NULL; f->sizek=0;
+ f->lineinfo=NULL; f->sizelineinfo=0;
+ f->locvars=NULL; f->sizelocvars=0;
+ f->upvalues=NULL; f->sizeupvalues=0;
+}
+
+/*
+** f may already have been traversed by the collector, so the objects it
+** now refers to must go through the write barrier
+*/
+static void BarrierProto(lua_State* L, Proto* f)
+{
+ int i;
+ for (i=0; i<f->sizek; i++) luaC_barrier(L,f,&f->k[i]);
+ for (i=0; i<f->sizep; i++) luaC_objbarrier(L,f,f->p[i]);
+ for (i=0; i<f->sizelocvars; i++)
+  if (f->locvars[i].varname) luaC_objbarrier(L,f,f->locvars[i].varname);
+ for (i=0; i<f->sizeupvalues; i++)
+  if (f->upvalues[i]) luaC_objbarrier(L,f,f->upvalues[i]);
+}
+
+void luaU_materialize (lua_State* L, Proto* f)
+{
+ LazyLoad l;
+ int status;
+ if (f->lazy==NULL) return;
+ l.f=f;
+ l.size=f->sizelazy;
+ status=luaD_rawrunprotected(L,f_materialize,&l);
+ if (status!=0)
+ {
+  /* leave f deferred so that every call reports the error */
+  ResetProto(L,f);
+  luaD_throw(L,status);
+ }
+ luaM_freearray(L,f->lazy,f->sizelazy,char);
+ f->lazy=NULL;
+ f->sizelazy=0;
+ BarrierProto(L,f);
 }
+// /Custom
 
 /*
 * make header
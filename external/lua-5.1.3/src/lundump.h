@@ -13,6 +13,9 @@
 /* load one chunk; from lundump.c */
 LUAI_FUNC Proto* luaU_undump (lua_State* L, ZIO* Z, Mbuffer* buff, const char* name);
 
+/* load the rest of a function whose undump was deferred; from lundump.c */
+LUAI_FUNC void luaU_materialize (lua_State* L, Proto* f);
+
 /* make header; from lundump.c */
 LUAI_FUNC void luaU_header (char* h);
 
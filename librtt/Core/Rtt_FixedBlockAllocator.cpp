@@ -16,7 +16,12 @@
 #include <stdlib.h>
 #include <malloc/malloc.h>
 #elif defined( Rtt_ANDROID_ENV )
+#include <malloc.h>
 #include <sys/sysconf.h>
+#elif defined( Rtt_WIN_ENV )
+#include <malloc.h>
+#else
+#include <stdlib.h>
 #endif
 
 // ----------------------------------------------------------------------------
@@ -30,7 +35,6 @@ namespace Rtt
 namespace MemoryPage
 {
 
-const size_t kSize = 1 << 12;	// 4KB
 // #ifdef Rtt_USE_64BIT
 const size_t kAlignmentMask = ~kSize & ( kSize - 1 );
 
@@ -63,7 +67,14 @@ Alloc( )
 		result = memalign( sysconf( _SC_PAGESIZE ), kSize );
 	#elif defined( Rtt_WEBOS_ENV ) || (defined( Rtt_EMSCRIPTEN_ENV ) && !defined(WIN32))
 		result = valloc( kSize );
-	#elif defined( Rtt_WIN_ENV ) || defined( Rtt_POWERVR_ENV ) || defined( Rtt_NXS_ENV )
+	#elif defined( Rtt_LINUX_ENV )
+		if ( 0 != posix_memalign( & result, kSize, kSize ) )
+		{
+			result = NULL;
+		}
+	#elif defined( Rtt_WIN_ENV )
+		result = _aligned_malloc( kSize, kSize );
+	#elif defined( Rtt_POWERVR_ENV ) || defined( Rtt_NXS_ENV )
 		result = malloc( kSize );
 		// TODO: Need to return page-aligned memory block or else we'll crash
 		Rtt_ASSERT_NOT_IMPLEMENTED();
@@ -78,6 +89,16 @@ Alloc( )
 	return result;
 }
 
+void
+Free( void* p )
+{
+	#if defined( Rtt_WIN_ENV )
+		_aligned_free( p );
+	#else
+		free( p );
+	#endif
+}
+
 } // MemoryPage
 
 
@@ -119,8 +140,9 @@ FixedBlock::Alloc()
 	{
 		result = fBumpPtr;
 
-		void* pNext = ((U8*)result) + fBlockSize;
-		fBumpPtr = ( pNext >= fBumpPtrEnd ? pNext : NULL );
+		// Stop bumping once the next block would run past the end of the page
+		U8* pNext = ((U8*)result) + fBlockSize;
+		fBumpPtr = ( pNext + fBlockSize <= (const U8*)fBumpPtrEnd ? pNext : NULL );
 	}
 	else if ( fFreeList )
 	{
@@ -146,11 +168,8 @@ FixedBlock::FreeObject( void* p )
 {
 	Rtt_ASSERT( fBlockSize >= sizeof( p ) );
 
-	if ( fFreeList )
-	{
-		// The contents of p stores the next ptr in the free list
-		*((void**)p) = fFreeList;
-	}
+	// The contents of p stores the next ptr in the free list
+	*((void**)p) = fFreeList;
 
 	fFreeList = p;
 }
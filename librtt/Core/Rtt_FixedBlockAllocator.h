@@ -13,11 +13,6 @@
 #include "Core/Rtt_Types.h"
 #include "Core/Rtt_Allocator.h"
 
-// TODO: Move MemoryPage::Free() into .cpp file so we can get rid of this include
-#ifdef Rtt_ANDROID_ENV
-#include <malloc.h>
-#endif
-
 // ----------------------------------------------------------------------------
 
 namespace Rtt
@@ -28,11 +23,9 @@ namespace Rtt
 namespace MemoryPage
 {
 
-Rtt_INLINE static void
-Free( void* p )
-{
-	free( p );
-}
+const size_t kSize = 1 << 12;	// 4KB
+
+void Free( void* p );
 
 } // MemoryPage
 
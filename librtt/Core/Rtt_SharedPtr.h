@@ -61,6 +61,9 @@ class SharedPtr
 		bool IsNull() const;
 		bool NotNull() const { return ! IsNull(); }
 
+		// Number of SharedPtr's to the resource, including this one
+		int GetStrongCount() const { return fCount.GetStrongCount(); }
+
 #ifdef Rtt_DEBUG_SHARED_PTR
 		void Log( const char *label ) const;
 #endif
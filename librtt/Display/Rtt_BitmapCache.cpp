@@ -0,0 +1,327 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Display/Rtt_BitmapCache.h"
+
+#include "Core/Rtt_Math.h"
+#include "Display/Rtt_BitmapPaint.h"
+#include "Display/Rtt_Display.h"
+#include "Display/Rtt_DisplayDefaults.h"
+#include "Display/Rtt_GroupObject.h"
+#include "Display/Rtt_RectObject.h"
+#include "Display/Rtt_SnapshotObject.h"
+#include "Display/Rtt_TextureFactory.h"
+#include "Display/Rtt_TextureResource.h"
+#include "Renderer/Rtt_FrameBufferObject.h"
+#include "Renderer/Rtt_Renderer.h"
+
+#include <math.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// In "auto" mode, a group is cached once its subtree has been left alone for
+// this many rendered frames...
+static const U16 kAutoStableFrames = 30;
+
+// ...and it draws at least this many children
+static const S32 kAutoMinChildren = 8;
+
+// Texture dimensions are rounded up to a multiple of this, so small changes
+// in the group's bounds reuse the same texture
+static const S32 kTextureGranularity = 64;
+
+static S32
+RoundUpToGranularity( S32 value )
+{
+	return ( value + kTextureGranularity - 1 ) & ~( kTextureGranularity - 1 );
+}
+
+// ----------------------------------------------------------------------------
+
+static const char kAutoString[] = "auto";
+
+BitmapCache::Mode
+BitmapCache::ModeForString( const char *str )
+{
+	Mode result = kNone;
+
+	if ( str && 0 == strcmp( str, kAutoString ) )
+	{
+		result = kAuto;
+	}
+
+	return result;
+}
+
+// ----------------------------------------------------------------------------
+
+BitmapCache::BitmapCache( Rtt_Allocator *allocator, GroupObject& owner )
+:	fAllocator( allocator ),
+	fOwner( owner ),
+	fQuad( NULL ),
+	fFrameBufferObject( NULL ),
+	fCullBounds(),
+	fBounds(),
+	fTextureWidth( 0 ),
+	fTextureHeight( 0 ),
+	fStableFrameCount( 0 ),
+	fMode( kNone ),
+	fIsChanged( true ),
+	fIsActive( false ),
+	fIsContentValid( false ),
+	fShouldRender( false ),
+	fIsRendering( false ),
+	fIsTimeDependent( false )
+{
+}
+
+BitmapCache::~BitmapCache()
+{
+	ReleaseTarget();
+
+	Rtt_DELETE( fQuad );
+}
+
+void
+BitmapCache::SetMode( Mode newValue )
+{
+	if ( newValue != fMode )
+	{
+		fMode = newValue;
+
+		if ( kNone == newValue )
+		{
+			ReleaseTarget();
+			fIsActive = false;
+		}
+
+		Invalidate();
+	}
+}
+
+void
+BitmapCache::Invalidate()
+{
+	fIsContentValid = false;
+	fIsChanged = true;
+}
+
+void
+BitmapCache::Prepare( const Display& display )
+{
+	// Time-dependent shaders change the content on every frame
+	if ( fIsTimeDependent )
+	{
+		Invalidate();
+	}
+
+	if ( fIsChanged )
+	{
+		fStableFrameCount = 0;
+		fIsChanged = false;
+	}
+	else if ( fStableFrameCount < kAutoStableFrames )
+	{
+		++fStableFrameCount;
+	}
+
+	bool isActive = ( kAlways == fMode )
+		|| ( kAuto == fMode
+			 && fStableFrameCount >= kAutoStableFrames
+			 && fOwner.NumChildren() >= kAutoMinChildren );
+
+	if ( isActive && ! fIsContentValid )
+	{
+		Rect bounds = fOwner.StageBounds();
+		if ( fCullBounds.NotEmpty() )
+		{
+			bounds.Intersect( fCullBounds );
+		}
+
+		isActive = UpdateTarget( display, bounds );
+		fShouldRender = isActive;
+	}
+
+	fIsActive = isActive;
+
+	if ( isActive )
+	{
+		// The quad is already in content space
+		Matrix identity;
+		fQuad->UpdateTransform( identity );
+		fQuad->Prepare( display );
+	}
+}
+
+void
+BitmapCache::Draw( Renderer& renderer ) const
+{
+	Rtt_ASSERT( fIsActive );
+
+	if ( fShouldRender )
+	{
+		U32 timeDependencyCount = renderer.GetTimeDependencyCount();
+
+		// The owner's Draw() checks IsRendering() to draw its children
+		// instead of this cache
+		fIsRendering = true;
+		{
+			Color clearColor = ColorZero();
+			SnapshotObject::RenderToFBO( renderer, fFrameBufferObject, fBounds, fOwner, & clearColor );
+		}
+		fIsRendering = false;
+
+		fIsTimeDependent = ( renderer.GetTimeDependencyCount() > timeDependencyCount );
+		fIsContentValid = true;
+		fShouldRender = false;
+
+		renderer.TallyBitmapCache( false );
+	}
+	else
+	{
+		renderer.TallyBitmapCache( true );
+	}
+
+	fQuad->WillDraw( renderer );
+	fQuad->Draw( renderer );
+	fQuad->DidDraw( renderer );
+}
+
+bool
+BitmapCache::UpdateTarget( const Display& display, const Rect& contentBounds )
+{
+	if ( contentBounds.IsEmpty()
+		 || contentBounds.Width() <= Rtt_REAL_0
+		 || contentBounds.Height() <= Rtt_REAL_0 )
+	{
+		return false;
+	}
+
+	// Pixels per content unit. ContentToScreen() truncates, so measure a
+	// large span rather than a single unit.
+	const Real kSpan = Rtt_IntToReal( 1024 );
+	Real x = Rtt_REAL_0, y = Rtt_REAL_0;
+	Real scaleX = kSpan, scaleY = kSpan;
+	display.ContentToScreen( x, y, scaleX, scaleY );
+	if ( scaleX <= Rtt_REAL_0 || scaleY <= Rtt_REAL_0 )
+	{
+		return false;
+	}
+	scaleX = Rtt_RealDiv( scaleX, kSpan );
+	scaleY = Rtt_RealDiv( scaleY, kSpan );
+
+	// Snap to whole pixels, so the cache is drawn without resampling
+	Real pixelMinX = floorf( Rtt_RealMul( contentBounds.xMin, scaleX ) );
+	Real pixelMinY = floorf( Rtt_RealMul( contentBounds.yMin, scaleY ) );
+	S32 pixelW = (S32)ceilf( Rtt_RealMul( contentBounds.xMax, scaleX ) - pixelMinX );
+	S32 pixelH = (S32)ceilf( Rtt_RealMul( contentBounds.yMax, scaleY ) - pixelMinY );
+
+	S32 textureW = RoundUpToGranularity( Max( pixelW, (S32)1 ) );
+	S32 textureH = RoundUpToGranularity( Max( pixelH, (S32)1 ) );
+
+	// Too large to be worth caching
+	S32 maxTextureSize = (S32)Display::GetMaxTextureSize();
+	if ( textureW > maxTextureSize || textureH > maxTextureSize )
+	{
+		return false;
+	}
+
+	// The texture can be larger than the content, so it covers a bit more
+	Rect bounds;
+	bounds.xMin = Rtt_RealDiv( pixelMinX, scaleX );
+	bounds.yMin = Rtt_RealDiv( pixelMinY, scaleY );
+	bounds.xMax = bounds.xMin + Rtt_RealDiv( Rtt_IntToReal( textureW ), scaleX );
+	bounds.yMax = bounds.yMin + Rtt_RealDiv( Rtt_IntToReal( textureH ), scaleY );
+
+	if ( textureW != fTextureWidth || textureH != fTextureHeight || ! fQuad )
+	{
+		ReleaseTarget();
+
+		TextureFactory& factory = display.GetTextureFactory();
+
+		RenderTypes::TextureFilter magFilter = display.GetDefaults().GetMagTextureFilter();
+
+		SharedPtr< TextureResource > resource = factory.Create(
+			textureW,
+			textureH,
+			Texture::kRGBA,
+			RenderTypes::Convert( magFilter ),
+			Texture::kClampToEdge,
+			false );
+
+		// See SnapshotObject::Initialize()
+		resource->GetTexture().SetRetina( true );
+
+		if ( ! fQuad )
+		{
+			fQuad = RectObject::NewRect( fAllocator, bounds.Width(), bounds.Height() );
+
+			// Like the groups of a snapshot, the quad is never a child of
+			// the owner. It only borrows the owner's stage.
+			fQuad->SetRenderedOffScreen( true );
+			fQuad->SetParent( & fOwner );
+		}
+
+		fQuad->SetFill( Rtt_NEW( fAllocator, BitmapPaint( resource ) ) );
+
+		FrameBufferObject::ExtraOptions opts = {};
+		fFrameBufferObject = Rtt_NEW( fAllocator, FrameBufferObject( fAllocator, & resource->GetTexture(), & opts ) );
+
+		fTextureWidth = textureW;
+		fTextureHeight = textureH;
+	}
+
+	if ( bounds.xMin != fBounds.xMin || bounds.yMin != fBounds.yMin
+		 || bounds.xMax != fBounds.xMax || bounds.yMax != fBounds.yMax )
+	{
+		fQuad->SetGeometricProperty( kWidth, bounds.Width() );
+		fQuad->SetGeometricProperty( kHeight, bounds.Height() );
+		fQuad->SetGeometricProperty( kOriginX, Rtt_RealDiv2( bounds.xMin + bounds.xMax ) );
+		fQuad->SetGeometricProperty( kOriginY, Rtt_RealDiv2( bounds.yMin + bounds.yMax ) );
+
+		fBounds = bounds;
+	}
+
+	return true;
+}
+
+void
+BitmapCache::ReleaseTarget()
+{
+	if ( fFrameBufferObject )
+	{
+		fOwner.QueueRelease( fFrameBufferObject );
+		fFrameBufferObject = NULL;
+	}
+
+	// The texture goes away with the quad's paint
+	if ( fQuad )
+	{
+		fQuad->SetFill( NULL );
+	}
+
+	fTextureWidth = 0;
+	fTextureHeight = 0;
+	fBounds.SetEmpty();
+	fIsContentValid = false;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,108 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_BitmapCache_H__
+#define _Rtt_BitmapCache_H__
+
+#include "Core/Rtt_Geometry.h"
+#include "Core/Rtt_Types.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+class Display;
+class FrameBufferObject;
+class GroupObject;
+class RectObject;
+class Renderer;
+
+// ----------------------------------------------------------------------------
+
+// Renders the children of a group into a texture once, then draws the group
+// as a single quad until something in its subtree invalidates the display.
+//
+// The texture covers the group's content bounds (clipped to the cull bounds),
+// so the quad is drawn in content space with an identity transform. Moving
+// the group moves its children, which invalidates the cache like any other
+// change would.
+class BitmapCache
+{
+	Rtt_CLASS_NO_COPIES( BitmapCache )
+
+	public:
+		typedef BitmapCache Self;
+
+		typedef enum _Mode
+		{
+			kNone = 0,
+			kAlways,
+			kAuto,
+
+			kNumModes
+		}
+		Mode;
+
+		static Mode ModeForString( const char *str );
+
+	public:
+		BitmapCache( Rtt_Allocator *allocator, GroupObject& owner );
+		~BitmapCache();
+
+	public:
+		Mode GetMode() const { return (Mode)fMode; }
+		void SetMode( Mode newValue );
+
+		// Called when anything in the owner's subtree changes
+		void Invalidate();
+
+		void SetCullBounds( const Rect& bounds ) { fCullBounds = bounds; }
+
+		// True when the owner should draw the cache instead of its children.
+		// Only valid after Prepare().
+		bool IsActive() const { return fIsActive; }
+
+		// True while the children are being rendered into the cache
+		bool IsRendering() const { return fIsRendering; }
+
+	public:
+		void Prepare( const Display& display );
+		void Draw( Renderer& renderer ) const;
+
+	protected:
+		bool UpdateTarget( const Display& display, const Rect& contentBounds );
+		void ReleaseTarget();
+
+	private:
+		Rtt_Allocator *fAllocator;
+		GroupObject& fOwner;
+		RectObject *fQuad;
+		FrameBufferObject *fFrameBufferObject;
+		Rect fCullBounds;
+		Rect fBounds; // Content bounds covered by the texture
+		S32 fTextureWidth;
+		S32 fTextureHeight;
+		U16 fStableFrameCount;
+		U8 fMode;
+		bool fIsChanged;
+		bool fIsActive;
+		mutable bool fIsContentValid;
+		mutable bool fShouldRender;
+		mutable bool fIsRendering;
+		mutable bool fIsTimeDependent;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_BitmapCache_H__
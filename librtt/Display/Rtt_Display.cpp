@@ -25,6 +25,7 @@
 #include "Display/Rtt_TextureResource.h"
 
 #include "Rtt_BufferBitmap.h"
+#include "Rtt_EventPool.h"
 #include "Rtt_Lua.h"
 #include "Rtt_LuaContext.h"
 #include "Rtt_PlatformSurface.h"
@@ -578,7 +579,10 @@ Display::Update()
 	up.Add( "Prepare for frame event" );
 
     const FrameEvent& fe = FrameEvent::Constant();
-    fe.Dispatch( L, runtime );
+    {
+        EventPool::Scope scope( runtime.GetEventPool(), L, fe );
+        fe.Dispatch( L, runtime );
+    }
     
     up.Add( "FrameEvent" );
     
@@ -1993,7 +1997,7 @@ Display::Collect( lua_State *L )
     if ( ! fIsCollecting )
     {
         fIsCollecting = true;
-        GroupObject::CollectUnreachables( L, GetScene(), * Orphanage() );
+        GetScene().CollectOrphans( L );
         fIsCollecting = false;
     }
 }
@@ -61,7 +61,8 @@ DisplayDefaults::DisplayDefaults()
     fSceneDepthClear( 1.0 ),
     fAddedDepthClear( 1.0 ),
     fSceneStencilClear( 0 ),
-    fAddedStencilClear( 0 )
+    fAddedStencilClear( 0 ),
+    fGPUTransformMinVertices( 0 )
 {
 	static TimeTransform sTransform;
 
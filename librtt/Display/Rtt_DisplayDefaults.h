@@ -119,6 +119,10 @@ class DisplayDefaults
         U32 GetAddedStencilClearValue() const { return fAddedStencilClear; }
         void SetAddedStencilClearValue( float newValue ) { fAddedStencilClear = newValue; }
 
+        // Shapes with at least this many vertices are transformed by the GPU (0 disables)
+        U32 GetGPUTransformMinVertices() const { return fGPUTransformMinVertices; }
+        void SetGPUTransformMinVertices( U32 newValue ) { fGPUTransformMinVertices = newValue; }
+
         const TimeTransform* GetTimeTransform() const;
         void SetTimeTransform( const TimeTransform *transform );
 
@@ -154,6 +158,7 @@ class DisplayDefaults
         float fAddedDepthClear;
         U32 fSceneStencilClear;
         U32 fAddedStencilClear;
+        U32 fGPUTransformMinVertices;
         TimeTransform *fTimeTransform;
 };
 
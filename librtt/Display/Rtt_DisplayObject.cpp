@@ -26,6 +26,8 @@
 #include "Rtt_PhysicsWorld.h"
 #include "Rtt_RenderingStream.h"
 #include "Core/Rtt_StringHash.h"
+#include "Renderer/Rtt_Matrix_Renderer.h"
+#include "Renderer/Rtt_Renderer.h"
 #include "Renderer/Rtt_Uniform.h"
 
 #ifdef Rtt_PHYSICS
@@ -231,6 +233,9 @@ DisplayObject::DidChangePaint( RenderData& data )
 
 DisplayObject::DisplayObject()
 :    fParent( NULL ),
+    fPrevSibling( NULL ),
+    fNextSibling( NULL ),
+    fChildIndex( -1 ),
     fSrcToDst(),
     fTransform(),
     fStageBounds(),
@@ -392,6 +397,41 @@ DisplayObject::CullOffscreen( const Rect& screenBounds )
     }
 }
 
+bool
+DisplayObject::TranslateOffscreen( Real dx, Real dy, const Rect& screenBounds )
+{
+    // Only leaf nodes qualify, b/c a group's descendants would also need to
+    // be translated. The transform must be current except for earlier deferrals.
+    bool result = IsOffScreen()
+        && IsNotHidden()
+        && ( ! SkipsCull() && CanCull() )
+        && NULL == AsGroupObject()
+        && IsValid( kStageBoundsFlag )
+        && ( IsValid( kTransformFlag ) || IsProperty( kIsTransformDeferred ) )
+        && screenBounds.NotEmpty();
+
+    if ( result )
+    {
+        Rect bounds = fStageBounds;
+        bounds.Translate( dx, dy );
+
+        result = ! screenBounds.Intersects( bounds );
+        if ( result )
+        {
+            fStageBounds = bounds;
+            fSrcToDst.Translate( dx, dy );
+
+            // Leave the transform dirty, so the next UpdateTransform() lets
+            // subclasses react to the new transform, e.g. rebuild vertices.
+            // Stage bounds stay valid, as they are exact.
+            fDirtyFlags |= ( kTransformFlag | kGeometryFlag );
+            SetProperty( kIsTransformDeferred, true );
+        }
+    }
+
+    return result;
+}
+
 bool
 DisplayObject::UpdateTransform( const Matrix& parentToDstSpace )
 {
@@ -449,6 +489,7 @@ DisplayObject::UpdateTransform( const Matrix& parentToDstSpace )
             // Object's transform gets applied first, then parentToDstSpace
             fSrcToDst = parentToDstSpace;
             fSrcToDst.Concat( GetMatrix() );
+            SetProperty( kIsTransformDeferred, false );
 
             // After applying transform, allow subclasses to further customize,
             // e.g. trimmed frames from imagesheets
@@ -1148,6 +1189,12 @@ DisplayObject::Invalidate( DirtyFlags flags )
 
     fDirtyFlags |= flags;
 
+    if ( flags & kTransformFlag )
+    {
+        // The receiver's own transform changed, so translating it no longer suffices
+        SetProperty( kIsTransformDeferred, false );
+    }
+
     if ( flags & ( kGeometryFlag | kTransformFlag | kStageBoundsFlag ) )
     {
         InvalidateStageBounds();
@@ -1242,6 +1289,13 @@ DisplayObject::InvalidateDisplay()
     {
         canvas->InvalidateDisplay();
     }
+
+    // Whatever changed is drawn by the ancestors, so their bitmap caches are stale
+    GroupObject *parent = GetParent();
+    if ( parent )
+    {
+        parent->InvalidateBitmapCaches();
+    }
 }
 
 void
@@ -1406,6 +1460,35 @@ DisplayObject::GetMaskGeometricProperty( enum GeometricProperty p ) const
     return result;
 }
 
+bool
+DisplayObject::IsMaskedInHierarchy() const
+{
+    for ( const DisplayObject *object = this; object; object = object->GetParent() )
+    {
+        if ( object->GetMask() )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Saves the current frustum in viewMatrix and projMatrix, then folds this
+// object's transform into the view. Restore with renderer.SetFrustum().
+void
+DisplayObject::PushSrcToDstFrustum( Renderer& renderer, Real viewMatrix[16], Real projMatrix[16] ) const
+{
+    renderer.GetFrustum( viewMatrix, projMatrix );
+
+    Real srcToDst[16];
+    Real objectViewMatrix[16];
+    GetSrcToDstMatrix().ToGLMatrix( srcToDst );
+    Multiply4x4( viewMatrix, srcToDst, objectViewMatrix );
+
+    renderer.SetFrustum( objectViewMatrix, projMatrix );
+}
+
 void
 DisplayObject::WillDraw( Renderer& renderer ) const
 {
@@ -120,6 +120,7 @@ class DisplayObject : public MDrawable, public MLuaProxyable
             kIsRestricted = 0x800,
             kSkipsCull = 0x1000,
             kSkipsHitTest = 0x2000,
+            kIsTransformDeferred = 0x4000,
 
             // NOTE: Current maximum of 16 PropertyMasks!!!
         };
@@ -162,6 +163,12 @@ class DisplayObject : public MDrawable, public MLuaProxyable
     protected:
         void CullOffscreen( const Rect& screenBounds );
 
+        // Stands in for UpdateTransform() when the parent's transform only
+        // moved by (dx,dy). If the receiver stays offscreen, its transform and
+        // stage bounds are translated and the rest of UpdateTransform() is
+        // deferred until it is needed. Otherwise, returns false and does nothing.
+        bool TranslateOffscreen( Real dx, Real dy, const Rect& screenBounds );
+
 	public:
 		// MDrawable
 		virtual bool UpdateTransform( const Matrix& parentToDstSpace );
@@ -313,6 +320,12 @@ class DisplayObject : public MDrawable, public MLuaProxyable
         void SetMaskGeometricProperty( enum GeometricProperty p, Real newValue );
         Real GetMaskGeometricProperty( enum GeometricProperty p ) const;
 
+    protected:
+        // For subclasses that keep their vertices in local space and let
+        // the renderer apply the transform instead (see ShapeObject)
+        bool IsMaskedInHierarchy() const;
+        void PushSrcToDstFrustum( Renderer& renderer, Real viewMatrix[16], Real projMatrix[16] ) const;
+
     public:
         // Surround calls to Draw() with these
         virtual void WillDraw( Renderer& renderer ) const;
@@ -456,6 +469,13 @@ class DisplayObject : public MDrawable, public MLuaProxyable
     private:
         GroupObject* fParent;
 
+        // Neighbors in the parent's child list (see GroupObject) and the index
+        // in the parent's draw order array, which is only valid when that
+        // array is up to date
+        DisplayObject* fPrevSibling;
+        DisplayObject* fNextSibling;
+        S32 fChildIndex;
+
         //! "Src" is Local-space.
         //! "Dst" is Content-space.
         //! This is an optimization. This Matrix contains the concatenation
@@ -488,7 +508,7 @@ class DisplayObject : public MDrawable, public MLuaProxyable
         U8 fUnused; // Alignment
 
         friend class DisplayObjectDrawGuard;
-        friend class GroupObject; // Access to CullOffscreen
+        friend class GroupObject; // Access to CullOffscreen, TranslateOffscreen, siblings
         friend class EmitterObject;
         friend class DisplayLibrary;
         friend class LuaDisplayObjectProxyVTable;
@@ -32,7 +32,7 @@ namespace Rtt
 // ----------------------------------------------------------------------------
 
 void
-DisplayPath::UpdateGeometry( Geometry& dst, const VertexCache& src, const Matrix& srcToDstSpace, U32 flags, Array<U16> *indices )
+DisplayPath::UpdateGeometry( Geometry& dst, const VertexCache& src, const Matrix& srcToDstSpace, U32 flags, Array<U16> *indices, U32 startIndex )
 {
     if ( 0 == flags ) { return; }
 
@@ -40,10 +40,21 @@ DisplayPath::UpdateGeometry( Geometry& dst, const VertexCache& src, const Matrix
     const ArrayVertex2& texVertices = src.TexVertices();
     U32 numVertices = vertices.Length();
 
+    startIndex = Min( startIndex, Min( numVertices, dst.GetVerticesUsed() ) );
+
     U32 numIndices = indices==NULL?0:indices->Length();
     if ( dst.GetVerticesAllocated() < numVertices || dst.GetIndicesAllocated() < numIndices)
     {
-        dst.Resize( numVertices, numIndices, false );
+        if ( startIndex > 0 )
+        {
+            // Keep the leading vertices, and leave room to grow
+            U32 numAllocated = dst.GetVerticesAllocated();
+            dst.Resize( Max( numVertices, numAllocated + ( numAllocated >> 1 ) ), numIndices, true );
+        }
+        else
+        {
+            dst.Resize( numVertices, numIndices, false );
+        }
     }
     Geometry::Vertex *dstVertices = dst.GetVertexData();
 
@@ -87,7 +98,9 @@ DisplayPath::UpdateGeometry( Geometry& dst, const VertexCache& src, const Matrix
         step = 0U;
     }
 
-    for ( U32 i = 0, iMax = vertices.Length(); i < iMax; i++, zsource += step )
+    zsource += step * startIndex;
+
+    for ( U32 i = startIndex, iMax = vertices.Length(); i < iMax; i++, zsource += step )
 	{
 		Rtt_ASSERT( i < dst.GetVerticesAllocated() );
 
@@ -95,11 +108,8 @@ DisplayPath::UpdateGeometry( Geometry& dst, const VertexCache& src, const Matrix
 
         if ( updateVertices )
         {
-            Vertex2 v = vertices[i];
-            srcToDstSpace.Apply( v );
-
-			dst.x = v.x;
-			dst.y = v.y;
+			dst.x = vertices[i].x;
+			dst.y = vertices[i].y;
             dst.z = *zsource;
 		}
 
@@ -112,6 +122,11 @@ DisplayPath::UpdateGeometry( Geometry& dst, const VertexCache& src, const Matrix
     }
 
     dst.SetVerticesUsed( numVertices );
+
+    if ( updateVertices )
+    {
+        srcToDstSpace.Apply( dst, startIndex );
+    }
     
     if(flags & kIndicesMask)
     {
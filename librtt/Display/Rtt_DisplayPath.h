@@ -52,12 +52,14 @@ class DisplayPath
             kIndicesMask = 0x4,
         };
 
+		// Vertices before startIndex are assumed to be up to date
 		static void UpdateGeometry(
 			Geometry& dst,
 			const VertexCache& src,
 			const Matrix& srcToDstSpace,
 			U32 flags,
-		    ArrayIndex *indices );
+		    ArrayIndex *indices,
+			U32 startIndex = 0 );
     
         static const void * ZKey();
         static const void * IndicesKey();
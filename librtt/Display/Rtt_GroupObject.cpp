@@ -20,6 +20,9 @@
 
 #include "Rtt_Profiling.h"
 
+#include <algorithm>
+#include <vector>
+
 // ----------------------------------------------------------------------------
 
 namespace Rtt
@@ -51,8 +54,34 @@ MakeUnreachable( lua_State *L, Scene& scene, DisplayObject& object )
     object.FinalizeSelf( L );
 }
 
+// Returns true if 'to' only differs from 'from' by a translation of (dx,dy)
+static bool
+IsTranslation( const Matrix& from, const Matrix& to, Real& dx, Real& dy )
+{
+    bool result = ( from.IsIdentity() && to.IsIdentity() );
+
+    if ( ! result )
+    {
+        static const Real kIdentityRow0[] = { Rtt_REAL_1, Rtt_REAL_0, Rtt_REAL_0 };
+        static const Real kIdentityRow1[] = { Rtt_REAL_0, Rtt_REAL_1, Rtt_REAL_0 };
+
+        const Real *fromRow0 = ( from.IsIdentity() ? kIdentityRow0 : from.Row0() );
+        const Real *fromRow1 = ( from.IsIdentity() ? kIdentityRow1 : from.Row1() );
+        const Real *toRow0 = ( to.IsIdentity() ? kIdentityRow0 : to.Row0() );
+        const Real *toRow1 = ( to.IsIdentity() ? kIdentityRow1 : to.Row1() );
+
+        result = ( fromRow0[0] == toRow0[0] && fromRow0[1] == toRow0[1]
+            && fromRow1[0] == toRow1[0] && fromRow1[1] == toRow1[1] );
+    }
+
+    dx = to.Tx() - from.Tx();
+    dy = to.Ty() - from.Ty();
+
+    return result;
+}
+
 void
-GroupObject::CollectUnreachables( lua_State *L, Scene& scene, GroupObject& group )
+GroupObject::CollectUnreachables( lua_State *L, Scene& scene, GroupObject& group, GroupObject *graveyard )
 {
     for ( int i = group.NumChildren(); --i >= 0; )
     {
@@ -61,10 +90,44 @@ GroupObject::CollectUnreachables( lua_State *L, Scene& scene, GroupObject& group
         MakeUnreachable( L, scene, child );
 
         Rtt_ASSERT( ! child.IsReachable() );
-        group.Remove( i );
+        if ( graveyard )
+        {
+            graveyard->Insert( -1, group.Release( i ), false );
+        }
+        else
+        {
+            group.Remove( i );
+        }
     }
 }
 
+bool
+GroupObject::DestroyLastLeaf( GroupObject& root )
+{
+    if ( root.NumChildren() <= 0 )
+    {
+        return false;
+    }
+
+    // Descend along the last child until we reach a leaf. Its parent (and thus
+    // its stage) stays alive until the leaf is gone, so the leaf's d-tor can
+    // still queue its GPU resources for release via the Scene.
+    GroupObject *parent = & root;
+    for ( GroupObject *group = parent->fLastChild->AsGroupObject();
+          group && group->NumChildren() > 0;
+          group = parent->fLastChild->AsGroupObject() )
+    {
+        parent = group;
+    }
+
+    // Nothing under the root is drawn, so skip the invalidation done by Remove()
+    DisplayObject *leaf = parent->fLastChild;
+    parent->UnlinkChild( leaf );
+    Rtt_DELETE( leaf );
+
+    return true;
+}
+
 void
 GroupObject::ReleaseChildrenLuaReferences( lua_State *L )
 {
@@ -85,11 +148,28 @@ GroupObject::ReleaseChildrenLuaReferences( lua_State *L )
 GroupObject::GroupObject( Rtt_Allocator* pAllocator, StageObject* canvas )
 :    Super(),
     fStage( canvas ),
-    fChildren( pAllocator )
+    fBitmapCache( NULL ),
+    fFirstChild( NULL ),
+    fLastChild( NULL ),
+    fNumChildren( 0 ),
+    fChildren( pAllocator ),
+    fIsChildArrayStale( false )
 {
     SetObjectDesc("GroupObject"); // for introspection
 }
 
+GroupObject::~GroupObject()
+{
+    Rtt_DELETE( fBitmapCache );
+
+    for ( DisplayObject *child = fFirstChild; child; )
+    {
+        DisplayObject *next = child->fNextSibling;
+        Rtt_DELETE( child );
+        child = next;
+    }
+}
+
 GroupObject*
 GroupObject::AsGroupObject()
 {
@@ -105,6 +185,8 @@ GroupObject::AsGroupObject() const
 bool
 GroupObject::UpdateTransform( const Matrix& parentToDstSpace )
 {
+    const Matrix previousSrcToDst( GetSrcToDstMatrix() );
+
     bool shouldUpdate = Super::UpdateTransform( parentToDstSpace );
 
     if ( ShouldHitTest() )
@@ -129,18 +211,33 @@ GroupObject::UpdateTransform( const Matrix& parentToDstSpace )
                 : stage->GetDisplay().GetScreenContentBounds() );
         }
 
+        if ( fBitmapCache )
+        {
+            fBitmapCache->SetCullBounds( screenBounds );
+        }
+
         const Matrix& xform = GetSrcToDstMatrix();
 
         U8 alphaCumulativeFromAncestors = AlphaCumulative();
 
+        // When the receiver only moved, e.g. while scrolling, offscreen leaves
+        // just translate their bounds; see DisplayObject::TranslateOffscreen()
+        Real dx = Rtt_REAL_0, dy = Rtt_REAL_0;
+        bool isTranslation = shouldUpdate && IsTranslation( previousSrcToDst, xform, dx, dy );
+        U32 numTranslated = 0;
+
 		SUMMED_TIMING( ed, "Group: Visit Children" );
 
-        for ( S32 i = 0, iMax = fChildren.Length(); i < iMax; i++ )
+        for ( DisplayObject *child = fFirstChild; child; child = child->fNextSibling )
         {
-            DisplayObject *child = fChildren[i];
-
             child->UpdateAlphaCumulative( alphaCumulativeFromAncestors );
 
+            if ( isTranslation && child->TranslateOffscreen( dx, dy, screenBounds ) )
+            {
+                ++numTranslated;
+                continue;
+            }
+
             if ( shouldUpdate )
             {
                 // If receiver's matrix is out of date, then so are the children's
@@ -165,6 +262,11 @@ GroupObject::UpdateTransform( const Matrix& parentToDstSpace )
             }
         }
     }
+
+        if ( numTranslated > 0 && stage )
+        {
+            stage->GetScene().GetStatistics().fNumDeferredTransforms += numTranslated;
+        }
 	}
 
     return shouldUpdate;
@@ -184,11 +286,10 @@ GroupObject::Prepare( const Display& display )
 
         // Propagate certain flags to children
         DirtyFlags flags = kGroupPropagationMask & GetDirtyFlags();
+        U32 numSkipped = 0;
 
-        for ( S32 i = 0, iMax = fChildren.Length(); i < iMax; i++ )
+        for ( DisplayObject* child = fFirstChild; child; child = child->fNextSibling )
         {
-            DisplayObject* child = fChildren[i];
-
             // At least one of the following must be true:
             // 1. child is not a group
             // 2. (or if it's a group then), child is onscreen
@@ -205,6 +306,22 @@ GroupObject::Prepare( const Display& display )
 
                 child->Prepare( display );
             }
+            else if ( child->IsDirty() )
+            {
+                // Geometry and paint are rebuilt once the child is back onscreen
+                ++numSkipped;
+            }
+        }
+
+        StageObject *stage = GetStage();
+        if ( numSkipped > 0 && stage )
+        {
+            stage->GetScene().GetStatistics().fNumSkippedPrepares += numSkipped;
+        }
+
+        if ( fBitmapCache )
+        {
+            fBitmapCache->Prepare( display );
         }
 
         SetValid();
@@ -226,6 +343,14 @@ GroupObject::Draw( Renderer& renderer ) const
 
         const BitmapMask *mask = GetMask();
 
+        if ( fBitmapCache && fBitmapCache->IsRendering() )
+        {
+            // Rendering into the cache. The mask is applied when the
+            // cache itself is drawn below.
+            DrawChildren( renderer );
+            return;
+        }
+
         if ( mask )
         {
             Texture *texture = const_cast< BitmapPaint * >( mask->GetPaint() )->GetTexture();
@@ -233,16 +358,13 @@ GroupObject::Draw( Renderer& renderer ) const
             renderer.PushMask( texture, uniform );
         }
 
-        for ( S32 i = 0, iMax = fChildren.Length(); i < iMax; i++ )
+        if ( fBitmapCache && fBitmapCache->IsActive() )
         {
-            const DisplayObject *child = fChildren[i];
-
-            if ( ! child->IsOffScreen() )
-            {
-                child->WillDraw( renderer );
-                child->Draw( renderer );
-                child->DidDraw( renderer );
-            }
+            fBitmapCache->Draw( renderer );
+        }
+        else
+        {
+            DrawChildren( renderer );
         }
 
         if ( mask )
@@ -254,15 +376,28 @@ GroupObject::Draw( Renderer& renderer ) const
     }
 }
 
+void
+GroupObject::DrawChildren( Renderer& renderer ) const
+{
+    for ( const DisplayObject *child = fFirstChild; child; child = child->fNextSibling )
+    {
+        if ( ! child->IsOffScreen() )
+        {
+            child->WillDraw( renderer );
+            child->Draw( renderer );
+            child->DidDraw( renderer );
+        }
+    }
+}
+
 void
 GroupObject::GetSelfBounds( Rect& rect ) const
 {
     rect.SetEmpty();
 
-    for ( S32 i = 0, iMax = fChildren.Length(); i < iMax; i++ )
+    for ( const DisplayObject* child = fFirstChild; child; child = child->fNextSibling )
     {
         Rect childRect;
-        const DisplayObject* child = fChildren[i];
         child->GetSelfBounds( childRect );
 
 		Real dx, dy;
@@ -307,6 +442,8 @@ GroupObject::ShouldOffsetWithAnchor() const
 void
 GroupObject::DidInsert( bool childParentChanged )
 {
+    InvalidateBitmapCaches();
+
     if ( childParentChanged )
     {
         Invalidate( kStageBoundsFlag );
@@ -320,6 +457,8 @@ GroupObject::DidInsert( bool childParentChanged )
 void
 GroupObject::DidRemove()
 {
+    InvalidateBitmapCaches();
+
     Invalidate( kStageBoundsFlag );
 }
 
@@ -361,11 +500,11 @@ GroupObject::Insert( S32 index, DisplayObject* newChild, bool resetTransform )
             {
 				SUMMED_TIMING( rc, "Group: Insert (release child)" );
 
-                oldParent->Release( oldParent->Find( * newChild ) );
+                oldParent->ReleaseChild( * newChild );
             }
 
             newChild->SetParent( this );
-            fChildren.Insert( index, newChild );
+            LinkChild( newChild, ( index < fNumChildren ? ChildNode( index ) : NULL ) );
 
             // ++TransactionId();
             DidInsert( true );
@@ -376,20 +515,18 @@ GroupObject::Insert( S32 index, DisplayObject* newChild, bool resetTransform )
         {
 			SUMMED_TIMING( sp, "Group: Insert (same parent)" );
 
-            // newChild already belongs in this group
-            S32 oldIndex = oldParent->Find( * newChild );
+            // newChild already belongs in this group, so it goes in front of
+            // the child currently at index. This avoids looking up its index,
+            // so toFront() and toBack() are O(1).
+            DisplayObject* before = ( index < fNumChildren ? ChildNode( index ) : NULL );
 
-            // If new index is different from the old, then re-insert
-            if ( index != oldIndex )
+            // If new position is different from the old, then re-insert
+            if ( before != newChild && before != newChild->fNextSibling )
             {
-                DisplayObject* o = fChildren.Release( oldIndex ); Rtt_ASSERT( o == newChild );
-
-                // Removing an element causes the indices of all elements
-                // that came after to be one less.
-                if ( oldIndex < index ) { --index; }
+                UnlinkChild( newChild );
 
                 //++TransactionId();
-                fChildren.Insert( index, o );
+                LinkChild( newChild, before );
                 DidInsert( false );
             }
         }
@@ -399,7 +536,9 @@ GroupObject::Insert( S32 index, DisplayObject* newChild, bool resetTransform )
 void
 GroupObject::Remove( S32 index )
 {
-    fChildren.Remove( index, 1 );
+    DisplayObject* child = ChildNode( index );
+    UnlinkChild( child );
+    Rtt_DELETE( child );
 
     //++TransactionId();
     DidRemove();
@@ -412,14 +551,132 @@ GroupObject::Release( S32 index )
 
     if (index < NumChildren())
     {
-        child = fChildren.Release( index );
-        child->SetParent( NULL );
+        child = ReleaseChild( * ChildNode( index ) );
+    }
+
+    return child;
+}
+
+DisplayObject*
+GroupObject::ReleaseChild( DisplayObject& child )
+{
+    Rtt_ASSERT( this == child.GetParent() );
+
+    UnlinkChild( & child );
+    child.SetParent( NULL );
+
+    //++TransactionId();
+    DidRemove();
+
+    return & child;
+}
+
+void
+GroupObject::SortChildren( const Real* keys )
+{
+    const S32 numChildren = NumChildren();
+    if ( numChildren < 2 )
+    {
+        return;
+    }
+
+    struct SortEntry
+    {
+        Real fKey;
+        DisplayObject* fChild;
+
+        bool operator<( const SortEntry& rhs ) const { return fKey < rhs.fKey; }
+    };
+
+    const LightPtrArray< DisplayObject >& children = Children();
+
+    std::vector< SortEntry > entries( numChildren );
+    for ( S32 i = 0; i < numChildren; i++ )
+    {
+        entries[i].fKey = keys[i];
+        entries[i].fChild = children[i];
+    }
+
+    std::stable_sort( entries.begin(), entries.end() );
+
+    // Relink the children in sorted order. The array is rewritten in place,
+    // so it stays up to date.
+    bool isReordered = false;
+    DisplayObject* prev = NULL;
+    for ( S32 i = 0; i < numChildren; i++ )
+    {
+        DisplayObject* child = entries[i].fChild;
+
+        isReordered = isReordered || ( child != fChildren[i] );
+
+        child->fPrevSibling = prev;
+        child->fNextSibling = NULL;
+        child->fChildIndex = i;
+        fChildren[i] = child;
+
+        if ( prev )
+        {
+            prev->fNextSibling = child;
+        }
+        prev = child;
+    }
 
+    fFirstChild = entries[0].fChild;
+    fLastChild = prev;
+
+    if ( isReordered )
+    {
         //++TransactionId();
-        DidRemove();
+        DidInsert( false );
     }
+}
 
-    return child;
+BitmapCache::Mode
+GroupObject::GetCacheMode() const
+{
+    return ( fBitmapCache ? fBitmapCache->GetMode() : BitmapCache::kNone );
+}
+
+void
+GroupObject::SetCacheMode( BitmapCache::Mode newValue )
+{
+    // The stage is never cached
+    if ( IsStage() )
+    {
+        return;
+    }
+
+    if ( BitmapCache::kNone == newValue )
+    {
+        if ( fBitmapCache )
+        {
+            Rtt_DELETE( fBitmapCache );
+            fBitmapCache = NULL;
+        }
+    }
+    else
+    {
+        if ( ! fBitmapCache )
+        {
+            fBitmapCache = Rtt_NEW( Allocator(), BitmapCache( Allocator(), * this ) );
+        }
+
+        fBitmapCache->SetMode( newValue );
+    }
+
+    InvalidateDisplay();
+}
+
+void
+GroupObject::InvalidateBitmapCaches()
+{
+    for ( GroupObject *group = this; group; group = group->GetParent() )
+    {
+        if ( group->fBitmapCache )
+        {
+            group->fBitmapCache->Invalidate();
+        }
+    }
 }
 
 S32
@@ -427,14 +684,116 @@ GroupObject::Find( const DisplayObject& child ) const
 {
 	SUMMED_TIMING( fc, "Group: Find child" );
 
-    S32 i = 0, iMax = fChildren.Length();
-    for ( ;
-          i < iMax && ( & child != fChildren[i] );
-          i++ )
+    if ( this != child.GetParent() )
     {
+        return -1;
     }
 
-    return ( i < iMax ? i : -1 );
+    // Indices are assigned when the array is rebuilt
+    Children();
+
+    return child.fChildIndex;
+}
+
+void
+GroupObject::UpdateChildArray() const
+{
+    fChildren.Clear();
+
+    S32 i = 0;
+    for ( DisplayObject* child = fFirstChild; child; child = child->fNextSibling )
+    {
+        child->fChildIndex = i++;
+        fChildren.Append( child );
+    }
+
+    fIsChildArrayStale = false;
+}
+
+DisplayObject*
+GroupObject::ChildNode( S32 index ) const
+{
+    Rtt_ASSERT( index >= 0 && index < fNumChildren );
+
+    // Either end is reachable without the array, e.g. when children are moved
+    // into another group one at a time
+    if ( 0 == index )
+    {
+        return fFirstChild;
+    }
+
+    if ( fNumChildren - 1 == index )
+    {
+        return fLastChild;
+    }
+
+    return Children()[index];
+}
+
+// Inserts child in front of 'before', or at the end if 'before' is NULL
+void
+GroupObject::LinkChild( DisplayObject* child, DisplayObject* before )
+{
+    Rtt_ASSERT( child && ! child->fPrevSibling && ! child->fNextSibling );
+
+    DisplayObject* prev = ( before ? before->fPrevSibling : fLastChild );
+
+    child->fPrevSibling = prev;
+    child->fNextSibling = before;
+
+    if ( prev ) { prev->fNextSibling = child; }
+    else { fFirstChild = child; }
+
+    if ( before ) { before->fPrevSibling = child; }
+    else { fLastChild = child; }
+
+    // Appending keeps the array up to date, anything else invalidates it
+    if ( ! fIsChildArrayStale )
+    {
+        if ( before )
+        {
+            fIsChildArrayStale = true;
+        }
+        else
+        {
+            child->fChildIndex = fNumChildren;
+            fChildren.Append( child );
+        }
+    }
+
+    ++fNumChildren;
+}
+
+void
+GroupObject::UnlinkChild( DisplayObject* child )
+{
+    DisplayObject* prev = child->fPrevSibling;
+    DisplayObject* next = child->fNextSibling;
+
+    if ( prev ) { prev->fNextSibling = next; }
+    else { fFirstChild = next; }
+
+    if ( next ) { next->fPrevSibling = prev; }
+    else { fLastChild = prev; }
+
+    // Removing the last child keeps the array up to date, anything else invalidates it
+    if ( ! fIsChildArrayStale )
+    {
+        if ( next )
+        {
+            fIsChildArrayStale = true;
+        }
+        else
+        {
+            fChildren.Release( fNumChildren - 1 );
+        }
+    }
+
+    child->fPrevSibling = NULL;
+    child->fNextSibling = NULL;
+    child->fChildIndex = -1;
+
+    --fNumChildren;
 }
 
 // ----------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 #ifndef _Rtt_GroupObject_H__
 #define _Rtt_GroupObject_H__
 
+#include "Display/Rtt_BitmapCache.h"
 #include "Display/Rtt_DisplayObject.h"
 #include "Display/Rtt_DisplayTypes.h"
 
@@ -31,11 +32,19 @@ class GroupObject : public DisplayObject
 		typedef GroupObject Self;
 
 	public:
-		static void CollectUnreachables( lua_State *L, Scene& scene, GroupObject& group );
+		// When 'graveyard' is non-NULL, unreachable objects are finalized right away
+		// but moved into 'graveyard' instead of being deleted. Call DestroyLastLeaf()
+		// on the graveyard to delete them incrementally.
+		static void CollectUnreachables( lua_State *L, Scene& scene, GroupObject& group, GroupObject *graveyard = NULL );
+
+		// Deletes the last leaf in the subtree rooted at 'root', i.e. at most one
+		// object per call. Returns false when 'root' has no descendants left.
+		static bool DestroyLastLeaf( GroupObject& root );
 		void ReleaseChildrenLuaReferences( lua_State *L );
 
 	public:
 		GroupObject( Rtt_Allocator* pAllocator, StageObject* canvas );
+		virtual ~GroupObject();
 
 	public:
 		// Super
@@ -49,6 +58,9 @@ class GroupObject : public DisplayObject
 		virtual void Draw( Renderer& renderer ) const;
 		virtual void GetSelfBounds( Rect& rect ) const;
 
+	protected:
+		void DrawChildren( Renderer& renderer ) const;
+
 	public:
 		virtual bool HitTest( Real contentX, Real contentY );
 		virtual bool CanCull() const;
@@ -64,13 +76,27 @@ class GroupObject : public DisplayObject
 		void SetStage( StageObject* canvas ) { fStage = canvas; }
 
 	public:
-		S32 NumChildren() const { return fChildren.Length(); }
-		const DisplayObject& ChildAt( S32 index ) const { return * fChildren[index]; }
-		DisplayObject& ChildAt( S32 index ) { return * fChildren[index]; }
+		S32 NumChildren() const { return fNumChildren; }
+		const DisplayObject& ChildAt( S32 index ) const { return * Children()[index]; }
+		DisplayObject& ChildAt( S32 index ) { return * Children()[index]; }
 
 	protected:
 		bool IsStage() const { return this == (GroupObject*)fStage; }
 
+		// Children in draw order. After children are removed or reordered, the
+		// array is rebuilt from the child list the next time it's needed.
+		const LightPtrArray< DisplayObject >& Children() const
+		{
+			if ( fIsChildArrayStale ) { UpdateChildArray(); }
+			return fChildren;
+		}
+
+	private:
+		void UpdateChildArray() const;
+		DisplayObject* ChildNode( S32 index ) const;
+		void LinkChild( DisplayObject* child, DisplayObject* before );
+		void UnlinkChild( DisplayObject* child );
+
 	protected:
 		virtual void DidInsert( bool childParentChanged );
 		virtual void DidRemove();
@@ -81,15 +107,40 @@ class GroupObject : public DisplayObject
 		DisplayObject* Release( S32 index );
 		S32 Find( const DisplayObject& child ) const;
 
+		// Same as Release( Find( child ) ), but does not need the child's index
+		DisplayObject* ReleaseChild( DisplayObject& child );
+
+		// Reorders the children by ascending key, where keys[i] belongs to the
+		// child at index i. Children with equal keys keep their relative order.
+		void SortChildren( const Real* keys );
+
 	public:
 		Rtt_Allocator* Allocator() const { return fChildren.Allocator(); }
 
+	public:
+		// When enabled, the children are drawn from a texture that is only
+		// re-rendered after something in the subtree changes.
+		BitmapCache::Mode GetCacheMode() const;
+		void SetCacheMode( BitmapCache::Mode newValue );
+
+		// Marks the bitmap caches of the receiver and its ancestors stale
+		void InvalidateBitmapCaches();
+
 	private:
 		StageObject* fStage;
+		BitmapCache* fBitmapCache;
 
 	protected:
-		// Children are drawn in order, i.e. first child is drawn below the second
-		PtrArrayDisplayObject fChildren;
+		// Children are drawn in order, i.e. first child is drawn below the second.
+		// The list of siblings is authoritative, so inserting, removing and
+		// reordering children at either end or by reference is O(1).
+		DisplayObject* fFirstChild;
+		DisplayObject* fLastChild;
+		S32 fNumChildren;
+
+		// Only used for access by index
+		mutable LightPtrArray< DisplayObject > fChildren;
+		mutable bool fIsChildArrayStale;
 };
 
 // ----------------------------------------------------------------------------
@@ -12,6 +12,7 @@
 #include "Rtt_LineObject.h"
 
 #include "Display/Rtt_Display.h"
+#include "Display/Rtt_DisplayDefaults.h"
 #include "Display/Rtt_OpenPath.h"
 #include "Display/Rtt_Shader.h"
 #include "Display/Rtt_ShaderFactory.h"
@@ -48,7 +49,8 @@ LineObject::LineObject( OpenPath* path )
 	fShaderColor( ColorZero() ),
 	fPath( path ),
 	fStrokeShader( NULL ),
-	fAnchorSegments( false )
+	fAnchorSegments( false ),
+	fIsTransformedOnGPU( false )
 {
 	Rtt_ASSERT( fPath );
 	fPath->SetObserver( this );
@@ -66,7 +68,8 @@ LineObject::UpdateTransform( const Matrix& parentToDstSpace )
 {
 	bool shouldUpdate = Super::UpdateTransform( parentToDstSpace );
 
-	if ( shouldUpdate )
+	// Local-space vertices do not depend on the transform
+	if ( shouldUpdate && ! fIsTransformedOnGPU )
 	{
 		fPath->Invalidate( OpenPath::kStroke );
 	}
@@ -85,6 +88,15 @@ LineObject::Prepare( const Display& display )
 
 	if ( ShouldPrepare() )
 	{
+		bool isTransformedOnGPU = ShouldTransformOnGPU( display );
+		if ( isTransformedOnGPU != fIsTransformedOnGPU )
+		{
+			// Rewrite the vertices in the other space
+			fIsTransformedOnGPU = isTransformedOnGPU;
+			fPath->Invalidate( OpenPath::kStroke );
+			Invalidate( kGeometryFlag );
+		}
+
 		// NOTE: We need to update paint *prior* to geometry
 		// b/c in the case of image sheets, the paint needs to be updated
 		// in order for the texture coordinates to be updated.
@@ -96,7 +108,8 @@ LineObject::Prepare( const Display& display )
 
 		if ( ! IsValid( kGeometryFlag ) )
 		{
-			const Matrix& xform = GetSrcToDstMatrix();
+			Matrix identity;
+			const Matrix& xform = ( fIsTransformedOnGPU ? identity : GetSrcToDstMatrix() );
 			fPath->Update( fStrokeData, xform );
 			SetValid( kGeometryFlag );
 		}
@@ -166,7 +179,20 @@ LineObject::Draw( Renderer& renderer ) const
 
 		if ( fPath->HasStroke() && fPath->IsStrokeVisible() )
 		{
-			fStrokeShader->Draw( renderer, fStrokeData );
+			if ( fIsTransformedOnGPU )
+			{
+				Real viewMatrix[16];
+				Real projMatrix[16];
+				PushSrcToDstFrustum( renderer, viewMatrix, projMatrix );
+
+				fStrokeShader->Draw( renderer, fStrokeData );
+
+				renderer.SetFrustum( viewMatrix, projMatrix );
+			}
+			else
+			{
+				fStrokeShader->Draw( renderer, fStrokeData );
+			}
 		}
 	}
 }
@@ -177,6 +203,30 @@ LineObject::GetSelfBounds( Rect& rect ) const
 	fPath->GetSelfBounds( rect );
 }
 
+bool
+LineObject::ShouldTransformOnGPU( const Display& display ) const
+{
+	U32 minVertices = display.GetDefaults().GetGPUTransformMinVertices();
+	const Paint *stroke = fPath->GetStroke();
+	if ( 0 == minVertices
+		 || ! stroke
+		 || ! fStrokeData.fGeometry
+		 || fStrokeData.fGeometry->GetVerticesUsed() < minVertices )
+	{
+		return false;
+	}
+
+	// Effects and masks need content-space vertices (see ShapeObject)
+	ShaderFactory& factory = display.GetShaderFactory();
+	const Shader *shader = stroke->GetShader( factory );
+	if ( shader != & factory.GetDefault() && shader != & factory.GetDefaultColorShader() )
+	{
+		return false;
+	}
+
+	return ! IsMaskedInHierarchy();
+}
+
 const LuaProxyVTable&
 LineObject::ProxyVTable() const
 {
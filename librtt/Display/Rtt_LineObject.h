@@ -71,6 +71,9 @@ class LineObject : public DisplayObject
     public:
         void SetBlend( RenderTypes::BlendType newValue );
         RenderTypes::BlendType GetBlend() const;
+
+	protected:
+		bool ShouldTransformOnGPU( const Display& display ) const;
     
 	private:
 		RenderData fStrokeData;
@@ -80,6 +83,9 @@ class LineObject : public DisplayObject
 		const Shader *fStrokeShader; // Temporary
 
 		bool fAnchorSegments;
+
+		// When true, the stroke stays in local space (see ShapeObject)
+		bool fIsTransformedOnGPU;
 };
 
 // ----------------------------------------------------------------------------
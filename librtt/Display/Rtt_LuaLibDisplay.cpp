@@ -53,6 +53,8 @@
 #include "Display/Rtt_ImageSheet.h"
 #include "Display/Rtt_ImageSheetUserdata.h"
 #include "Rtt_LineObject.h"
+#include "Rtt_EventPool.h"
+#include "Rtt_GCScheduler.h"
 #include "Rtt_LuaContext.h"
 #include "Rtt_LuaLibNative.h"
 #include "Rtt_LuaLibSystem.h"
@@ -62,7 +64,9 @@
 #include "Display/Rtt_OpenPath.h"
 #include "Rtt_RenderingStream.h"
 #include "Rtt_Runtime.h"
+#include "Display/Rtt_SpriteBatchObject.h"
 #include "Display/Rtt_SpriteObject.h"
+#include "Display/Rtt_SpritePlayer.h"
 #include "Display/Rtt_TextObject.h"
 #include "Renderer/Rtt_Texture.h"
 #include "Renderer/Rtt_Renderer.h"
@@ -156,6 +160,7 @@ class DisplayLibrary
         static int _newContainer( lua_State *L );
         static int newSnapshot( lua_State *L );
         static int newSprite( lua_State *L );
+        static int newSpriteBatch( lua_State *L );
         static int newMesh( lua_State *L );
         static int getDefault( lua_State *L );
         static int setDefault( lua_State *L );
@@ -236,6 +241,7 @@ DisplayLibrary::Open( lua_State *L )
         { "_newContainer", _newContainer },
         { "newSnapshot", newSnapshot },
         { "newSprite", newSprite },
+        { "newSpriteBatch", newSpriteBatch },
         { "newMesh", newMesh },
         { "getDefault", getDefault },
         { "setDefault", setDefault },
@@ -804,9 +810,22 @@ DisplayLibrary::newPolygon( lua_State *L )
     Real y = luaL_checkreal( L, nextArg++ );
 
     ShapePath *path = ShapePath::NewPolygon( display.GetAllocator() );
-    bool hasZ = lua_toboolean( L, nextArg + 1 );
+
+    // display.newPolygon( [parent,] x, y, vertices [, hasZ] [, holes] )
+    int holesArg = nextArg + 1;
+    bool hasZ = false;
+    if ( ! lua_istable( L, holesArg ) )
+    {
+        hasZ = lua_toboolean( L, holesArg );
+        ++holesArg;
+    }
+    if ( ! lua_istable( L, holesArg ) )
+    {
+        holesArg = 0;
+    }
+
     TesselatorPolygon *tesselator = (TesselatorPolygon *)path->GetTesselator();
-    if ( ShapeAdapterPolygon::InitializeContour( L, nextArg, * tesselator, hasZ ) )
+    if ( ShapeAdapterPolygon::InitializeContour( L, nextArg, * tesselator, hasZ, holesArg ) )
     {
         ShapeObject *v = polygonFactory( display.GetAllocator(), path );
 
@@ -817,6 +836,16 @@ DisplayLibrary::newPolygon( lua_State *L )
             tesselator->SetTriangulationArray( indexArray );
 
             LoadZ( L, nextArg, path );
+
+            // Hole points follow the outer points in the contour
+            for ( int i = 1, iMax = holesArg ? (int)lua_objlen( L, holesArg ) : 0; i <= iMax; i++, lua_pop( L, 1 ) )
+            {
+                lua_rawgeti( L, holesArg, i );
+                if ( lua_istable( L, -1 ) )
+                {
+                    LoadZ( L, lua_gettop( L ), path );
+                }
+            }
         }
 
         result = LuaLibDisplay::AssignParentAndPushResult( L, display, v, parent );
@@ -1844,6 +1873,45 @@ DisplayLibrary::newSprite( lua_State *L )
     return result;
 }
 
+// display.newSpriteBatch( [parent, ] imageSheet, capacity )
+int
+DisplayLibrary::newSpriteBatch( lua_State *L )
+{
+    int result = 0;
+
+    int nextArg = 1;
+    GroupObject *parent = LuaLibDisplay::GetParent( L, nextArg );
+    ImageSheetUserdata *ud = ImageSheet::ToUserdata( L, nextArg );
+
+    if ( ud && ! ud->GetSheet()->IsEmpty() )
+    {
+        nextArg++;
+
+        int capacity = (int) lua_tointeger( L, nextArg );
+        if ( capacity > 0 )
+        {
+            Self *library = ToLibrary( L );
+            Display& display = library->GetDisplay();
+            Rtt_Allocator *context = display.GetAllocator();
+
+            SpriteBatchObject *o = Rtt_NEW( context, SpriteBatchObject( context, ud->GetSheet(), (U32)capacity ) );
+            o->Initialize( display );
+
+            result = LuaLibDisplay::AssignParentAndPushResult( L, display, o, parent );
+        }
+        else
+        {
+            CoronaLuaError( L, "display.newSpriteBatch() requires argument #%d to be a positive capacity", nextArg );
+        }
+    }
+    else
+    {
+        CoronaLuaError( L, "display.newSpriteBatch() requires argument #%d to be a non-empty imageSheet", nextArg );
+    }
+
+    return result;
+}
+
 static int
 PushColor( lua_State *L, Color c, bool isBytes )
 {
@@ -2028,6 +2096,10 @@ DisplayLibrary::getDefault( lua_State *L )
     {
         lua_pushinteger( L, defaults.GetAddedStencilClearValue() );
     }
+    else if ( ( Rtt_StringCompare( key, "gpuTransformMinVertices" ) == 0 ) )
+    {
+        lua_pushinteger( L, defaults.GetGPUTransformMinVertices() );
+    }
     else if ( key )
     {
         luaL_error( L, "ERROR: display.getDefault() given invalid key (%s)", key );
@@ -2254,6 +2326,11 @@ DisplayLibrary::setDefault( lua_State *L )
         U32 stencil = lua_tointeger( L, index );
         defaults.SetAddedStencilClearValue( stencil );
     }
+    else if ( ( Rtt_StringCompare( key, "gpuTransformMinVertices" ) == 0 ) )
+    {
+        lua_Integer count = lua_tointeger( L, index );
+        defaults.SetGPUTransformMinVertices( count > 0 ? (U32)count : 0 );
+    }
     else if ( key )
     {
         luaL_error( L, "ERROR: display.setDefault() given invalid key (%s)", key );
@@ -2943,6 +3020,44 @@ DisplayLibrary::getStatistics( lua_State *L )
 		lua_setfield( L, 1, "textureBindCount" );
 		lua_pushinteger( L, stats.fTextureBindCount );
 		lua_setfield( L, 1, "textureBindCount" );
+		lua_pushinteger( L, stats.fBitmapCacheHitCount );
+		lua_setfield( L, 1, "bitmapCacheHitCount" );
+		lua_pushinteger( L, stats.fBitmapCacheMissCount );
+		lua_setfield( L, 1, "bitmapCacheMissCount" );
+		lua_pushinteger( L, stats.fEffectPassCount );
+		lua_setfield( L, 1, "effectPassCount" );
+		lua_pushinteger( L, stats.fEffectPassSkipCount );
+		lua_setfield( L, 1, "effectPassSkipCount" );
+
+		const GCScheduler::Statistics& gcStats = lib->GetDisplay().GetRuntime().GetGCScheduler().GetFrameStatistics();
+
+		lua_pushnumber( L, gcStats.fTime );
+		lua_setfield( L, 1, "gcTime" );
+		lua_pushinteger( L, gcStats.fLuaStepCount );
+		lua_setfield( L, 1, "gcStepCount" );
+		lua_pushinteger( L, gcStats.fLuaCycleCount );
+		lua_setfield( L, 1, "gcCycleCount" );
+		lua_pushinteger( L, gcStats.fObjectsDestroyed );
+		lua_setfield( L, 1, "gcObjectsDestroyed" );
+		lua_pushinteger( L, gcStats.fObjectsPending );
+		lua_setfield( L, 1, "gcObjectsPending" );
+
+		const EventPool::Statistics& eventStats = lib->GetDisplay().GetRuntime().GetEventPool().GetFrameStatistics();
+
+		lua_pushinteger( L, eventStats.fTablesCreated );
+		lua_setfield( L, 1, "eventTablesCreated" );
+		lua_pushinteger( L, eventStats.fTablesReused );
+		lua_setfield( L, 1, "eventTablesReused" );
+
+		lua_pushinteger( L, lib->GetDisplay().GetSpritePlayer().GetUpdateCount() );
+		lua_setfield( L, 1, "spriteUpdateCount" );
+
+		const Scene::Statistics& sceneStats = lib->GetDisplay().GetScene().GetStatistics();
+
+		lua_pushinteger( L, sceneStats.fNumDeferredTransforms );
+		lua_setfield( L, 1, "offscreenTransformsDeferred" );
+		lua_pushinteger( L, sceneStats.fNumSkippedPrepares );
+		lua_setfield( L, 1, "offscreenPreparesSkipped" );
 	}
 
 	return 0;
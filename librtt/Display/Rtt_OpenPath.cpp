@@ -33,6 +33,8 @@ OpenPath::OpenPath( Rtt_Allocator* pAllocator )
     fStrokePoints( pAllocator ),
     fBounds(),
     fWidth( 0 ),
+    fLineState(),
+    fStrokeTailStart( 0 ),
     fProperties( 0 ),
     fDirtyFlags( kDefault )
 {
@@ -63,13 +65,21 @@ OpenPath::Tesselate()
 
     TesselatorLine tesselator( fStrokePoints, TesselatorLine::kLineMode );
     tesselator.SetWidth( GetWidth() );
+    tesselator.SetLineState( & fLineState );
 
     ArrayVertex2& vertices = fStrokeSource.Vertices();
-    if ( ! IsValid( kStrokeSource ) )
+    if ( ! IsValid( kStrokeSource | kStrokeSourceAppend ) )
     {
-        vertices.Clear();
-        tesselator.GenerateStroke( vertices );
-        SetValid( kStrokeSource );
+        // When points were only appended, stroke just the new segments.
+        // Everything up to the old end cap stays as is.
+        U32 numValid = vertices.Length();
+        bool isAppended = IsValid( kStrokeSource ) && tesselator.AppendStroke( vertices );
+        if ( ! isAppended )
+        {
+            vertices.Clear();
+            tesselator.GenerateStroke( vertices );
+        }
+        SetValid( kStrokeSource | kStrokeSourceAppend );
 
         if ( hasTexture )
         {
@@ -77,7 +87,16 @@ OpenPath::Tesselate()
         }
 
         // Force renderdata update
-        Invalidate( kStroke );
+        if ( isAppended && IsValid( kStroke ) )
+        {
+            U32 tailStart = numValid - 2;
+            fStrokeTailStart = ( IsValid( kStrokeTail ) ? tailStart : Min( fStrokeTailStart, tailStart ) );
+            Invalidate( kStrokeTail );
+        }
+        else
+        {
+            Invalidate( kStroke );
+        }
 
         // Force per-vertex color data update
         GetObserver()->Invalidate( DisplayObject::kColorFlag );
@@ -109,17 +128,26 @@ OpenPath::Update( RenderData& data, const Matrix& srcToDstSpace )
         Tesselate();
 
         U32 flags = 0;
+        U32 startIndex = 0;
         if ( ! IsValid( kStroke ) )
         {
             flags |= kVerticesMask;
         }
+        else if ( ! IsValid( kStrokeTail ) )
+        {
+            flags |= kVerticesMask;
+            startIndex = fStrokeTailStart;
+        }
         if ( ! IsValid( kStrokeTexture ) )
         {
             flags |= kTexVerticesMask;
+            startIndex = 0;
         }
 
-        UpdateGeometry( *fStrokeGeometry, fStrokeSource, srcToDstSpace, flags, NULL );
+        UpdateGeometry( *fStrokeGeometry, fStrokeSource, srcToDstSpace, flags, NULL, startIndex );
         data.fGeometry = fStrokeGeometry;
+
+        SetValid( kStroke | kStrokeTexture | kStrokeTail );
     }
 }
 
@@ -215,10 +243,12 @@ OpenPath::SetWidth( Real newValue )
 void
 OpenPath::Insert( S32 index, const Vertex2& p )
 {
+    bool isAppend = ( index < 0 || index >= fStrokePoints.Length() );
+
     fStrokePoints.Insert( index, p );
     fBounds.Union( p );
 
-    Invalidate( kStrokeSource );
+    Invalidate( isAppend ? kStrokeSourceAppend : kStrokeSource );
 }
 
 void
@@ -266,9 +296,9 @@ OpenPath::SetStrokeVertexColor( U32 index, U32 color )
 U32
 OpenPath::GetStrokeVertexCount() const
 {
-    if (IsValid( kStrokeSource ))
+    if (IsValid( kStrokeSource | kStrokeSourceAppend ))
     {
-        return fStrokeGeometry->GetVerticesAllocated();
+        return fStrokeSource.Vertices().Length();
     }
 
     else
@@ -11,6 +11,7 @@
 #define _Rtt_OpenPath_H__
 
 #include "Display/Rtt_DisplayPath.h"
+#include "Display/Rtt_TesselatorLine.h"
 #include "Renderer/Rtt_RenderData.h"
 #include "Rtt_VertexCache.h"
 
@@ -43,6 +44,8 @@ class OpenPath : public DisplayPath
             kStrokeTexture = 0x2,            // Stroke tex coords in renderdata
             kStrokeSource = 0x4,            // Stroke tesselation
             kStrokeSourceTexture = 0x8,        // Stroke tex tesselation
+            kStrokeSourceAppend = 0x10,        // Points appended since the stroke tesselation
+            kStrokeTail = 0x20,                // Stroke vertices in renderdata, from fStrokeTailStart on
 
             kDefault = kStrokeSource,
         };
@@ -118,6 +121,8 @@ class OpenPath : public DisplayPath
         ArrayVertex2 fStrokePoints;
         Rect fBounds; // self bounds
         Real fWidth;
+        TesselatorLine::LineState fLineState;
+        U32 fStrokeTailStart;
         U8 fProperties;
         U8 fDirtyFlags;
 };
@@ -20,6 +20,7 @@
 #include "Renderer/Rtt_Geometry_Renderer.h"
 #include "Renderer/Rtt_RenderData.h"
 #include "Renderer/Rtt_TextureBitmap.h"
+#include "Renderer/Rtt_VertexKernels.h"
 #include "Rtt_LuaUserdataProxy.h"
 #include "Rtt_Lua.h"
 
@@ -159,11 +160,6 @@ namespace Rtt
 		return &fResource->GetTexture();
 	}
 
-	inline U8 Scale2(U16 a, U16 b)
-	{
-		return (U8)((a * b) >> 8U);
-	}
-
 	void
 		Paint::UpdateColor(RenderData& data, U8 objectAlpha)
 	{
@@ -190,45 +186,25 @@ namespace Rtt
 		Geometry::Vertex* vertices = g->GetVertexData();
 
 		const U32* perVertexColors = g->GetPerVertexColorData();
-		const bool scaleColor = c.pixel != ColorWhite();
+		const U32 numVertices = g->GetVerticesUsed();
 
-		for (U32 i = 0, iMax = g->GetVerticesUsed(); i < iMax; i++)
+		if (!perVertexColors)
 		{
-			Geometry::Vertex& v = vertices[i];
-
-			// Faster way to assign (rs,gs,bs,as)
-	//		ColorUnion *dstScale = (ColorUnion *)& v.rs;
-	//		dstScale->pixel = pixel;
+			VertexKernels::FillColor(vertices, numVertices, c.pixel);
+		}
 
-			if (!perVertexColors)
-			{
-				v.rs = c.rgba.r;
-				v.gs = c.rgba.g;
-				v.bs = c.rgba.b;
-				v.as = c.rgba.a;
-			}
+		else
+		{
+			// Per-vertex colors are scaled by the paint color, unless white
+			VertexKernels::ScaleColors(vertices, perVertexColors, numVertices, c.pixel);
+		}
 
-			else
+		if (shouldUpdateShader)
+		{
+			for (U32 i = 0; i < numVertices; i++)
 			{
-				ColorUnion vc;
-				vc.pixel = perVertexColors[i];
-
-				v.rs = vc.rgba.r;
-				v.gs = vc.rgba.g;
-				v.bs = vc.rgba.b;
-				v.as = vc.rgba.a;
-
-				if (scaleColor)
-				{
-					v.rs = Scale2(v.rs, c.rgba.r);
-					v.gs = Scale2(v.gs, c.rgba.g);
-					v.bs = Scale2(v.bs, c.rgba.b);
-					v.as = Scale2(v.as, c.rgba.a);
-				}
-			}
+				Geometry::Vertex& v = vertices[i];
 
-			if (shouldUpdateShader)
-			{
 				v.ux = ux;
 				v.uy = uy;
 				v.uz = uz;
@@ -266,11 +266,12 @@ RectPath::UpdateStroke( const Matrix& srcToDstSpace )
 			fStrokeGeometry->Resize( kNumSrc, false );
 		}
 
+		srcToDstSpace.Apply( src, kNumSrc );
+
 		Geometry::Vertex *dst = fStrokeGeometry->GetVertexData();
 		for ( int i = 0; i < kNumSrc; i++ )
 		{
-			Vertex2& vSrc = src[i];
-			srcToDstSpace.Apply( vSrc );
+			const Vertex2& vSrc = src[i];
 			Geometry::Vertex& v = dst[i];
 			v.x = vSrc.x;
 			v.y = vSrc.y;
@@ -362,11 +363,8 @@ RectPath::UpdateGeometry(
 
 		if ( updateVertices )
 		{
-			Vertex2 v = vertices[i];
-			srcToDstSpace.Apply( v );
-
-			dst.x = v.x;
-			dst.y = v.y;
+			dst.x = vertices[i].x;
+			dst.y = vertices[i].y;
             dst.z = *zsource;
 		}
 
@@ -389,6 +387,11 @@ RectPath::UpdateGeometry(
 	}
 
 	dst.SetVerticesUsed( numVertices );
+
+	if ( updateVertices )
+	{
+		srcToDstSpace.Apply( dst );
+	}
 }
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,247 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Display/Rtt_RenderTargetPool.h"
+
+#include "Display/Rtt_Display.h"
+#include "Display/Rtt_Scene.h"
+#include "Display/Rtt_TextureFactory.h"
+#include "Renderer/Rtt_FrameBufferObject.h"
+#include "Renderer/Rtt_TextureVolatile.h"
+
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Filter and wrap are part of the key: the GL and Vulkan backends only apply
+// sampler state when a texture is created, so it cannot be changed on reuse
+RenderTargetPool::Key::Key( const Texture& texture )
+:	fWidth( texture.GetWidth() ),
+	fHeight( texture.GetHeight() ),
+	fFormat( texture.GetFormat() ),
+	fFilter( texture.GetFilter() ),
+	fWrapX( texture.GetWrapX() ),
+	fWrapY( texture.GetWrapY() )
+{
+}
+
+RenderTargetPool::Key::Key( U32 width, U32 height, Texture::Format format, Texture::Filter filter, Texture::Wrap wrap )
+:	fWidth( width ),
+	fHeight( height ),
+	fFormat( format ),
+	fFilter( filter ),
+	fWrapX( wrap ),
+	fWrapY( wrap )
+{
+}
+
+bool
+RenderTargetPool::Key::operator<( const Key& rhs ) const
+{
+	if ( fWidth != rhs.fWidth ) { return fWidth < rhs.fWidth; }
+	if ( fHeight != rhs.fHeight ) { return fHeight < rhs.fHeight; }
+	if ( fFormat != rhs.fFormat ) { return fFormat < rhs.fFormat; }
+	if ( fFilter != rhs.fFilter ) { return fFilter < rhs.fFilter; }
+	if ( fWrapX != rhs.fWrapX ) { return fWrapX < rhs.fWrapX; }
+	return fWrapY < rhs.fWrapY;
+}
+
+// ----------------------------------------------------------------------------
+
+RenderTargetPool::RenderTargetPool( TextureFactory& owner )
+:	fOwner( owner ),
+	fFree(),
+	fUsed(),
+	fFrame( 0 )
+{
+	memset( & fStatistics, 0, sizeof( fStatistics ) );
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+	// Users have released their targets by now (the scene goes first), and
+	// the scene's orphanage is gone, so free the remaining targets directly.
+	for ( FreeList::iterator iter = fFree.begin(); iter != fFree.end(); ++iter )
+	{
+		Destroy( iter->second.fFBO, false );
+	}
+}
+
+FrameBufferObject *
+RenderTargetPool::Acquire(
+	U32 width, U32 height,
+	Texture::Format format, Texture::Filter filter, Texture::Wrap wrap )
+{
+	FrameBufferObject *result = NULL;
+
+	// Prefer the most recently released target; skip ones released this frame
+	Key key( width, height, format, filter, wrap );
+	FreeList::iterator iBegin = fFree.lower_bound( key );
+	FreeList::iterator iFound = fFree.end();
+	for ( FreeList::iterator iter = fFree.upper_bound( key ); iter != iBegin; )
+	{
+		--iter;
+		if ( iter->second.fReleaseFrame != fFrame && ! iter->second.fIsStale )
+		{
+			iFound = iter;
+			break;
+		}
+	}
+
+	if ( fFree.end() != iFound )
+	{
+		result = iFound->second.fFBO;
+		fFree.erase( iFound );
+
+		const Texture *texture = result->GetTexture();
+		size_t numBytes = texture->GetSizeInBytes();
+		fStatistics.fBytesFree -= numBytes;
+		fStatistics.fBytesUsed += numBytes;
+		--fStatistics.fNumFree;
+		++fStatistics.fNumReused;
+	}
+	else
+	{
+		Rtt_Allocator *allocator = fOwner.GetDisplay().GetAllocator();
+
+		Texture *texture = Rtt_NEW( allocator, TextureVolatile( allocator, width, height, format, filter, wrap, wrap ) );
+		result = Rtt_NEW( allocator, FrameBufferObject( allocator, texture ) );
+
+		fStatistics.fBytesUsed += texture->GetSizeInBytes();
+		++fStatistics.fNumCreated;
+	}
+
+	fUsed.insert( UsedList::value_type( result, key ) );
+	++fStatistics.fNumUsed;
+
+	return result;
+}
+
+void
+RenderTargetPool::Release( FrameBufferObject *fbo )
+{
+	if ( fbo )
+	{
+		Texture& texture = * fbo->GetTexture();
+
+		// Users may have marked it, e.g. snapshots
+		texture.SetRetina( false );
+
+		// Snapshots let Lua change filter and wrap while they hold a target.
+		// The GPU may or may not have picked that up, so such a target is
+		// never reused and goes in the next BeginFrame().
+		Key key( texture );
+		bool isStale = false;
+		UsedList::iterator iUsed = fUsed.find( fbo );
+		if ( Rtt_VERIFY( fUsed.end() != iUsed ) )
+		{
+			isStale = ( key < iUsed->second || iUsed->second < key );
+			fUsed.erase( iUsed );
+		}
+
+		Entry entry = { fbo, fFrame, isStale };
+		fFree.insert( FreeList::value_type( key, entry ) );
+
+		size_t numBytes = texture.GetSizeInBytes();
+		fStatistics.fBytesUsed -= numBytes;
+		fStatistics.fBytesFree += numBytes;
+		--fStatistics.fNumUsed;
+		++fStatistics.fNumFree;
+	}
+}
+
+void
+RenderTargetPool::BeginFrame()
+{
+	++fFrame;
+
+	for ( FreeList::iterator iter = fFree.begin(); iter != fFree.end(); )
+	{
+		if ( iter->second.fIsStale || fFrame - iter->second.fReleaseFrame > kMaxIdleFrames )
+		{
+			Evict( iter++ );
+		}
+		else
+		{
+			++iter;
+		}
+	}
+
+	// Over budget, so evict the least recently released targets
+	if ( fStatistics.fBytesFree > kMaxBytesFree )
+	{
+		Trim( fStatistics.fBytesFree - kMaxBytesFree );
+	}
+}
+
+size_t
+RenderTargetPool::Trim( size_t numBytes )
+{
+	size_t bytesFree = fStatistics.fBytesFree;
+
+	// Only a handful of targets are free at a time, so a linear search suffices
+	while ( ! fFree.empty() && bytesFree - fStatistics.fBytesFree < numBytes )
+	{
+		FreeList::iterator iOldest = fFree.begin();
+		for ( FreeList::iterator iter = fFree.begin(); iter != fFree.end(); ++iter )
+		{
+			if ( iter->second.fReleaseFrame < iOldest->second.fReleaseFrame )
+			{
+				iOldest = iter;
+			}
+		}
+
+		Evict( iOldest );
+	}
+
+	return bytesFree - fStatistics.fBytesFree;
+}
+
+void
+RenderTargetPool::Evict( FreeList::iterator iter )
+{
+	const Entry& entry = iter->second;
+
+	fStatistics.fBytesFree -= entry.fFBO->GetTexture()->GetSizeInBytes();
+	--fStatistics.fNumFree;
+
+	Destroy( entry.fFBO, true );
+	fFree.erase( iter );
+}
+
+void
+RenderTargetPool::Destroy( FrameBufferObject *fbo, bool isDeferred )
+{
+	Texture *texture = fbo->GetTexture();
+
+	if ( isDeferred )
+	{
+		Scene& scene = fOwner.GetDisplay().GetScene();
+		scene.QueueRelease( texture );
+		scene.QueueRelease( fbo );
+	}
+	else
+	{
+		Rtt_DELETE( fbo );
+		Rtt_DELETE( texture );
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
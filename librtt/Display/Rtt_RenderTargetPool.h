@@ -0,0 +1,131 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_RenderTargetPool_H__
+#define _Rtt_RenderTargetPool_H__
+
+#include "Renderer/Rtt_Texture.h"
+
+#include <map>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+class FrameBufferObject;
+class TextureFactory;
+
+// ----------------------------------------------------------------------------
+
+// Recycles offscreen render targets (an FBO plus its texture) between users
+// that need targets of the same dimensions, format and sampler state: snapshots, texture
+// canvases, screen captures and the intermediate passes of composite effects.
+//
+// A target belongs to one user from Acquire() until Release(), so users may
+// keep rendered output in it across frames. A released target is only handed
+// out again on a later frame, after any draws queued against it this frame
+// have been issued. Contents are undefined after Acquire().
+//
+// Free targets are evicted least recently released first, once they go unused
+// for kMaxIdleFrames or the free ones exceed kMaxBytesFree, and when the
+// runtime trims memory to its budget (see TextureFactory::Trim()).
+class RenderTargetPool
+{
+	Rtt_CLASS_NO_COPIES( RenderTargetPool )
+
+	public:
+		typedef RenderTargetPool Self;
+
+		enum
+		{
+			kMaxIdleFrames = 60,
+			kMaxBytesFree = 32 * 1024 * 1024
+		};
+
+		struct Statistics
+		{
+			U32 fNumUsed;				// Number of targets held by users
+			U32 fNumFree;				// Number of targets waiting to be reused
+			size_t fBytesUsed;			// Texture bytes held by users
+			size_t fBytesFree;			// Texture bytes waiting to be reused
+			U32 fNumCreated;			// Number of targets created so far
+			U32 fNumReused;				// Number of Acquire() calls served from the pool
+		};
+
+	public:
+		RenderTargetPool( TextureFactory& owner );
+		~RenderTargetPool();
+
+	public:
+		FrameBufferObject *Acquire(
+			U32 width, U32 height,
+			Texture::Format format, Texture::Filter filter, Texture::Wrap wrap );
+		void Release( FrameBufferObject *fbo );
+
+		// Called once per rendered frame; frees targets that have gone idle
+		void BeginFrame();
+
+		// Frees free targets, least recently released first, until at least
+		// numBytes are freed or none are left. Returns the bytes freed.
+		size_t Trim( size_t numBytes );
+
+	public:
+		const Statistics& GetStatistics() const { return fStatistics; }
+
+		// Texture bytes of all targets, whether held by users or free
+		size_t GetBytesAllocated() const { return fStatistics.fBytesUsed + fStatistics.fBytesFree; }
+
+	protected:
+		struct Key
+		{
+			Key( const Texture& texture );
+			Key( U32 width, U32 height, Texture::Format format, Texture::Filter filter, Texture::Wrap wrap );
+
+			bool operator<( const Key& rhs ) const;
+
+			U32 fWidth;
+			U32 fHeight;
+			U8 fFormat;
+			U8 fFilter;
+			U8 fWrapX;
+			U8 fWrapY;
+		};
+
+		struct Entry
+		{
+			FrameBufferObject *fFBO;
+			U32 fReleaseFrame;
+			bool fIsStale;
+		};
+
+		// Free targets with equal keys are kept in release order
+		typedef std::multimap< Key, Entry > FreeList;
+
+		// Keys that targets held by users were acquired with
+		typedef std::map< const FrameBufferObject *, Key > UsedList;
+
+		void Evict( FreeList::iterator iter );
+		void Destroy( FrameBufferObject *fbo, bool isDeferred );
+
+	private:
+		TextureFactory& fOwner;
+		FreeList fFree;
+		UsedList fUsed;
+		Statistics fStatistics;
+		U32 fFrame;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_RenderTargetPool_H__
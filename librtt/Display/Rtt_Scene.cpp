@@ -53,9 +53,12 @@ Scene::Scene( Rtt_Allocator* pAllocator, Display& owner)
     fOffscreenStage( Rtt_NEW( pAllocator, StageObject( pAllocator, * this ) ) ),
     fOrphanage( Rtt_NEW( pAllocator, StageObject( pAllocator, * this ) ) ),
     fSnapshotOrphanage( Rtt_NEW( pAllocator, StageObject( pAllocator, * this ) ) ),
+    fGraveyard( Rtt_NEW( pAllocator, StageObject( pAllocator, * this ) ) ),
     fOverlay( Rtt_NEW( pAllocator, StageObject( pAllocator, * this ) ) ),
     fProxyOrphanage( owner.GetAllocator() ),
+    fStatistics(),
     fIsValid( false ),
+    fIsTeardownDeferred( false ),
     fCounter( 0 ),
     fActiveUpdatable()
 {
@@ -67,6 +70,7 @@ Scene::Scene( Rtt_Allocator* pAllocator, Display& owner)
     fOffscreenStage->SetRestricted( isRestricted );
     fOrphanage->SetRestricted( isRestricted );
     fSnapshotOrphanage->SetRestricted( isRestricted );
+    fGraveyard->SetRestricted( isRestricted );
 
 #ifdef Rtt_AUTHORING_SIMULATOR
     fOverlay->SetRestricted( isRestricted );
@@ -83,6 +87,9 @@ Scene::~Scene()
 
     Rtt_DELETE( fOrphanage );
     fOrphanage = NULL;
+
+    Rtt_DELETE( fGraveyard );
+    fGraveyard = NULL;
     
     // this order is differen than in the constructor because sometimes (TextureResourceCanvas) we want to put
     // things in offscreen stage for deleting. So we want to have it valid when deleting stage.
@@ -128,6 +135,40 @@ Scene::ForceCollect()
     fBackResourceOrphanage->Empty();
     fFrontResourceOrphanage->Empty();
     OnCollectUnreachables();
+
+    // Do not let deferred teardown hold on to resources
+    DestroyUnreachables();
+}
+
+void
+Scene::CollectOrphans( lua_State *L )
+{
+    GroupObject::CollectUnreachables( L, * this, * fOrphanage, ( fIsTeardownDeferred ? fGraveyard : NULL ) );
+}
+
+bool
+Scene::DestroyUnreachable()
+{
+    return GroupObject::DestroyLastLeaf( * fGraveyard );
+}
+
+void
+Scene::DestroyUnreachables()
+{
+    while ( GroupObject::DestroyLastLeaf( * fGraveyard ) )
+    {
+    }
+}
+
+void
+Scene::SetTeardownDeferred( bool newValue )
+{
+    fIsTeardownDeferred = newValue;
+
+    if ( ! newValue )
+    {
+        DestroyUnreachables();
+    }
 }
 
 void
@@ -138,7 +179,7 @@ Scene::OnCollectUnreachables()
     // Delete GPU resources.
     if ( fOrphanage )
     {
-        GroupObject::CollectUnreachables( L, * this, * fOrphanage );
+        CollectOrphans( L );
     }
 
     // Release native references to Lua user data.
@@ -224,6 +265,8 @@ Scene::Render( Renderer& renderer, PlatformSurface& rTarget, ProfilingEntryRAII*
 		ADD_ENTRY( "Scene: Preload" );
 		
         fOwner.GetTextureFactory().UpdateTextures(renderer);
+        fOwner.GetTextureFactory().GetRenderTargetPool().BeginFrame();
+        memset( & fStatistics, 0, sizeof( fStatistics ) );
 
 		ADD_ENTRY( "Scene: UpdateTextures" );
 		
@@ -39,6 +39,14 @@ class MUpdatable;
 // This is the top-level interface for rendering the entire DisplayObject tree.
 class Scene
 {
+	public:
+		// Counts of per-frame work skipped for offscreen objects
+		struct Statistics
+		{
+			U32 fNumDeferredTransforms;	// Offscreen objects that only had their bounds translated
+			U32 fNumSkippedPrepares;	// Dirty offscreen objects whose Prepare() was deferred
+		};
+
 	public:
 		Scene( Rtt_Allocator* pAllocator, Display& owner );
 		~Scene();
@@ -65,6 +73,22 @@ class Scene
 		// Intended to be called when the app is about to lose the OpenGL context and must delete GPU resources now.
 		void ForceCollect();
 
+		// Finalizes the orphanage's unreachable objects. If teardown is deferred,
+		// they are moved to the graveyard instead of being deleted right away.
+		void CollectOrphans( lua_State *L );
+
+		// Deletes one object from the graveyard. Returns false if it was empty.
+		bool DestroyUnreachable();
+
+		// Deletes everything in the graveyard.
+		void DestroyUnreachables();
+
+		// Number of orphaned subtrees in the graveyard still awaiting deletion.
+		S32 NumUnreachables() const { return fGraveyard->NumChildren(); }
+
+		bool IsTeardownDeferred() const { return fIsTeardownDeferred; }
+		void SetTeardownDeferred( bool newValue );
+
 	private:
 		void OnCollectUnreachables();
 
@@ -83,6 +107,11 @@ class Scene
 		void RenderOverlay( Display& display, Renderer& renderer, const Matrix& srcToDstSpace );
 		StageObject& Overlay();
 
+	public:
+		// Statistics of the frame being rendered, or of the last rendered frame
+		Statistics& GetStatistics() { return fStatistics; }
+		const Statistics& GetStatistics() const { return fStatistics; }
+
 	public:
 		StageObject* PushStage();
 		void PopStage();
@@ -100,9 +129,12 @@ class Scene
 		StageObject *fOffscreenStage;
 		StageObject *fOrphanage; // For Lua-created display objects removed from a group
 		StageObject *fSnapshotOrphanage;
+		StageObject *fGraveyard; // Unreachable objects whose deletion is deferred
 		StageObject *fOverlay;
 		LightPtrArray< LuaUserdataProxy > fProxyOrphanage;
+		Statistics fStatistics;
 		bool fIsValid;
+		bool fIsTeardownDeferred;
 		U8 fCounter; // DO NOT change type --- must be U8
 
 		// IMPORTANT: The purpose of this set is to iterate over all active
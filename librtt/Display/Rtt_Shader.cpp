@@ -13,6 +13,7 @@
 
 #include "Display/Rtt_DisplayObject.h"
 #include "Display/Rtt_Paint.h"
+#include "Display/Rtt_RenderTargetPool.h"
 #include "Display/Rtt_ShaderData.h"
 #include "Display/Rtt_ShaderResource.h"
 #include "Renderer/Rtt_RenderData.h"
@@ -47,11 +48,13 @@ Shader::Shader( Rtt_Allocator *allocator, const SharedPtr< ShaderResource >& res
 	fOwner( NULL ),
 	fFBO( NULL ),
 	fTexture( NULL ),
+	fRenderTargetPool( NULL ),
 	fRoot( NULL ),
 	fRenderData( NULL ),
 	fOutputReady( false ),
 	fDirty(false),
-    fIsDrawing( false )
+    fIsDrawing( false ),
+    fIsOutputValid( false )
 {
     Rtt_ASSERT( resource.NotNull() );
     if ( data )
@@ -69,16 +72,26 @@ Shader::Shader()
 	fOwner( NULL ),
 	fFBO( NULL ),
 	fTexture( NULL ),
+	fRenderTargetPool( NULL ),
 	fRoot( NULL ),
 	fRenderData( NULL ),
 	fOutputReady( false ),
 	fDirty(false),
-    fIsDrawing( false )
+    fIsDrawing( false ),
+    fIsOutputValid( false )
 {
 
 }
 Shader::~Shader()
 {
+    if ( fRenderTargetPool )
+    {
+        // The pool holds on to released targets until later frames
+        fRenderTargetPool->Release( fFBO );
+        fFBO = NULL;
+        fTexture = NULL;
+    }
+
     Paint *owner = GetPaint();
     if ( owner )
     {
@@ -116,12 +129,39 @@ void Shader::Log()
 void
 Shader::SetTextureBounds( const TextureInfo& textureInfo )
 {
+    if ( fTexture && fRenderTargetPool )
+    {
+        // Pooled targets follow the object's texture, so trade in a stale one
+        if ( (int)fTexture->GetWidth() != textureInfo.fWidth
+             || (int)fTexture->GetHeight() != textureInfo.fHeight
+             || fTexture->GetFormat() != textureInfo.fFormat
+             || fTexture->GetFilter() != textureInfo.fFilter )
+        {
+            fRenderTargetPool->Release( fFBO );
+            fRenderTargetPool = NULL;
+            fFBO = NULL;
+            fTexture = NULL;
+        }
+    }
+
     if ( ! fTexture )
     {
-        fTexture = Rtt_NEW( fAllocator, TextureVolatile( fAllocator, textureInfo.fWidth, textureInfo.fHeight,
-                                                        textureInfo.fFormat, textureInfo.fFilter, textureInfo.fWrap, textureInfo.fWrap ) );
-                                
-        fFBO = Rtt_NEW( fAllocator, FrameBufferObject( fAllocator, fTexture ) );
+        if ( textureInfo.fPool )
+        {
+            fRenderTargetPool = textureInfo.fPool;
+            fFBO = fRenderTargetPool->Acquire( textureInfo.fWidth, textureInfo.fHeight,
+                                               textureInfo.fFormat, textureInfo.fFilter, textureInfo.fWrap );
+            fTexture = fFBO->GetTexture();
+        }
+        else
+        {
+            fTexture = Rtt_NEW( fAllocator, TextureVolatile( fAllocator, textureInfo.fWidth, textureInfo.fHeight,
+                                                            textureInfo.fFormat, textureInfo.fFilter, textureInfo.fWrap, textureInfo.fWrap ) );
+
+            fFBO = Rtt_NEW( fAllocator, FrameBufferObject( fAllocator, fTexture ) );
+        }
+
+        fIsOutputValid = false;
     }
 }
 Texture *
@@ -152,6 +192,16 @@ Shader::RenderToTexture( Renderer& renderer, Geometry& cache ) const
 	//if ( fDirty )
 	if ( fTexture )
 	{
+		// Skip the pass if its output is still what it would render
+		OutputKey key;
+		GetOutputKey( key );
+
+		if ( fIsOutputValid && 0 == memcmp( & key, & fOutputKey, sizeof( OutputKey ) ) )
+		{
+			renderer.TallyEffectPass( true );
+			return;
+		}
+
 		// ????: (optionally???) Copy geometry
 		
 		// Save current state so we can restore it later
@@ -235,10 +285,56 @@ Shader::RenderToTexture( Renderer& renderer, Geometry& cache ) const
         renderer.SetFrustum( viewMatrix, projMatrix );
         
         renderer.SetFrameBufferObject( fbo );
+
+        // Binding fFBO above bumped the output's version, so take it now
+        fOutputKey = key;
+        fOutputKey.fOutputVersion = fTexture->GetVersion();
+        fIsOutputValid = IsOutputCacheable();
+
+        renderer.TallyTimeDependency( fResource->UsesTime() );
+        renderer.TallyEffectPass( false );
         
         //fDirty = true;
     }
 }
+
+bool
+Shader::IsOutputCacheable() const
+{
+    // Time-dependent kernels change every frame, and effects with native
+    // callbacks may change their extra space without telling us
+    if ( fResource->UsesTime() || fResource->GetEffectCallbacks() )
+    {
+        return false;
+    }
+
+    // Video frames arrive without a version bump
+    const Texture *inputs[] = { fRenderData->fFillTexture0, fRenderData->fFillTexture1 };
+    for ( int i = 0; i < 2; i++ )
+    {
+        if ( inputs[i] && CPUResource::kVideoTexture == inputs[i]->GetType() )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void
+Shader::GetOutputKey( OutputKey& key ) const
+{
+    memset( & key, 0, sizeof( key ) );
+
+    key.fInput0 = fRenderData->fFillTexture0;
+    key.fInput1 = fRenderData->fFillTexture1;
+    key.fInputVersion0 = key.fInput0 ? key.fInput0->GetVersion() : 0;
+    key.fInputVersion1 = key.fInput1 ? key.fInput1->GetVersion() : 0;
+    key.fDataVersion = fData ? fData->GetVersion() : 0;
+
+    // A lost GPU resource (e.g. after a context loss) takes the output with it
+    key.fOutputVersion = fTexture->GetGPUResource() ? fTexture->GetVersion() : U32( -1 );
+}
 void
 Shader::UpdatePaint( RenderData& data ) const
 {
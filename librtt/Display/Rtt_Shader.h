@@ -26,6 +26,8 @@ struct CoronaShaderDrawParams;
 namespace Rtt
 {
 
+class RenderTargetPool;
+
 struct TextureInfo
 {
     int fWidth;
@@ -33,6 +35,7 @@ struct TextureInfo
     Texture::Format fFormat;
     Texture::Filter fFilter;
     Texture::Wrap fWrap;
+    RenderTargetPool *fPool; // Source of intermediate targets (NULL if none)
 };
 
 class FrameBufferObject;
@@ -124,6 +127,22 @@ class Shader
 
     public:
         bool IsCompatible( const Geometry* geometry );
+
+    protected:
+        // What an intermediate pass last rendered from. If none of it has
+        // changed, the output in fTexture is still current.
+        struct OutputKey
+        {
+            const Texture *fInput0;
+            const Texture *fInput1;
+            U32 fInputVersion0;
+            U32 fInputVersion1;
+            U32 fDataVersion;
+            U32 fOutputVersion;
+        };
+
+        bool IsOutputCacheable() const;
+        void GetOutputKey( OutputKey& key ) const;
     
     protected:
         SharedPtr< ShaderResource > fResource;
@@ -133,6 +152,7 @@ class Shader
         Paint *fOwner; // weak ptr
         FrameBufferObject *fFBO;
         Texture *fTexture;
+        RenderTargetPool *fRenderTargetPool; // Weak; non-NULL if fFBO came from it
         const Shader *fRoot; // Weak reference
         
         
@@ -141,6 +161,8 @@ class Shader
         mutable bool fOutputReady;
         mutable bool fDirty;
         mutable bool fIsDrawing;
+        mutable OutputKey fOutputKey;
+        mutable bool fIsOutputValid;
 
     // TODO: Figure out better alternative
     friend class ShaderComposite;
@@ -12,7 +12,10 @@
 #include "Display/Rtt_Shader.h"
 
 #include "Display/Rtt_Paint.h"
+#include "Display/Rtt_Display.h"
 #include "Display/Rtt_DisplayObject.h"
+#include "Display/Rtt_StageObject.h"
+#include "Display/Rtt_TextureFactory.h"
 #include "Renderer/Rtt_RenderData.h"
 #include "Renderer/Rtt_Program.h"
 #include "Display/Rtt_ShaderComposite.h"
@@ -255,6 +258,18 @@ ShaderComposite::UpdateGeometry(const TextureInfo& textureInfo)
 
 }
 
+// Intermediate targets come from the display's pool when the paint is on a
+// stage. Otherwise (e.g. emitters) each node keeps a target of its own.
+RenderTargetPool *
+ShaderComposite::GetRenderTargetPool() const
+{
+	Paint *paint = GetPaint();
+	DisplayObject *observer = ( paint ? paint->GetObserver() : NULL );
+	StageObject *stage = ( observer ? observer->GetStage() : NULL );
+
+	return ( stage ? & stage->GetDisplay().GetTextureFactory().GetRenderTargetPool() : NULL );
+}
+
 // public: ShapeObject calls this.
 void
 ShaderComposite::Prepare( RenderData& objectData, int w, int h, ShaderResource::ProgramMod mod )
@@ -273,6 +288,7 @@ ShaderComposite::Prepare( RenderData& objectData, int w, int h, ShaderResource::
 		textureInfo.fFormat = objectTexture->GetFormat();
 		textureInfo.fFilter = objectTexture->GetFilter();
 		textureInfo.fWrap = Texture::kClampToEdge;
+		textureInfo.fPool = GetRenderTargetPool();
 
 		// To avoid cache w,h, just pass it in here.
 		UpdateGeometry(textureInfo); // Optional for single node case
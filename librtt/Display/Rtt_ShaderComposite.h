@@ -51,6 +51,7 @@ class ShaderComposite : public Shader
 		virtual void RenderToTexture( Renderer& renderer, Geometry& cache ) const;
 		Geometry& GetGeometry() const { return * fGeometry; }
 		void UpdateGeometry( const TextureInfo& textureInfo);
+		RenderTargetPool *GetRenderTargetPool() const;
 		
 	public:
 		virtual void Prepare( RenderData& objectData, int w, int h, ShaderResource::ProgramMod mod );
@@ -35,7 +35,8 @@ ShaderData::ShaderData( const WeakPtr< ShaderResource >& resource )
 	fShaderResource( resource ),
     fExtraSpace( NULL ),
     fExtraCount( 0U ),
-	fOwner( NULL )
+	fOwner( NULL ),
+	fVersion( 0 )
 {
 	memset( fVertexData, 0, sizeof( fVertexData ) );
 	memset( fUniformData, 0, sizeof( fUniformData ) );
@@ -141,6 +142,8 @@ ShaderData::InitializeUniform(
 		fUniformData[index] = result;
 	}
 
+	++fVersion;
+
 	Paint *paint = GetPaint();
 	if ( paint )
 	{
@@ -204,6 +207,7 @@ ShaderData::SetVertexData( DataIndex index, Real newValue )
 	Rtt_ASSERT( index < kNumData ); // Verify bounds
 
 	fVertexData[index] = newValue;
+	++fVersion;
 	
 	Paint *paint = GetPaint();
 	if ( paint )
@@ -338,6 +342,8 @@ ShaderData::DidUpdateUniform( DataIndex index )
 void
 ShaderData::Invalidate()
 {
+    ++fVersion;
+
     Paint *paint = GetPaint();
     if ( paint )
     {
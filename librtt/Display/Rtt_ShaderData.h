@@ -89,6 +89,7 @@ class ShaderData
 		void DidUpdateUniform( DataIndex index );
         void Invalidate();
         void * GetExtraSpace() const { return fExtraSpace; }
+        U32 GetVersion() const { return fVersion; } // Changes whenever params change
         U32 GetExtraCount() const { return fExtraCount; }
 
 	public:
@@ -108,6 +109,7 @@ class ShaderData
         void * fExtraSpace;
         U32 fExtraCount;
 		const Shader *fOwner;
+		U32 fVersion;
 		U8 fDirtyFlags;
 };
 
@@ -13,10 +13,13 @@
 
 #include "Core/Rtt_StringHash.h"
 #include "Display/Rtt_DisplayTypes.h"
+#include "Display/Rtt_ShapeObject.h"
 #include "Display/Rtt_ShapePath.h"
 #include "Display/Rtt_TesselatorPolygon.h"
 #include "Rtt_Lua.h"
 #include "Rtt_LuaContext.h"
+#include "Rtt_LuaUserdataProxy.h"
+#include "CoronaLua.h"
 
 // ----------------------------------------------------------------------------
 
@@ -32,9 +35,35 @@ ShapeAdapterPolygon::Constant()
 	return sAdapter;
 }
 
+// Appends the vertices of the outline at 'index' to the contour
+static void
+AppendOutline( lua_State *L, int index, ArrayVertex2& contour, Rect& bounds, bool hasZ )
+{
+	int componentCount = hasZ ? 3 : 2;
+	int numVertices = (int) lua_objlen( L, index ) / componentCount;
+
+	contour.Reserve( contour.Length() + numVertices );
+
+	for ( int i = 0; i < numVertices; i++ )
+	{
+		// Lua is one-based, so the first element must be at index 1.
+		lua_rawgeti( L, index, ( ( i * componentCount ) + 1 ) );
+
+		// Lua is one-based, so the second element must be at index 2.
+		lua_rawgeti( L, index, ( ( i * componentCount ) + 2 ) );
+
+		Vertex2 v = { luaL_toreal( L, -2 ),
+						luaL_toreal( L, -1 ) };
+		lua_pop( L, 2 );
+
+		contour.Append( v );
+		bounds.Union( v );
+	}
+}
+
 bool
 ShapeAdapterPolygon::InitializeContour(
-	lua_State *L, int index, TesselatorPolygon& tesselator, bool hasZ )
+	lua_State *L, int index, TesselatorPolygon& tesselator, bool hasZ, int holesIndex )
 {
 	bool result = false;
 
@@ -47,35 +76,40 @@ ShapeAdapterPolygon::InitializeContour(
 		// This is used to find the center of the body.
 		Rect bounds;
 
-        int componentCount = hasZ ? 3 : 2;
-        int numVertices = (int) lua_objlen( L, index ) / componentCount;
-        
-		for ( int i = 0; i < numVertices; i++ )
-		{
-			// Lua is one-based, so the first element must be at index 1.
-            lua_rawgeti( L, index, ( ( i * componentCount ) + 1 ) );
-
-			// Lua is one-based, so the second element must be at index 2.
-            lua_rawgeti( L, index, ( ( i * componentCount ) + 2 ) );
-
-			Vertex2 v = { luaL_toreal( L, -2 ),
-							luaL_toreal( L, -1 ) };
-			lua_pop( L, 2 );
+		AppendOutline( L, index, contour, bounds, hasZ );
 
-			contour.Append( v );
-			bounds.Union( v );
+		if ( holesIndex > 0 && lua_istable( L, holesIndex ) )
+		{
+			// Holes never extend the bounds, so they don't move the center
+			Rect holeBounds;
+			ArrayS32& holes = tesselator.GetHoles();
+			for ( int i = 1, iMax = (int) lua_objlen( L, holesIndex ); i <= iMax; i++ )
+			{
+				lua_rawgeti( L, holesIndex, i );
+				if ( lua_istable( L, -1 ) )
+				{
+					S32 start = contour.Length();
+					AppendOutline( L, lua_gettop( L ), contour, holeBounds, hasZ );
+					if ( contour.Length() > start )
+					{
+						holes.Append( start );
+					}
+				}
+				lua_pop( L, 1 );
+			}
 		}
 
 		Vertex2 center_offset;
 		bounds.GetCenter( center_offset );
 
 		// Offset the contour to center the body around its center of mass.
-		for ( int i = 0; i < numVertices; i++ )
+		for ( int i = 0, iMax = contour.Length(); i < iMax; i++ )
 		{
 			contour[ i ].x -= center_offset.x;
 			contour[ i ].y -= center_offset.y;
 		}
 
+		tesselator.SetVertexOffset( center_offset );
 		tesselator.Invalidate();
 		result = true;
 	}
@@ -95,14 +129,13 @@ ShapeAdapterPolygon::GetHash( lua_State *L ) const
 {
 	static const char *keys[] = 
 	{
-		"",
+		"setVertex",	// 0
+		"getVertex",	// 1
 	};
-	static StringHash sHash( *LuaContext::GetAllocator( L ), keys, sizeof( keys ) / sizeof( const char * ), 1, 0, 0, __FILE__, __LINE__ );
+	static StringHash sHash( *LuaContext::GetAllocator( L ), keys, sizeof( keys ) / sizeof( const char * ), 2, 0, 1, __FILE__, __LINE__ );
 	return &sHash;
 }
 
-// No properties (except inherited ones), so disabling for now.
-#if 0
 int
 ShapeAdapterPolygon::ValueForKey(
 	const LuaUserdataProxy& sender,
@@ -125,45 +158,107 @@ ShapeAdapterPolygon::ValueForKey(
 	int index = GetHash( L )->Lookup( key );
 	switch ( index )
 	{
+		case 0:
+			Lua::PushCachedFunction( L, setVertex );
+			break;
+		case 1:
+			Lua::PushCachedFunction( L, getVertex );
+			break;
 		default:
-			result = 0; // No Lua values pushed
+			result = Super::ValueForKey( sender, L, key );
 			break;
 	}
 
 	return result;
 }
 
-bool
-ShapeAdapterPolygon::SetValueForKey(
-	LuaUserdataProxy& sender,
-	lua_State *L,
-	const char *key,
-	int valueIndex ) const
+// path:setVertex( index, x, y )
+// Moves a point of the outline (holes follow the outer points). Only the
+// fill is regenerated; the triangulation is reused, so points should not
+// be moved across other edges.
+int
+ShapeAdapterPolygon::setVertex( lua_State *L )
 {
-	bool result = false;
+	int result = 0;
+	int nextArg = 1;
+	LuaUserdataProxy* sender = LuaUserdataProxy::ToProxy( L, nextArg++ );
+	if ( ! sender ) { return result; }
 
-	Rtt_ASSERT( key ); // Caller should check at the top-most level
+	ShapePath *path = (ShapePath *)sender->GetUserdata();
+	if ( ! path ) { return result; }
 
-	ShapePath *path = (ShapePath *)sender.GetUserdata();
+	TesselatorPolygon *tesselator =
+		static_cast< TesselatorPolygon * >( path->GetTesselator() );
+	if ( ! tesselator ) { return result; }
+
+	int vertIndex = luaL_checkint( L, nextArg++ ) - 1;
+	Real x = luaL_checkreal( L, nextArg++ );
+	Real y = luaL_checkreal( L, nextArg++ );
+
+	ArrayVertex2& contour = tesselator->GetContour();
+	if ( vertIndex >= contour.Length() || vertIndex < 0 )
+	{
+		luaL_argerror( L, 2, "index is out of bounds" );
+	}
+
+	const Vertex2& offset = tesselator->GetVertexOffset();
+	x -= offset.x;
+	y -= offset.y;
+
+	Vertex2& orig = contour[vertIndex];
+	if ( ! Rtt_RealEqual( x, orig.x ) || ! Rtt_RealEqual( y, orig.y ) )
+	{
+		orig.x = x;
+		orig.y = y;
+
+		tesselator->InvalidatePositions();
+
+		path->Invalidate( ClosedPath::kFillSource |
+						 ClosedPath::kFillSourceTexture |
+						 ClosedPath::kStrokeSource );
+
+		path->GetObserver()->Invalidate( DisplayObject::kGeometryFlag |
+										DisplayObject::kStageBoundsFlag |
+										DisplayObject::kTransformFlag );
+	}
+
+	return result;
+}
+
+// path:getVertex( index )
+int
+ShapeAdapterPolygon::getVertex( lua_State *L )
+{
+	int result = 0;
+	int nextArg = 1;
+	LuaUserdataProxy* sender = LuaUserdataProxy::ToProxy( L, nextArg++ );
+	if ( ! sender ) { return result; }
+
+	ShapePath *path = (ShapePath *)sender->GetUserdata();
 	if ( ! path ) { return result; }
 
 	TesselatorPolygon *tesselator =
 		static_cast< TesselatorPolygon * >( path->GetTesselator() );
 	if ( ! tesselator ) { return result; }
 
-	result = true; // Assume value will be set
+	int vertIndex = luaL_checkint( L, nextArg++ ) - 1;
 
-	int index = GetHash( L )->Lookup( key );
-	switch ( index )
+	const ArrayVertex2& contour = tesselator->GetContour();
+	if ( vertIndex >= contour.Length() || vertIndex < 0 )
 	{
-		default:
-			result = false; // No value set
-			break;
+		CoronaLuaWarning( L, "path:getVertex() index is out of bounds" );
+	}
+	else
+	{
+		const Vertex2& vert = contour[vertIndex];
+		const Vertex2& offset = tesselator->GetVertexOffset();
+		lua_pushnumber( L, vert.x + offset.x );
+		lua_pushnumber( L, vert.y + offset.y );
+		result = 2;
 	}
 
 	return result;
 }
-#endif
 
 // ----------------------------------------------------------------------------
 
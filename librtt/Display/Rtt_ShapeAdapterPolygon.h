@@ -29,28 +29,25 @@ class ShapeAdapterPolygon : public ShapeAdapter
 	public:
 		static const ShapeAdapterPolygon& Constant();
 
+		// 'holesIndex' is an optional array of hole outlines, each in the
+		// same format as the outline at 'index' (0 for none)
 		static bool InitializeContour(
-			lua_State *L, int index, TesselatorPolygon& tesselator, bool hasZ );
+			lua_State *L, int index, TesselatorPolygon& tesselator, bool hasZ, int holesIndex = 0 );
 
 	protected:
 		ShapeAdapterPolygon();
 
 	public:
-// No properties (except inherited ones), so disabling for now.
-#if 0
 		virtual int ValueForKey(
 			const LuaUserdataProxy& sender,
 			lua_State *L,
 			const char *key ) const;
 
-		virtual bool SetValueForKey(
-			LuaUserdataProxy& sender,
-			lua_State *L,
-			const char *key,
-			int valueIndex ) const;
-#endif
+		virtual StringHash *GetHash( lua_State *L ) const;
 
-        virtual StringHash *GetHash( lua_State *L ) const;
+	protected:
+		static int setVertex( lua_State *L );
+		static int getVertex( lua_State *L );
 };
 
 // ----------------------------------------------------------------------------
@@ -15,11 +15,13 @@
 #include "Display/Rtt_ImageSheetPaint.h"
 #include "Display/Rtt_ClosedPath.h"
 #include "Display/Rtt_Display.h"
+#include "Display/Rtt_DisplayDefaults.h"
 #include "Display/Rtt_Paint.h"
 #include "Display/Rtt_Shader.h"
 #include "Display/Rtt_ShaderFactory.h"
 #include "Rtt_LuaProxyVTable.h"
 
+#include "Renderer/Rtt_Geometry_Renderer.h"
 #include "Renderer/Rtt_Renderer.h"
 
 #include "Display/Rtt_BitmapMask.h"
@@ -42,7 +44,8 @@ ShapeObject::ShapeObject( ClosedPath* path )
 	fStrokeData(),
 	fPath( path ),
 	fFillShader( NULL ),
-	fStrokeShader( NULL )
+	fStrokeShader( NULL ),
+	fIsTransformedOnGPU( false )
 {
 	Rtt_ASSERT( fPath );
 
@@ -63,7 +66,8 @@ ShapeObject::UpdateTransform( const Matrix& parentToDstSpace )
 
 	SUMMED_TIMING( sut, "ShapeObject: post-Super::UpdateTransform" );
 
-	if ( shouldUpdate )
+	// Local-space vertices do not depend on the transform
+	if ( shouldUpdate && ! fIsTransformedOnGPU )
 	{
 		fPath->Invalidate( ClosedPath::kFill | ClosedPath::kStroke );
 	}
@@ -83,6 +87,15 @@ ShapeObject::Prepare( const Display& display )
 		// Vertices
 		Rtt_ASSERT( fPath );
 
+		bool isTransformedOnGPU = ShouldTransformOnGPU( display );
+		if ( isTransformedOnGPU != fIsTransformedOnGPU )
+		{
+			// Rewrite the vertices in the other space
+			fIsTransformedOnGPU = isTransformedOnGPU;
+			fPath->Invalidate( ClosedPath::kFill | ClosedPath::kStroke );
+			Invalidate( kGeometryFlag );
+		}
+
 		fPath->SetStrokeData( & fStrokeData );
 		{
 			// NOTE: We need to update paint *prior* to geometry
@@ -96,7 +109,8 @@ ShapeObject::Prepare( const Display& display )
 
 			if ( ! IsValid( kGeometryFlag ) )
 			{
-				const Matrix& xform = GetSrcToDstMatrix();
+				Matrix identity;
+				const Matrix& xform = ( fIsTransformedOnGPU ? identity : GetSrcToDstMatrix() );
 				fPath->Update( fFillData, xform );
 				SetValid( kGeometryFlag );
 			}
@@ -166,6 +180,13 @@ ShapeObject::Draw( Renderer& renderer ) const
 
 		fPath->UpdateResources( renderer );
 
+		Real viewMatrix[16];
+		Real projMatrix[16];
+		if ( fIsTransformedOnGPU )
+		{
+			PushSrcToDstFrustum( renderer, viewMatrix, projMatrix );
+		}
+
 		if ( fPath->IsFillVisible() )
 		{
 			fFillShader->Draw( renderer, fFillData );
@@ -175,6 +196,11 @@ ShapeObject::Draw( Renderer& renderer ) const
 		{
 			fStrokeShader->Draw( renderer, fStrokeData );
 		}
+
+		if ( fIsTransformedOnGPU )
+		{
+			renderer.SetFrustum( viewMatrix, projMatrix );
+		}
 	}
 	
 }
@@ -218,6 +244,18 @@ ShapeObject::HitTest( Real contentX, Real contentY )
 	Rtt_ASSERT( ShouldHitTest() );
 
 	bool result = false;
+
+	if ( fIsTransformedOnGPU )
+	{
+		// Geometry is in local space, so test the point in local space
+		Matrix inverse;
+		Matrix::Invert( GetSrcToDstMatrix(), inverse );
+
+		Vertex2 p = { contentX, contentY };
+		inverse.Apply( p );
+		contentX = p.x;
+		contentY = p.y;
+	}
 	
 	if ( fPath->HasFill()
 		 && ( fPath->IsFillVisible() || IsHitTestable() ) )
@@ -249,6 +287,54 @@ ShapeObject::DidUpdateTransform( Matrix& srcToDst )
 	}
 }
 
+bool
+ShapeObject::ShouldTransformOnGPU( const Display& display ) const
+{
+	U32 minVertices = display.GetDefaults().GetGPUTransformMinVertices();
+	if ( 0 == minVertices || ! CanTransformOnGPU() )
+	{
+		return false;
+	}
+
+	// Only pays off when re-transforming the vertices costs more than
+	// the draw call that a per-object view matrix forces
+	U32 numVertices = 0;
+	if ( fFillData.fGeometry )
+	{
+		numVertices += fFillData.fGeometry->GetVerticesUsed();
+	}
+	if ( fStrokeData.fGeometry )
+	{
+		numVertices += fStrokeData.fGeometry->GetVerticesUsed();
+	}
+	if ( numVertices < minVertices )
+	{
+		return false;
+	}
+
+	// Effects (vertex kernels) and masks work on content-space
+	// positions in the shader, so they need CPU-transformed vertices
+	ShaderFactory& factory = display.GetShaderFactory();
+	const Shader *defaultShader = & factory.GetDefault();
+	const Shader *defaultColorShader = & factory.GetDefaultColorShader();
+
+	const Paint *paints[] = { fPath->GetFill(), fPath->GetStroke() };
+	for ( int i = 0; i < 2; i++ )
+	{
+		const Paint *paint = paints[i];
+		if ( paint )
+		{
+			const Shader *shader = paint->GetShader( factory );
+			if ( shader != defaultShader && shader != defaultColorShader )
+			{
+				return false;
+			}
+		}
+	}
+
+	return ! IsMaskedInHierarchy();
+}
+
 ShaderResource::ProgramMod
 ShapeObject::GetProgramMod() const
 {
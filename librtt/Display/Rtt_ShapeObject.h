@@ -67,6 +67,12 @@ class ShapeObject : public DisplayObject
 		const RenderData& GetFillData() const { return fFillData; }
 		const Shader* GetFillShader() const { return fFillShader; }
 
+		// Subclasses that read back their vertices in content space
+		// must keep their geometry transformed on the CPU.
+		virtual bool CanTransformOnGPU() const { return true; }
+		bool ShouldTransformOnGPU( const Display& display ) const;
+		bool IsTransformedOnGPU() const { return fIsTransformedOnGPU; }
+
 	public:
 		const ClosedPath& GetPath() const { return *fPath; }
 		ClosedPath& GetPath() { return *fPath; }
@@ -98,6 +104,10 @@ class ShapeObject : public DisplayObject
 		const Shader *fFillShader; // Temporary
 		const Shader *fStrokeShader; // Temporary
 
+		// When true, geometry stays in local space and the renderer
+		// applies the object's transform via the view matrix
+		bool fIsTransformedOnGPU;
+
 //		mutable LuaUserdataProxy *fProxy;
 };
 
@@ -142,7 +142,7 @@ SnapshotObject::SnapshotObject(
 
 SnapshotObject::~SnapshotObject()
 {
-	QueueRelease( fFrameBufferObject );
+	// fFrameBufferObject goes back to the pool with the fill's texture resource
 
 	Rtt_DELETE( fCanvas );
 	Rtt_DELETE( fGroup );
@@ -184,13 +184,14 @@ SnapshotObject::Initialize( lua_State *L, Display& display, Real contentW, Real
 
 	// TODO: Support minFilter and both wrapX/Y.
 	// We're cheating right now.
-	SharedPtr< TextureResource > resource = factory.Create(
+	// The target is recycled through the factory's RenderTargetPool, so
+	// transient snapshots do not create a new FBO each time.
+	SharedPtr< TextureResource > resource = factory.CreateRenderTarget(
 		pixelW,
 		pixelH,
 		Texture::kRGBA,
 		RenderTypes::Convert( magFilter ),
-		RenderTypes::Convert( wrap ),
-		false );
+		RenderTypes::Convert( wrap ) );
 
 	// Set texture to be "retina" which ensures that the Renderer passes
 	// correct scale factors to the shader
@@ -200,28 +201,21 @@ SnapshotObject::Initialize( lua_State *L, Display& display, Real contentW, Real
 	SetFill( paint );
 
 	// Prevent 'paint' from being replaced by a different paint
-	// Also, the FBO instance holds a reference to the Texture instance
-	// that's inside 'paint', so both FBO and paint should be destroyed
-	// at the same time.
+	// Also, the FBO instance belongs to the texture resource inside 'paint',
+	// so both FBO and paint should be destroyed at the same time.
 	GetPath().SetFillLocked( true );
 
-
-	if (!fFrameBufferObject)
-	{
-		FrameBufferObject::ExtraOptions opts = {};
-		/* TODO
-			fHasDepth = display.GetDefaults().GetAddDepthToResource();
-			fHasStencil = display.GetDefaults().GetAddStencilToResource();
-			fDepthClearValue = display.GetDefaults().GetAddedDepthClearValue();
-			fStencilClearValue = display.GetDefaults().GetAddedStencilClearValue();
-		 
-			TODO:
-				if (opts.depthBits) add appropriate frame buffer resources...
-				if (opts.stencilBits) ditto
-		 */
-
-		fFrameBufferObject = Rtt_NEW( display.GetAllocator(), FrameBufferObject( display.GetAllocator(), & resource->GetTexture(), &opts ) ); // n.b. mustClear = false
-	}
+	/* TODO
+		fHasDepth = display.GetDefaults().GetAddDepthToResource();
+		fHasStencil = display.GetDefaults().GetAddStencilToResource();
+		fDepthClearValue = display.GetDefaults().GetAddedDepthClearValue();
+		fStencilClearValue = display.GetDefaults().GetAddedStencilClearValue();
+	 
+		TODO:
+			if (opts.depthBits) add appropriate frame buffer resources...
+			if (opts.stencilBits) ditto
+	 */
+	fFrameBufferObject = resource->GetRenderTarget();
 }
 
 bool
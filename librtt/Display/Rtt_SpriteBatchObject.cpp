@@ -0,0 +1,438 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Display/Rtt_SpriteBatchObject.h"
+
+#include "Display/Rtt_Display.h"
+#include "Display/Rtt_ImageFrame.h"
+#include "Display/Rtt_Shader.h"
+#include "Display/Rtt_ShaderFactory.h"
+#include "Display/Rtt_TextureResource.h"
+#include "Renderer/Rtt_Geometry_Renderer.h"
+#include "Renderer/Rtt_Renderer.h"
+#include "Renderer/Rtt_VertexKernels.h"
+#include "Rtt_LuaProxyVTable.h"
+#include "Rtt_Matrix.h"
+#include "Rtt_Profiling.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+namespace // anonymous
+{
+
+// Corners of an instance's quad in the batch's local space, in the order
+// top-left, top-right, bottom-left, bottom-right
+void
+GetInstanceQuad( const SpriteBatchObject::Instance& instance, const ImageFrame& frame, Vertex2 quad[4] )
+{
+	Real halfW = Rtt_RealDiv2( Rtt_IntToReal( frame.GetWidth() ) );
+	Real halfH = Rtt_RealDiv2( Rtt_IntToReal( frame.GetHeight() ) );
+	Real offsetX = ( frame.IsTrimmed() ? frame.GetOffsetX() : Rtt_REAL_0 );
+	Real offsetY = ( frame.IsTrimmed() ? frame.GetOffsetY() : Rtt_REAL_0 );
+
+	Real angle = Rtt_RealDegreesToRadians( instance.fRotation );
+	Real c = Rtt_RealCos( angle );
+	Real s = Rtt_RealSin( angle );
+
+	const Real xs[] = { offsetX - halfW, offsetX + halfW };
+	const Real ys[] = { offsetY - halfH, offsetY + halfH };
+
+	for ( int i = 0; i < 4; i++ )
+	{
+		Real x = Rtt_RealMul( xs[i & 1], instance.fXScale );
+		Real y = Rtt_RealMul( ys[i >> 1], instance.fYScale );
+
+		quad[i].x = instance.fX + Rtt_RealMul( c, x ) - Rtt_RealMul( s, y );
+		quad[i].y = instance.fY + Rtt_RealMul( s, x ) + Rtt_RealMul( c, y );
+	}
+}
+
+// Vertex order of the two triangles of an instance, as quad corner indices
+const int kTriangleCorners[SpriteBatchObject::kVerticesPerInstance] = { 0, 1, 2, 2, 1, 3 };
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+SpriteBatchObject::SpriteBatchObject( Rtt_Allocator *pAllocator, const AutoPtr< ImageSheet >& sheet, U32 capacity )
+:	Super(),
+	fSheet( sheet ),
+	fInstances( pAllocator ),
+	fCapacity( capacity ),
+	fDirtyStart( 0 ),
+	fDirtyEnd( 0 ),
+	fSelfBounds(),
+	fIsSelfBoundsValid( true ),
+	fData(),
+	fShader( NULL )
+{
+	fInstances.Reserve( capacity );
+
+	SetObjectDesc( "SpriteBatchObject" ); // for introspection
+}
+
+SpriteBatchObject::~SpriteBatchObject()
+{
+	if ( fData.fGeometry )
+	{
+		QueueRelease( fData.fGeometry );
+	}
+}
+
+void
+SpriteBatchObject::Initialize( Display& display )
+{
+	Rtt_Allocator *allocator = display.GetAllocator();
+
+	fData.fGeometry = Rtt_NEW( allocator, Geometry( allocator, Geometry::kTriangles, 0, 0, false ) );
+	fData.fGeometry->Resize( fCapacity * kVerticesPerInstance, false );
+	fData.fGeometry->SetVerticesUsed( 0 );
+
+	fData.fFillTexture0 = & fSheet->GetTextureResource()->GetTexture();
+
+	fShader = & display.GetShaderFactory().GetDefault();
+}
+
+void
+SpriteBatchObject::Prepare( const Display& display )
+{
+	Super::Prepare( display );
+
+	SUMMED_TIMING( sbp, "SpriteBatchObject: post-Super::Prepare" );
+
+	if ( ShouldPrepare() )
+	{
+		U32 numInstances = GetNumInstances();
+
+		// Only instances that changed are rewritten. The batch's own
+		// transform is applied in Draw(), so it never dirties vertices.
+		if ( fDirtyStart < fDirtyEnd )
+		{
+			UpdateVertices( fDirtyStart, fDirtyEnd );
+
+			if ( IsValid( kColorFlag ) )
+			{
+				UpdateColors( fDirtyStart, fDirtyEnd );
+			}
+		}
+
+		fDirtyStart = fDirtyEnd = numInstances;
+		fData.fGeometry->SetVerticesUsed( numInstances * kVerticesPerInstance );
+
+		if ( ! IsValid( kColorFlag ) )
+		{
+			UpdateColors( 0, numInstances );
+		}
+
+		if ( ! IsValid( kProgramFlag ) )
+		{
+			fShader->Prepare( fData, 0, 0, ShaderResource::kDefault );
+		}
+
+		SetValid( kGeometryFlag | kPaintFlag | kColorFlag | kProgramFlag | kProgramDataFlag );
+	}
+}
+
+void
+SpriteBatchObject::Draw( Renderer& renderer ) const
+{
+	if ( ShouldDraw() && GetNumInstances() > 0 )
+	{
+		SUMMED_TIMING( sbd, "SpriteBatchObject: Draw" );
+
+		Real viewMatrix[16];
+		Real projMatrix[16];
+		PushSrcToDstFrustum( renderer, viewMatrix, projMatrix );
+
+		fShader->Draw( renderer, fData );
+
+		renderer.SetFrustum( viewMatrix, projMatrix );
+	}
+}
+
+void
+SpriteBatchObject::GetSelfBounds( Rect& rect ) const
+{
+	if ( ! fIsSelfBoundsValid )
+	{
+		fSelfBounds.SetEmpty();
+
+		Vertex2 quad[4];
+		for ( U32 i = 0, iMax = GetNumInstances(); i < iMax; i++ )
+		{
+			const Instance& instance = fInstances[i];
+			GetInstanceQuad( instance, * fSheet->GetFrame( instance.fFrame ), quad );
+
+			for ( int j = 0; j < 4; j++ )
+			{
+				fSelfBounds.Union( quad[j] );
+			}
+		}
+
+		fIsSelfBoundsValid = true;
+	}
+
+	rect = fSelfBounds;
+}
+
+bool
+SpriteBatchObject::HitTest( Real contentX, Real contentY )
+{
+	Matrix inverse;
+	Matrix::Invert( GetSrcToDstMatrix(), inverse );
+
+	Vertex2 p = { contentX, contentY };
+	inverse.Apply( p );
+
+	Rect bounds;
+	GetSelfBounds( bounds );
+	if ( ! bounds.HitTest( p.x, p.y ) )
+	{
+		return false;
+	}
+
+	// Later instances are drawn on top, so test them first
+	for ( U32 i = GetNumInstances(); i-- > 0; )
+	{
+		const Instance& instance = fInstances[i];
+		if ( Rtt_RealIsZero( instance.fXScale ) || Rtt_RealIsZero( instance.fYScale ) )
+		{
+			continue;
+		}
+
+		// Map the point into the instance's unrotated, unscaled frame
+		Real angle = Rtt_RealDegreesToRadians( instance.fRotation );
+		Real c = Rtt_RealCos( angle );
+		Real s = Rtt_RealSin( angle );
+		Real dx = p.x - instance.fX;
+		Real dy = p.y - instance.fY;
+		Real x = Rtt_RealDiv( Rtt_RealMul( c, dx ) + Rtt_RealMul( s, dy ), instance.fXScale );
+		Real y = Rtt_RealDiv( Rtt_RealMul( c, dy ) - Rtt_RealMul( s, dx ), instance.fYScale );
+
+		const ImageFrame& frame = * fSheet->GetFrame( instance.fFrame );
+		Real halfW = Rtt_RealDiv2( Rtt_IntToReal( frame.GetWidth() ) );
+		Real halfH = Rtt_RealDiv2( Rtt_IntToReal( frame.GetHeight() ) );
+		if ( frame.IsTrimmed() )
+		{
+			x -= frame.GetOffsetX();
+			y -= frame.GetOffsetY();
+		}
+
+		if ( x >= -halfW && x <= halfW && y >= -halfH && y <= halfH )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool
+SpriteBatchObject::ShouldOffsetWithAnchor() const
+{
+	// Like groups, instance positions are relative to the batch's origin
+	return false;
+}
+
+const LuaProxyVTable&
+SpriteBatchObject::ProxyVTable() const
+{
+	return LuaSpriteBatchObjectProxyVTable::Constant();
+}
+
+bool
+SpriteBatchObject::Append( const Instance& instance )
+{
+	U32 index = GetNumInstances();
+	bool result = ( index < fCapacity );
+	if ( result )
+	{
+		fInstances.Append( instance );
+		InvalidateInstances( index, index + 1 );
+	}
+
+	return result;
+}
+
+bool
+SpriteBatchObject::Set( U32 index, const Instance& instance )
+{
+	bool result = ( index < GetNumInstances() );
+	if ( result )
+	{
+		fInstances[index] = instance;
+		InvalidateInstances( index, index + 1 );
+	}
+
+	return result;
+}
+
+bool
+SpriteBatchObject::SetTint( U32 index, Color tint )
+{
+	bool result = ( index < GetNumInstances() );
+	if ( result )
+	{
+		fInstances[index].fTint = tint;
+		InvalidateInstances( index, index + 1 );
+	}
+
+	return result;
+}
+
+U32
+SpriteBatchObject::SetInstances( U32 index, const Real *values, U32 count )
+{
+	U32 numInstances = GetNumInstances();
+	if ( index > numInstances || index >= fCapacity )
+	{
+		return 0;
+	}
+
+	count = Min( count, fCapacity - index );
+
+	S32 maxFrame = fSheet->GetNumFrames() - 1;
+	for ( U32 i = 0; i < count; i++, values += kValuesPerInstance )
+	{
+		Instance instance;
+		instance.fFrame = Clamp( (S32)values[0], (S32)0, maxFrame );
+		instance.fX = values[1];
+		instance.fY = values[2];
+		instance.fRotation = values[3];
+		instance.fXScale = values[4];
+		instance.fYScale = values[5];
+
+		U32 target = index + i;
+		if ( target < numInstances )
+		{
+			instance.fTint = fInstances[target].fTint;
+			fInstances[target] = instance;
+		}
+		else
+		{
+			instance.fTint = ColorWhite();
+			fInstances.Append( instance );
+		}
+	}
+
+	InvalidateInstances( index, index + count );
+
+	return count;
+}
+
+void
+SpriteBatchObject::Remove( U32 index )
+{
+	U32 last = GetNumInstances() - 1;
+	if ( index <= last )
+	{
+		if ( index < last )
+		{
+			fInstances[index] = fInstances[last];
+			InvalidateInstances( index, index + 1 );
+		}
+
+		fInstances.Remove( last, 1, false );
+		InvalidateInstances( last, last );
+	}
+}
+
+void
+SpriteBatchObject::RemoveAll()
+{
+	fInstances.Clear();
+	InvalidateInstances( 0, 0 );
+}
+
+void
+SpriteBatchObject::InvalidateInstances( U32 start, U32 end )
+{
+	if ( fDirtyStart < fDirtyEnd )
+	{
+		fDirtyStart = Min( fDirtyStart, start );
+		fDirtyEnd = Max( fDirtyEnd, end );
+	}
+	else
+	{
+		fDirtyStart = start;
+		fDirtyEnd = end;
+	}
+
+	fDirtyEnd = Min( fDirtyEnd, GetNumInstances() );
+	fIsSelfBoundsValid = false;
+
+	// Also dirties the stage bounds of the batch and its ancestors
+	Invalidate( kGeometryFlag );
+}
+
+void
+SpriteBatchObject::UpdateVertices( U32 start, U32 end )
+{
+	Geometry::Vertex *vertices = fData.fGeometry->GetVertexData() + start * kVerticesPerInstance;
+
+	Vertex2 quad[4];
+	Vertex2 uv[4];
+	for ( U32 i = start; i < end; i++ )
+	{
+		const Instance& instance = fInstances[i];
+		const ImageFrame& frame = * fSheet->GetFrame( instance.fFrame );
+
+		GetInstanceQuad( instance, frame, quad );
+
+		for ( int j = 0; j < 4; j++ )
+		{
+			uv[j].x = Rtt_IntToReal( j & 1 );
+			uv[j].y = Rtt_IntToReal( j >> 1 );
+			frame.UpdateUVVertex( uv[j] );
+		}
+
+		for ( int j = 0; j < kVerticesPerInstance; j++, vertices++ )
+		{
+			const int corner = kTriangleCorners[j];
+
+			vertices->x = quad[corner].x;
+			vertices->y = quad[corner].y;
+			vertices->z = Rtt_REAL_0;
+			vertices->u = uv[corner].x;
+			vertices->v = uv[corner].y;
+			vertices->q = Rtt_REAL_1;
+			vertices->ux = vertices->uy = vertices->uz = vertices->uw = Rtt_REAL_0;
+		}
+	}
+}
+
+void
+SpriteBatchObject::UpdateColors( U32 start, U32 end )
+{
+	Geometry::Vertex *vertices = fData.fGeometry->GetVertexData() + start * kVerticesPerInstance;
+	U8 alpha = AlphaCumulative();
+
+	for ( U32 i = start; i < end; i++, vertices += kVerticesPerInstance )
+	{
+		ColorUnion c;
+		c.pixel = fInstances[i].fTint;
+		c.rgba.ModulateAlpha( alpha );
+		c.rgba.PremultiplyAlpha();
+
+		VertexKernels::FillColor( vertices, kVerticesPerInstance, c.pixel );
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
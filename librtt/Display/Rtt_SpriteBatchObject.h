@@ -0,0 +1,132 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef __Rtt_SpriteBatchObject__
+#define __Rtt_SpriteBatchObject__
+
+#include "Display/Rtt_DisplayObject.h"
+#include "Display/Rtt_ImageSheet.h"
+#include "Renderer/Rtt_RenderData.h"
+
+#include "Core/Rtt_Array.h"
+#include "Core/Rtt_AutoPtr.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+class Shader;
+
+// ----------------------------------------------------------------------------
+
+// Draws up to a fixed number of frames of one ImageSheet in a single draw call.
+//
+// Each instance is a quad in the batch's local space. Their vertices are only
+// rewritten when instances change; the batch's own transform is applied on
+// the GPU, so moving the batch as a whole costs no vertex work.
+class SpriteBatchObject : public DisplayObject
+{
+	Rtt_CLASS_NO_COPIES( SpriteBatchObject )
+
+	public:
+		typedef SpriteBatchObject Self;
+		typedef DisplayObject Super;
+
+		enum
+		{
+			kVerticesPerInstance = 6,
+
+			// Values per instance in a packed array: frame, x, y, rotation, xScale, yScale
+			kValuesPerInstance = 6
+		};
+
+		struct Instance
+		{
+			Real fX;
+			Real fY;
+			Real fRotation;
+			Real fXScale;
+			Real fYScale;
+			S32 fFrame;
+			Color fTint;
+		};
+
+	public:
+		SpriteBatchObject( Rtt_Allocator *pAllocator, const AutoPtr< ImageSheet >& sheet, U32 capacity );
+		virtual ~SpriteBatchObject();
+
+	public:
+		// Creates the geometry and selects the shader
+		void Initialize( Display& display );
+
+	public:
+		// MDrawable
+		virtual void Prepare( const Display& display );
+		virtual void Draw( Renderer& renderer ) const;
+		virtual void GetSelfBounds( Rect& rect ) const;
+
+	public:
+		virtual bool HitTest( Real contentX, Real contentY );
+		virtual bool ShouldOffsetWithAnchor() const;
+
+	public:
+		virtual const LuaProxyVTable& ProxyVTable() const;
+
+	public:
+		const AutoPtr< ImageSheet >& GetSheet() const { return fSheet; }
+		U32 GetCapacity() const { return fCapacity; }
+		U32 GetNumInstances() const { return fInstances.Length(); }
+
+		// Index arguments are 0-based. Return false if the batch is full or
+		// index is out of range
+		bool Append( const Instance& instance );
+		bool Set( U32 index, const Instance& instance );
+		bool SetTint( U32 index, Color tint );
+
+		// Replaces the instances starting at index with count packed records
+		// of kValuesPerInstance values, adding instances past the end as
+		// needed. Tints of replaced instances are kept. Returns the number of
+		// records written, which is less than count once the batch is full.
+		U32 SetInstances( U32 index, const Real *values, U32 count );
+
+		// The last instance takes the place of the removed one
+		void Remove( U32 index );
+		void RemoveAll();
+
+		const Instance& GetInstance( U32 index ) const { return fInstances[index]; }
+
+	protected:
+		void InvalidateInstances( U32 start, U32 end );
+		void UpdateVertices( U32 start, U32 end );
+		void UpdateColors( U32 start, U32 end );
+
+	private:
+		AutoPtr< ImageSheet > fSheet;
+		Array< Instance > fInstances;
+		U32 fCapacity;
+
+		// Instances in [fDirtyStart, fDirtyEnd) need their vertices rewritten
+		U32 fDirtyStart;
+		U32 fDirtyEnd;
+
+		mutable Rect fSelfBounds;
+		mutable bool fIsSelfBoundsValid;
+
+		RenderData fData;
+		Shader *fShader;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // __Rtt_SpriteBatchObject__
@@ -612,6 +612,12 @@ SpriteObject::SpriteObject(
 			fStartTime(0),
 			fPlayTime(0),
 			fTimeScaleIncrement(0),
+			fTimeArrayCachedFrame(0),
+			fTimeArrayCachedNextFrameTime(Rtt_REAL_0),
+			fScheduledPrev(NULL),
+			fScheduledNext(NULL),
+			fScheduledTime(0),
+			fScheduledList(-1),
 			fProperties(0)
 {
 	SetObjectDesc( "SpriteObject" );     // for introspection
@@ -1021,6 +1027,50 @@ SpriteObject::Update( lua_State *L, U64 milliseconds )
 	}
 }
 
+U64
+SpriteObject::GetNextUpdateTime( U64 milliseconds ) const
+{
+	U64 result = milliseconds;
+
+	SpriteObjectSequence *sequence = GetCurrentSequence();
+
+	// Frame-based sequences advance on every update, and the first update
+	// dispatches the "began" phase, so only time-based ones can wait.
+	if ( IsProperty( kIsPlayingBegan )
+		 && milliseconds >= fStartTime
+		 && fTimeScale > Rtt_REAL_0
+		 && ( sequence->GetTime() > 0 || sequence->GetTimeArray() != NULL ) )
+	{
+		// Same as in Update()
+		Real elapsed = Rtt_IntToReal((U32)(milliseconds - fStartTime + fTimeScaleIncrement));
+		Real dt = Rtt_RealMul( elapsed, fTimeScale );
+
+		// Scaled time at which the frame index next changes
+		Real nextFrameTime;
+		if ( sequence->GetTimeArray() == NULL )
+		{
+			Real timePerFrame = sequence->GetTimePerFrame();
+			int frameIndex = (int)Rtt_RealDiv( dt, timePerFrame );
+			nextFrameTime = Rtt_RealMul( Rtt_IntToReal( frameIndex + 1 ), timePerFrame );
+		}
+		else
+		{
+			nextFrameTime = fTimeArrayCachedNextFrameTime;
+		}
+
+		// Round down, since waking early only costs an extra update.
+		// Very long delays are capped and simply re-evaluated when they expire.
+		const Real kMaxDelay = Rtt_IntToReal( 60000 );
+		Real delay = Rtt_RealDiv( nextFrameTime, fTimeScale ) - elapsed;
+		if ( delay >= Rtt_REAL_1 )
+		{
+			result += (U64)Rtt_RealToInt( Min( delay, kMaxDelay ) );
+		}
+	}
+
+	return result;
+}
+
 void
 SpriteObject::Play( lua_State *L )
 {
@@ -1175,6 +1225,8 @@ SpriteObject::SetFrame( int index )
 
 		int frameIndex = sequence->GetEffectiveFrame( index );
 		SetBitmapFrame( frameIndex );
+
+		fPlayer.Reschedule( this );
 	}
 }
 
@@ -1316,6 +1368,8 @@ SpriteObject::SetPlaying( bool newValue )
 			Rtt_ASSERT( ! IsProperty( kIsPlayingBegan ) );
 			fStartTime = fPlayer.GetAnimationTime();
 		}
+
+		fPlayer.Reschedule( this );
 	}
 }
 
@@ -1343,6 +1397,8 @@ SpriteObject::SetTimeScale( Real newValue ) {
 
 
   fTimeScale = newValue;
+
+  fPlayer.Reschedule( this );
 }
 
 SpriteObjectSequence*
@@ -1366,6 +1422,8 @@ SpriteObject::Reset()
 	ResetTimeArrayIteratorCache(sequence);
 	int frameIndex = sequence->GetEffectiveFrame( 0 );
 	SetBitmapFrame( frameIndex );
+
+	fPlayer.Reschedule( this );
 }
 	
 
@@ -144,6 +144,8 @@ class SpriteObjectSequence
 
 class SpriteObject : public RectObject
 {
+	friend class SpritePlayer;
+
 	public:
 		typedef RectObject Super;
 		typedef SpriteObject Self;
@@ -212,6 +214,10 @@ class SpriteObject : public RectObject
 	public:
 		void Update( lua_State *L, U64 milliseconds );
 
+		// Earliest time at which Update() can change the frame. Returns
+		// 'milliseconds' or earlier when the sprite must update every frame.
+		U64 GetNextUpdateTime( U64 milliseconds ) const;
+
 	public:
 		void Play( lua_State *L );
 		void Pause();
@@ -263,6 +269,12 @@ class SpriteObject : public RectObject
 		int fTimeArrayCachedFrame; // stores iterator state for SpriteObjectSequence::GetFrameIndexForDeltaTime()
 		Real fTimeArrayCachedNextFrameTime; // stores iterator state for SpriteObjectSequence::GetFrameIndexForDeltaTime()
 	
+		// Owned by fPlayer
+		SpriteObject *fScheduledPrev;
+		SpriteObject *fScheduledNext;
+		U64 fScheduledTime;
+		S32 fScheduledList;
+
 		Properties fProperties;
 };
 
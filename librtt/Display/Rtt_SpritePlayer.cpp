@@ -22,11 +22,29 @@ namespace Rtt
 // ----------------------------------------------------------------------------
 
 SpritePlayer::SpritePlayer( Rtt_Allocator *pAllocator )
-:	fSprites( pAllocator ),
-	fRemoveList( pAllocator ),
-	fIsRunning( false ),
-	fAnimationTime(0)
+:	fAnimationTime( 0 ),
+	fLastTick( 0 ),
+	fCurrent( NULL ),
+	fUpdateCount( 0 ),
+	fIsSkippingOffScreen( false )
 {
+	for ( S32 i = 0; i < kNumLists; i++ )
+	{
+		fLists[i] = NULL;
+	}
+}
+
+SpritePlayer::~SpritePlayer()
+{
+	// Sprites normally remove themselves first, but don't leave them
+	// pointing into a dead player.
+	for ( S32 i = 0; i < kNumLists; i++ )
+	{
+		while ( fLists[i] )
+		{
+			Unlink( fLists[i] );
+		}
+	}
 }
 
 U64 SpritePlayer::GetAnimationTime() const
@@ -37,113 +55,174 @@ U64 SpritePlayer::GetAnimationTime() const
 void
 SpritePlayer::AddSprite( SpriteObject *object )
 {
-	for ( int i = 0, iMax = fSprites.Length(); i < iMax; i++ )
-	{
-		const SpriteObject *item = fSprites[i];
-		if ( item == object )
-		{
-			object = NULL;
-			break;
-		}
-	}
+	Reschedule( object );
+}
+
+void
+SpritePlayer::RemoveSprite( SpriteObject *object )
+{
+	Unlink( object );
 
-	if ( object )
+	if ( object == fCurrent )
 	{
-		fSprites.Append( object );
+		fCurrent = NULL;
 	}
 }
 
-static int
-GetInsertionIndex( Array< int >& array, int element, int start, int end )
+void
+SpritePlayer::Reschedule( SpriteObject *object )
 {
-	Rtt_ASSERT( start >= 0 );
-	Rtt_ASSERT( start <= end );
-	Rtt_ASSERT( end < array.Length() );
-
-	int pivot = ( start + ((end-start) >> 1) ); // start + ( end - start ) / 2;
-
-	if ( start == end )
+	if ( object == fCurrent )
 	{
-		return ( array[pivot] >= element ? pivot : pivot+1 );
+		// Run() reschedules it once its update is done
+		return;
 	}
-	else if ( array[pivot] >= element )
+
+	if ( object->IsPlaying() )
 	{
-		return GetInsertionIndex( array, element, start, pivot );
+		Schedule( object, object->GetNextUpdateTime( fAnimationTime ) );
 	}
 	else
 	{
-		return GetInsertionIndex( array, element, pivot+1, end );
+		Unlink( object );
 	}
 }
 
 void
-SpritePlayer::RemoveSprite( SpriteObject *object )
+SpritePlayer::Run( lua_State *L, U64 millisecondTime )
 {
-	for ( int i = 0, iMax = fSprites.Length(); i < iMax; i++ )
+	fAnimationTime = millisecondTime;
+	fUpdateCount = 0;
+
+	CollectDue( millisecondTime );
+
+	// Always pop the head, since a listener can remove any sprite,
+	// including the one being updated.
+	SpriteObject *&ready = fLists[kReadyList];
+	while ( ready )
 	{
-		const SpriteObject *item = fSprites[i];
-		if ( item == object )
+		SpriteObject *sprite = ready;
+		Unlink( sprite );
+
+		if ( fIsSkippingOffScreen && sprite->IsOffScreen() )
 		{
-			if ( fIsRunning )
-			{
-				object->SetMarked( true );
-
-				// Always insert indices ('i'), small to large
-				int index = 0;
-				int removeListLen = fRemoveList.Length();
-				if ( removeListLen > 0 )
-				{
-					index = GetInsertionIndex( fRemoveList, i, 0, removeListLen - 1 );
-				}
-				fRemoveList.Insert( index, i );
-			}
-			else
-			{
-				fSprites.Remove( i, 1, false );
-			}
-			break;
+			Schedule( sprite, millisecondTime + kTickMilliseconds );
+			continue;
+		}
+
+		fCurrent = sprite;
+		sprite->Update( L, millisecondTime );
+		++fUpdateCount;
+
+		if ( fCurrent )
+		{
+			fCurrent = NULL;
+			Reschedule( sprite );
 		}
 	}
 }
 
 void
-SpritePlayer::Run( lua_State *L, U64 millisecondTime )
+SpritePlayer::Schedule( SpriteObject *object, U64 time )
 {
-	fAnimationTime = millisecondTime;
-	fIsRunning = true;
-	Update( L );
-	fIsRunning = false;
+	Unlink( object );
+
+	object->fScheduledTime = time;
 
-	Collect();
+	if ( time <= fAnimationTime )
+	{
+		// Due on the next Run()
+		Link( object, kPendingList );
+	}
+	else
+	{
+		Link( object, (S32)( ( time / kTickMilliseconds ) % kNumSlots ) );
+	}
+}
+
+void
+SpritePlayer::Link( SpriteObject *object, S32 list )
+{
+	Rtt_ASSERT( kUnscheduled == object->fScheduledList );
+	Rtt_ASSERT( list >= 0 && list < kNumLists );
+
+	SpriteObject *head = fLists[list];
+	object->fScheduledPrev = NULL;
+	object->fScheduledNext = head;
+	if ( head )
+	{
+		head->fScheduledPrev = object;
+	}
+	fLists[list] = object;
+	object->fScheduledList = list;
 }
 
 void
-SpritePlayer::Update( lua_State *L )
+SpritePlayer::Unlink( SpriteObject *object )
 {
-	for ( int i = 0, iMax = fSprites.Length(); i < iMax; i++ )
+	S32 list = object->fScheduledList;
+	if ( kUnscheduled != list )
 	{
-		SpriteObject *sprite = fSprites[i];
-		if ( ! sprite->IsMarked() )
+		SpriteObject *prev = object->fScheduledPrev;
+		SpriteObject *next = object->fScheduledNext;
+		if ( prev )
 		{
-			sprite->Update( L, GetAnimationTime() );
+			prev->fScheduledNext = next;
 		}
+		else
+		{
+			Rtt_ASSERT( fLists[list] == object );
+			fLists[list] = next;
+		}
+		if ( next )
+		{
+			next->fScheduledPrev = prev;
+		}
+
+		object->fScheduledPrev = NULL;
+		object->fScheduledNext = NULL;
+		object->fScheduledList = kUnscheduled;
 	}
 }
 
 void
-SpritePlayer::Collect()
+SpritePlayer::CollectDue( U64 millisecondTime )
 {
-	Rtt_ASSERT( ! fIsRunning );
+	Rtt_ASSERT( NULL == fLists[kReadyList] );
 
-	// Remove backwards so that larger indices are removed first.
-	// Otherwise larger indices into fSprites are invalidated by 
-	// compacting fSprites at smaller indices.
-	for ( int i = fRemoveList.Length(); --i >= 0; )
+	fLists[kReadyList] = fLists[kPendingList];
+	fLists[kPendingList] = NULL;
+	for ( SpriteObject *iCurrent = fLists[kReadyList]; iCurrent; iCurrent = iCurrent->fScheduledNext )
 	{
-		int index = fRemoveList[i];
-		fSprites.Remove( index, 1, false );
-		fRemoveList.Remove( i, 1 );
+		iCurrent->fScheduledList = kReadyList;
 	}
+
+	// Visit the slots of every tick since the last Run(), starting with the
+	// last one, which may still hold sprites due later within that tick.
+	// After a long stall, one turn of the wheel covers every slot.
+	U64 tick = millisecondTime / kTickMilliseconds;
+	U64 first = fLastTick;
+	if ( tick - first >= kNumSlots )
+	{
+		first = tick - ( kNumSlots - 1 );
+	}
+
+	for ( U64 t = first; t <= tick; t++ )
+	{
+		S32 slot = (S32)( t % kNumSlots );
+		for ( SpriteObject *iCurrent = fLists[slot], *iNext; iCurrent; iCurrent = iNext )
+		{
+			iNext = iCurrent->fScheduledNext;
+
+			if ( iCurrent->fScheduledTime <= millisecondTime )
+			{
+				Unlink( iCurrent );
+				Link( iCurrent, kReadyList );
+			}
+		}
+	}
+
+	fLastTick = tick;
 }
 
 // ----------------------------------------------------------------------------
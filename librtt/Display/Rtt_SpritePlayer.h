@@ -10,7 +10,6 @@
 #ifndef __Rtt_SpritePlayer__
 #define __Rtt_SpritePlayer__
 
-#include "Core/Rtt_Array.h"
 #include "Display/Rtt_SpriteObject.h"
 
 // ----------------------------------------------------------------------------
@@ -22,31 +21,74 @@ namespace Rtt
 
 // ----------------------------------------------------------------------------
 
+// Schedules sprite updates by the time of each sprite's next frame change.
+//
+// Playing sprites live in a hashed timing wheel: slot 'i' holds the sprites
+// due at tick 'i' modulo kNumSlots. Sprites due further out than one turn of
+// the wheel stay in their slot until their time comes. Sprites that must be
+// updated on every frame (e.g. frame-based sequences) wait in a pending list.
+// Paused and finished sprites are not scheduled at all.
+//
+// Each sprite is linked into at most one list via its own prev/next pointers,
+// so adding, removing and rescheduling a sprite are O(1).
 class SpritePlayer
 {
 	public:
 		typedef SpritePlayer Self;
 
+		enum
+		{
+			kNumSlots = 256,
+			kTickMilliseconds = 8,
+		};
+
 	public:
 		SpritePlayer( Rtt_Allocator *pAllocator );
+		~SpritePlayer();
 
 	public:
 		void AddSprite( SpriteObject *object );
 		void RemoveSprite( SpriteObject *object );
 
+		// Call whenever the playback state of 'object' changes
+		void Reschedule( SpriteObject *object );
+
 	public:
 		void Run( lua_State *L, U64 millisecondTime );
 		U64 GetAnimationTime() const;
 
+	public:
+		// When true, sprites culled on the last render are not updated. They
+		// are polled again each tick, so time-based sequences catch up once the
+		// sprite is back onscreen; frame-based ones stay on the current frame.
+		bool IsSkippingOffScreen() const { return fIsSkippingOffScreen; }
+		void SetSkippingOffScreen( bool newValue ) { fIsSkippingOffScreen = newValue; }
+
+		// Number of sprites updated during the last Run()
+		U32 GetUpdateCount() const { return fUpdateCount; }
+
 	protected:
-		void Update( lua_State *L );
-		void Collect();
+		enum
+		{
+			kUnscheduled = -1,
+			kPendingList = kNumSlots,
+			kReadyList,
+
+			kNumLists
+		};
+
+		void Schedule( SpriteObject *object, U64 time );
+		void Link( SpriteObject *object, S32 list );
+		void Unlink( SpriteObject *object );
+		void CollectDue( U64 millisecondTime );
 
 	private:
 		U64 fAnimationTime;
-		LightPtrArray< SpriteObject > fSprites;
-		Array< int > fRemoveList; // indices in fSprites of items to remove
-		bool fIsRunning;
+		U64 fLastTick;
+		SpriteObject *fLists[kNumLists];
+		SpriteObject *fCurrent; // sprite being updated, or NULL
+		U32 fUpdateCount;
+		bool fIsSkippingOffScreen;
 };
 
 // ----------------------------------------------------------------------------
@@ -23,6 +23,7 @@ namespace Rtt
 TesselatorLine::TesselatorLine( const ArrayVertex2& controlPoints, Mode mode )
 :	Super(),
 	fControlPoints( controlPoints ),
+	fLineState( NULL ),
 	fMode( mode )
 {
 }
@@ -270,6 +271,11 @@ TesselatorLine::GenerateStrokeLine( ArrayVertex2& vertices )
 
 	const S32 numControlPoints = fControlPoints.Length();
 
+	if ( fLineState )
+	{
+		fLineState->fNumPoints = 0;
+	}
+
 	if ( numControlPoints > 1 )
 	{
 		S32 numAdded = 0;
@@ -318,6 +324,15 @@ TesselatorLine::GenerateStrokeLine( ArrayVertex2& vertices )
 		// Last endpoint
 		numAdded += AddBoundaryPoints( dstVertices, * v2, dx, dy, innerWidth, outerWidth );
 
+		if ( fLineState )
+		{
+			fLineState->fDx = dx;
+			fLineState->fDy = dy;
+			fLineState->fX1n = x1_n;
+			fLineState->fY1n = y1_n;
+			fLineState->fNumPoints = numControlPoints;
+		}
+
 		controlVertices += numControlPoints;
 	}
 
@@ -325,6 +340,56 @@ exit_gracefully:
 	return;
 }
 
+bool
+TesselatorLine::AppendStroke( ArrayVertex2& vertices )
+{
+	LineState *state = fLineState;
+
+	const S32 numControlPoints = fControlPoints.Length();
+
+	// Both endpoints must have been stroked, and points only added since
+	if ( kLineMode != fMode
+		 || ! state
+		 || state->fNumPoints < 2
+		 || state->fNumPoints > numControlPoints
+		 || vertices.Length() < 4 )
+	{
+		return false;
+	}
+
+	if ( state->fNumPoints < numControlPoints )
+	{
+		const Vertex2 *controlVertices = fControlPoints.ReadAccess();
+
+		Real dx = state->fDx;
+		Real dy = state->fDy;
+		Real x1_n = state->fX1n;
+		Real y1_n = state->fY1n;
+
+		// The old last endpoint becomes a joint, so drop its end cap
+		vertices.Remove( vertices.Length() - 2, 2, false );
+
+		const Vertex2* v1 = & controlVertices[state->fNumPoints - 1];
+		for ( S32 j = state->fNumPoints; j < numControlPoints; j++ )
+		{
+			const Vertex2* v2 = & controlVertices[j];
+			StrokeSegment( vertices, v1, v2, dx, dy, x1_n, y1_n, fInnerWidth, fOuterWidth );
+			v1 = v2;
+		}
+
+		// Last endpoint
+		AddBoundaryPoints( vertices, * v1, dx, dy, fInnerWidth, fOuterWidth );
+
+		state->fDx = dx;
+		state->fDy = dy;
+		state->fX1n = x1_n;
+		state->fY1n = y1_n;
+		state->fNumPoints = numControlPoints;
+	}
+
+	return true;
+}
+
 void
 TesselatorLine::GenerateStrokeLoop( ArrayVertex2& vertices )
 {
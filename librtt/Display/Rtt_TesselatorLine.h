@@ -34,9 +34,29 @@ class TesselatorLine : public Tesselator
 		}
 		Mode;
 
+		// Where the stroke of a kLineMode line left off, so points appended
+		// to the control points later can be stroked on their own
+		struct LineState
+		{
+			Real fDx;			// Normal at the last control point
+			Real fDy;
+			Real fX1n;			// Direction of the last segment
+			Real fY1n;
+			S32 fNumPoints;		// Number of control points stroked
+		};
+
 	public:
 		TesselatorLine( const ArrayVertex2& controlPoints, Mode mode );
 
+	public:
+		// GenerateStroke() saves its end state here, if set
+		void SetLineState( LineState *state ) { fLineState = state; }
+
+		// Strokes the control points appended since the line state was saved,
+		// replacing the end cap of the existing stroke vertices. Returns false
+		// when the stroke must be generated from scratch instead.
+		bool AppendStroke( ArrayVertex2& vertices );
+
 	public:
 		virtual U32 StrokeVertexCount() const override;
 
@@ -58,6 +78,7 @@ class TesselatorLine : public Tesselator
 
 	private:
 		const ArrayVertex2& fControlPoints;
+		LineState *fLineState;
 		U8 fMode;
 };
 
@@ -15,6 +15,8 @@
 #include "Rtt_Matrix.h"
 #include "Rtt_Transform.h"
 
+#include <math.h>
+
 // ----------------------------------------------------------------------------
 
 namespace Rtt
@@ -22,178 +24,928 @@ namespace Rtt
 
 // ----------------------------------------------------------------------------
 
+// Ear clipping triangulator for polygons with holes.
+//
+// Holes are first joined to the outer ring by zero-width bridges, so the
+// result is a single ring. Ears are then clipped in order. For larger
+// polygons, the vertices are also linked in z-order (Morton code) so the
+// point-in-ear test only visits vertices whose codes fall in the ear's
+// bounds, which keeps the typical case close to O(n log n).
+//
+// When no ear can be found (self-intersections, self-touching contours),
+// the ring is first filtered of duplicate and collinear points, then local
+// self-intersections are cut off, and finally the ring is split along a
+// valid diagonal and each half is triangulated on its own. So a bad
+// contour degrades to a partial fill instead of no fill at all.
+//
+// Based on the algorithm used by Mapbox's earcut:
+//
+//   ISC License
+//
+//   Copyright (c) 2016, Mapbox
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose
+//   with or without fee is hereby granted, provided that the above copyright notice
+//   and this permission notice appear in all copies.
+//
+//   THE SOFTWARE IS PROVIDED "AS IS" AND ISC DISCLAIMS ALL WARRANTIES WITH REGARD TO
+//   THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+//   IN NO EVENT SHALL ISC BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA
+//   OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION,
+//   ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 class Triangulate
 {
+	Rtt_CLASS_NO_COPIES( Triangulate )
+
 	public:
-		// Tesselate a contour/polygon into a series of triangles.
+		// Appends 3 contour indices per triangle to 'outTriangles'. 'holes'
+		// holds the start of each hole ring in 'contour', in ascending order.
+		// Returns false if no triangles could be generated.
 		static bool Process(
-			const ArrayVertex2 &contour, ArrayVertex2 &result, Rect& bounds, ArrayIndex * triangulationIndices );
-
-		// Compute area of a contour/polygon
-		static float Area(const ArrayVertex2 &contour);
+			Rtt_Allocator *allocator,
+			const ArrayVertex2 &contour,
+			const ArrayS32 &holes,
+			ArrayS32 &outTriangles );
 
-		// Decide if point Px/Py is inside triangle defined by (Ax,Ay) (Bx,By) (Cx,Cy)
-		static bool InsideTriangle(
-			float Ax, float Ay,
-			float Bx, float By,
-			float Cx, float Cy,
-			float Px, float Py);
+	protected:
+		struct Node
+		{
+			S32 i; // contour index
+			double x;
+			double y;
+			U32 z; // z-order curve value
+			Node *prev;
+			Node *next;
+			Node *prevZ; // neighbors in z-order
+			Node *nextZ;
+			bool steiner;
+		};
+
+	protected:
+		Triangulate( Rtt_Allocator *allocator, const ArrayVertex2 &contour, ArrayS32 &triangles );
+
+	protected:
+		Node* NewNode( S32 i );
+		Node* InsertNode( S32 i, Node *last );
+		static void RemoveNode( Node *p );
+
+		Node* LinkedList( S32 start, S32 end, bool clockwise );
+		static Node* FilterPoints( Node *start, Node *end = NULL );
+		void EarcutLinked( Node *ear, int pass );
+		bool IsEar( Node *ear ) const;
+		bool IsEarHashed( Node *ear ) const;
+		Node* CureLocalIntersections( Node *start );
+		void SplitEarcut( Node *start );
+		Node* SplitPolygon( Node *a, Node *b );
+
+		Node* EliminateHoles( const ArrayS32 &holes, Node *outerNode );
+		Node* EliminateHole( Node *hole, Node *outerNode );
+		static Node* FindHoleBridge( Node *hole, Node *outerNode );
+
+		void IndexCurve( Node *start );
+		static Node* SortLinked( Node *list );
+		U32 ZOrder( double x, double y ) const;
+
+		void AppendTriangle( const Node *a, const Node *b, const Node *c );
+
+	protected:
+		static double SignedArea( const ArrayVertex2 &contour, S32 start, S32 end );
+		static double Area( const Node *p, const Node *q, const Node *r );
+		static bool Equals( const Node *p1, const Node *p2 );
+		static bool PointInTriangle(
+			double ax, double ay, double bx, double by, double cx, double cy, double px, double py );
+		static bool BlocksEar(
+			const Node *p, const Node *a, const Node *b, const Node *c,
+			double x0, double y0, double x1, double y1 );
+		static bool Intersects( const Node *p1, const Node *q1, const Node *p2, const Node *q2 );
+		static bool OnSegment( const Node *p, const Node *q, const Node *r );
+		static bool IntersectsPolygon( const Node *a, const Node *b );
+		static bool LocallyInside( const Node *a, const Node *b );
+		static bool MiddleInside( const Node *a, const Node *b );
+		static bool IsValidDiagonal( const Node *a, const Node *b );
+		static bool SectorContainsSector( const Node *m, const Node *p );
+		static Node* GetLeftmost( Node *start );
 
 	private:
-		static bool Snip(
-			const ArrayVertex2 &contour,
-			int u, int v, int w, int n, int *V );
+		enum
+		{
+			kNodesPerBlock = 256,
+
+			// Below this, the plain O(n^2) ear test is faster than hashing
+			kMinHashedVertices = 80,
+		};
+
+		struct NodeBlock
+		{
+			Node nodes[kNodesPerBlock];
+		};
+
+		const ArrayVertex2 &fContour;
+		ArrayS32 &fTriangles;
+		PtrArray< NodeBlock > fBlocks;
+		S32 fBlockUsed;
+		double fMinX;
+		double fMinY;
+		double fInvSize; // 0 when z-order hashing is off
 };
 
-float
-Triangulate::Area( const ArrayVertex2 &contour )
+bool
+Triangulate::Process(
+	Rtt_Allocator *allocator,
+	const ArrayVertex2 &contour,
+	const ArrayS32 &holes,
+	ArrayS32 &outTriangles )
+{
+	S32 n = contour.Length();
+	S32 outerLength = ( holes.Length() > 0 ? holes[0] : n );
+	if ( outerLength < 3 ) { return false; }
+
+	S32 numTriangles = outTriangles.Length();
+
+	Triangulate t( allocator, contour, outTriangles );
+
+	Node *outerNode = t.LinkedList( 0, outerLength, true );
+	if ( ! outerNode || outerNode->next == outerNode->prev ) { return false; }
+
+	if ( holes.Length() > 0 )
+	{
+		outerNode = t.EliminateHoles( holes, outerNode );
+	}
+
+	if ( n > kMinHashedVertices )
+	{
+		double minX = contour[0].x, minY = contour[0].y;
+		double maxX = minX, maxY = minY;
+		for ( S32 i = 1; i < outerLength; i++ )
+		{
+			const Vertex2& v = contour[i];
+			if ( v.x < minX ) { minX = v.x; }
+			if ( v.y < minY ) { minY = v.y; }
+			if ( v.x > maxX ) { maxX = v.x; }
+			if ( v.y > maxY ) { maxY = v.y; }
+		}
+
+		// z-order is computed in a 32767x32767 grid over the outer bounds
+		double size = Max( maxX - minX, maxY - minY );
+		t.fMinX = minX;
+		t.fMinY = minY;
+		t.fInvSize = ( size > 0.0 ? 32767.0 / size : 0.0 );
+	}
+
+	t.EarcutLinked( outerNode, 0 );
+
+	return outTriangles.Length() > numTriangles;
+}
+
+Triangulate::Triangulate( Rtt_Allocator *allocator, const ArrayVertex2 &contour, ArrayS32 &triangles )
+:	fContour( contour ),
+	fTriangles( triangles ),
+	fBlocks( allocator ),
+	fBlockUsed( kNodesPerBlock ),
+	fMinX( 0.0 ),
+	fMinY( 0.0 ),
+	fInvSize( 0.0 )
+{
+	// A simple polygon produces n-2 triangles
+	fTriangles.Reserve( fTriangles.Length() + 3 * contour.Length() );
+}
+
+// Nodes are allocated in blocks so that they never move
+Triangulate::Node*
+Triangulate::NewNode( S32 i )
+{
+	if ( fBlockUsed >= kNodesPerBlock )
+	{
+		fBlocks.Append( Rtt_NEW( fBlocks.Allocator(), NodeBlock ) );
+		fBlockUsed = 0;
+	}
+
+	Node *p = & fBlocks[fBlocks.Length() - 1]->nodes[fBlockUsed++];
+	p->i = i;
+	p->x = fContour[i].x;
+	p->y = fContour[i].y;
+	p->z = 0;
+	p->prev = NULL;
+	p->next = NULL;
+	p->prevZ = NULL;
+	p->nextZ = NULL;
+	p->steiner = false;
+
+	return p;
+}
+
+Triangulate::Node*
+Triangulate::InsertNode( S32 i, Node *last )
+{
+	Node *p = NewNode( i );
+
+	if ( ! last )
+	{
+		p->prev = p;
+		p->next = p;
+	}
+	else
+	{
+		p->next = last->next;
+		p->prev = last;
+		last->next->prev = p;
+		last->next = p;
+	}
+
+	return p;
+}
+
+void
+Triangulate::RemoveNode( Node *p )
+{
+	p->next->prev = p->prev;
+	p->prev->next = p->next;
+
+	if ( p->prevZ ) { p->prevZ->nextZ = p->nextZ; }
+	if ( p->nextZ ) { p->nextZ->prevZ = p->prevZ; }
+}
+
+// Creates a circular doubly linked list from contour[start, end) in the
+// specified winding order
+Triangulate::Node*
+Triangulate::LinkedList( S32 start, S32 end, bool clockwise )
+{
+	Node *last = NULL;
+
+	if ( clockwise == ( SignedArea( fContour, start, end ) > 0.0 ) )
+	{
+		for ( S32 i = start; i < end; i++ ) { last = InsertNode( i, last ); }
+	}
+	else
+	{
+		for ( S32 i = end - 1; i >= start; i-- ) { last = InsertNode( i, last ); }
+	}
+
+	if ( last && Equals( last, last->next ) )
+	{
+		RemoveNode( last );
+		last = last->next;
+	}
+
+	return last;
+}
+
+// Eliminates duplicate and collinear points
+Triangulate::Node*
+Triangulate::FilterPoints( Node *start, Node *end )
+{
+	if ( ! start ) { return start; }
+	if ( ! end ) { end = start; }
+
+	Node *p = start;
+	bool again;
+	do
+	{
+		again = false;
+
+		if ( ! p->steiner && ( Equals( p, p->next ) || 0.0 == Area( p->prev, p, p->next ) ) )
+		{
+			RemoveNode( p );
+			p = end = p->prev;
+			if ( p == p->next ) { break; }
+			again = true;
+		}
+		else
+		{
+			p = p->next;
+		}
+	}
+	while ( again || p != end );
+
+	return end;
+}
+
+void
+Triangulate::EarcutLinked( Node *ear, int pass )
 {
-	int n = contour.Length();
+	if ( ! ear ) { return; }
+
+	// Interlink polygon nodes in z-order
+	if ( 0 == pass && fInvSize > 0.0 ) { IndexCurve( ear ); }
 
-	float A = 0.0f;
+	Node *stop = ear;
 
-	for( int p = n-1, q = 0; q < n; p = q++ )
+	// Iterate through ears, slicing them one by one
+	while ( ear->prev != ear->next )
 	{
-		A += contour[p].x * contour[q].y - contour[q].x * contour[p].y;
+		Node *prev = ear->prev;
+		Node *next = ear->next;
+
+		if ( fInvSize > 0.0 ? IsEarHashed( ear ) : IsEar( ear ) )
+		{
+			AppendTriangle( prev, ear, next );
+
+			RemoveNode( ear );
+
+			// Skipping the next vertex leads to less sliver triangles
+			ear = next->next;
+			stop = next->next;
+
+			continue;
+		}
+
+		ear = next;
+
+		// If we looped through the whole remaining polygon and can't find any more ears
+		if ( ear == stop )
+		{
+			if ( 0 == pass )
+			{
+				// Try filtering points and slicing again
+				EarcutLinked( FilterPoints( ear ), 1 );
+			}
+			else if ( 1 == pass )
+			{
+				// If this didn't work, try curing all small self-intersections locally
+				ear = CureLocalIntersections( FilterPoints( ear ) );
+				EarcutLinked( ear, 2 );
+			}
+			else if ( 2 == pass )
+			{
+				// As a last resort, try splitting the remaining polygon into two
+				SplitEarcut( ear );
+			}
+
+			break;
+		}
 	}
-	return A * 0.5f;
 }
 
-// InsideTriangle decides if point P is Inside of the triangle defined by A, B, C.
+// Check whether a polygon node forms a valid ear with adjacent nodes
 bool
-Triangulate::InsideTriangle(
-	float Ax, float Ay,
-	float Bx, float By,
-	float Cx, float Cy,
-	float Px, float Py )
-{
-	float ax, ay, bx, by, cx, cy, apx, apy, bpx, bpy, cpx, cpy;
-	float cCROSSap, bCROSScp, aCROSSbp;
-
-	ax  = Cx - Bx;	ay  = Cy - By;
-	bx  = Ax - Cx;	by  = Ay - Cy;
-	cx  = Bx - Ax;	cy  = By - Ay;
-	apx = Px - Ax;	apy = Py - Ay;
-	bpx = Px - Bx;	bpy = Py - By;
-	cpx = Px - Cx;	cpy = Py - Cy;
-
-	aCROSSbp = ax*bpy - ay*bpx;
-	cCROSSap = cx*apy - cy*apx;
-	bCROSScp = bx*cpy - by*cpx;
-
-	return ((aCROSSbp >= 0.0f) && (bCROSScp >= 0.0f) && (cCROSSap >= 0.0f));
-};
+Triangulate::IsEar( Node *ear ) const
+{
+	const Node *a = ear->prev;
+	const Node *b = ear;
+	const Node *c = ear->next;
+
+	// Reflex, can't be an ear
+	if ( Area( a, b, c ) >= 0.0 ) { return false; }
 
-static const float EPSILON=0.0000000001f;
+	// Now make sure we don't have other points inside the potential ear
+	double x0 = Min( a->x, Min( b->x, c->x ) );
+	double y0 = Min( a->y, Min( b->y, c->y ) );
+	double x1 = Max( a->x, Max( b->x, c->x ) );
+	double y1 = Max( a->y, Max( b->y, c->y ) );
+
+	for ( const Node *p = c->next; p != a; p = p->next )
+	{
+		if ( BlocksEar( p, a, b, c, x0, y0, x1, y1 ) ) { return false; }
+	}
+
+	return true;
+}
 
 bool
-Triangulate::Snip( const ArrayVertex2 &contour, int u, int v, int w, int n, int *V )
+Triangulate::IsEarHashed( Node *ear ) const
 {
-	int p;
-	float Ax, Ay, Bx, By, Cx, Cy, Px, Py;
+	const Node *a = ear->prev;
+	const Node *b = ear;
+	const Node *c = ear->next;
 
-	Ax = contour[V[u]].x;
-	Ay = contour[V[u]].y;
+	if ( Area( a, b, c ) >= 0.0 ) { return false; }
 
-	Bx = contour[V[v]].x;
-	By = contour[V[v]].y;
+	double x0 = Min( a->x, Min( b->x, c->x ) );
+	double y0 = Min( a->y, Min( b->y, c->y ) );
+	double x1 = Max( a->x, Max( b->x, c->x ) );
+	double y1 = Max( a->y, Max( b->y, c->y ) );
 
-	Cx = contour[V[w]].x;
-	Cy = contour[V[w]].y;
+	// z-order range for the current triangle bbox
+	U32 minZ = ZOrder( x0, y0 );
+	U32 maxZ = ZOrder( x1, y1 );
 
-	if ( EPSILON > (((Bx-Ax)*(Cy-Ay)) - ((By-Ay)*(Cx-Ax))) ) { return false; }
+	const Node *p = ear->prevZ;
+	const Node *n = ear->nextZ;
 
-	for ( p=0; p < n; p++ )
+	// Look for points inside the triangle in both directions
+	while ( p && p->z >= minZ && n && n->z <= maxZ )
 	{
-		if ( (p == u) || (p == v) || (p == w) ) { continue; }
-		Px = contour[V[p]].x;
-		Py = contour[V[p]].y;
-		if ( InsideTriangle( Ax, Ay, Bx, By, Cx, Cy, Px, Py ) ) { return false; }
+		if ( BlocksEar( p, a, b, c, x0, y0, x1, y1 ) ) { return false; }
+		p = p->prevZ;
+
+		if ( BlocksEar( n, a, b, c, x0, y0, x1, y1 ) ) { return false; }
+		n = n->nextZ;
+	}
+
+	// Look for remaining points in decreasing z-order
+	for ( ; p && p->z >= minZ; p = p->prevZ )
+	{
+		if ( BlocksEar( p, a, b, c, x0, y0, x1, y1 ) ) { return false; }
+	}
+
+	// Look for remaining points in increasing z-order
+	for ( ; n && n->z <= maxZ; n = n->nextZ )
+	{
+		if ( BlocksEar( n, a, b, c, x0, y0, x1, y1 ) ) { return false; }
 	}
 
 	return true;
 }
 
-bool
-Triangulate::Process( const ArrayVertex2 &contour, ArrayVertex2 &result, Rect& bounds, ArrayIndex * triangulationIndices )
+// Go through all polygon nodes and cure small local self-intersections
+Triangulate::Node*
+Triangulate::CureLocalIntersections( Node *start )
 {
-	// allocate and initialize list of Vertices in polygon
-	int n = contour.Length();
-	if ( n < 3 ) return false;
+	if ( ! start ) { return start; }
+
+	Node *p = start;
+	do
+	{
+		Node *a = p->prev;
+		Node *b = p->next->next;
 
-	int *V = new int[n];
+		if ( ! Equals( a, b ) && Intersects( a, p, p->next, b )
+			 && LocallyInside( a, b ) && LocallyInside( b, a ) )
+		{
+			AppendTriangle( a, p, b );
+
+			// Remove two nodes involved
+			RemoveNode( p );
+			RemoveNode( p->next );
+
+			p = start = b;
+		}
+		p = p->next;
+	}
+	while ( p != start );
 
-	// we want a counter-clockwise polygon in V
-	if ( 0.0f < Area(contour) )
+	return FilterPoints( p );
+}
+
+// Try splitting polygon into two and triangulate them independently
+void
+Triangulate::SplitEarcut( Node *start )
+{
+	// Look for a valid diagonal that divides the polygon into two
+	Node *a = start;
+	do
 	{
-		for ( int v = 0; v < n; v++ )
+		for ( Node *b = a->next->next; b != a->prev; b = b->next )
 		{
-			V[v] = v;
+			if ( a->i != b->i && IsValidDiagonal( a, b ) )
+			{
+				// Split the polygon in two by the diagonal
+				Node *c = SplitPolygon( a, b );
+
+				// Filter collinear points around the cuts
+				a = FilterPoints( a, a->next );
+				c = FilterPoints( c, c->next );
+
+				// Run earcut on each half
+				EarcutLinked( a, 0 );
+				EarcutLinked( c, 0 );
+				return;
+			}
 		}
+		a = a->next;
 	}
-	else
+	while ( a != start );
+}
+
+// Link two polygon vertices with a bridge. If the vertices belong to the
+// same ring, it splits the polygon into two. If one belongs to the outer
+// ring and another to a hole, it merges them into a single ring.
+Triangulate::Node*
+Triangulate::SplitPolygon( Node *a, Node *b )
+{
+	Node *a2 = NewNode( a->i );
+	Node *b2 = NewNode( b->i );
+	Node *an = a->next;
+	Node *bp = b->prev;
+
+	a->next = b;
+	b->prev = a;
+
+	a2->next = an;
+	an->prev = a2;
+
+	b2->next = a2;
+	a2->prev = b2;
+
+	bp->next = b2;
+	b2->prev = bp;
+
+	return b2;
+}
+
+// Link every hole into the outer loop, producing a single-ring polygon
+// without holes
+Triangulate::Node*
+Triangulate::EliminateHoles( const ArrayS32 &holes, Node *outerNode )
+{
+	LightPtrArray< Node > queue( fBlocks.Allocator() );
+	queue.Reserve( holes.Length() );
+
+	for ( S32 i = 0, iMax = holes.Length(); i < iMax; i++ )
 	{
-		for ( int v = 0; v < n; v++ )
+		S32 start = holes[i];
+		S32 end = ( i < iMax - 1 ? holes[i + 1] : fContour.Length() );
+
+		Node *list = LinkedList( start, end, false );
+		if ( list )
 		{
-			V[v] = (n-1)-v;
+			if ( list == list->next ) { list->steiner = true; }
+			queue.Append( GetLeftmost( list ) );
 		}
 	}
 
-	int nv = n;
+	// Process holes from left to right. Insertion sort, since there are
+	// usually only a handful.
+	for ( S32 i = 1, iMax = queue.Length(); i < iMax; i++ )
+	{
+		Node *hole = queue[i];
+		S32 j = i - 1;
+		for ( ; j >= 0 && queue[j]->x > hole->x; j-- )
+		{
+			queue[j + 1] = queue[j];
+		}
+		queue[j + 1] = hole;
+	}
 
-	// remove nv-2 Vertices, creating 1 triangle every time
-	int count = 2*nv;   // error detection
+	for ( S32 i = 0, iMax = queue.Length(); i < iMax; i++ )
+	{
+		outerNode = EliminateHole( queue[i], outerNode );
+	}
+
+	return outerNode;
+}
 
-	for ( int m = 0, v = nv-1; nv > 2; )
+// Find a bridge between vertices that connects hole with an outer ring
+// and link it
+Triangulate::Node*
+Triangulate::EliminateHole( Node *hole, Node *outerNode )
+{
+	Node *bridge = FindHoleBridge( hole, outerNode );
+	if ( ! bridge )
 	{
-		// if we loop, it is probably a non-simple polygon 
-		if (0 >= (count--))
+		return outerNode;
+	}
+
+	Node *bridgeReverse = SplitPolygon( bridge, hole );
+
+	// Filter collinear points around the cuts
+	FilterPoints( bridgeReverse, bridgeReverse->next );
+	return FilterPoints( bridge, bridge->next );
+}
+
+// David Eberly's algorithm for finding a bridge between hole and outer polygon
+Triangulate::Node*
+Triangulate::FindHoleBridge( Node *hole, Node *outerNode )
+{
+	Node *p = outerNode;
+	double hx = hole->x;
+	double hy = hole->y;
+	double qx = -HUGE_VAL;
+	Node *m = NULL;
+
+	// Find a segment intersected by a ray from the hole's leftmost point to
+	// the left. The segment's endpoint with lesser x will be a potential
+	// connection point.
+	do
+	{
+		if ( hy <= p->y && hy >= p->next->y && p->next->y != p->y )
 		{
-			//** Triangulate: ERROR - probable bad polygon!
-			return false;
+			double x = p->x + ( hy - p->y ) * ( p->next->x - p->x ) / ( p->next->y - p->y );
+			if ( x <= hx && x > qx )
+			{
+				qx = x;
+				m = ( p->x < p->next->x ? p : p->next );
+				if ( x == hx )
+				{
+					// The hole touches the outer segment; pick the leftmost endpoint
+					return m;
+				}
+			}
 		}
+		p = p->next;
+	}
+	while ( p != outerNode );
+
+	if ( ! m ) { return NULL; }
 
-		// three consecutive vertices in current polygon, <u,v,w>
-		int u = v;   if (nv <= u) { u = 0; }	// previous
-		v = u+1;     if (nv <= v) { v = 0; }	// new v   
-		int w = v+1; if (nv <= w) { w = 0; }	// next    
+	// Look for points inside the triangle of hole point, segment
+	// intersection and endpoint. If there are no points found, we have a
+	// valid connection. Otherwise choose the point of the minimum angle
+	// with the ray as connection point.
+	const Node *stop = m;
+	double mx = m->x;
+	double my = m->y;
+	double tanMin = HUGE_VAL;
 
-		if ( Snip( contour, u, v, w, nv, V ) )
+	p = m;
+	do
+	{
+		if ( hx >= p->x && p->x >= mx && hx != p->x
+			 && PointInTriangle( hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y ) )
 		{
-			int a,b,c,s,t;
+			double tan = fabs( hy - p->y ) / ( hx - p->x ); // tangential
+
+			if ( LocallyInside( p, hole )
+				 && ( tan < tanMin || ( tan == tanMin && ( p->x > m->x || ( p->x == m->x && SectorContainsSector( m, p ) ) ) ) ) )
+			{
+				m = p;
+				tanMin = tan;
+			}
+		}
+
+		p = p->next;
+	}
+	while ( p != stop );
+
+	return m;
+}
+
+void
+Triangulate::IndexCurve( Node *start )
+{
+	Node *p = start;
+	do
+	{
+		if ( 0 == p->z ) { p->z = ZOrder( p->x, p->y ); }
+		p->prevZ = p->prev;
+		p->nextZ = p->next;
+		p = p->next;
+	}
+	while ( p != start );
 
-			// true names of the vertices
-			a = V[u]; b = V[v]; c = V[w];
+	p->prevZ->nextZ = NULL;
+	p->prevZ = NULL;
 
-			// output Triangle
-			result.Append( contour[a] ); bounds.Union( contour[a] );
-			result.Append( contour[b] ); bounds.Union( contour[b] );
-			result.Append( contour[c] ); bounds.Union( contour[c] );
+	SortLinked( p );
+}
 
-            if (triangulationIndices)
-            {
-                triangulationIndices->Append( a );
-                triangulationIndices->Append( b );
-                triangulationIndices->Append( c );
-            }
+// Simon Tatham's linked list merge sort algorithm
+Triangulate::Node*
+Triangulate::SortLinked( Node *list )
+{
+	S32 numMerges;
+	S32 inSize = 1;
 
-			m++;
+	do
+	{
+		Node *p = list;
+		Node *tail = NULL;
+		list = NULL;
+		numMerges = 0;
 
-			// remove v from remaining polygon
-			for ( s = v, t = v+1; t < nv; s++, t++ )
+		while ( p )
+		{
+			numMerges++;
+
+			Node *q = p;
+			S32 pSize = 0;
+			for ( S32 i = 0; i < inSize; i++ )
 			{
-				V[s] = V[t];
+				pSize++;
+				q = q->nextZ;
+				if ( ! q ) { break; }
 			}
-			nv--;
 
-			// resest error detection counter
-			count = 2*nv;
+			S32 qSize = inSize;
+
+			while ( pSize > 0 || ( qSize > 0 && q ) )
+			{
+				Node *e;
+				if ( pSize != 0 && ( qSize == 0 || ! q || p->z <= q->z ) )
+				{
+					e = p;
+					p = p->nextZ;
+					pSize--;
+				}
+				else
+				{
+					e = q;
+					q = q->nextZ;
+					qSize--;
+				}
+
+				if ( tail ) { tail->nextZ = e; }
+				else { list = e; }
+
+				e->prevZ = tail;
+				tail = e;
+			}
+
+			p = q;
 		}
+
+		tail->nextZ = NULL;
+		inSize *= 2;
 	}
+	while ( numMerges > 1 );
 
-	delete [] V;
+	return list;
+}
 
-	return true;
+// Grid cell of a coordinate. Hole vertices may lie outside the outer
+// bounds, so they are clamped into the grid (NaN goes to 0).
+static U32
+ZOrderCell( double value )
+{
+	if ( ! ( value > 0.0 ) ) { return 0; }
+	if ( value > 32767.0 ) { return 32767; }
+	return (U32)value;
+}
+
+// z-order of a point given coords and inverse of the longer side of the
+// data bbox
+U32
+Triangulate::ZOrder( double x, double y ) const
+{
+	// Coords are transformed into non-negative 15-bit integer range
+	U32 ix = ZOrderCell( ( x - fMinX ) * fInvSize );
+	U32 iy = ZOrderCell( ( y - fMinY ) * fInvSize );
+
+	ix = ( ix | ( ix << 8 ) ) & 0x00FF00FF;
+	ix = ( ix | ( ix << 4 ) ) & 0x0F0F0F0F;
+	ix = ( ix | ( ix << 2 ) ) & 0x33333333;
+	ix = ( ix | ( ix << 1 ) ) & 0x55555555;
+
+	iy = ( iy | ( iy << 8 ) ) & 0x00FF00FF;
+	iy = ( iy | ( iy << 4 ) ) & 0x0F0F0F0F;
+	iy = ( iy | ( iy << 2 ) ) & 0x33333333;
+	iy = ( iy | ( iy << 1 ) ) & 0x55555555;
+
+	return ix | ( iy << 1 );
+}
+
+void
+Triangulate::AppendTriangle( const Node *a, const Node *b, const Node *c )
+{
+	fTriangles.Append( a->i );
+	fTriangles.Append( b->i );
+	fTriangles.Append( c->i );
+}
+
+double
+Triangulate::SignedArea( const ArrayVertex2 &contour, S32 start, S32 end )
+{
+	double sum = 0.0;
+	for ( S32 i = start, j = end - 1; i < end; j = i++ )
+	{
+		sum += ( (double)contour[j].x - contour[i].x ) * ( (double)contour[i].y + contour[j].y );
+	}
+	return sum;
+}
+
+// Signed area of a triangle
+double
+Triangulate::Area( const Node *p, const Node *q, const Node *r )
+{
+	return ( q->y - p->y ) * ( r->x - q->x ) - ( q->x - p->x ) * ( r->y - q->y );
+}
+
+bool
+Triangulate::Equals( const Node *p1, const Node *p2 )
+{
+	return p1->x == p2->x && p1->y == p2->y;
+}
+
+// Check if a point lies within a convex triangle
+bool
+Triangulate::PointInTriangle(
+	double ax, double ay, double bx, double by, double cx, double cy, double px, double py )
+{
+	return ( cx - px ) * ( ay - py ) >= ( ax - px ) * ( cy - py )
+		&& ( ax - px ) * ( by - py ) >= ( bx - px ) * ( ay - py )
+		&& ( bx - px ) * ( cy - py ) >= ( cx - px ) * ( by - py );
+}
+
+// Check if p is a reflex vertex inside the ear a-b-c, whose bounds are (x0,y0)-(x1,y1)
+bool
+Triangulate::BlocksEar(
+	const Node *p, const Node *a, const Node *b, const Node *c,
+	double x0, double y0, double x1, double y1 )
+{
+	return p != a && p != c
+		&& p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1
+		&& PointInTriangle( a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y )
+		&& Area( p->prev, p, p->next ) >= 0.0;
+}
+
+static int
+Sign( double value )
+{
+	return ( value > 0.0 ? 1 : ( value < 0.0 ? -1 : 0 ) );
+}
+
+// Check if two segments intersect
+bool
+Triangulate::Intersects( const Node *p1, const Node *q1, const Node *p2, const Node *q2 )
+{
+	int o1 = Sign( Area( p1, q1, p2 ) );
+	int o2 = Sign( Area( p1, q1, q2 ) );
+	int o3 = Sign( Area( p2, q2, p1 ) );
+	int o4 = Sign( Area( p2, q2, q1 ) );
+
+	if ( o1 != o2 && o3 != o4 ) { return true; } // general case
+
+	if ( o1 == 0 && OnSegment( p1, p2, q1 ) ) { return true; } // p1, q1 and p2 are collinear and p2 lies on p1q1
+	if ( o2 == 0 && OnSegment( p1, q2, q1 ) ) { return true; } // p1, q1 and q2 are collinear and q2 lies on p1q1
+	if ( o3 == 0 && OnSegment( p2, p1, q2 ) ) { return true; } // p2, q2 and p1 are collinear and p1 lies on p2q2
+	if ( o4 == 0 && OnSegment( p2, q1, q2 ) ) { return true; } // p2, q2 and q1 are collinear and q1 lies on p2q2
+
+	return false;
+}
+
+// For collinear points p, q, r, check if point q lies on segment pr
+bool
+Triangulate::OnSegment( const Node *p, const Node *q, const Node *r )
+{
+	return q->x <= Max( p->x, r->x ) && q->x >= Min( p->x, r->x )
+		&& q->y <= Max( p->y, r->y ) && q->y >= Min( p->y, r->y );
+}
+
+// Check if a polygon diagonal intersects any polygon segments
+bool
+Triangulate::IntersectsPolygon( const Node *a, const Node *b )
+{
+	const Node *p = a;
+	do
+	{
+		if ( p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i
+			 && Intersects( p, p->next, a, b ) )
+		{
+			return true;
+		}
+		p = p->next;
+	}
+	while ( p != a );
+
+	return false;
+}
+
+// Check if a polygon diagonal is locally inside the polygon
+bool
+Triangulate::LocallyInside( const Node *a, const Node *b )
+{
+	return Area( a->prev, a, a->next ) < 0.0
+		? Area( a, b, a->next ) >= 0.0 && Area( a, a->prev, b ) >= 0.0
+		: Area( a, b, a->prev ) < 0.0 || Area( a, a->next, b ) < 0.0;
+}
+
+// Check if the middle point of a polygon diagonal is inside the polygon
+bool
+Triangulate::MiddleInside( const Node *a, const Node *b )
+{
+	const Node *p = a;
+	bool inside = false;
+	double px = ( a->x + b->x ) * 0.5;
+	double py = ( a->y + b->y ) * 0.5;
+	do
+	{
+		if ( ( ( p->y > py ) != ( p->next->y > py ) ) && p->next->y != p->y
+			 && ( px < ( p->next->x - p->x ) * ( py - p->y ) / ( p->next->y - p->y ) + p->x ) )
+		{
+			inside = ! inside;
+		}
+		p = p->next;
+	}
+	while ( p != a );
+
+	return inside;
+}
+
+// Check if a diagonal between two polygon nodes is valid (lies in polygon interior)
+bool
+Triangulate::IsValidDiagonal( const Node *a, const Node *b )
+{
+	return a->next->i != b->i && a->prev->i != b->i && ! IntersectsPolygon( a, b ) // doesn't intersect other edges
+		&& ( ( LocallyInside( a, b ) && LocallyInside( b, a ) && MiddleInside( a, b ) // locally visible
+			   && ( 0.0 != Area( a->prev, a, b->prev ) || 0.0 != Area( a, b->prev, b ) ) ) // does not create opposite-facing sectors
+			 || ( Equals( a, b ) && Area( a->prev, a, a->next ) > 0.0 && Area( b->prev, b, b->next ) > 0.0 ) ); // special zero-length case
+}
+
+// Whether sector in vertex m contains sector in vertex p in the same coordinates
+bool
+Triangulate::SectorContainsSector( const Node *m, const Node *p )
+{
+	return Area( m->prev, m, p->prev ) < 0.0 && Area( p->next, m, m->next ) < 0.0;
+}
+
+// Find the leftmost node of a polygon ring
+Triangulate::Node*
+Triangulate::GetLeftmost( Node *start )
+{
+	Node *p = start;
+	Node *leftmost = start;
+	do
+	{
+		if ( p->x < leftmost->x || ( p->x == leftmost->x && p->y < leftmost->y ) )
+		{
+			leftmost = p;
+		}
+		p = p->next;
+	}
+	while ( p != start );
+
+	return leftmost;
 }
 
 // ----------------------------------------------------------------------------
@@ -201,13 +953,16 @@ Triangulate::Process( const ArrayVertex2 &contour, ArrayVertex2 &result, Rect& b
 TesselatorPolygon::TesselatorPolygon( Rtt_Allocator *allocator )
 :	Super(),
 	fContour( allocator ),
+	fHoles( allocator ),
+	fTriangles( allocator ),
 	fFill( allocator ),
 	fSelfBounds(),
 	fCenter( kVertexOrigin ),
+	fVertexOffset( kVertexOrigin ),
+	fIsTriangulationValid( false ),
 	fIsFillValid( false ),
 	fIsBadPolygon( false ),
-    fTriangulationIndices( NULL ),
-	fFillCount( -1 )
+	fTriangulationIndices( NULL )
 {
 }
 
@@ -270,11 +1025,39 @@ TesselatorPolygon::GenerateFillTexture( ArrayVertex2& texCoords, const Transform
 void
 TesselatorPolygon::GenerateStroke( ArrayVertex2& vertices )
 {
-	TesselatorLine t( fContour, TesselatorLine::kLoopMode );
-	t.SetInnerWidth( GetInnerWidth() );
-	t.SetOuterWidth( GetOuterWidth() );
+	if ( fHoles.Length() == 0 )
+	{
+		TesselatorLine t( fContour, TesselatorLine::kLoopMode );
+		t.SetInnerWidth( GetInnerWidth() );
+		t.SetOuterWidth( GetOuterWidth() );
 
-	t.GenerateStroke( vertices );
+		t.GenerateStroke( vertices );
+		return;
+	}
+
+	// Stroke each ring, joining the strips with degenerate triangles
+	ArrayVertex2 ring( fContour.Allocator() );
+	for ( S32 i = 0, iMax = GetRingCount(); i < iMax; i++ )
+	{
+		GetRing( i, ring );
+
+		TesselatorLine t( ring, TesselatorLine::kLoopMode );
+		t.SetInnerWidth( GetInnerWidth() );
+		t.SetOuterWidth( GetOuterWidth() );
+
+		S32 start = vertices.Length();
+		if ( start > 0 )
+		{
+			vertices.Append( vertices[start - 1] );
+		}
+
+		t.GenerateStroke( vertices );
+
+		if ( start > 0 && vertices.Length() > start + 1 )
+		{
+			vertices.Append( vertices[start + 1] );
+		}
+	}
 }
 
 void
@@ -293,36 +1076,77 @@ TesselatorPolygon::GetFillPrimitive() const
 U32
 TesselatorPolygon::FillVertexCount() const
 {
-	if ( -1 == fFillCount )
-	{
-		TesselatorPolygon dummy( fContour.Allocator() );
+	// The fill is cached, so computing it here is not wasted
+	const_cast< TesselatorPolygon * >( this )->Update();
 
-		dummy.fContour.Reserve( fContour.Length() );
+	return fFill.Length();
+}
 
-		for (int i = 0, iMax = fContour.Length(); i < iMax; ++i)
-		{
-			dummy.fContour.Append( fContour[i] );
-		}
+U32
+TesselatorPolygon::StrokeVertexCount() const
+{
+	if ( fHoles.Length() == 0 )
+	{
+		return TesselatorLine::VertexCountFromPoints( fContour, true );
+	}
 
-		dummy.Update();
+	// See GenerateStroke()
+	U32 result = 0;
+	for ( S32 i = 0, iMax = GetRingCount(); i < iMax; i++ )
+	{
+		S32 start, end;
+		GetRingRange( i, start, end );
 
-		fFillCount = S32( dummy.fFill.Length() );
+		result += TesselatorLine::VertexCountFromPoints( end - start, true ) + ( i > 0 ? 2 : 0 );
 	}
 
-	return U32( fFillCount );
+	return result;
 }
 
-U32
-TesselatorPolygon::StrokeVertexCount() const
+void
+TesselatorPolygon::Invalidate()
 {
-	return TesselatorLine::VertexCountFromPoints( fContour, true );
+	fIsTriangulationValid = false;
+	fIsFillValid = false;
+	fIsBadPolygon = false;
 }
 
 void
-TesselatorPolygon::Invalidate()
+TesselatorPolygon::InvalidatePositions()
 {
 	fIsFillValid = false;
-	fIsBadPolygon = false;
+}
+
+void
+TesselatorPolygon::GetRing( S32 index, ArrayVertex2& outRing ) const
+{
+	S32 start, end;
+	GetRingRange( index, start, end );
+
+	outRing.Clear();
+	outRing.Reserve( end - start );
+	for ( S32 i = start; i < end; i++ )
+	{
+		outRing.Append( fContour[i] );
+	}
+}
+
+void
+TesselatorPolygon::GetRingRange( S32 index, S32& outStart, S32& outEnd ) const
+{
+	Rtt_ASSERT( index >= 0 && index < GetRingCount() );
+
+	outStart = ( index > 0 ? fHoles[index - 1] : 0 );
+	outEnd = ( index < fHoles.Length() ? fHoles[index] : fContour.Length() );
+}
+
+void
+TesselatorPolygon::SetTriangulationArray( ArrayIndex * triangulationIndices )
+{
+	fTriangulationIndices = triangulationIndices;
+
+	// Re-gather the fill so the indices are filled in
+	fIsFillValid = false;
 }
 
 void
@@ -334,17 +1158,41 @@ TesselatorPolygon::Update()
 		 && ! fIsBadPolygon )
 	{
 		fSelfBounds.SetEmpty();
+		fFill.Clear();
 
-        if (fTriangulationIndices)
-        {
-            fTriangulationIndices->Clear();
-        }
+		if (fTriangulationIndices)
+		{
+			fTriangulationIndices->Clear();
+		}
+
+		// Triangulation only depends on the topology, so moved points
+		// (see InvalidatePositions()) reuse the cached triangles.
+		if ( ! fIsTriangulationValid )
+		{
+			fTriangles.Clear();
+			fIsTriangulationValid = Triangulate::Process( fContour.Allocator(), fContour, fHoles, fTriangles );
+		}
 
-		fIsFillValid = Triangulate::Process( fContour, fFill, fSelfBounds, fTriangulationIndices );
+		fIsFillValid = fIsTriangulationValid;
 		fIsBadPolygon = ! fIsFillValid;
 
 		if ( fIsFillValid )
 		{
+			fFill.Reserve( fTriangles.Length() );
+			for ( S32 i = 0, iMax = fTriangles.Length(); i < iMax; i++ )
+			{
+				S32 index = fTriangles[i];
+				const Vertex2& v = fContour[index];
+
+				fFill.Append( v );
+				fSelfBounds.Union( v );
+
+				if ( fTriangulationIndices )
+				{
+					fTriangulationIndices->Append( index );
+				}
+			}
+
 			// Center vertices about the origin
 			Vertex2 center;
 			fSelfBounds.GetCenter( center );
@@ -354,7 +1202,7 @@ TesselatorPolygon::Update()
 		else
 		{
 			// Failure case
-			Rtt_TRACE_SIM( ( "WARNING: Polygon could not be generated. The polygon outline is invalid, possibly due to holes or self-intersection.\n" ) );
+			Rtt_TRACE_SIM( ( "WARNING: Polygon could not be generated. The polygon outline is invalid, possibly due to self-intersection.\n" ) );
 			fFill.Empty();
 			fSelfBounds.SetEmpty();
 		}
@@ -44,23 +44,42 @@ class TesselatorPolygon : public TesselatorShape
 		// Call when the contour has changed
 		void Invalidate();
 
+		// Call when contour points have moved, but none were added or removed.
+		// The cached triangulation is reused.
+		void InvalidatePositions();
+
+		// The outer ring, followed by any hole rings
 		ArrayVertex2& GetContour() { return fContour; }
-    
-        void SetTriangulationArray( ArrayIndex * triangulationIndices ) { fTriangulationIndices = triangulationIndices; }
+
+		// Start of each hole ring in the contour, in ascending order
+		ArrayS32& GetHoles() { return fHoles; }
+
+		S32 GetRingCount() const { return fHoles.Length() + 1; }
+		void GetRing( S32 index, ArrayVertex2& outRing ) const;
+
+		const Vertex2& GetVertexOffset() const { return fVertexOffset; }
+		void SetVertexOffset( const Vertex2& offset ) { fVertexOffset = offset; }
+
+		void SetTriangulationArray( ArrayIndex * triangulationIndices );
 
 	protected:
 		// Update the polygons
 		void Update();
 
+		void GetRingRange( S32 index, S32& outStart, S32& outEnd ) const;
+
 	private:
 		ArrayVertex2 fContour;
+		ArrayS32 fHoles;
+		ArrayS32 fTriangles; // cache the triangulation (3 contour indices per triangle)
 		ArrayVertex2 fFill; // cache the fill
 		Rect fSelfBounds;
 		Vertex2 fCenter;
+		Vertex2 fVertexOffset;
+		bool fIsTriangulationValid;
 		bool fIsFillValid;
 		bool fIsBadPolygon;
-        ArrayIndex * fTriangulationIndices;
-		mutable S32 fFillCount;
+		ArrayIndex * fTriangulationIndices;
 };
 
 // ----------------------------------------------------------------------------
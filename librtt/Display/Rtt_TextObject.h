@@ -71,6 +71,10 @@ class TextObject : public RectObject
 		TextObject( Display& display, const char text[], PlatformFont *font, Real w, Real h, const char alignment[] );
 		virtual ~TextObject();
 
+	protected:
+		// Text snaps its content-space vertices to pixels
+		virtual bool CanTransformOnGPU() const { return false; }
+
 	protected:
 		bool Initialize();
 		void UpdateScaledFont();
@@ -45,7 +45,11 @@ TextureFactory::TextureFactory( Display& display )
 	fVideo(),
 	fVideoSource(kCamera),
 	fTextureMemoryUsed( 0 ),
-	fCreateQueue( display.GetAllocator() )
+	fCreateQueue( display.GetAllocator() ),
+	fRenderTargetPool( * this ),
+	fRecentlyUsed(),
+	fRecentlyUsedIndex(),
+	fMemoryBudget( 0 )
 {
 }
 
@@ -286,6 +290,15 @@ TextureFactory::FindOrCreate(
 		}
 	}
 
+	// Only images in the read-only resource directories are kept: files in
+	// Documents or Temporary can be rewritten (display.save, network.download)
+	// under the same path, and must then be loaded again
+	bool isReadOnly = ( MPlatform::kResourceDir == baseDir || MPlatform::kSystemResourceDir == baseDir );
+	if ( fMemoryBudget > 0 && isReadOnly && result.NotNull() )
+	{
+		MarkRecentlyUsed( key, result );
+	}
+
 	return result;
 }
 
@@ -492,6 +505,17 @@ TextureFactory::Create(
 		* this, w, h, format, filter, wrap, save_to_file ) );
 }
 
+SharedPtr< TextureResource >
+TextureFactory::CreateRenderTarget(
+	int w, int h,
+	Texture::Format format,
+	Texture::Filter filter,
+	Texture::Wrap wrap )
+{
+	return SharedPtr< TextureResource >( TextureResourceBitmap::CreateRenderTarget(
+		* this, w, h, format, filter, wrap ) );
+}
+
 SharedPtr< TextureResource >
 TextureFactory::Create(
 	const char *str,
@@ -544,6 +568,79 @@ TextureFactory::WillRemoveTexture( const TextureResource& resource )
 }
 
 
+void
+TextureFactory::SetMemoryBudget( size_t numBytes )
+{
+	fMemoryBudget = numBytes;
+
+	if ( 0 == numBytes )
+	{
+		fRecentlyUsedIndex.clear();
+		fRecentlyUsed.clear();
+	}
+}
+
+size_t
+TextureFactory::GetCachedTextureMemory() const
+{
+	size_t result = 0;
+	for ( RecentlyUsedList::const_iterator iter = fRecentlyUsed.begin(); iter != fRecentlyUsed.end(); ++iter )
+	{
+		const SharedPtr< TextureResource >& resource = iter->second;
+		if ( 1 == resource.GetStrongCount() )
+		{
+			result += resource->GetTexture().GetSizeInBytes();
+		}
+	}
+	return result;
+}
+
+size_t
+TextureFactory::Trim( size_t numBytes )
+{
+	size_t result = 0;
+
+	for ( RecentlyUsedList::iterator iter = fRecentlyUsed.begin();
+		  iter != fRecentlyUsed.end() && result < numBytes; )
+	{
+		const SharedPtr< TextureResource >& resource = iter->second;
+		if ( 1 == resource.GetStrongCount() )
+		{
+			// Last reference, so this releases the texture
+			result += resource->GetTexture().GetSizeInBytes();
+			fRecentlyUsedIndex.erase( iter->first );
+			iter = fRecentlyUsed.erase( iter );
+		}
+		else
+		{
+			++iter;
+		}
+	}
+
+	if ( result < numBytes )
+	{
+		result += fRenderTargetPool.Trim( numBytes - result );
+	}
+
+	return result;
+}
+
+void
+TextureFactory::MarkRecentlyUsed( const std::string& key, const SharedPtr< TextureResource >& resource )
+{
+	std::map< std::string, RecentlyUsedList::iterator >::iterator element = fRecentlyUsedIndex.find( key );
+	if ( element != fRecentlyUsedIndex.end() )
+	{
+		// Move to the end (MRU)
+		fRecentlyUsed.splice( fRecentlyUsed.end(), fRecentlyUsed, element->second );
+	}
+	else
+	{
+		fRecentlyUsed.push_back( std::make_pair( key, resource ) );
+		fRecentlyUsedIndex[key] = --fRecentlyUsed.end();
+	}
+}
+
 SharedPtr< TextureResource >
 TextureFactory::FindOrCreateCanvas(const std::string &cacheKey,
 								Real width, Real height,
@@ -561,6 +658,10 @@ TextureFactory::FindOrCreateCanvas(const std::string &cacheKey,
 	
 	fCache[cacheKey] = CacheEntry( result );
 	result->SetCacheKey(cacheKey);
+
+	// The target may come from the pool with another user's pixels in it,
+	// so clear it on the first frame rather than waiting for invalidate()
+	resource->Invalidate( false, true );
 	
 	
 	return result;
@@ -635,6 +736,13 @@ void TextureFactory::Release( const std::string &key )
 	
 void TextureFactory::ReleaseByType( TextureResource::TextureResourceType type)
 {
+	// Cached image textures go too. All of them are bitmaps.
+	if ( TextureResource::kTextureResource_Any == type || TextureResource::kTextureResourceBitmap == type )
+	{
+		fRecentlyUsedIndex.clear();
+		fRecentlyUsed.clear();
+	}
+
 	if ( TextureResource::kTextureResource_Any == type )
 	{
 		fOwnedTextures.clear();
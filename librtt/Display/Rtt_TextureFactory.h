@@ -13,9 +13,11 @@
 #include "Core/Rtt_SharedPtr.h"
 #include "Renderer/Rtt_Texture.h"
 #include "Renderer/Rtt_VideoSource.h"
+#include "Display/Rtt_RenderTargetPool.h"
 #include "Display/Rtt_TextureResource.h"
 
 #include <string>
+#include <list>
 #include <map>
 #include <set>
 
@@ -100,6 +102,14 @@ class TextureFactory
 			Texture::Wrap wrap,
 			bool save_to_file );
 
+		// The texture comes with a framebuffer (see TextureResource::GetRenderTarget())
+		// that is recycled through the RenderTargetPool. Contents are undefined.
+		SharedPtr< TextureResource > CreateRenderTarget(
+			int w, int h,
+			Texture::Format format,
+			Texture::Filter filter,
+			Texture::Wrap wrap );
+
 		SharedPtr< TextureResource > Create(
 			const char *str,
 			const PlatformFont& font,
@@ -122,7 +132,31 @@ class TextureFactory
 
 		void DidAddTexture( const TextureResource& resource );
 		void WillRemoveTexture( const TextureResource& resource );
-		S32 GetTextureMemoryUsed() const { return fTextureMemoryUsed; }
+		S32 GetTextureMemoryUsed() const { return fTextureMemoryUsed + (S32)fRenderTargetPool.GetBytesAllocated(); }
+
+		// Offscreen targets shared by snapshots, canvases, captures and
+		// effect graphs (see ShaderComposite)
+		RenderTargetPool& GetRenderTargetPool() { return fRenderTargetPool; }
+
+	// Memory budget
+	//
+	// With a non-zero budget, image textures from the resource directory stay
+	// cached after their last user lets go, so scenes that are rebuilt don't
+	// decode their images again. Trim() evicts such unreferenced textures least recently used
+	// first, then free render targets, to bring usage back under budget.
+	public:
+		void SetMemoryBudget( size_t numBytes );
+		size_t GetMemoryBudget() const { return fMemoryBudget; }
+
+		// Texture bytes held only by the cache of unreferenced textures
+		size_t GetCachedTextureMemory() const;
+
+		// Frees unreferenced textures and free render targets until at least
+		// numBytes are freed or nothing evictable is left. Returns the bytes freed.
+		size_t Trim( size_t numBytes );
+
+	protected:
+		void MarkRecentlyUsed( const std::string& key, const SharedPtr< TextureResource >& resource );
 
 	protected:
 		class CacheEntry
@@ -179,7 +213,14 @@ class TextureFactory
 		VideoSource fVideoSource;
 		
 		S32 fTextureMemoryUsed;
-		
+
+		RenderTargetPool fRenderTargetPool;
+
+		// Image textures in use order, least recent first
+		typedef std::list< std::pair< std::string, SharedPtr< TextureResource > > > RecentlyUsedList;
+		RecentlyUsedList fRecentlyUsed;
+		std::map< std::string, RecentlyUsedList::iterator > fRecentlyUsedIndex;
+		size_t fMemoryBudget;
 };
 
 // ----------------------------------------------------------------------------
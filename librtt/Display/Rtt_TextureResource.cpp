@@ -14,6 +14,7 @@
 #include "Rtt_TextureFactory.h"
 #include "Rtt_Display.h"
 #include "Rtt_Scene.h"
+#include "Renderer/Rtt_FrameBufferObject.h"
 
 // ----------------------------------------------------------------------------
 
@@ -24,6 +25,7 @@ namespace Rtt
 TextureResource::TextureResource(TextureFactory &factory, Texture *texture,  PlatformBitmap *bitmap, TextureResourceType type)
 	: fFactory(factory)
 	, fTexture(texture)
+	, fRenderTarget(NULL)
 	, fBitmap(bitmap)
 	, fType(type)
 	, fProxy(NULL)
@@ -33,15 +35,33 @@ TextureResource::TextureResource(TextureFactory &factory, Texture *texture,  Pla
 		fFactory.DidAddTexture( (TextureResource&)* this );
 	}
 }
+
+// Pooled targets count towards texture memory through the pool
+TextureResource::TextureResource(TextureFactory &factory, FrameBufferObject *target, TextureResourceType type)
+	: fFactory(factory)
+	, fTexture(target->GetTexture())
+	, fRenderTarget(target)
+	, fBitmap(NULL)
+	, fType(type)
+	, fProxy(NULL)
+{
+}
 	
 TextureResource::~TextureResource()
 {
-	if (fTexture)
+	if (fRenderTarget)
+	{
+		fFactory.GetRenderTargetPool().Release( fRenderTarget );
+	}
+	else
 	{
-		fFactory.WillRemoveTexture( (TextureResource&)* this );
+		if (fTexture)
+		{
+			fFactory.WillRemoveTexture( (TextureResource&)* this );
+		}
+		fFactory.QueueRelease( fTexture );
 	}
 	Rtt_DELETE( fBitmap );
-	fFactory.QueueRelease( fTexture );
 
 	if ( fProxy )
 	{
@@ -27,6 +27,7 @@ class MLuaUserdataAdapter;
 class LuaUserdataProxy;
 class TextureFactory;
 class PlatformBitmap;
+class FrameBufferObject;
 // ----------------------------------------------------------------------------
 
 class TextureResource
@@ -45,6 +46,10 @@ class TextureResource
 	
 	protected:
 		TextureResource(TextureFactory &factory, Texture *texture,  PlatformBitmap *bitmap, TextureResourceType type);
+
+		// The texture is that of 'target', which was acquired from the factory's
+		// RenderTargetPool and goes back to it with the resource
+		TextureResource(TextureFactory &factory, FrameBufferObject *target, TextureResourceType type);
 	public:
 
 		static PlatformBitmap::Format ConvertFormat( Texture::Format );
@@ -59,6 +64,9 @@ class TextureResource
 		Texture& GetTexture() { return *fTexture; }
 		const Texture& GetTexture() const { return *fTexture; }
 
+		// Non-NULL if the texture belongs to a pooled render target
+		FrameBufferObject *GetRenderTarget() const { return fRenderTarget; }
+
 		virtual void Render(Renderer &renderer){};
 		virtual void Teardown(){};
 		virtual void ReleaseLuaReferences( lua_State *L ) {};
@@ -90,6 +98,7 @@ class TextureResource
 		std::string fCacheKey;
 		TextureFactory &fFactory;
 		Texture *fTexture;
+		FrameBufferObject *fRenderTarget;
 		PlatformBitmap *fBitmap;
 		TextureResourceType fType;
 		mutable LuaUserdataProxy *fProxy;
@@ -96,6 +96,22 @@ TextureResourceBitmap::CreateVideo(TextureFactory& factory)
 		
 	return result;
 }
+
+TextureResourceBitmap *
+TextureResourceBitmap::CreateRenderTarget(
+	TextureFactory& factory,
+	int w, int h,
+	Texture::Format format,
+	Texture::Filter filter,
+	Texture::Wrap wrap )
+{
+	FrameBufferObject *target = factory.GetRenderTargetPool().Acquire( w, h, format, filter, wrap );
+
+	TextureResourceBitmap *result =
+		Rtt_NEW( factory.GetDisplay().GetAllocator(), TextureResourceBitmap( factory, target ) );
+
+	return result;
+}
 			
 /*
 static Texture::Filter
@@ -202,6 +218,14 @@ TextureResourceBitmap::TextureResourceBitmap(
 
 }
 
+TextureResourceBitmap::TextureResourceBitmap(
+	TextureFactory &factory,
+	FrameBufferObject *target )
+	: TextureResource(factory, target, kTextureResourceBitmap)
+{
+
+}
+
 TextureResourceBitmap::~TextureResourceBitmap()
 {
 }
@@ -51,6 +51,13 @@ class TextureResourceBitmap : public TextureResource
 			
 		static Self *CreateVideo(
 			TextureFactory& factory);
+
+		static Self *CreateRenderTarget(
+			TextureFactory& factory,
+			int w, int h,
+			Texture::Format format,
+			Texture::Filter filter,
+			Texture::Wrap wrap );
 	
 	protected:
 		TextureResourceBitmap(
@@ -60,6 +67,9 @@ class TextureResourceBitmap : public TextureResource
 			TextureFactory &factory,
 			Texture *texture,
 			PlatformBitmap *bitmap );
+		TextureResourceBitmap(
+			TextureFactory &factory,
+			FrameBufferObject *target );
 
 	public:
 		virtual ~TextureResourceBitmap();
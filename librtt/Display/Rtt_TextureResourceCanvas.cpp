@@ -23,7 +23,6 @@
 namespace Rtt {
 	
 TextureResourceCanvas::TextureResourceCanvas(TextureFactory &factory,
-											 Texture *texture,
 											 FrameBufferObject* fbo,
 											 GroupObject *cache,
 											 GroupObject *queue,
@@ -31,7 +30,7 @@ TextureResourceCanvas::TextureResourceCanvas(TextureFactory &factory,
 											 Real height,
 											 int texWidth,
 											 int texHeight)
-: TextureResource(factory, texture, NULL, kTextureResourceCanvas)
+: TextureResource(factory, fbo, kTextureResourceCanvas)
 , fDstFBO(fbo)
 , fContentWidth(width)
 , fContentHeight(height)
@@ -52,8 +51,6 @@ TextureResourceCanvas* TextureResourceCanvas::Create(Rtt::TextureFactory &factor
 {
 	Display &display = factory.GetDisplay();
 	
-	Rtt_Allocator* pAllocator = display.GetAllocator();
-	
 	Texture::Filter filter = RenderTypes::Convert( display.GetDefaults().GetMagTextureFilter() );
 	Texture::Wrap wrap = RenderTypes::Convert( display.GetDefaults().GetTextureWrapX() );
 
@@ -62,9 +59,6 @@ TextureResourceCanvas* TextureResourceCanvas::Create(Rtt::TextureFactory &factor
 		format = Texture::kRGBA;
 	}
 
-	Texture *texture = Rtt_NEW( pAllocator,
-							   TextureVolatile( display.GetAllocator(), texWidth, texHeight, format, filter, wrap, wrap ) );
-
 	/* TODO
 		fHasDepth = display.GetDefaults().GetAddDepthToResource();
 		fHasStencil = display.GetDefaults().GetAddStencilToResource();
@@ -73,22 +67,21 @@ TextureResourceCanvas* TextureResourceCanvas::Create(Rtt::TextureFactory &factor
 	 
 		TODO: add appropriate frame buffer resources...
 	 */	
-	FrameBufferObject * fbo = Rtt_NEW( pAllocator,
-									  FrameBufferObject( pAllocator, texture, nullptr ) );
+	FrameBufferObject * fbo = factory.GetRenderTargetPool().Acquire( texWidth, texHeight, format, filter, wrap );
 
-	GroupObject *cache = Rtt_NEW( pAllocator,
+	GroupObject *cache = Rtt_NEW( display.GetAllocator(),
 								 GroupObject(display.GetAllocator(), display.GetStageOffscreen() ) );
 	cache->SetRenderedOffScreen( true );
 	cache->SetHitTestable( false );
 	
-	GroupObject *queue = Rtt_NEW( pAllocator,
+	GroupObject *queue = Rtt_NEW( display.GetAllocator(),
 								 GroupObject(display.GetAllocator(), display.GetStageOffscreen() ) );
 	queue->SetRenderedOffScreen( true );
 	queue->SetHitTestable( false );
 
 	
 	
-	TextureResourceCanvas *ret = new TextureResourceCanvas(factory, texture, fbo, cache, queue, width, height, texWidth, texHeight);
+	TextureResourceCanvas *ret = new TextureResourceCanvas(factory, fbo, cache, queue, width, height, texWidth, texHeight);
 
 	
 	return ret;
@@ -96,7 +89,7 @@ TextureResourceCanvas* TextureResourceCanvas::Create(Rtt::TextureFactory &factor
 
 TextureResourceCanvas::~TextureResourceCanvas()
 {
-	GetTextureFactory().GetDisplay().GetStage()->QueueRelease(fDstFBO);
+	// fDstFBO goes back to the pool in ~TextureResource()
 	Rtt_DELETE( fGroupCache );
 	Rtt_DELETE( fGroupQueue );
 }
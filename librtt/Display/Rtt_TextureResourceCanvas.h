@@ -33,7 +33,6 @@ class TextureResourceCanvas : public TextureResource
 	protected:
 		TextureResourceCanvas(
 							  TextureFactory &factory,
-							  Texture *texture,
 							  FrameBufferObject* fbo,
 							  GroupObject *cache,
 							  GroupObject *qeue,
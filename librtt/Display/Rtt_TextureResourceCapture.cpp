@@ -22,13 +22,13 @@ namespace Rtt {
 	
 TextureResourceCapture::TextureResourceCapture(
 					  TextureFactory &factory,
-					  Texture *texture,
+					  FrameBufferObject* target,
 					  FrameBufferObject* fbo,
 					  Real width,
 					  Real height,
 					  int texWidth,
 					  int texHeight)
-: TextureResource(factory, texture, NULL, kTextureResourceCapture)
+: TextureResource(factory, target, kTextureResourceCapture)
 , fDstFBO(fbo)
 , fContentWidth(width)
 , fContentHeight(height)
@@ -46,34 +46,30 @@ TextureResourceCapture::Create(
 {
 	Display &display = factory.GetDisplay();
 	
-	Rtt_Allocator* pAllocator = display.GetAllocator();
-	
 	Texture::Filter filter = RenderTypes::Convert( display.GetDefaults().GetMagTextureFilter() );
 	// ^^ TODO: does this filter need to match the BlitFrameBuffer version?
 	Texture::Wrap wrap = RenderTypes::Convert( display.GetDefaults().GetTextureWrapX() );
 
-	Texture *texture = Rtt_NEW( pAllocator,
-							   TextureVolatile( display.GetAllocator(), texW, texH, Texture::kRGB, filter, wrap, wrap ) );
+	// The texture always comes from the pool. Its framebuffer is only used as
+	// a blit destination; otherwise the screen is copied into the texture.
+	FrameBufferObject * target = factory.GetRenderTargetPool().Acquire( texW, texH, Texture::kRGB, filter, wrap );
 
 	FrameBufferObject * fbo = NULL;
 	
 	if (display.HasFramebufferBlit( NULL ))
 	{
 		// TODO: extra options
-		fbo = Rtt_NEW( pAllocator, FrameBufferObject( pAllocator, texture ) );
+		fbo = target;
 	}
 	
-	TextureResourceCapture *ret = new TextureResourceCapture(factory, texture, fbo, w, h, texW, texH);
+	TextureResourceCapture *ret = new TextureResourceCapture(factory, target, fbo, w, h, texW, texH);
 	
 	return ret;
 }
 
 TextureResourceCapture::~TextureResourceCapture()
 {
-	if (fDstFBO)
-	{
-		GetTextureFactory().GetDisplay().GetStage()->QueueRelease(fDstFBO);
-	}
+	// fDstFBO goes back to the pool in ~TextureResource()
 }
 
 const MLuaUserdataAdapter&
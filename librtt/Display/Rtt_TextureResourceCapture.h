@@ -32,7 +32,7 @@ class TextureResourceCapture : public TextureResource
 	protected:
 		TextureResourceCapture(
 							  TextureFactory &factory,
-							  Texture *texture,
+							  FrameBufferObject* target,
 							  FrameBufferObject* fbo,
 							  Real width,
 							  Real height,
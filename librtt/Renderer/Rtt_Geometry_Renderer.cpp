@@ -17,6 +17,7 @@
 #include "Renderer/Rtt_FormatExtensionList.h"
 #include "Display/Rtt_DisplayTypes.h"
 #include "Renderer/Rtt_RenderTypes.h"
+#include "Renderer/Rtt_VertexKernels.h"
 
 #include "Corona/CoronaGraphics.h"
 
@@ -97,17 +98,13 @@ void Geometry::Vertex::SetPos(Real x_,
 void Geometry::Vertex::SetColor4ub(U32 vertexCount, Vertex* vertices,
     U8 r, U8 g, U8 b, U8 a)
 {
-    for (U32 i = 0;
-        i < vertexCount;
-        ++i)
-    {
-        Vertex& vert = vertices[i];
+    ColorUnion c;
+    c.rgba.r = r;
+    c.rgba.g = g;
+    c.rgba.b = b;
+    c.rgba.a = a;
 
-        vert.rs = r;
-        vert.gs = g;
-        vert.bs = b;
-        vert.as = a;
-    }
+    VertexKernels::FillColor(vertices, vertexCount, c.pixel);
 }
 
 void Geometry::Vertex::SetColor(U32 vertexCount, Vertex* vertices,
@@ -22,6 +22,7 @@
 #include "Renderer/Rtt_CPUResource.h"
 #include "Renderer/Rtt_Texture.h"
 #include "Renderer/Rtt_Uniform.h"
+#include "Renderer/Rtt_VertexKernels.h"
 #include "Core/Rtt_Allocator.h"
 #include "Core/Rtt_Assert.h"
 #include "Core/Rtt_Math.h"
@@ -137,7 +138,11 @@ Renderer::Statistics::Statistics()
     fGeometryBindCount( 0 ),
     fProgramBindCount( 0 ),
     fTextureBindCount( 0 ),
-    fUniformBindCount( 0 )
+    fUniformBindCount( 0 ),
+    fBitmapCacheHitCount( 0 ),
+    fBitmapCacheMissCount( 0 ),
+    fEffectPassCount( 0 ),
+    fEffectPassSkipCount( 0 )
 {
 }
 
@@ -457,6 +462,8 @@ Renderer::SetFrameBufferObject( FrameBufferObject* fbo )
         {
             QueueCreate( fbo );
         }
+
+        texture->IncrementVersion();
     }
     fBackCommandBuffer->BindFrameBufferObject( fbo );
     
@@ -1064,6 +1071,32 @@ Renderer::TallyTimeDependency( bool usesTime )
 	}
 }
 
+void
+Renderer::TallyBitmapCache( bool isHit )
+{
+	if ( isHit )
+	{
+		INCREMENT( fStatistics.fBitmapCacheHitCount );
+	}
+	else
+	{
+		INCREMENT( fStatistics.fBitmapCacheMissCount );
+	}
+}
+
+void
+Renderer::TallyEffectPass( bool isSkipped )
+{
+	if ( isSkipped )
+	{
+		INCREMENT( fStatistics.fEffectPassSkipCount );
+	}
+	else
+	{
+		INCREMENT( fStatistics.fEffectPassCount );
+	}
+}
+
 U16
 Renderer::AddCustomCommand( const CoronaCommand & command )
 {
@@ -1420,6 +1453,20 @@ Renderer::WriteGeometry( void* dstGeomComp, const void* srcGeom, U32 stride, U32
     Rtt_ASSERT( mask );
 }
 
+// True when no custom writers are installed, so vertices are plain copies
+bool
+Renderer::UsesCopyGeometryWriter() const
+{
+    if ( 1 != fGeometryWriters.Length() )
+    {
+        return false;
+    }
+
+    const GeometryWriter& writer = fGeometryWriters[0];
+
+    return GeometryWriter::CopyGeometryWriter().fWriter == writer.fWriter && GeometryWriter::kAll == writer.fMask && NULL == writer.fContext;
+}
+
 void
 Renderer::QueueUpdate( CPUResource* resource )
 {
@@ -2062,6 +2109,15 @@ Renderer::AddedUsesTime()
 void
 Renderer::MergeVertexData( Geometry::Vertex** destination, const Geometry::Vertex* mainSrc, const Geometry::Vertex* extensionSrc, int index, int extraCount )
 {
+    if ( UsesCopyGeometryWriter() )
+    {
+        VertexKernels::InterleaveVertices( *destination, mainSrc, extensionSrc, index, 1, extraCount );
+
+        *destination += 1 + extraCount;
+
+        return;
+    }
+
     WriteGeometry( *destination, mainSrc, sizeof(Geometry::Vertex), index );
 
     /* memcpy( *destination, &mainSrc[index], sizeof(Geometry::Vertex) ); */
@@ -2079,6 +2135,16 @@ void
 Renderer::MergeVertexDataRange( Geometry::Vertex** destination, Geometry* geometry, int count, int extraCount, int offset )
 {
     const Geometry::Vertex * mainSrc = geometry->GetVertexData(), * extensionSrc = geometry->GetExtendedVertexData();
+
+    // Without custom writers, skip the per-vertex writer dispatch
+    if ( UsesCopyGeometryWriter() )
+    {
+        VertexKernels::InterleaveVertices( *destination, mainSrc, extensionSrc, offset, count, extraCount );
+
+        *destination += count * ( 1 + extraCount );
+
+        return;
+    }
     
     for (int index = 0; index < count; ++index)
     {
@@ -210,6 +210,10 @@ class Renderer
             U32 fProgramBindCount;        // Number of Program bindings
             U32 fTextureBindCount;        // Number of Texture bindings
             U32 fUniformBindCount;        // Number of Uniform bindings
+            U32 fBitmapCacheHitCount;    // Number of bitmap caches drawn as-is
+            U32 fBitmapCacheMissCount;    // Number of bitmap caches re-rendered
+            U32 fEffectPassCount;        // Number of multipass effect nodes rendered
+            U32 fEffectPassSkipCount;    // Number of multipass effect nodes reused as-is
         };
 
         // Return true if statistics gathering is enabled. Disabled by default.
@@ -246,6 +250,12 @@ class Renderer
         // whether or not objects *on*screen need to be re-blitted
         void SetTimeDependencyCount( U32 newValue ) { fTimeDependencyCount = newValue; }
         U32 GetTimeDependencyCount() const { return fTimeDependencyCount; }
+
+        // Called each time a bitmap-cached group is drawn (see BitmapCache)
+        void TallyBitmapCache( bool isHit );
+
+        // Called for each intermediate node of a multipass effect (see Shader)
+        void TallyEffectPass( bool isSkipped );
     
         U16 AddStateBlock( const CoronaStateBlock & block );
         bool GetStateBlockInfo( U16 id, U8 *& start, U32 & size, bool mightDirty );
@@ -272,6 +282,7 @@ class Renderer
         
     protected:
 	    void WriteGeometry ( void * dstGeomComp, const void* srcGeom, U32 stride, U32 index, U32 count = 1, GeometryWriter::MaskBits validBits = GeometryWriter::kMain );
+	    bool UsesCopyGeometryWriter() const;
 
     protected:
         // Destroys all queued GPU resources passed into the DestroyQueue() method.
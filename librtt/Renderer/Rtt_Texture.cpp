@@ -21,7 +21,8 @@ namespace Rtt
 Texture::Texture( Rtt_Allocator* allocator )
 :	Super( allocator ),
 	fIsRetina( false ),
-	fIsTarget( false )
+	fIsTarget( false ),
+	fVersion( 0 )
 {
 }
 
@@ -35,6 +36,14 @@ Texture::GetType() const
 	return CPUResource::kTexture;
 }
 
+void
+Texture::Invalidate()
+{
+	IncrementVersion();
+
+	Super::Invalidate();
+}
+
 void 
 Texture::Allocate()
 {
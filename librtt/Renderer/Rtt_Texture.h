@@ -76,6 +76,7 @@ class Texture : public CPUResource
 		virtual ~Texture();
 
 		virtual ResourceType GetType() const;
+		virtual void Invalidate();
 		virtual void Allocate();
 		virtual void Deallocate();
 
@@ -101,9 +102,16 @@ class Texture : public CPUResource
 		void SetTarget( bool newValue ){ fIsTarget = newValue; }
 		bool IsTarget() const { return fIsTarget; }
 
+	public:
+		// Changes whenever the contents may have changed, i.e. on Invalidate()
+		// or when bound as a render target. Used to detect stale derived output.
+		U32 GetVersion() const { return fVersion; }
+		void IncrementVersion() { ++fVersion; }
+
 	private:
 		bool fIsRetina;
 		bool fIsTarget;
+		U32 fVersion;
 };
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,239 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Renderer/Rtt_VertexKernels.h"
+
+#include "Renderer/Rtt_RenderTypes.h"
+
+#if defined( Rtt_VERTEX_KERNELS_SSE2 )
+	#include <emmintrin.h>
+#elif defined( Rtt_VERTEX_KERNELS_NEON )
+	#include <arm_neon.h>
+#endif
+
+#include <stddef.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+namespace VertexKernels
+{
+
+// Vertex colors are 4 consecutive bytes, so they can be written as one U32
+Rtt_STATIC_ASSERT( offsetof( Geometry::Vertex, as ) == offsetof( Geometry::Vertex, rs ) + 3 );
+
+static inline void
+TransformPoint( const Real row0[3], const Real row1[3], Real *p )
+{
+	Real x = row0[2] + row0[0] * p[0];
+	x += row0[1] * p[1];
+
+	Real y = row1[2] + row1[0] * p[0];
+	y += row1[1] * p[1];
+
+	p[0] = x;
+	p[1] = y;
+}
+
+static inline U32
+ScaleColor( U32 color, const ColorUnion& scale )
+{
+	ColorUnion c;
+	c.pixel = color;
+
+	for ( int i = 0; i < 4; i++ )
+	{
+		c.channels[i] = (U8)( ( (U16)c.channels[i] * scale.channels[i] ) >> 8U );
+	}
+
+	return c.pixel;
+}
+
+// Vertices are 44 bytes and not 16-byte aligned, so whole registers are
+// moved unaligned and memcpy() copies the remainder
+static inline void
+CopyBytes( void *dst, const void *src, size_t numBytes )
+{
+	U8 *d = static_cast< U8 * >( dst );
+	const U8 *s = static_cast< const U8 * >( src );
+	size_t i = 0;
+
+#if defined( Rtt_VERTEX_KERNELS_SSE2 )
+	for ( ; i + 16 <= numBytes; i += 16 )
+	{
+		_mm_storeu_si128( reinterpret_cast< __m128i * >( d + i ), _mm_loadu_si128( reinterpret_cast< const __m128i * >( s + i ) ) );
+	}
+#elif defined( Rtt_VERTEX_KERNELS_NEON )
+	for ( ; i + 16 <= numBytes; i += 16 )
+	{
+		vst1q_u8( d + i, vld1q_u8( s + i ) );
+	}
+#endif
+
+	memcpy( d + i, s + i, numBytes - i );
+}
+
+void
+TransformPoints( const Real row0[3], const Real row1[3], Real *points, size_t stride, U32 count )
+{
+	U8 *p = reinterpret_cast< U8 * >( points );
+	U32 i = 0;
+
+#if defined( Rtt_VERTEX_KERNELS_SSE2 )
+	// Two points per register: (x0, y0, x1, y1)
+	const __m128 m0 = _mm_setr_ps( row0[0], row1[0], row0[0], row1[0] );
+	const __m128 m1 = _mm_setr_ps( row0[1], row1[1], row0[1], row1[1] );
+	const __m128 t = _mm_setr_ps( row0[2], row1[2], row0[2], row1[2] );
+
+	for ( ; i + 2 <= count; i += 2, p += 2 * stride )
+	{
+		__m64 *p0 = reinterpret_cast< __m64 * >( p );
+		__m64 *p1 = reinterpret_cast< __m64 * >( p + stride );
+
+		__m128 v = _mm_loadh_pi( _mm_loadl_pi( _mm_setzero_ps(), p0 ), p1 );
+		__m128 xs = _mm_shuffle_ps( v, v, _MM_SHUFFLE( 2, 2, 0, 0 ) );
+		__m128 ys = _mm_shuffle_ps( v, v, _MM_SHUFFLE( 3, 3, 1, 1 ) );
+		__m128 r = _mm_add_ps( _mm_add_ps( t, _mm_mul_ps( m0, xs ) ), _mm_mul_ps( m1, ys ) );
+
+		_mm_storel_pi( p0, r );
+		_mm_storeh_pi( p1, r );
+	}
+#elif defined( Rtt_VERTEX_KERNELS_NEON )
+	// One point per register, both rows at once
+	const Real c0[] = { row0[0], row1[0] };
+	const Real c1[] = { row0[1], row1[1] };
+	const Real c2[] = { row0[2], row1[2] };
+	const float32x2_t m0 = vld1_f32( c0 );
+	const float32x2_t m1 = vld1_f32( c1 );
+	const float32x2_t t = vld1_f32( c2 );
+
+	for ( ; i < count; i++, p += stride )
+	{
+		float32_t *pt = reinterpret_cast< float32_t * >( p );
+
+		float32x2_t v = vld1_f32( pt );
+		float32x2_t r = vadd_f32( vadd_f32( t, vmul_lane_f32( m0, v, 0 ) ), vmul_lane_f32( m1, v, 1 ) );
+
+		vst1_f32( pt, r );
+	}
+#endif
+
+	for ( ; i < count; i++, p += stride )
+	{
+		TransformPoint( row0, row1, reinterpret_cast< Real * >( p ) );
+	}
+}
+
+void
+FillColor( Geometry::Vertex *vertices, U32 count, U32 color )
+{
+	for ( U32 i = 0; i < count; i++ )
+	{
+		memcpy( & vertices[i].rs, & color, sizeof( color ) );
+	}
+}
+
+void
+ScaleColors( Geometry::Vertex *vertices, const U32 *colors, U32 count, U32 scale )
+{
+	U32 i = 0;
+
+	if ( ColorWhite() == scale )
+	{
+		for ( ; i < count; i++ )
+		{
+			memcpy( & vertices[i].rs, & colors[i], sizeof( U32 ) );
+		}
+
+		return;
+	}
+
+	U32 scaled[4];
+
+#if defined( Rtt_VERTEX_KERNELS_SSE2 )
+	// Widen 4 colors to 16 bits per channel, multiply, and narrow the high bytes
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i s16 = _mm_unpacklo_epi8( _mm_set1_epi32( (int)scale ), zero );
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128i c = _mm_loadu_si128( reinterpret_cast< const __m128i * >( colors + i ) );
+		__m128i lo = _mm_srli_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( c, zero ), s16 ), 8 );
+		__m128i hi = _mm_srli_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( c, zero ), s16 ), 8 );
+		_mm_storeu_si128( reinterpret_cast< __m128i * >( scaled ), _mm_packus_epi16( lo, hi ) );
+
+		for ( int j = 0; j < 4; j++ )
+		{
+			memcpy( & vertices[i + j].rs, & scaled[j], sizeof( U32 ) );
+		}
+	}
+#elif defined( Rtt_VERTEX_KERNELS_NEON )
+	const uint8x8_t s8 = vreinterpret_u8_u32( vdup_n_u32( scale ) );
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		uint8x16_t c = vld1q_u8( reinterpret_cast< const uint8_t * >( colors + i ) );
+		uint8x8_t lo = vshrn_n_u16( vmull_u8( vget_low_u8( c ), s8 ), 8 );
+		uint8x8_t hi = vshrn_n_u16( vmull_u8( vget_high_u8( c ), s8 ), 8 );
+		vst1q_u8( reinterpret_cast< uint8_t * >( scaled ), vcombine_u8( lo, hi ) );
+
+		for ( int j = 0; j < 4; j++ )
+		{
+			memcpy( & vertices[i + j].rs, & scaled[j], sizeof( U32 ) );
+		}
+	}
+#endif
+
+	ColorUnion s;
+	s.pixel = scale;
+
+	for ( ; i < count; i++ )
+	{
+		scaled[0] = ScaleColor( colors[i], s );
+		memcpy( & vertices[i].rs, & scaled[0], sizeof( U32 ) );
+	}
+}
+
+void
+InterleaveVertices(
+	Geometry::Vertex *dst,
+	const Geometry::Vertex *vertices,
+	const Geometry::Vertex *extra,
+	U32 first,
+	U32 count,
+	U32 extraCount )
+{
+	const size_t extraSize = extraCount * sizeof( Geometry::Vertex );
+	const Geometry::Vertex *src = vertices + first;
+	const Geometry::Vertex *srcExtra = extra + (size_t)first * extraCount;
+
+	for ( U32 i = 0; i < count; i++ )
+	{
+		CopyBytes( dst, src + i, sizeof( Geometry::Vertex ) );
+		CopyBytes( dst + 1, srcExtra, extraSize );
+
+		dst += 1 + extraCount;
+		srcExtra += extraCount;
+	}
+}
+
+} // VertexKernels
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
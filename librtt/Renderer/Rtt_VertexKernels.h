@@ -0,0 +1,66 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_VertexKernels_H__
+#define _Rtt_VertexKernels_H__
+
+#include "Renderer/Rtt_Geometry_Renderer.h"
+
+// ----------------------------------------------------------------------------
+
+// SSE2 is part of every x86-64 target and NEON of every arm64 one, so the
+// vector paths are chosen at compile time. Other targets use the scalar loops.
+#if ! defined( Rtt_REAL_FIXED )
+	#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+		#define Rtt_VERTEX_KERNELS_SSE2
+	#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+		#define Rtt_VERTEX_KERNELS_NEON
+	#endif
+#endif
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Batched loops over vertex data. Results match the per-vertex code they
+// replace exactly, i.e. the same operations in the same order.
+namespace VertexKernels
+{
+	// Transforms count (x,y) points in place by the 2D affine matrix whose
+	// rows are row0 and row1. Consecutive points start stride bytes apart.
+	void TransformPoints( const Real row0[3], const Real row1[3], Real *points, size_t stride, U32 count );
+
+	// Sets the color of each vertex to color
+	void FillColor( Geometry::Vertex *vertices, U32 count, U32 color );
+
+	// Sets the color of each vertex to the matching entry in colors. Unless
+	// scale is white, each channel is then scaled by scale's: (c * s) >> 8
+	void ScaleColors( Geometry::Vertex *vertices, const U32 *colors, U32 count, U32 scale );
+
+	// Writes count vertices of vertices, starting at first, each followed by
+	// its extraCount vertices of extra, i.e. the layout of extended geometry
+	void InterleaveVertices(
+		Geometry::Vertex *dst,
+		const Geometry::Vertex *vertices,
+		const Geometry::Vertex *extra,
+		U32 first,
+		U32 count,
+		U32 extraCount );
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_VertexKernels_H__
@@ -15,6 +15,7 @@
 #include "Rtt_LuaFile.h"
 #include "Core/Rtt_String.h"
 #include "Core/Rtt_FileSystem.h"
+#include "Core/Rtt_Math.h"
 
 #if !defined( Rtt_NO_ARCHIVE )
 	#include "Rtt_LuaContext.h"
@@ -42,6 +43,20 @@
 #include <errno.h>
 #include <sys/stat.h>
 
+#if defined( Rtt_ARCHIVE_ZLIB )
+	#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+
+#if defined( Rtt_ARCHIVE_PRELOAD )
+	#include <condition_variable>
+	#include <mutex>
+#endif
+
 // #define Rtt_DEBUG_ARCHIVE 1
 
 // ----------------------------------------------------------------------------
@@ -51,91 +66,343 @@ namespace Rtt
 
 // ----------------------------------------------------------------------------
 
+// 32-bit FNV-1a
+static U32
+HashBytes( const U8 *bytes, size_t numBytes )
+{
+	U32 result = 2166136261U;
+	for ( size_t i = 0; i < numBytes; i++ )
+	{
+		result = ( result ^ bytes[i] ) * 16777619U;
+	}
+	return result;
+}
+
 static bool
-CopyFile( FILE *src, FILE *dst, long *numBytes )
+ReadFileBytes( const char *filepath, std::vector< U8 >& rBytes )
 {
+	FILE *src = Rtt_FileOpen( filepath, "rb" );
+	if ( NULL == src )
+	{
+		return false;
+	}
+
 	bool result = true;
-	Rtt_ASSERT( src && dst );
+	U8 buf[4096];
+	size_t numRead = 0;
+	while ( ( numRead = fread( buf, 1, sizeof( buf ), src ) ) > 0 )
+	{
+		rBytes.insert( rBytes.end(), buf, buf + numRead );
+	}
+	result = ( 0 == ferror( src ) );
 
-	long startPos = ftell( dst );
+	Rtt_FileClose( src );
+	return result;
+}
+
+// ----------------------------------------------------------------------------
 
-	int c;
-	while( (c = getc( src )) != EOF )
+static void
+AppendLineRun( std::string& rLines, U32 line, U32 count )
+{
+	char run[32];
+	if ( count > 1 )
 	{
-		if ( ! Rtt_VERIFY( EOF != putc( c, dst ) ) )
-		{
-			Rtt_TRACE( ( "ERROR: Copy could not be copied!\n" ) );
-			result = false;
-			goto exit_gracefully;
-		}
+		snprintf( run, sizeof( run ), "%s%ux%u", rLines.empty() ? "" : ",", (unsigned int)line, (unsigned int)count );
 	}
+	else
+	{
+		snprintf( run, sizeof( run ), "%s%u", rLines.empty() ? "" : ",", (unsigned int)line );
+	}
+	rLines += run;
+}
 
-/*
-// Only works for plain text files
-#if 1
-    char buf[256];
-    const size_t kNumElem = sizeof(buf) / sizeof(buf[0]);
+// Rewrites Lua 5.1 bytecode without debug info. The source name of the main
+// chunk and each function's first line are kept so errors still name the
+// file, and each function's per-instruction lines go to a line map, one line
+// per function:
+//
+//   <entry> <TAB> <function> <TAB> <first line> <TAB> <lines>
+//
+// where <function> is the path of indices from the main chunk ("0", "0.2",
+// ...) and <lines> lists the line of each instruction, "NxC" meaning line N
+// repeated C times.
+class BytecodeStripper
+{
+	public:
+		BytecodeStripper( const std::vector< U8 >& src, std::vector< U8 >& rDst, std::string& rLineMap );
 
-    const size_t kElemSize = sizeof( buf[0] ); // obj size
+	public:
+		bool Strip( const char *entryName );
 
-    size_t objectsRead = 0;
-    while ( ( objectsRead = fread( buf, kElemSize, kNumElem, src ) ) )
-    {
-        if ( fwrite( buf, kElemSize, objectsRead, dst ) < objectsRead )
-        {
-            result = false;
-            goto exit_gracefully;
-        }
-    } 
-#else
-	char buf[256];
-	const size_t kBufSize = sizeof(buf) / sizeof(buf[0]);
+		static bool IsBytecode( const std::vector< U8 >& bytes );
+
+	private:
+		bool Copy( size_t numBytes );
+		bool Skip( size_t numBytes );
+		bool ReadU32( U32& rValue );
+		bool CopyU32( U32& rValue );
+		void WriteZero();
+		bool CopyString();
+		bool StripString();
+		bool StripFunction( const std::string& path, int depth );
+
+	private:
+		enum
+		{
+			kHeaderSize = 12,
+			kMaxDepth = 200
+		};
+
+		const std::vector< U8 >& fSrc;
+		std::vector< U8 >& fDst;
+		std::string& fLineMap;
+		const char *fEntryName;
+		size_t fPos;
+		size_t fNumberSize;
+		bool fIsLittleEndian;
+};
+
+BytecodeStripper::BytecodeStripper( const std::vector< U8 >& src, std::vector< U8 >& rDst, std::string& rLineMap )
+:	fSrc( src ),
+	fDst( rDst ),
+	fLineMap( rLineMap ),
+	fEntryName( NULL ),
+	fPos( 0 ),
+	fNumberSize( 0 ),
+	fIsLittleEndian( true )
+{
+}
+
+bool
+BytecodeStripper::IsBytecode( const std::vector< U8 >& bytes )
+{
+	return bytes.size() > 4 && 0 == memcmp( bytes.data(), "\033Lua", 4 );
+}
 
-	while ( fgets( buf, kBufSize, src ) )
+bool
+BytecodeStripper::Strip( const char *entryName )
+{
+	// Signature, version 5.1, official format, endianness, then the sizes of
+	// int, size_t and Instruction (all 32-bit for Corona) and lua_Number
+	const std::vector< U8 >& h = fSrc;
+	bool result = h.size() > kHeaderSize && IsBytecode( h )
+		&& 0x51 == h[4] && 0 == h[5] && h[6] <= 1
+		&& 4 == h[7] && 4 == h[8] && 4 == h[9]
+		&& ( 4 == h[10] || 8 == h[10] );
+
+	if ( result )
 	{
-		if ( ! Rtt_VERIFY( EOF != fputs( buf, dst ) ) )
+		fEntryName = entryName;
+		fIsLittleEndian = ( 1 == h[6] );
+		fNumberSize = h[10];
+		fPos = 0;
+		fDst.clear();
+
+		size_t lineMapLen = fLineMap.length();
+		result = Copy( kHeaderSize ) && StripFunction( "0", 0 ) && fPos == fSrc.size();
+		if ( ! result )
 		{
-			Rtt_TRACE( ( "ERROR: Copy could not be copied!\n" ) );
-			result = false;
-			goto exit_gracefully;
+			fLineMap.resize( lineMapLen );
 		}
 	}
-#endif
-*/
 
-exit_gracefully:
-	if ( numBytes )
+	return result;
+}
+
+bool
+BytecodeStripper::Copy( size_t numBytes )
+{
+	bool result = ( numBytes <= fSrc.size() - fPos );
+	if ( result )
 	{
-		*numBytes = ftell( dst ) - startPos;
+		fDst.insert( fDst.end(), fSrc.begin() + fPos, fSrc.begin() + fPos + numBytes );
+		fPos += numBytes;
 	}
 	return result;
 }
 
-template < size_t N >
-static size_t
-GetByteAlignedValue( size_t x )
+bool
+BytecodeStripper::Skip( size_t numBytes )
 {
-	Rtt_STATIC_ASSERT( 0 == (N & (N-1)) ); // Ensure that N is a power of 2
+	bool result = ( numBytes <= fSrc.size() - fPos );
+	if ( result )
+	{
+		fPos += numBytes;
+	}
+	return result;
+}
 
-	return ( x + (N-1) ) & (~(N-1));
+bool
+BytecodeStripper::ReadU32( U32& rValue )
+{
+	bool result = ( sizeof( U32 ) <= fSrc.size() - fPos );
+	if ( result )
+	{
+		const U8 *p = & fSrc[fPos];
+		rValue = fIsLittleEndian
+			? ( (U32)p[0] | ((U32)p[1] << 8) | ((U32)p[2] << 16) | ((U32)p[3] << 24) )
+			: ( (U32)p[3] | ((U32)p[2] << 8) | ((U32)p[1] << 16) | ((U32)p[0] << 24) );
+		fPos += sizeof( U32 );
+	}
+	return result;
 }
 
-static size_t
-GetFileSize( const char *filepath )
+bool
+BytecodeStripper::CopyU32( U32& rValue )
 {
-	Rtt_ASSERT( filepath );
+	if ( ! ReadU32( rValue ) )
+	{
+		return false;
+	}
 
-	struct stat statbuf;
-	int result = stat( filepath, & statbuf );
+	fPos -= sizeof( U32 );
+	return Copy( sizeof( U32 ) );
+}
+
+// Zero reads the same in either byte order
+void
+BytecodeStripper::WriteZero()
+{
+	fDst.insert( fDst.end(), sizeof( U32 ), 0 );
+}
+
+bool
+BytecodeStripper::CopyString()
+{
+	U32 len;
+	return CopyU32( len ) && Copy( len );
+}
+
+bool
+BytecodeStripper::StripString()
+{
+	U32 len;
+	return ReadU32( len ) && Skip( len );
+}
 
-	if (result != 0)
+bool
+BytecodeStripper::StripFunction( const std::string& path, int depth )
+{
+	if ( depth > kMaxDepth )
+	{
+		return false;
+	}
+
+	// source (only the main chunk's), linedefined, lastlinedefined, then
+	// nups, numparams, is_vararg and maxstacksize
+	bool result = false;
+	if ( 0 == depth )
+	{
+		result = CopyString();
+	}
+	else
 	{
-		fprintf(stderr, "car: cannot stat file '%s'\n", filepath);
+		result = StripString();
+		WriteZero();
 	}
 
-	Rtt_UNUSED( result ); Rtt_ASSERT( 0 == result );
+	U32 lineDefined = 0;
+	U32 n = 0;
+	result = result && CopyU32( lineDefined ) && Copy( sizeof( U32 ) + 4 );
 
-	return statbuf.st_size;
+	// code
+	result = result && CopyU32( n ) && n <= fSrc.size() / sizeof( U32 ) && Copy( (size_t)n * sizeof( U32 ) );
+
+	// constants
+	result = result && CopyU32( n );
+	for ( U32 i = 0; result && i < n; i++ )
+	{
+		result = Copy( 1 );
+		if ( result )
+		{
+			switch ( fDst.back() )
+			{
+				case 0: // nil
+					break;
+				case 1: // boolean
+					result = Copy( 1 );
+					break;
+				case 3: // number
+					result = Copy( fNumberSize );
+					break;
+				case 4: // string
+					result = CopyString();
+					break;
+				default:
+					result = false;
+					break;
+			}
+		}
+	}
+
+	// functions
+	std::string lines;
+	result = result && CopyU32( n );
+	for ( U32 i = 0; result && i < n; i++ )
+	{
+		char index[16];
+		snprintf( index, sizeof( index ), ".%u", (unsigned int)i );
+		result = StripFunction( path + index, depth + 1 );
+	}
+
+	// lineinfo, with runs of the same line collapsed
+	result = result && ReadU32( n );
+	U32 line = 0;
+	U32 count = 0;
+	for ( U32 i = 0; result && i < n; i++ )
+	{
+		U32 next;
+		result = ReadU32( next );
+		if ( result && count > 0 && next != line )
+		{
+			AppendLineRun( lines, line, count );
+			count = 0;
+		}
+		line = next;
+		++count;
+	}
+	if ( count > 0 )
+	{
+		AppendLineRun( lines, line, count );
+	}
+	WriteZero();
+
+	// locvars
+	result = result && ReadU32( n );
+	for ( U32 i = 0; result && i < n; i++ )
+	{
+		result = StripString() && Skip( 2*sizeof( U32 ) );
+	}
+	WriteZero();
+
+	// upvalue names
+	result = result && ReadU32( n );
+	for ( U32 i = 0; result && i < n; i++ )
+	{
+		result = StripString();
+	}
+	WriteZero();
+
+	if ( result )
+	{
+		char defined[16];
+		snprintf( defined, sizeof( defined ), "%u", (unsigned int)lineDefined );
+		fLineMap += std::string( fEntryName ) + '\t' + path + '\t' + defined + '\t' + lines + '\n';
+	}
+
+	return result;
+}
+
+// ----------------------------------------------------------------------------
+
+template < size_t N >
+static size_t
+GetByteAlignedValue( size_t x )
+{
+	Rtt_STATIC_ASSERT( 0 == (N & (N-1)) ); // Ensure that N is a power of 2
+
+	return ( x + (N-1) ) & (~(N-1));
 }
 
 /*
@@ -224,15 +491,64 @@ struct ArchiveWriterEntry
 	size_t nameLen;
 	const char* srcPath;
 	size_t srcLen;
+	U32 flags;
+	U32 hash;
+	std::vector< U8 > bytes; // as stored, i.e. possibly deflated
+};
+
+// Version 2 data entry
+// --------------------------
+//   U32        tag (kDataTag)
+//   U32        tag length
+//   U32        flags
+//   U32        stored length
+//   U32        original length
+//   U32        hash of the original bytes
+//   U32[2]     reserved
+//   U8[]       bytes (entries start on 16-byte boundaries)
+struct ArchiveDataEntry
+{
+	const U8 *bytes;
+	U32 storedLen;
+	U32 originalLen;
+	U32 flags;
+	U32 hash;
 };
 
+// Produces the original bytes of a deflated entry and checks them against its hash
+static bool
+InflateEntry( const ArchiveDataEntry& entry, std::vector< U8 >& rBytes )
+{
+#if defined( Rtt_ARCHIVE_ZLIB )
+	rBytes.resize( entry.originalLen );
+
+	uLongf len = (uLongf)entry.originalLen;
+	bool result =
+		Z_OK == uncompress( rBytes.data(), & len, entry.bytes, (uLong)entry.storedLen )
+		&& len == entry.originalLen
+		&& HashBytes( rBytes.data(), len ) == entry.hash;
+
+	if ( ! result )
+	{
+		rBytes.clear();
+	}
+	return result;
+#else
+	Rtt_UNUSED( entry );
+	Rtt_UNUSED( rBytes );
+	return false;
+#endif
+}
+
 class ArchiveWriter
 {
 	public:
 		enum
 		{
 			kTagSize = sizeof(U32)*2,
-			kVersion = 0x1
+			kDataHeaderSize = sizeof(U32)*8,
+			kEntryAlignment = 16,
+			kVersion = 0x2
 		};
 
 	public:
@@ -246,7 +562,8 @@ class ArchiveWriter
 		int Serialize( Archive::Tag tag, U32 len ) const;
 		int Serialize( U32 value ) const;
 		int Serialize( const char *value, size_t len ) const;
-		int Serialize( const char *filepath ) const;
+		int SerializeBytes( const U8 *bytes, size_t len ) const;
+		int PadTo( size_t position ) const;
 
 	public:
 //		int Serialize( ArchiveWriterEntry& entry );
@@ -344,56 +661,23 @@ ArchiveWriter::Serialize( const char *value, size_t len ) const
 }
 
 int
-ArchiveWriter::Serialize( const char *filepath ) const
+ArchiveWriter::SerializeBytes( const U8 *bytes, size_t len ) const
 {
 	Rtt_ASSERT( fDst );
-	Rtt_ASSERT( filepath );
-
-	int result = 0;
+	return (int)fwrite( bytes, 1, len, fDst );
+}
 
-	FILE *src = Rtt_FileOpen( filepath, "rb" );
+// Writes 0's up to the given position
+int
+ArchiveWriter::PadTo( size_t position ) const
+{
+	Rtt_ASSERT( fDst );
 
-	if (src == NULL)
+	int result = 0;
+	for ( long i = ftell( fDst ); i >= 0 && (size_t)i < position; i++ )
 	{
-		fprintf(stderr, "car: cannot serialize file '%s' (%s)\n", filepath, strerror(errno));
-
-		return 0;
+		result += fprintf( fDst, "%c", 0 );
 	}
-	else
-	{
-		size_t len = GetFileSize( filepath );
-		size_t len4 = GetByteAlignedValue< 4 >( len );
-
-		FILE *dst = fDst;
-		long numBytes = 0;
-		if ( Rtt_VERIFY( CopyFile( src, dst, & numBytes ) ) )
-		{
-			Rtt_ASSERT( numBytes >= 0 && (size_t)numBytes == len );
-
-			size_t numChars = len4 - len;
-			Rtt_ASSERT( numChars < 4 );
-			switch( numChars )
-			{
-				case 3:
-					fprintf( dst, "%c", '\0' );
-				case 2:
-					fprintf( dst, "%c", '\0' );
-				case 1:
-					fprintf( dst, "%c", '\0' );
-				default:
-					break;
-			}
-
-			result += len4;
-		}
-		else
-		{
-			result += numBytes;
-		}
-
-		Rtt_FileClose(src);
-	}
-
 	return result;
 }
 
@@ -427,8 +711,13 @@ class ArchiveReader
 		const char* ParseString();
 		void* ParseData( U32& rLength );
 
+		// Parses a data entry of either version, including its tag
+		bool ParseDataEntry( ArchiveDataEntry& rEntry );
+
 	public:
 		bool Seek( S32 offset, bool fromOrigin );
+		U8 GetVersion() const { return fVersion; }
+		const void* GetData() const { return fData; }
 
 	protected:
 		void VerifyBounds() const;
@@ -451,15 +740,18 @@ ArchiveReader::ArchiveReader()
 bool
 ArchiveReader::Initialize( const void* data, size_t numBytes )
 {
-	const U8 kHeader[] = { 'r', 'a', 'c', ArchiveWriter::kVersion };
-	const size_t kHeaderSize = sizeof( kHeader );
-	bool result = ( data && numBytes > kHeaderSize && 0 == memcmp( data, kHeader, kHeaderSize ) );
+	// The last header byte is the version. Older versions remain readable.
+	const U8 kHeader[] = { 'r', 'a', 'c' };
+	const size_t kHeaderSize = sizeof( kHeader ) + 1;
+	bool result = ( data && numBytes > kHeaderSize && 0 == memcmp( data, kHeader, sizeof( kHeader ) ) );
+	U8 version = result ? ((const U8*)data)[sizeof( kHeader )] : 0;
+	result = result && version >= 0x1 && version <= ArchiveWriter::kVersion;
 	if ( result )
 	{
 		fPos = ((U8*)data) + kHeaderSize;
 		fData = data;
 		fDataLen = numBytes;
-		fVersion = ArchiveWriter::kVersion;
+		fVersion = version;
 
 #if Rtt_DEBUG_ARCHIVE
 		Rtt_TRACE( ( "[ArchiveReader::Initialize] inData(%p) fPos(%p) fData(%p) headerSize(%ld) fDataLen(%ld)\n",
@@ -555,6 +847,45 @@ ArchiveReader::ParseData( U32& rLength )
 	return result;
 }
 
+bool
+ArchiveReader::ParseDataEntry( ArchiveDataEntry& rEntry )
+{
+	const U8 *pEnd = ((const U8*)fData) + fDataLen;
+	const size_t headerSize = ( fVersion < 2 ? ArchiveWriter::kTagSize + sizeof( U32 ) : (size_t)ArchiveWriter::kDataHeaderSize );
+	if ( (size_t)( pEnd - (const U8*)fPos ) < headerSize )
+	{
+		return false;
+	}
+
+	U32 tagLen;
+	if ( Archive::kDataTag != ParseTag( tagLen ) )
+	{
+		return false;
+	}
+
+	if ( fVersion < 2 )
+	{
+		U32 *p = (U32*)fPos;
+		rEntry.storedLen = ReadU32( p );
+		rEntry.originalLen = rEntry.storedLen;
+		rEntry.bytes = (const U8*)( p + 1 );
+		rEntry.flags = 0;
+		rEntry.hash = 0;
+	}
+	else
+	{
+		rEntry.flags = ParseU32();
+		rEntry.storedLen = ParseU32();
+		rEntry.originalLen = ParseU32();
+		rEntry.hash = ParseU32();
+		rEntry.bytes = ((const U8*)fPos) + 2*sizeof( U32 ); // skip reserved words
+	}
+
+	// Reject unknown flags and entries that run past the end of the archive
+	return 0 == ( rEntry.flags & ~(U32)( Archive::kDeflateFlag | Archive::kLazyFlag ) )
+		&& rEntry.storedLen <= (size_t)( pEnd - rEntry.bytes );
+}
+
 bool
 ArchiveReader::Seek( S32 offset, bool fromOrigin )
 {
@@ -564,7 +895,7 @@ ArchiveReader::Seek( S32 offset, bool fromOrigin )
 
 	if ( fromOrigin )
 	{
-		result = ( offset >= 0 );
+		result = ( offset >= 0 && (size_t)offset < fDataLen );
 		if ( result )
 		{
 			fPos = ((U8*)fData) + offset;
@@ -594,8 +925,110 @@ ArchiveReader::VerifyBounds() const
 
 // ----------------------------------------------------------------------------
 
+static bool
+MatchesName( const char *entryName, const char *name )
+{
+	// Module names may omit the ".lu" extension
+	const char kExtension[] = "." Rtt_LUA_OBJECT_FILE_EXTENSION;
+	size_t nameLen = strlen( name );
+	return 0 == strcmp( entryName, name )
+		|| ( 0 == strncmp( entryName, name, nameLen ) && 0 == strcmp( entryName + nameLen, kExtension ) );
+}
+
+// Reads, strips, hashes and deflates one entry. Called concurrently for
+// different entries, so it must not touch shared state.
+static void
+PrepareEntry( ArchiveWriterEntry& entry, const char *path, const Archive::SerializeOptions& options, std::string& rLineMap )
+{
+	entry.type = Archive::kLuaObjectResource;
+	entry.offset = 0;
+	entry.flags = 0;
+
+	entry.name = GetBasename( path );
+	entry.nameLen = strlen( entry.name );
+	entry.srcPath = path;
+
+	if ( ! ReadFileBytes( path, entry.bytes ) )
+	{
+		fprintf(stderr, "car: cannot serialize file '%s' (%s)\n", path, strerror(errno));
+		entry.bytes.clear();
+	}
+
+	if ( BytecodeStripper::IsBytecode( entry.bytes ) )
+	{
+		if ( options.stripDebug )
+		{
+			std::vector< U8 > stripped;
+			BytecodeStripper stripper( entry.bytes, stripped, rLineMap );
+			if ( stripper.Strip( entry.name ) )
+			{
+				entry.bytes.swap( stripped );
+			}
+			else
+			{
+				fprintf(stderr, "car: cannot strip '%s', it is not Lua 5.1 bytecode\n", path);
+			}
+		}
+
+		if ( options.lazyLoad )
+		{
+			entry.flags |= Archive::kLazyFlag;
+		}
+	}
+	entry.srcLen = entry.bytes.size();
+	entry.hash = HashBytes( entry.bytes.data(), entry.srcLen );
+
+#if defined( Rtt_ARCHIVE_ZLIB )
+	if ( options.compress && entry.srcLen > 0 )
+	{
+		// Only keep the deflated bytes if they are actually smaller
+		uLongf deflatedLen = compressBound( (uLong)entry.srcLen );
+		std::vector< U8 > deflated( deflatedLen );
+		if ( Z_OK == compress2( deflated.data(), & deflatedLen, entry.bytes.data(), (uLong)entry.srcLen, Z_BEST_COMPRESSION )
+			 && deflatedLen < entry.srcLen )
+		{
+			deflated.resize( deflatedLen );
+			entry.bytes.swap( deflated );
+			entry.flags |= Archive::kDeflateFlag;
+		}
+	}
+#endif
+}
+
+// Reads a line map written by Serialize(), keeping each entry's rows
+static void
+ReadLineMap( const char *path, std::map< std::string, std::string >& rRows )
+{
+	std::vector< U8 > bytes;
+	if ( ! ReadFileBytes( path, bytes ) )
+	{
+		return;
+	}
+
+	std::string contents( bytes.begin(), bytes.end() );
+	size_t start = 0;
+	while ( start < contents.length() )
+	{
+		size_t end = contents.find( '\n', start );
+		end = ( std::string::npos == end ? contents.length() : end + 1 );
+
+		size_t tab = contents.find( '\t', start );
+		if ( '#' != contents[start] && tab < end )
+		{
+			rRows[contents.substr( start, tab - start )] += contents.substr( start, end - start );
+		}
+		start = end;
+	}
+}
+
 void
 Archive::Serialize( const char *dstPath, int numSrcPaths, const char *srcPaths[] )
+{
+	Serialize( dstPath, numSrcPaths, srcPaths, SerializeOptions() );
+}
+
+void
+Archive::Serialize( const char *dstPath, int numSrcPaths, const char *srcPaths[], const SerializeOptions& options )
 {
 	std::vector<std::string> fileList;
 	size_t fileCount = 0;
@@ -622,6 +1055,12 @@ Archive::Serialize( const char *dstPath, int numSrcPaths, const char *srcPaths[]
 
 	const char *tmpDirName = Rtt_MakeTempDirectory(tmpDirTemplate);
 
+	std::string lineMapPath = options.lineMapPath ? options.lineMapPath : std::string( dstPath ) + ".lines";
+
+	// Line map rows of the entries kept from an existing archive. Those
+	// entries are already stripped, so stripping them again finds no lines.
+	std::map< std::string, std::string > keptLineMap;
+
 	if (Rtt_FileExists(dstPath))
 	{
 		// Archive already exists, extract the current contents so we can overwrite
@@ -649,6 +1088,15 @@ Archive::Serialize( const char *dstPath, int numSrcPaths, const char *srcPaths[]
 		// Enumerate the files now in the temporary directory and make the new archive with them
 		fileList = Rtt_ListFiles(tmpDirName);
 		fileCount = fileList.size();
+
+		if ( options.stripDebug )
+		{
+			ReadLineMap( lineMapPath.c_str(), keptLineMap );
+			for ( int i = 0; i < numSrcPaths; i++ )
+			{
+				keptLineMap.erase( GetBasename( srcPaths[i] ) );
+			}
+		}
 	}
 	else
 	{
@@ -663,33 +1111,115 @@ Archive::Serialize( const char *dstPath, int numSrcPaths, const char *srcPaths[]
 		fileCount = numSrcPaths;
 	}
 
+	// Neither the caller's directory walk nor Rtt_ListFiles() has a stable order
+	std::stable_sort( fileList.begin(), fileList.end(), []( const std::string& a, const std::string& b )
+	{
+		return strcmp( GetBasename( a.c_str() ), GetBasename( b.c_str() ) ) < 0;
+	} );
+
+#if !defined( Rtt_ARCHIVE_ZLIB )
+	if ( options.compress )
+	{
+		fprintf(stderr, "car: compression is not supported by this build, entries will be stored\n");
+	}
+#endif
+
+	// Stripped line info, see BytecodeStripper
+	std::string lineMap;
+
 	ArchiveWriter writer;
 	int startPos = writer.Initialize( dstPath );
 	if ( Rtt_VERIFY( startPos > 0 ) )
 	{
 		ArchiveWriterEntry* entries = new ArchiveWriterEntry[fileCount];
 
-		U32 contentsLen = sizeof(U32); // numElements
-		size_t entryIdx = 0;
-		for (std::vector<std::string>::iterator it = fileList.begin(); it != fileList.end(); ++it)
+		// Each entry keeps its own slice of the line map so the map does not
+		// depend on which thread finishes first
+		std::vector< std::string > lineMaps( fileCount );
+
+		std::atomic< size_t > next( 0 );
+		auto prepareEntries = [&]()
+		{
+			for ( size_t i = next++; i < fileCount; i = next++ )
+			{
+				PrepareEntry( entries[i], fileList[i].c_str(), options, lineMaps[i] );
+			}
+		};
+
+		size_t numThreads = ( options.numThreads > 0 ? (size_t)options.numThreads : std::thread::hardware_concurrency() );
+		numThreads = Min( Max( numThreads, (size_t)1 ), Max( fileCount, (size_t)1 ) );
+		std::vector< std::thread > threads;
+		for ( size_t i = 1; i < numThreads; i++ )
+		{
+			threads.push_back( std::thread( prepareEntries ) );
+		}
+		prepareEntries();
+		for ( size_t i = 0; i < threads.size(); i++ )
 		{
-			ArchiveWriterEntry& entry = entries[entryIdx++];
-			entry.type = kLuaObjectResource;
-			entry.offset = 0;
+			threads[i].join();
+		}
 
-			const char* path = it->c_str();
-			entry.name = GetBasename( path );
-			entry.nameLen = strlen( entry.name );
-			entry.srcPath = path;
-			entry.srcLen = GetFileSize( path );
+		U32 contentsLen = sizeof(U32); // numElements
+		for ( size_t i = 0; i < fileCount; i++ )
+		{
+			const ArchiveWriterEntry& entry = entries[i];
+			std::map< std::string, std::string >::const_iterator kept = keptLineMap.find( entry.name );
+			if ( kept != keptLineMap.end() )
+			{
+				lineMap += kept->second;
+			}
+			else
+			{
+				// Every function has instructions, so an empty run means no line info
+				if ( std::string::npos != lineMaps[i].find( "\t\n" ) )
+				{
+					fprintf(stderr, "car: no line info for '%s', it was already stripped\n", entry.name);
+				}
+				lineMap += lineMaps[i];
+			}
 
 			// type, offset, numChars, string data
 			contentsLen += 3*sizeof(U32) + GetByteAlignedValue< 4 >( entry.nameLen + 1 );
 		}
 
-		U32 offsetBase = startPos + contentsLen;
+		// Indices of the entries needed at startup
+		std::vector< U32 > manifest;
+		if ( options.numPreloadNames > 0 )
+		{
+			for ( int i = 0; i < options.numPreloadNames; i++ )
+			{
+				size_t j = 0;
+				while ( j < fileCount && ! MatchesName( entries[j].name, options.preloadNames[i] ) )
+				{
+					++j;
+				}
+
+				if ( j < fileCount )
+				{
+					manifest.push_back( (U32)j );
+				}
+				else
+				{
+					fprintf(stderr, "car: cannot preload '%s', it is not in the archive\n", options.preloadNames[i]);
+				}
+			}
+		}
+		else
+		{
+			for ( size_t j = 0; j < fileCount; j++ )
+			{
+				if ( MatchesName( entries[j].name, "main" ) || MatchesName( entries[j].name, "config" ) )
+				{
+					manifest.push_back( (U32)j );
+				}
+			}
+		}
+
+		U32 manifestLen = (U32)( sizeof(U32) * ( 1 + manifest.size() ) ); // numElements, indices
 
-		offsetBase += writer.Serialize( Archive::kContentsTag, contentsLen );
+		size_t offsetBase = startPos + ArchiveWriter::kTagSize + contentsLen + ArchiveWriter::kTagSize + manifestLen;
+
+		writer.Serialize( Archive::kContentsTag, contentsLen );
 
 		// Contents
 		// --------------------------
@@ -708,43 +1238,76 @@ Archive::Serialize( const char *dstPath, int numSrcPaths, const char *srcPaths[]
 		for ( size_t i = 0; i < fileCount; i++ )
 		{
 			ArchiveWriterEntry& entry = entries[i];
+
+			// Each entry starts on a 16-byte boundary
+			offsetBase = GetByteAlignedValue< ArchiveWriter::kEntryAlignment >( offsetBase );
+
 			writer.Serialize( entry.type );
-			writer.Serialize( offsetBase );
+			writer.Serialize( (U32)offsetBase );
 			writer.Serialize( entry.name, entry.nameLen );
 
 			// store offset for this entry
-			entry.offset = offsetBase;
+			entry.offset = (U32)offsetBase;
+
+			offsetBase += ArchiveWriter::kDataHeaderSize + entry.bytes.size();
+		}
 
-			// For next offset, add srcLen *and* bytes for tag, length 
-			offsetBase +=
-				GetByteAlignedValue< 4 >( entry.srcLen )
-				+ ArchiveWriter::kTagSize
-				+ sizeof(U32);
+		// Manifest
+		// --------------------------
+		//   U32        numElements
+		//   U32[]      indices into Contents
+		writer.Serialize( Archive::kManifestTag, manifestLen );
+		writer.Serialize( (U32)manifest.size() );
+		for ( size_t i = 0; i < manifest.size(); i++ )
+		{
+			writer.Serialize( manifest[i] );
 		}
 
 		// Data
 		// --------------------------
-		//   String     data
+		//   Entry[]    see ArchiveDataEntry
 		for ( size_t i = 0; i < fileCount; i++ )
 		{
 			ArchiveWriterEntry& entry = entries[i];
 
+			writer.PadTo( entry.offset );
 			Rtt_ASSERT(
 				writer.GetPosition() >= 0
 				&& (size_t)writer.GetPosition() == entry.offset );
 
-			// data tag length = sizeof( length ) + byte-aligned len of bytes buffer
-			writer.Serialize( kDataTag, sizeof( U32 ) + (U32) GetByteAlignedValue< 4 >( entry.srcLen ) );
+			U32 storedLen = (U32)entry.bytes.size();
+			writer.Serialize( kDataTag, ArchiveWriter::kDataHeaderSize - ArchiveWriter::kTagSize + storedLen );
+			writer.Serialize( entry.flags );
+			writer.Serialize( storedLen );
 			writer.Serialize( (U32) entry.srcLen );
-			writer.Serialize( entry.srcPath );
+			writer.Serialize( entry.hash );
+			writer.Serialize( (U32) 0 );
+			writer.Serialize( (U32) 0 );
+			writer.SerializeBytes( entry.bytes.data(), storedLen );
 		}
 
 		// EOF
+		writer.PadTo( GetByteAlignedValue< 4 >( writer.GetPosition() ) );
 		writer.Serialize( kEOFTag, 0 );
 
 		delete [] entries;
 	}
 
+	if ( options.stripDebug )
+	{
+		FILE *dst = Rtt_FileOpen( lineMapPath.c_str(), "wb" );
+		if ( dst )
+		{
+			fprintf( dst, "# entry\tfunction\tfirst line\tline of each instruction\n" );
+			fwrite( lineMap.data(), 1, lineMap.length(), dst );
+			Rtt_FileClose( dst );
+		}
+		else
+		{
+			fprintf(stderr, "car: cannot open line map '%s' for writing\n", lineMapPath.c_str());
+		}
+	}
+
 	Rtt_DeleteDirectory(tmpDirName);
 }
 
@@ -848,15 +1411,27 @@ Archive::Deserialize( const char *dstDir, const char *srcCarFile )
 						{
 							ArchiveEntry& entry = entries[i];
 
-							reader.Seek( entry.offset, true );
-							U32 tagLen;
-							U32 tag = reader.ParseTag( tagLen );
-							if ( Rtt_VERIFY( Archive::kDataTag == tag ) )
+							ArchiveDataEntry data;
+							if ( Rtt_VERIFY( reader.Seek( entry.offset, true ) && reader.ParseDataEntry( data ) ) )
 							{
-								U32 resourceLen = 0;
-								void* resource = reader.ParseData( resourceLen );
-								WriteFile( dstDir, entry.name, resource, resourceLen );
-								++count;
+								if ( data.flags & kDeflateFlag )
+								{
+									std::vector< U8 > bytes;
+									if ( InflateEntry( data, bytes ) )
+									{
+										WriteFile( dstDir, entry.name, bytes.data(), bytes.size() );
+										++count;
+									}
+									else
+									{
+										fprintf(stderr, "car: cannot inflate '%s'\n", entry.name);
+									}
+								}
+								else
+								{
+									WriteFile( dstDir, entry.name, data.bytes, data.storedLen );
+									++count;
+								}
 							}
 						}
 
@@ -933,14 +1508,10 @@ Archive::List(const char *srcCarFile)
 				{
 					ArchiveEntry& entry = entries[i];
 
-					reader.Seek( entry.offset, true );
-					U32 tagLen;
-					U32 tag = reader.ParseTag( tagLen );
-					if ( Rtt_VERIFY( Archive::kDataTag == tag ) )
+					ArchiveDataEntry data;
+					if ( Rtt_VERIFY( reader.Seek( entry.offset, true ) && reader.ParseDataEntry( data ) ) )
 					{
-						U32 resourceLen = 0;
-						reader.ParseData( resourceLen );
-						printf("%7d %s\n", resourceLen, entry.name);
+						printf("%7d %s\n", data.originalLen, entry.name);
 					}
 				}
 
@@ -960,12 +1531,301 @@ Archive::List(const char *srcCarFile)
 	}
 }
 
+size_t
+Archive::Verify( const char *srcCarFile )
+{
+	int fd = Rtt_FileDescriptorOpen(srcCarFile, O_RDONLY, S_IRUSR);
+	struct stat statbuf;
+	size_t numBad = 0;
+
+	if (fd == -1)
+	{
+		fprintf(stderr, "car: cannot open archive '%s'\n", srcCarFile);
+
+		return 1;
+	}
+
+	if (fstat( fd, & statbuf ) == -1)
+	{
+		fprintf(stderr, "car: cannot stat archive '%s'\n", srcCarFile);
+
+		return 1;
+	}
+	size_t dataLen = statbuf.st_size;
+
+	void *data = Rtt_FileMemoryMap(fd, 0, dataLen, false);
+
+	Rtt_FileDescriptorClose(fd);
+
+	ArchiveReader reader;
+	U32 tagLen;
+	if (reader.Initialize(data, dataLen) == 0)
+	{
+		fprintf(stderr, "car: file '%s' is not a car archive\n", srcCarFile);
+		++numBad;
+	}
+	else if ( kContentsTag != reader.ParseTag( tagLen ) )
+	{
+		fprintf(stderr, "car: archive '%s' has no contents\n", srcCarFile);
+		++numBad;
+	}
+	else
+	{
+		U32 numElements = reader.ParseU32();
+		ArchiveEntry *entries = (ArchiveEntry*)Rtt_MALLOC( & allocator, sizeof( ArchiveEntry )*numElements );
+		for ( U32 i = 0; i < numElements; i++ )
+		{
+			ArchiveEntry& entry = entries[i];
+			entry.type = reader.ParseU32();
+			entry.offset = reader.ParseU32();
+			entry.name = reader.ParseString();
+		}
+
+		U32 numPreloaded = 0;
+		if ( reader.GetVersion() >= 2 )
+		{
+			if ( kManifestTag == reader.ParseTag( tagLen ) )
+			{
+				numPreloaded = reader.ParseU32();
+				for ( U32 i = 0; i < numPreloaded; i++ )
+				{
+					U32 index = reader.ParseU32();
+					if ( index >= numElements )
+					{
+						fprintf(stderr, "car: manifest refers to missing entry %u\n", index);
+						++numBad;
+					}
+				}
+			}
+			else
+			{
+				fprintf(stderr, "car: archive '%s' has no manifest\n", srcCarFile);
+				++numBad;
+			}
+		}
+
+		std::vector< U8 > bytes;
+		for ( U32 i = 0; i < numElements; i++ )
+		{
+			ArchiveEntry& entry = entries[i];
+
+			const char *problem = NULL;
+			ArchiveDataEntry data;
+			if ( ! reader.Seek( entry.offset, true ) || ! reader.ParseDataEntry( data ) )
+			{
+				problem = "entry is truncated or malformed";
+			}
+			else if ( reader.GetVersion() >= 2 )
+			{
+				if ( 0 != ( entry.offset % ArchiveWriter::kEntryAlignment ) )
+				{
+					problem = "entry is not aligned";
+				}
+				else if ( data.flags & kDeflateFlag )
+				{
+					if ( ! InflateEntry( data, bytes ) )
+					{
+						problem = "entry cannot be inflated or does not match its hash";
+					}
+				}
+				else if ( data.storedLen != data.originalLen || HashBytes( data.bytes, data.storedLen ) != data.hash )
+				{
+					problem = "entry does not match its hash";
+				}
+			}
+
+			if ( problem )
+			{
+				fprintf(stderr, "car: %s: %s\n", entry.name, problem);
+				++numBad;
+			}
+		}
+
+		printf("%s: version %d, %u entries, %u preloaded, %u bad\n",
+			srcCarFile, reader.GetVersion(), numElements, numPreloaded, (unsigned int)numBad);
+
+		Rtt_FREE( entries );
+	}
+
+	if (data != NULL)
+	{
+		Rtt_FileMemoryUnmap(data, dataLen);
+	}
+
+	return numBad;
+}
+
 // ----------------------------------------------------------------------------
 
 #if !defined( Rtt_NO_ARCHIVE )
 
 // ----------------------------------------------------------------------------
 
+#if defined( Rtt_ARCHIVE_PRELOAD )
+
+// Inflates the deflated entries of the startup manifest on worker threads
+// while the app is still starting. The Lua state is not thread-safe, so the
+// chunks themselves are still loaded on the main thread.
+class ArchivePreloader
+{
+	Rtt_CLASS_NO_COPIES( ArchivePreloader )
+
+	public:
+		enum
+		{
+			kMaxThreads = 4
+		};
+
+	public:
+		ArchivePreloader( const std::vector< U32 >& entryIndices, const std::vector< ArchiveDataEntry >& entries );
+		~ArchivePreloader();
+
+	public:
+		// Hands over the inflated bytes of an entry, doing or waiting for the
+		// work as needed. Returns false if the entry is not one of those being
+		// preloaded, is corrupt or was already taken.
+		bool Take( U32 entryIndex, std::vector< U8 >& rBytes );
+
+	private:
+		typedef enum State
+		{
+			kPending,
+			kRunning,
+			kDone,
+			kTaken
+		}
+		State;
+
+		struct Item
+		{
+			U32 entryIndex;
+			ArchiveDataEntry data;
+			std::vector< U8 > bytes;
+			bool isValid;
+			std::atomic< int > state;
+		};
+
+	private:
+		static bool Claim( Item& item );
+		void Process( Item& item );
+		void Run();
+
+	private:
+		Item *fItems;
+		size_t fNumItems;
+		std::atomic< size_t > fNext;
+		std::mutex fMutex;
+		std::condition_variable fCondition;
+		std::vector< std::thread > fThreads;
+};
+
+ArchivePreloader::ArchivePreloader( const std::vector< U32 >& entryIndices, const std::vector< ArchiveDataEntry >& entries )
+:	fItems( new Item[entryIndices.size()] ),
+	fNumItems( entryIndices.size() ),
+	fNext( 0 )
+{
+	Rtt_ASSERT( entryIndices.size() == entries.size() );
+
+	for ( size_t i = 0; i < fNumItems; i++ )
+	{
+		Item& item = fItems[i];
+		item.entryIndex = entryIndices[i];
+		item.data = entries[i];
+		item.isValid = false;
+		item.state = kPending;
+	}
+
+	size_t numThreads = std::thread::hardware_concurrency();
+	numThreads = ( numThreads > 1 ? numThreads - 1 : 1 );
+	numThreads = Min( numThreads, Min( (size_t)kMaxThreads, fNumItems ) );
+	for ( size_t i = 0; i < numThreads; i++ )
+	{
+		fThreads.push_back( std::thread( & ArchivePreloader::Run, this ) );
+	}
+}
+
+ArchivePreloader::~ArchivePreloader()
+{
+	// Leave whatever has not been started
+	fNext = fNumItems;
+	for ( size_t i = 0; i < fThreads.size(); i++ )
+	{
+		fThreads[i].join();
+	}
+
+	delete [] fItems;
+}
+
+bool
+ArchivePreloader::Take( U32 entryIndex, std::vector< U8 >& rBytes )
+{
+	for ( size_t i = 0; i < fNumItems; i++ )
+	{
+		Item& item = fItems[i];
+		if ( item.entryIndex != entryIndex )
+		{
+			continue;
+		}
+
+		// Don't wait behind the queue for an entry no worker has started
+		if ( Claim( item ) )
+		{
+			Process( item );
+		}
+		else
+		{
+			std::unique_lock< std::mutex > lock( fMutex );
+			fCondition.wait( lock, [&item]() { return item.state >= kDone; } );
+		}
+
+		int expected = kDone;
+		if ( item.state.compare_exchange_strong( expected, kTaken ) && item.isValid )
+		{
+			rBytes.swap( item.bytes );
+			return true;
+		}
+		return false;
+	}
+
+	return false;
+}
+
+bool
+ArchivePreloader::Claim( Item& item )
+{
+	int expected = kPending;
+	return item.state.compare_exchange_strong( expected, kRunning );
+}
+
+void
+ArchivePreloader::Process( Item& item )
+{
+	item.isValid = InflateEntry( item.data, item.bytes );
+
+	{
+		std::lock_guard< std::mutex > lock( fMutex );
+		item.state = kDone;
+	}
+	fCondition.notify_all();
+}
+
+void
+ArchivePreloader::Run()
+{
+	for ( size_t i = fNext++; i < fNumItems; i = fNext++ )
+	{
+		Item& item = fItems[i];
+		if ( Claim( item ) )
+		{
+			Process( item );
+		}
+	}
+}
+
+#endif // Rtt_ARCHIVE_PRELOAD
+
+// ----------------------------------------------------------------------------
+
 Archive::Archive( Rtt_Allocator& allocator, const char *srcPath )
 :	fAllocator( allocator ),
 	fEntries( NULL ),
@@ -973,7 +1833,9 @@ Archive::Archive( Rtt_Allocator& allocator, const char *srcPath )
 #if defined( Rtt_ARCHIVE_COPY_DATA )
 	fBits( &allocator ),
 #endif
-	fData( NULL )
+	fData( NULL ),
+	fVersion( 0 ),
+	fPreloader( NULL )
 {
 #if defined( Rtt_WIN_PHONE_ENV ) || defined(Rtt_NXS_ENV)
 	FILE* filePointer = Rtt_FileOpen(srcPath, "rb");
@@ -1023,12 +1885,16 @@ Archive::Archive( Rtt_Allocator& allocator, const char *srcPath )
 	Rtt_FileDescriptorClose(fileDescriptor);
 #endif
 
-#if defined( EMSCRIPTEN )
-	// On browser, mmap is not reliable wrt byte-alignment,
-	// so ensure byte-alignment by copying data to a malloc'd buffer
-	fBits.Set( (const char *)fData, fDataLen );
-	munmap( (void *)fData, fDataLen );
-	fData = fBits.Get();
+#if defined( Rtt_ARCHIVE_COPY_DATA )
+	// On browser, mmap is not reliable wrt byte-alignment. The reader needs
+	// 4-byte aligned words, so only copy the data to a malloc'd buffer when
+	// the mapping itself is misaligned.
+	if ( fData && 0 != ( (uintptr_t)fData & 0x3 ) )
+	{
+		fBits.Set( (const char *)fData, fDataLen );
+		munmap( (void *)fData, fDataLen );
+		fData = fBits.Get();
+	}
 #endif
 
 
@@ -1091,12 +1957,61 @@ Archive::Archive( Rtt_Allocator& allocator, const char *srcPath )
 					break;
 			}
 		}
+
+		fVersion = reader.GetVersion();
+
+#if defined( Rtt_ARCHIVE_PRELOAD )
+		// Start inflating the deflated entries needed at startup
+		U32 tagLen;
+		if ( fVersion >= 2 && fEntries && Archive::kManifestTag == reader.ParseTag( tagLen ) )
+		{
+			std::vector< U32 > entryIndices;
+			U32 numElements = reader.ParseU32();
+			for ( U32 i = 0; i < numElements; i++ )
+			{
+				U32 index = reader.ParseU32();
+				if ( index < fNumEntries )
+				{
+					entryIndices.push_back( index );
+				}
+			}
+
+			std::vector< U32 > preloadIndices;
+			std::vector< ArchiveDataEntry > preloadEntries;
+			for ( size_t i = 0; i < entryIndices.size(); i++ )
+			{
+				ArchiveDataEntry data;
+				if ( reader.Seek( fEntries[entryIndices[i]].offset, true ) && reader.ParseDataEntry( data )
+					 && ( data.flags & kDeflateFlag ) )
+				{
+					preloadIndices.push_back( entryIndices[i] );
+					preloadEntries.push_back( data );
+				}
+			}
+
+			// Stored entries are read straight from the mapping, so they need no threads
+			if ( preloadIndices.size() > 0 )
+			{
+				fPreloader = new ArchivePreloader( preloadIndices, preloadEntries );
+			}
+		}
+#endif
 	}
 }
 
 Archive::~Archive()
 {
-#if defined( Rtt_EMSCRIPTEN_ENV ) || defined( Rtt_NXS_ENV )
+#if defined( Rtt_ARCHIVE_PRELOAD )
+	// Workers read from the mapping
+	delete fPreloader;
+#endif
+
+#if defined( Rtt_ARCHIVE_COPY_DATA )
+	if ( fData && fData != fBits.Get() )
+	{
+		munmap( (void*)fData, fDataLen );
+	}
+#elif defined( Rtt_NXS_ENV )
 	// Do nothing.
 #elif defined( Rtt_WIN_PHONE_ENV )
 	Rtt_FREE((void*)fData);
@@ -1172,15 +2087,33 @@ Archive::LoadResource( lua_State *L, const char *name )
 		ArchiveEntry& entry = fEntries[i];
 		if ( 0 == Rtt_StringCompare( entry.name, name ) )
 		{
-			reader.Seek( entry.offset, true );
-			U32 tagLen;
-			U32 tag = reader.ParseTag( tagLen );
-			if ( Rtt_VERIFY( Archive::kDataTag == tag ) )
+			ArchiveDataEntry data;
+			if ( Rtt_VERIFY( reader.Seek( entry.offset, true ) && reader.ParseDataEntry( data ) ) )
 			{
-				U32 resourceLen = 0;
-				void* resource = reader.ParseData( resourceLen );
-				status = luaL_loadbuffer( L, static_cast< const char* >( resource ), resourceLen, name );
-				goto exit_gracefully;
+				int wasLazy = lua_setlazyload( L, ( data.flags & kLazyFlag ) ? 1 : 0 );
+				if ( data.flags & kDeflateFlag )
+				{
+					std::vector< U8 > bytes;
+#if defined( Rtt_ARCHIVE_PRELOAD )
+					bool isInflated = ( fPreloader && fPreloader->Take( (U32)i, bytes ) ) || InflateEntry( data, bytes );
+#else
+					bool isInflated = InflateEntry( data, bytes );
+#endif
+					if ( isInflated )
+					{
+						status = luaL_loadbuffer( L, reinterpret_cast< const char* >( bytes.data() ), bytes.size(), name );
+					}
+				}
+				else
+				{
+					status = luaL_loadbuffer( L, reinterpret_cast< const char* >( data.bytes ), data.storedLen, name );
+				}
+				lua_setlazyload( L, wasLazy );
+
+				if ( LUA_ERRFILE != status )
+				{
+					goto exit_gracefully;
+				}
 			}
 			errorFormat = kFormatAchiveCorrupted;
 		}
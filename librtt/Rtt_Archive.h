@@ -22,11 +22,27 @@
 	#include "Core/Rtt_Data.h"
 #endif
 
+// Compressed entries need zlib. Every runtime target links it, so any archive
+// can be read; tools built without it (Rtt_NO_ARCHIVE) store entries as is.
+// Windows Phone is not maintained and has no zlib.
+#if !defined( Rtt_ARCHIVE_ZLIB ) && !defined( Rtt_WIN_PHONE_ENV )
+	#if !defined( Rtt_NO_ARCHIVE ) || defined( Rtt_LINUX_ENV ) || defined( Rtt_ANDROID_ENV )
+		#define Rtt_ARCHIVE_ZLIB 1
+	#endif
+#endif
+
+// Deflated startup entries are inflated on worker threads, where there are threads
+#if !defined( Rtt_NO_ARCHIVE ) && defined( Rtt_ARCHIVE_ZLIB ) && !defined( Rtt_EMSCRIPTEN_ENV )
+	#define Rtt_ARCHIVE_PRELOAD 1
+#endif
+
 // ----------------------------------------------------------------------------
 
 namespace Rtt
 {
 
+class ArchivePreloader;
+
 // ----------------------------------------------------------------------------
 
 class Archive
@@ -42,11 +58,57 @@ class Archive
 			kUnknownTag = 0x0,
 			kContentsTag = 0x1,
 			kDataTag = 0x2,
+			kManifestTag = 0x3,
 			
 			kEOFTag = 0xFFFFFFFF
 		}
 		Tag;
 
+		// Per-entry flags (version 2 and later)
+		enum
+		{
+			kDeflateFlag = 0x1,
+			kLazyFlag = 0x2 // undump nested functions on first call
+		};
+
+		struct SerializeOptions
+		{
+			SerializeOptions()
+			:	compress( false ),
+				stripDebug( false ),
+				lazyLoad( false ),
+				lineMapPath( NULL ),
+				numPreloadNames( 0 ),
+				preloadNames( NULL ),
+				numThreads( 0 )
+			{
+			}
+
+			// Deflate entries that shrink when compressed
+			bool compress;
+
+			// Drop line info, local and upvalue names from Lua bytecode.
+			// Errors and tracebacks then locate a frame as "file:<N>+pc P",
+			// where N is the function's first line and P the instruction;
+			// the line map gives the source line of instruction P.
+			bool stripDebug;
+
+			// Mark Lua bytecode entries for lazy loading of nested functions
+			bool lazyLoad;
+
+			// Where stripped line info is written. Defaults to dstPath + ".lines".
+			const char *lineMapPath;
+
+			// Entries listed in the startup manifest. When empty, main.lu
+			// and config.lu are listed if present.
+			int numPreloadNames;
+			const char **preloadNames;
+
+			// Threads used to read, strip and deflate entries. 0 means one per core.
+			// Entries are sorted by name, so the archive does not depend on it.
+			int numThreads;
+		};
+
 	private:
 		// TODO: Create a hash table (keyed by resource type and then name)
 		struct ArchiveEntry
@@ -58,9 +120,13 @@ class Archive
 
 	public:
 		static void Serialize( const char *dstPath, int numSrcPaths, const char *srcPaths[] );
+		static void Serialize( const char *dstPath, int numSrcPaths, const char *srcPaths[], const SerializeOptions& options );
 		static size_t Deserialize( const char *dstDir, const char *srcCarFile );
 		static void List(const char *srcCarFile);
 
+		// Checks every entry's bounds and content hash. Returns the number of bad entries.
+		static size_t Verify( const char *srcCarFile );
+
 #if !defined( Rtt_NO_ARCHIVE )
 	public:
 		Archive( Rtt_Allocator& allocator, const char *srcPath );
@@ -80,6 +146,10 @@ class Archive
 		size_t fNumEntries;
 		const void* fData;
 		size_t fDataLen;
+		U8 fVersion;
+
+		// Inflates the startup manifest's entries on worker threads
+		ArchivePreloader* fPreloader;
 #if defined( Rtt_ARCHIVE_COPY_DATA )
 		Data<char> fBits;
 #endif
@@ -25,6 +25,7 @@
 #include "Display/Rtt_StageObject.h"
 #include "Input/Rtt_PlatformInputAxis.h"
 #include "Input/Rtt_PlatformInputDevice.h"
+#include "Rtt_EventPool.h"
 #include "Rtt_Lua.h"
 #include "Display/Rtt_BitmapMask.h"
 #include "Rtt_HitTestObject.h"
@@ -82,10 +83,25 @@ VirtualEvent::Dispatch( lua_State *L, Runtime& ) const
 int
 VirtualEvent::Push( lua_State *L ) const
 {
-	Lua::NewEvent( L, Name() ); Rtt_ASSERT( lua_istable( L, -1 ) );
+	if ( LuaContext::HasRuntime( L ) )
+	{
+		Runtime *runtime = LuaContext::GetRuntime( L );
+		runtime->GetEventPool().PushTable( L, * this, IsReusable() );
+	}
+	else
+	{
+		Lua::NewEvent( L, Name() );
+	}
+	Rtt_ASSERT( lua_istable( L, -1 ) );
 	return 1;
 }
 
+bool
+VirtualEvent::IsReusable() const
+{
+	return false;
+}
+
 // ----------------------------------------------------------------------------
 
 ErrorEvent::ErrorEvent()
@@ -153,6 +169,12 @@ FrameEvent::Push( lua_State *L ) const
 	return 1;
 }
 
+bool
+FrameEvent::IsReusable() const
+{
+	return true;
+}
+
 // ----------------------------------------------------------------------------
 
 const RenderEvent&
@@ -474,6 +496,12 @@ AccelerometerEvent::Push( lua_State *L ) const
 	return 1;
 }
 
+bool
+AccelerometerEvent::IsReusable() const
+{
+	return true;
+}
+
 // ----------------------------------------------------------------------------
 
 /// Creates a new event data object that stores a single gyroscope measurement.
@@ -627,6 +655,14 @@ HeadingEvent::Push( lua_State *L ) const
 // ----------------------------------------------------------------------------
 
 MemoryWarningEvent::MemoryWarningEvent( )
+:	fNumBytesUsed( 0 ),
+	fBudget( 0 )
+{
+}
+
+MemoryWarningEvent::MemoryWarningEvent( size_t numBytesUsed, size_t budget )
+:	fNumBytesUsed( numBytesUsed ),
+	fBudget( budget )
 {
 }
 
@@ -642,7 +678,14 @@ MemoryWarningEvent::Push( lua_State *L ) const
 {
 	if ( Rtt_VERIFY( Super::Push( L ) ) )
 	{
-		// No fields currently in memory warning events	
+		// Platform warnings have no fields
+		if ( fBudget > 0 )
+		{
+			lua_pushnumber( L, (lua_Number)fNumBytesUsed );
+			lua_setfield( L, -2, "bytesUsed" );
+			lua_pushnumber( L, (lua_Number)fBudget );
+			lua_setfield( L, -2, "budget" );
+		}
 	}
 	return 1;
 }
@@ -999,6 +1042,12 @@ BaseCollisionEvent::Push( lua_State *L ) const
 	return 1;
 }
 
+bool
+BaseCollisionEvent::IsReusable() const
+{
+	return true;
+}
+
 // Collision events follow a propagation model similar to touch events.
 // They propagate to object1, then object2, then to the global Runtime.
 // The choice of object1 and object2 is *arbitrary*, determined by Box2D.
@@ -1535,6 +1584,12 @@ AxisEvent::Push( lua_State *L ) const
 	return 1;
 }
 
+bool
+AxisEvent::IsReusable() const
+{
+	return true;
+}
+
 // ----------------------------------------------------------------------------
 
 const char ColorSampleEvent::kName[] = "colorSample";
@@ -2111,6 +2166,13 @@ TouchEvent::Push( lua_State *L ) const
 	return 1;
 }
 
+bool
+TouchEvent::IsReusable() const
+{
+	// Only "moved" is high-frequency. Apps commonly keep the "began" event around.
+	return kMoved == fPhase;
+}
+
 void
 TouchEvent::Dispatch( lua_State *L, Runtime& runtime ) const
 {
@@ -2169,6 +2231,8 @@ MultitouchEvent::Dispatch( lua_State *L, Runtime& runtime ) const
 	for ( int i = 0, iMax = fNumTouches; i < iMax; i++ )
 	{
 		const TouchEvent& e = fTouches[i];
+		EventPool::Scope scope( runtime.GetEventPool(), L, e );
+
 		DisplayObject *object = stage.GetFocus( e.GetId() );
 		if ( object )
 		{
@@ -92,6 +92,9 @@ class VirtualEvent : public MEvent
 	public:
 		virtual int Push( lua_State *L ) const;
 
+		// Whether Push() may use a pooled table (see EventPool)
+		virtual bool IsReusable() const;
+
 	protected:
 		int PrepareDispatch( lua_State *L ) const;
 
@@ -137,6 +140,7 @@ class FrameEvent : public VirtualEvent
 	public:
 		virtual const char* Name() const;
 		virtual int Push( lua_State *L ) const;
+		virtual bool IsReusable() const;
 };
 
 // ============================================================================
@@ -311,6 +315,7 @@ class AccelerometerEvent : public VirtualEvent
 	public:
 		virtual const char* Name() const;
 		virtual int Push( lua_State *L ) const;
+		virtual bool IsReusable() const;
 
 	private:
 		// We use doubles here b/c lua_Numbers are double and the source data was typically double
@@ -423,10 +428,17 @@ class MemoryWarningEvent : public VirtualEvent
 		
 	public:
 		MemoryWarningEvent( );
+
+		// Sent by the runtime when usage goes over the config.lua memoryBudget
+		MemoryWarningEvent( size_t numBytesUsed, size_t budget );
 		
 	public:
 		virtual const char* Name() const;
 		virtual int Push( lua_State *L ) const;
+
+	private:
+		size_t fNumBytesUsed;
+		size_t fBudget;
 };
 
 // ----------------------------------------------------------------------------
@@ -578,6 +590,7 @@ class BaseCollisionEvent : public VirtualEvent
 
 	public:
 		virtual int Push( lua_State *L ) const;
+		virtual bool IsReusable() const;
 		virtual void Dispatch( lua_State *L, Runtime& runtime ) const;
 		
 	private:
@@ -789,6 +802,7 @@ class AxisEvent : public VirtualEvent
 
 		virtual const char* Name() const;
 		virtual int Push( lua_State *L ) const;
+		virtual bool IsReusable() const;
 
 	protected:
 		PlatformInputDevice *fDevicePointer;
@@ -923,6 +937,7 @@ class TouchEvent : public HitEvent
 	public:
 		virtual const char* Name() const;
 		virtual int Push( lua_State *L ) const;
+		virtual bool IsReusable() const;
 		virtual void Dispatch( lua_State *L, Runtime& runtime ) const;
 
 	public:
@@ -0,0 +1,258 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_EventPool.h"
+
+#include "Rtt_Event.h"
+#include "Rtt_Lua.h"
+
+#include "lua.h"
+#include "lauxlib.h"
+
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+#if defined( Rtt_DEBUG ) || defined( Rtt_AUTHORING_SIMULATOR )
+	#define Rtt_EVENT_POOL_EXPIRE
+#endif
+
+// Registry table mapping event names to their pooled tables
+static const char kPoolKey[] = "Rtt::EventPool";
+
+#ifdef Rtt_EVENT_POOL_EXPIRE
+
+// Registry key of the metatable attached to pooled tables between dispatches
+static const char kExpiredKey[] = "Rtt::EventPool::Expired";
+
+static int
+ExpiredAccess( lua_State *L )
+{
+	return luaL_error( L,
+		"ERROR: An event table was used after its dispatch ended. "
+		"Event tables are reused when 'reuseEventTables' is set in config.lua, "
+		"so listeners must copy any fields they need later." );
+}
+
+#endif // Rtt_EVENT_POOL_EXPIRE
+
+// Removes every field of the table at 'index'
+static void
+ClearTable( lua_State *L, int index )
+{
+	lua_pushnil( L );
+	while ( lua_next( L, index ) )
+	{
+		lua_pop( L, 1 );
+
+		// Assigning nil to an existing field is safe during traversal
+		lua_pushvalue( L, -1 );
+		lua_pushnil( L );
+		lua_rawset( L, index );
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+EventPool::Statistics::Statistics()
+:	fTablesCreated( 0 ),
+	fTablesReused( 0 )
+{
+}
+
+// ----------------------------------------------------------------------------
+
+EventPool::Scope::Scope( EventPool& pool, lua_State *L, const MEvent& e )
+:	fPool( pool ),
+	fL( L ),
+	fEvent( e )
+{
+	fPool.Begin( fEvent );
+}
+
+EventPool::Scope::~Scope()
+{
+	fPool.End( fL, fEvent );
+}
+
+// ----------------------------------------------------------------------------
+
+EventPool::EventPool( Rtt_Allocator *allocator )
+:	fScopes( allocator ),
+	fCurrent(),
+	fStatistics(),
+	fIsEnabled( false )
+{
+}
+
+void
+EventPool::PushTable( lua_State *L, const MEvent& e, bool isReusable )
+{
+	Entry *entry = ( fIsEnabled && isReusable ? Find( e ) : NULL );
+	if ( entry && ( entry->fIsClaimed || Claim( * entry ) ) )
+	{
+		PushPooledTable( L, e.Name() );
+	}
+	else
+	{
+		Lua::NewEvent( L, e.Name() );
+		++fCurrent.fTablesCreated;
+	}
+}
+
+void
+EventPool::BeginFrame()
+{
+	fStatistics = fCurrent;
+	fCurrent = Statistics();
+}
+
+void
+EventPool::Begin( const MEvent& e )
+{
+	if ( fIsEnabled )
+	{
+		Entry entry = { & e, false };
+		fScopes.Append( entry );
+	}
+}
+
+void
+EventPool::End( lua_State *L, const MEvent& e )
+{
+	// Scopes are strictly nested, so 'e' is on top unless pooling
+	// was enabled while it was being dispatched.
+	S32 index = fScopes.Length() - 1;
+	if ( index >= 0 && fScopes[index].fEvent == & e )
+	{
+#ifdef Rtt_EVENT_POOL_EXPIRE
+		if ( fScopes[index].fIsClaimed )
+		{
+			Expire( L, e.Name() );
+		}
+#endif
+		fScopes.Remove( index, 1 );
+	}
+}
+
+EventPool::Entry*
+EventPool::Find( const MEvent& e )
+{
+	for ( S32 i = fScopes.Length() - 1; i >= 0; i-- )
+	{
+		if ( fScopes[i].fEvent == & e )
+		{
+			return & fScopes[i];
+		}
+	}
+
+	return NULL;
+}
+
+bool
+EventPool::Claim( Entry& entry )
+{
+	// An enclosing dispatch of the same name may still be using the table
+	const char *name = entry.fEvent->Name();
+	for ( S32 i = 0, iMax = fScopes.Length(); i < iMax; i++ )
+	{
+		const Entry& other = fScopes[i];
+		if ( other.fIsClaimed && 0 == strcmp( other.fEvent->Name(), name ) )
+		{
+			return false;
+		}
+	}
+
+	entry.fIsClaimed = true;
+	return true;
+}
+
+void
+EventPool::PushPooledTable( lua_State *L, const char *name )
+{
+	lua_getfield( L, LUA_REGISTRYINDEX, kPoolKey );
+	if ( ! lua_istable( L, -1 ) )
+	{
+		lua_pop( L, 1 );
+		lua_newtable( L );
+		lua_pushvalue( L, -1 );
+		lua_setfield( L, LUA_REGISTRYINDEX, kPoolKey );
+	}
+
+	lua_getfield( L, -1, name );
+	if ( lua_istable( L, -1 ) )
+	{
+		// The same event may be pushed several times per dispatch (e.g. a
+		// collision goes to both objects, then Runtime), so always start
+		// from an empty table.
+		ClearTable( L, lua_gettop( L ) );
+#ifdef Rtt_EVENT_POOL_EXPIRE
+		lua_pushnil( L );
+		lua_setmetatable( L, -2 );
+#endif
+		lua_pushstring( L, name );
+		lua_setfield( L, -2, MEvent::kNameKey );
+		++fCurrent.fTablesReused;
+	}
+	else
+	{
+		lua_pop( L, 1 );
+		Lua::NewEvent( L, name );
+		lua_pushvalue( L, -1 );
+		lua_setfield( L, -3, name );
+		++fCurrent.fTablesCreated;
+	}
+
+	lua_remove( L, -2 ); // pop pool
+}
+
+void
+EventPool::Expire( lua_State *L, const char *name )
+{
+#ifdef Rtt_EVENT_POOL_EXPIRE
+	lua_getfield( L, LUA_REGISTRYINDEX, kPoolKey );
+	if ( lua_istable( L, -1 ) )
+	{
+		lua_getfield( L, -1, name );
+		if ( lua_istable( L, -1 ) )
+		{
+			ClearTable( L, lua_gettop( L ) );
+
+			lua_getfield( L, LUA_REGISTRYINDEX, kExpiredKey );
+			if ( ! lua_istable( L, -1 ) )
+			{
+				lua_pop( L, 1 );
+				lua_createtable( L, 0, 2 );
+				lua_pushcfunction( L, & ExpiredAccess );
+				lua_setfield( L, -2, "__index" );
+				lua_pushcfunction( L, & ExpiredAccess );
+				lua_setfield( L, -2, "__newindex" );
+				lua_pushvalue( L, -1 );
+				lua_setfield( L, LUA_REGISTRYINDEX, kExpiredKey );
+			}
+			lua_setmetatable( L, -2 );
+		}
+		lua_pop( L, 1 );
+	}
+	lua_pop( L, 1 );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_EventPool_H__
+#define _Rtt_EventPool_H__
+
+#include "Core/Rtt_Types.h"
+#include "Core/Rtt_Array.h"
+
+// ----------------------------------------------------------------------------
+
+struct lua_State;
+
+namespace Rtt
+{
+
+class MEvent;
+
+// ----------------------------------------------------------------------------
+
+// Recycles the Lua tables of high-frequency events (enterFrame, collision,
+// accelerometer, axis, touch "moved") instead of creating a new table per
+// dispatch.
+//
+// A pooled table is only handed out while its event is being dispatched
+// inside a Scope, and only to the outermost such event of a given name, so
+// nested dispatches still get their own table. Listeners must not keep a
+// pooled table after they return. In debug and simulator builds, touching
+// one afterwards raises a Lua error.
+//
+// Disabled by default (see "reuseEventTables" in config.lua).
+class EventPool
+{
+	Rtt_CLASS_NO_COPIES( EventPool )
+
+	public:
+		struct Statistics
+		{
+			Statistics();
+
+			U32 fTablesCreated;			// Number of event tables created
+			U32 fTablesReused;			// Number of event tables taken from the pool
+		};
+
+		// Marks 'e' as being dispatched for the lifetime of the scope
+		class Scope
+		{
+			Rtt_CLASS_NO_COPIES( Scope )
+
+			public:
+				Scope( EventPool& pool, lua_State *L, const MEvent& e );
+				~Scope();
+
+			private:
+				EventPool& fPool;
+				lua_State *fL;
+				const MEvent& fEvent;
+		};
+
+	public:
+		EventPool( Rtt_Allocator *allocator );
+
+	public:
+		bool IsEnabled() const { return fIsEnabled; }
+		void SetEnabled( bool newValue ) { fIsEnabled = newValue; }
+
+	public:
+		// Pushes a table for 'e' with its "name" field set. The table comes
+		// from the pool when 'isReusable' is set and 'e' is being dispatched
+		// in a Scope; otherwise, a new table is created.
+		void PushTable( lua_State *L, const MEvent& e, bool isReusable );
+
+	public:
+		// Call at the start of a frame
+		void BeginFrame();
+
+		// Get the previous frame's statistics.
+		const Statistics& GetFrameStatistics() const { return fStatistics; }
+
+	protected:
+		void Begin( const MEvent& e );
+		void End( lua_State *L, const MEvent& e );
+
+	private:
+		struct Entry
+		{
+			const MEvent *fEvent;
+			bool fIsClaimed;
+		};
+
+		Entry* Find( const MEvent& e );
+		bool Claim( Entry& entry );
+
+		void PushPooledTable( lua_State *L, const char *name );
+		void Expire( lua_State *L, const char *name );
+
+	private:
+		Array< Entry > fScopes;
+		Statistics fCurrent;
+		Statistics fStatistics;
+		bool fIsEnabled;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_EventPool_H__
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_GCScheduler.h"
+
+#include "Core/Rtt_Math.h"
+#include "Display/Rtt_Display.h"
+#include "Display/Rtt_Scene.h"
+#include "Rtt_LuaContext.h"
+#include "Rtt_Runtime.h"
+
+#include "lua.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Always delete a few orphans per frame, even when the frame ran over,
+// so the graveyard cannot grow without bound under sustained load.
+static const U32 kMinObjectsPerFrame = 16;
+
+static const S32 kDefaultStepSize = 16;
+
+GCScheduler::Statistics::Statistics()
+:	fTime( Rtt_REAL_0 ),
+	fLuaStepCount( 0 ),
+	fLuaCycleCount( 0 ),
+	fObjectsDestroyed( 0 ),
+	fObjectsPending( 0 )
+{
+}
+
+// ----------------------------------------------------------------------------
+
+GCScheduler::GCScheduler( Runtime& owner )
+:	fOwner( owner ),
+	fFrameStart( Rtt_GetAbsoluteTime() ),
+	fFrameBudget( Rtt_REAL_0 ),
+	fStepSize( kDefaultStepSize ),
+	fStatistics()
+{
+}
+
+void
+GCScheduler::SetFrameBudget( Real newValue )
+{
+	fFrameBudget = Max( newValue, Rtt_REAL_0 );
+
+	if ( fOwner.IsDisplayValid() )
+	{
+		fOwner.GetDisplay().GetScene().SetTeardownDeferred( IsEnabled() );
+	}
+}
+
+void
+GCScheduler::BeginFrame()
+{
+	fFrameStart = Rtt_GetAbsoluteTime();
+}
+
+void
+GCScheduler::Step()
+{
+	if ( ! IsEnabled() || ! fOwner.IsVMContextValid() || ! fOwner.IsDisplayValid() )
+	{
+		return;
+	}
+
+	Statistics stats;
+
+	const Rtt_AbsoluteTime stepStart = Rtt_GetAbsoluteTime();
+
+	// Budget is whatever is left of the frame, capped by fFrameBudget
+	const U64 frameInterval = (U64)( 1000000.f * fOwner.GetFrameInterval() );
+	const U64 frameElapsed = Rtt_AbsoluteToMicroseconds( stepStart - fFrameStart );
+	const U64 maxBudget = (U64)( 1000.f * fFrameBudget );
+	const U64 budget = ( frameElapsed < frameInterval ? Min( frameInterval - frameElapsed, maxBudget ) : 0 );
+
+	Scene& scene = fOwner.GetDisplay().GetScene();
+
+	// Display objects first. Deleting them queues their GPU resources for
+	// release (via Renderer::QueueDestroy) and drops references the Lua
+	// steps below can then reclaim.
+	U64 elapsed = 0;
+	while ( ( stats.fObjectsDestroyed < kMinObjectsPerFrame || elapsed < budget )
+			&& scene.DestroyUnreachable() )
+	{
+		++stats.fObjectsDestroyed;
+		elapsed = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - stepStart );
+	}
+
+	lua_State *L = fOwner.VMContext().L();
+	while ( elapsed < budget )
+	{
+		++stats.fLuaStepCount;
+
+		// Stop once a cycle completes; starting the next one right away
+		// would only re-traverse a heap we just finished with.
+		if ( lua_gc( L, LUA_GCSTEP, fStepSize ) )
+		{
+			++stats.fLuaCycleCount;
+			break;
+		}
+
+		elapsed = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - stepStart );
+	}
+
+	stats.fTime = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - stepStart ) / 1000.f;
+	stats.fObjectsPending = scene.NumUnreachables();
+
+	fStatistics = stats;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
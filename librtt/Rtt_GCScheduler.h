@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_GCScheduler_H__
+#define _Rtt_GCScheduler_H__
+
+#include "Core/Rtt_Types.h"
+#include "Core/Rtt_Real.h"
+#include "Core/Rtt_Time.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+class Runtime;
+
+// ----------------------------------------------------------------------------
+
+// Spends whatever is left of a frame (after Display::Render) on garbage:
+// deleting orphaned display objects and stepping the incremental Lua GC.
+//
+// Disabled by default. When enabled, orphaned display objects are still
+// finalized at the end of each Lua call, but their deletion is deferred
+// to the scheduler so removing a large subtree does not cause a hitch.
+class GCScheduler
+{
+	Rtt_CLASS_NO_COPIES( GCScheduler )
+
+	public:
+		struct Statistics
+		{
+			Statistics();
+
+			Real fTime;					// Time spent collecting in ms
+			U32 fLuaStepCount;			// Number of LUA_GCSTEP calls
+			U32 fLuaCycleCount;			// Number of Lua GC cycles completed
+			U32 fObjectsDestroyed;		// Number of display objects deleted
+			U32 fObjectsPending;		// Number of orphaned subtrees still awaiting deletion
+		};
+
+	public:
+		GCScheduler( Runtime& owner );
+
+	public:
+		// Maximum time (in ms) spent collecting per frame. 0 disables the scheduler.
+		Real GetFrameBudget() const { return fFrameBudget; }
+		void SetFrameBudget( Real newValue );
+
+		// Size of each incremental Lua GC step (see lua_gc)
+		S32 GetStepSize() const { return fStepSize; }
+		void SetStepSize( S32 newValue ) { fStepSize = newValue; }
+
+		bool IsEnabled() const { return fFrameBudget > Rtt_REAL_0; }
+
+	public:
+		// Call at the start of a frame, before the Scheduler and Display::Update
+		void BeginFrame();
+
+		// Call after Display::Render. Uses the time left in the frame (capped
+		// by the frame budget) to delete orphans and step the Lua GC.
+		void Step();
+
+		// Get the previous frame's statistics.
+		const Statistics& GetFrameStatistics() const { return fStatistics; }
+
+	private:
+		Runtime& fOwner;
+		Rtt_AbsoluteTime fFrameStart;
+		Real fFrameBudget;
+		S32 fStepSize;
+		Statistics fStatistics;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_GCScheduler_H__
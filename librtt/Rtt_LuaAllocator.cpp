@@ -0,0 +1,225 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_LuaAllocator.h"
+
+#include "Core/Rtt_FixedBlockAllocator.h"
+#include "Core/Rtt_Math.h"
+
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Multiples of 8 so every block stays double-aligned. Spacing widens with
+// size to bound the per-block waste. Must end at kMaxSmallSize.
+static const U16 kSizeClassBytes[LuaAllocator::kNumSizeClasses] =
+{
+	16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256
+};
+
+// ----------------------------------------------------------------------------
+
+LuaAllocator::LuaAllocator( Rtt_Allocator *allocator )
+:	fAllocator( allocator ),
+	fLargeBytes( 0 ),
+	fLargeBlocks( 0 )
+{
+	Rtt_ASSERT( kMaxSmallSize == kSizeClassBytes[kNumSizeClasses - 1] );
+
+	for ( S32 i = 0; i < kNumSizeClasses; i++ )
+	{
+		SizeClass& sizeClass = fSizeClasses[i];
+		sizeClass.fStatistics.fBlockSize = kSizeClassBytes[i];
+		sizeClass.fStatistics.fBlocksUsed = 0;
+		sizeClass.fStatistics.fBlocksFree = 0;
+		sizeClass.fStatistics.fPageCount = 0;
+		sizeClass.fPages = NULL;
+		sizeClass.fFreeList = NULL;
+	}
+
+	// Map each 8-byte step to the smallest size class that fits it
+	for ( S32 i = 0, index = 0, iMax = sizeof( fSizeClassIndex ); i < iMax; i++ )
+	{
+		while ( kSizeClassBytes[index] < ( i << 3 ) )
+		{
+			++index;
+		}
+		fSizeClassIndex[i] = index;
+	}
+}
+
+LuaAllocator::~LuaAllocator()
+{
+	for ( S32 i = 0; i < kNumSizeClasses; i++ )
+	{
+		for ( FixedBlock *iCurrent = fSizeClasses[i].fPages, *iNext;
+			  iCurrent;
+			  iCurrent = iNext )
+		{
+			iNext = iCurrent->Next();
+
+			FixedBlock::Destroy( iCurrent );
+		}
+	}
+}
+
+void*
+LuaAllocator::Realloc( void *ptr, size_t osize, size_t nsize )
+{
+	if ( NULL == ptr )
+	{
+		osize = 0;
+	}
+
+	S32 oldIndex = ( osize > 0 ? SizeClassFor( osize ) : -1 );
+
+	if ( 0 == nsize )
+	{
+		if ( oldIndex >= 0 )
+		{
+			FreeSmall( oldIndex, ptr );
+		}
+		else if ( ptr )
+		{
+			Rtt_CNTX_FREE( fAllocator, ptr );
+			fLargeBytes -= osize;
+			--fLargeBlocks;
+		}
+		return NULL;
+	}
+
+	S32 newIndex = SizeClassFor( nsize );
+
+	if ( ptr && oldIndex == newIndex )
+	{
+		if ( oldIndex >= 0 )
+		{
+			// Same block size, so grow or shrink in place
+			return ptr;
+		}
+
+		// Large to large. Shrinks go to the heap too, so the tail is released.
+		void *result = Rtt_CNTX_REALLOC( fAllocator, ptr, nsize );
+		if ( result )
+		{
+			fLargeBytes = fLargeBytes - osize + nsize;
+		}
+		return result;
+	}
+
+	// New block, or moving between size classes
+	void *result = NULL;
+	if ( newIndex >= 0 )
+	{
+		result = AllocSmall( newIndex );
+	}
+	else
+	{
+		result = Rtt_CNTX_MALLOC( fAllocator, nsize );
+		if ( result )
+		{
+			fLargeBytes += nsize;
+			++fLargeBlocks;
+		}
+	}
+
+	if ( result && ptr )
+	{
+		memcpy( result, ptr, Min( osize, nsize ) );
+		(void)Realloc( ptr, osize, 0 );
+	}
+
+	return result;
+}
+
+void
+LuaAllocator::GetStatistics( Statistics& outStats ) const
+{
+	outStats.fSmallBytes = 0;
+	outStats.fPageBytes = 0;
+	outStats.fLargeBytes = fLargeBytes;
+	outStats.fLargeBlocks = fLargeBlocks;
+
+	for ( S32 i = 0; i < kNumSizeClasses; i++ )
+	{
+		const SizeClassStatistics& stats = fSizeClasses[i].fStatistics;
+		outStats.fSmallBytes += stats.fBlocksUsed * stats.fBlockSize;
+		outStats.fPageBytes += stats.fPageCount * MemoryPage::kSize;
+	}
+}
+
+const LuaAllocator::SizeClassStatistics&
+LuaAllocator::GetSizeClassStatistics( S32 index ) const
+{
+	Rtt_ASSERT( index >= 0 && index < kNumSizeClasses );
+
+	return fSizeClasses[index].fStatistics;
+}
+
+void*
+LuaAllocator::AllocSmall( S32 index )
+{
+	SizeClass& sizeClass = fSizeClasses[index];
+
+	void *result = sizeClass.fFreeList;
+	if ( result )
+	{
+		// The contents of a free block stores the next ptr in the free list
+		sizeClass.fFreeList = *((void**)result);
+		--sizeClass.fStatistics.fBlocksFree;
+	}
+	else
+	{
+		// Blocks only ever return to our free list, so the head page
+		// is the only one that can still have room.
+		result = ( sizeClass.fPages ? sizeClass.fPages->Alloc() : NULL );
+		if ( ! result )
+		{
+			FixedBlock *page = FixedBlock::Create( sizeClass.fStatistics.fBlockSize, sizeClass.fPages );
+			if ( Rtt_VERIFY( page ) )
+			{
+				sizeClass.fPages = page;
+				++sizeClass.fStatistics.fPageCount;
+				result = page->Alloc(); Rtt_ASSERT( result );
+			}
+		}
+	}
+
+	if ( result )
+	{
+		++sizeClass.fStatistics.fBlocksUsed;
+	}
+
+	return result;
+}
+
+void
+LuaAllocator::FreeSmall( S32 index, void *p )
+{
+	SizeClass& sizeClass = fSizeClasses[index];
+
+	*((void**)p) = sizeClass.fFreeList;
+	sizeClass.fFreeList = p;
+
+	--sizeClass.fStatistics.fBlocksUsed;
+	++sizeClass.fStatistics.fBlocksFree;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_LuaAllocator_H__
+#define _Rtt_LuaAllocator_H__
+
+#include "Core/Rtt_Types.h"
+#include "Core/Rtt_Allocator.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+class FixedBlock;
+
+// ----------------------------------------------------------------------------
+
+// Backs a single lua_State (see LuaContext::Alloc).
+//
+// Small blocks (tables, closures, short strings, etc) are carved out of
+// page-sized FixedBlock slabs, one set of slabs per size class, and recycled
+// through a per-class free list. Larger blocks go to the general-purpose heap.
+//
+// A Lua state is only ever used from one thread at a time, so the slabs
+// belong to the state and need no locking.
+class LuaAllocator
+{
+	Rtt_CLASS_NO_COPIES( LuaAllocator )
+
+	public:
+		enum
+		{
+			kNumSizeClasses = 15
+		};
+
+		// Requests larger than this go to the general-purpose heap
+		static const size_t kMaxSmallSize = 256;
+
+		struct SizeClassStatistics
+		{
+			U32 fBlockSize;				// Size in bytes of each block
+			U32 fBlocksUsed;			// Number of blocks handed out to Lua
+			U32 fBlocksFree;			// Number of blocks on the free list
+			U32 fPageCount;				// Number of slabs allocated
+		};
+
+		struct Statistics
+		{
+			size_t fSmallBytes;			// Bytes handed out in small blocks (rounded up to block size)
+			size_t fPageBytes;			// Bytes reserved by slabs
+			size_t fLargeBytes;			// Bytes handed out in large blocks
+			U32 fLargeBlocks;			// Number of large blocks
+		};
+
+	public:
+		LuaAllocator( Rtt_Allocator *allocator );
+		~LuaAllocator();
+
+	public:
+		// lua_Alloc semantics: 'osize' must be the size of 'ptr' as last requested
+		void* Realloc( void *ptr, size_t osize, size_t nsize );
+
+	public:
+		void GetStatistics( Statistics& outStats ) const;
+		const SizeClassStatistics& GetSizeClassStatistics( S32 index ) const;
+
+	protected:
+		// Returns -1 if 'size' is not a small size
+		Rtt_INLINE S32 SizeClassFor( size_t size ) const
+		{
+			return ( size <= kMaxSmallSize ? fSizeClassIndex[( size + 7 ) >> 3] : -1 );
+		}
+
+		void* AllocSmall( S32 index );
+		void FreeSmall( S32 index, void *p );
+
+	private:
+		struct SizeClass
+		{
+			SizeClassStatistics fStatistics;
+			FixedBlock *fPages;
+			void *fFreeList;
+		};
+
+		Rtt_Allocator *fAllocator;
+		SizeClass fSizeClasses[kNumSizeClasses];
+		S8 fSizeClassIndex[( kMaxSmallSize >> 3 ) + 1];
+		size_t fLargeBytes;
+		U32 fLargeBlocks;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_LuaAllocator_H__
@@ -18,6 +18,7 @@
 #include "Display/Rtt_StageObject.h"
 #include "Rtt_Archive.h"
 #include "Rtt_Event.h"
+#include "Rtt_LuaAllocator.h"
 #include "Rtt_LuaAux.h"
 #include "Rtt_LuaFile.h"
 #include "Rtt_LuaFrameworks.h"
@@ -25,6 +26,7 @@
 #include "Rtt_LuaCoronaBaseLib.h"
 #include "Rtt_LuaLibCrypto.h"
 #include "Rtt_LuaLibFacebook.h"
+#include "Rtt_LuaLibJSON.h"
 #include "Rtt_LuaLibMedia.h"
 #if defined ( Rtt_USE_ALMIXER )
 #include "Rtt_LuaLibOpenAL.h"
@@ -190,28 +192,6 @@ LuaContext::stackdump(lua_State* L)
 
 // ----------------------------------------------------------------------------
 
-void*
-LuaContext::Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
-{
-	if ( 0 == nsize )
-	{
-		Rtt_CNTX_FREE( (Rtt_Allocator*)ud, ptr );
-		return NULL;
-	}
-	else if ( 0 == osize )
-	{
-		return Rtt_CNTX_MALLOC( (Rtt_Allocator*)ud, nsize );
-	}
-	else if ( nsize <= osize )
-	{
-		return ptr;
-	}
-	else
-	{
-		return Rtt_CNTX_REALLOC( (Rtt_Allocator*)ud, ptr, nsize );
-	}
-}
-
 int
 LuaContext::Panic( ::lua_State* L )
 {
@@ -761,6 +741,7 @@ LuaContext::InitializeLuaCore( lua_State* L )
 		{ "launchpad", Lua::Open< luaload_launchpad> },
 		{ "dkjson", Lua::Open< luaload_dkjson > },
 		{ "json", Lua::Open< luaload_json > },
+		{ "json_native", LuaLibJSON::Open },
 		{ "widget", Lua::Open< luaload_widget > },
 		{ "widget_button", Lua::Open< luaload_widget_button > },
 		{ "widget_momentumScrolling", Lua::Open< luaload_widget_momentumScrolling > },
@@ -1055,6 +1036,7 @@ class LuaContextUserdata
 		const MPlatform& GetPlatform() const { return fPlatform; }
 		Runtime* GetRuntime() const { return fRuntime; }
 		LuaContext* GetOwner() const { return fOwner; }
+		LuaAllocator& GetLuaAllocator() { return fLuaAllocator; }
 
 	// Weak references. Does NOT own these.
 	private:
@@ -1062,13 +1044,17 @@ class LuaContextUserdata
 		const MPlatform& fPlatform;
 		Runtime *fRuntime;
 		LuaContext *fOwner;
+
+	private:
+		LuaAllocator fLuaAllocator;
 };
 
 LuaContextUserdata::LuaContextUserdata( Rtt_Allocator* pAllocator, const MPlatform& platform, Runtime *runtime )
 :	fAllocator( pAllocator ),
 	fPlatform( platform ),
 	fRuntime( runtime ),
-	fOwner( NULL )
+	fOwner( NULL ),
+	fLuaAllocator( pAllocator )
 {
 }
 
@@ -1083,6 +1069,12 @@ LuaContextUserdata::Initialize( LuaContext *owner )
 
 // ----------------------------------------------------------------------------	
 
+void*
+LuaContext::Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+	return static_cast< LuaContextUserdata* >( ud )->GetLuaAllocator().Realloc( ptr, osize, nsize );
+}
+
 LuaContext*
 LuaContext::New( Rtt_Allocator* pAllocator, const MPlatform& platform, Runtime *runtime )
 {
@@ -1133,6 +1125,14 @@ LuaContext::GetAllocator( lua_State* L )
 	return static_cast< LuaContextUserdata* >( ud )->GetAllocator();
 }	
 
+LuaAllocator&
+LuaContext::GetLuaAllocator( lua_State* L )
+{
+	void *ud = NULL;
+	(void)lua_getallocf( L, & ud ); Rtt_ASSERT( ud );
+	return static_cast< LuaContextUserdata* >( ud )->GetLuaAllocator();
+}
+
 const MPlatform&
 LuaContext::GetPlatform( lua_State* L )
 {
@@ -19,6 +19,7 @@
 namespace Rtt
 {
 
+class LuaAllocator;
 class MEvent;
 class MPlatform;
 class Runtime;
@@ -36,6 +37,7 @@ class LuaContext
 		static void Delete( LuaContext *context );
 
 		static Rtt_Allocator* GetAllocator( lua_State* L );
+		static LuaAllocator& GetLuaAllocator( lua_State* L );
 		static const MPlatform& GetPlatform( lua_State* L );
 		static Runtime* GetRuntime( lua_State* L );
         static bool HasRuntime( lua_State* L );
@@ -13,8 +13,27 @@
 
 #include "Rtt_LuaAux.h"
 #include "Rtt_LuaContext.h"
+#include "Rtt_Runtime.h"
+#include "Rtt_Scheduler.h"
+#include "Core/Rtt_FileSystem.h"
 
+#include <limits.h>
 #include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if defined( Rtt_WIN_ENV ) || defined( Rtt_POWERVR_ENV )
+	#ifndef S_IRUSR
+		#define S_IRUSR _S_IREAD	///< read by user
+	#endif
+	#ifndef S_ISDIR
+		#define S_ISDIR( mode ) ( ( ( mode ) & _S_IFMT ) == _S_IFDIR )
+	#endif
+#endif
+
+#include <atomic>
+#include <string>
+#include <thread>
 
 #include "Rtt_MCrypto.h"
 #include "Rtt_MPlatform.h"
@@ -109,6 +128,380 @@ hmac( lua_State *L )
 	return result;
 }
 
+// ----------------------------------------------------------------------------
+
+// Used where the platform has no incremental digest: the message is kept
+// until Final() and hashed in one call. Not safe to use off the Lua thread.
+class BufferedDigest : public MCrypto::Digest
+{
+	public:
+		BufferedDigest( const MCrypto& crypto, MCrypto::Algorithm algorithm )
+		:	fCrypto( crypto ),
+			fAlgorithm( algorithm )
+		{
+		}
+
+	public:
+		virtual void Update( const void *data, size_t length )
+		{
+			fMessage.append( (const char *)data, length );
+		}
+
+		virtual void Final( U8 *md )
+		{
+			Rtt::Data<const char> data( fMessage.data(), (int)fMessage.length() );
+			fCrypto.CalculateDigest( fAlgorithm, data, md );
+			std::string().swap( fMessage );
+		}
+
+	private:
+		const MCrypto& fCrypto;
+		MCrypto::Algorithm fAlgorithm;
+		std::string fMessage;
+};
+
+// ----------------------------------------------------------------------------
+
+static const char kDigestMetatable[] = "crypto.digest";
+
+struct DigestUserdata
+{
+	MCrypto::Digest *digest; // NULL once final() is called
+	size_t digestLen;
+	size_t bufferedLen; // only counted for a BufferedDigest
+	bool isBuffered;
+};
+
+static DigestUserdata *
+CheckDigest( lua_State *L, int index )
+{
+	return (DigestUserdata *)luaL_checkudata( L, index, kDigestMetatable );
+}
+
+// digest:update( chunk ) returns digest so calls can be chained
+static int
+digestUpdate( lua_State *L )
+{
+	DigestUserdata *ud = CheckDigest( L, 1 );
+	size_t length = 0;
+	const char *chunk = luaL_checklstring( L, 2, & length );
+
+	if ( ! ud->digest )
+	{
+		luaL_error( L, "digest:update() called after digest:final()" );
+	}
+	if ( ud->isBuffered )
+	{
+		// The message is hashed in one call, which takes an int length
+		if ( length > (size_t)INT_MAX - ud->bufferedLen )
+		{
+			luaL_error( L, "digest:update() message is too large to hash on this platform" );
+		}
+		ud->bufferedLen += length;
+	}
+	ud->digest->Update( chunk, length );
+
+	lua_settop( L, 1 );
+	return 1;
+}
+
+// digest:final( [raw] )
+static int
+digestFinal( lua_State *L )
+{
+	DigestUserdata *ud = CheckDigest( L, 1 );
+
+	if ( ! ud->digest )
+	{
+		luaL_error( L, "digest:final() called more than once" );
+	}
+
+	U8 md[MCrypto::kMaxDigestSize];
+	ud->digest->Final( md );
+	delete ud->digest;
+	ud->digest = NULL;
+
+	PushDigest( L, md, (int) ud->digestLen, lua_toboolean( L, 2 ) );
+	return 1;
+}
+
+static int
+digestFinalizer( lua_State *L )
+{
+	DigestUserdata *ud = CheckDigest( L, 1 );
+	delete ud->digest;
+	ud->digest = NULL;
+	return 0;
+}
+
+
+// crypto.newDigest( algorithm )
+static int
+newDigest( lua_State *L )
+{
+	S32 algorithm = EnumForUserdata( kAlgorithms, lua_touserdata( L, 1 ), MCrypto::kNumAlgorithms, -1 );
+
+	if ( algorithm < 0 )
+	{
+		CoronaLuaError( L, "crypto.newDigest() unknown message digest algorithm" );
+		return 0;
+	}
+
+	const MCrypto& crypto = LuaContext::GetPlatform( L ).GetCrypto();
+
+	DigestUserdata *ud = (DigestUserdata *)lua_newuserdata( L, sizeof( DigestUserdata ) );
+	ud->digest = NULL;
+	ud->digestLen = crypto.GetDigestLength( (MCrypto::Algorithm)algorithm );
+	ud->bufferedLen = 0;
+	ud->isBuffered = false;
+
+	if ( luaL_newmetatable( L, kDigestMetatable ) )
+	{
+		const luaL_Reg kMethods[] =
+		{
+			{ "update", digestUpdate },
+			{ "final", digestFinal },
+			{ "__gc", digestFinalizer },
+
+			{ NULL, NULL }
+		};
+		luaL_register( L, NULL, kMethods );
+
+		lua_pushvalue( L, -1 );
+		lua_setfield( L, -2, "__index" );
+	}
+	lua_setmetatable( L, -2 );
+
+	ud->digest = crypto.NewDigest( (MCrypto::Algorithm)algorithm );
+	if ( ! ud->digest )
+	{
+		ud->digest = new BufferedDigest( crypto, (MCrypto::Algorithm)algorithm );
+		ud->isBuffered = true;
+	}
+
+	return 1;
+}
+
+// ----------------------------------------------------------------------------
+
+// Hashes a file for crypto.digestFile() and reports back to the listener.
+//
+// The file is memory mapped and hashed kChunkSize bytes at a time: on a
+// worker thread where the platform's incremental digest is thread safe,
+// otherwise one chunk per frame on the Lua thread. Platforms without an
+// incremental digest hash the whole file on the frame after the call.
+class DigestFileTask : public Task
+{
+	public:
+		typedef Task Super;
+
+		enum
+		{
+			kChunkSize = 1024 * 1024
+		};
+
+	public:
+		DigestFileTask( const MCrypto& crypto, MCrypto::Algorithm algorithm, const char *path, Lua::Ref listener );
+		virtual ~DigestFileTask();
+
+	public:
+		virtual void operator()( Scheduler& sender );
+
+	protected:
+		void Run();
+		void Step();
+
+	private:
+		const MCrypto& fCrypto;
+		MCrypto::Algorithm fAlgorithm;
+		std::string fPath;
+		Lua::Ref fListener;
+		MCrypto::Digest *fDigest;
+		size_t fDigestLen;
+		const void *fData;
+		size_t fDataLen;
+		size_t fOffset; // bytes hashed by Step()
+		bool fIsError;
+		U8 fMD[MCrypto::kMaxDigestSize];
+		std::thread fThread;
+		std::atomic<bool> fIsDone;
+		std::atomic<bool> fIsCancelled;
+};
+
+DigestFileTask::DigestFileTask( const MCrypto& crypto, MCrypto::Algorithm algorithm, const char *path, Lua::Ref listener )
+:	Super( true ),
+	fCrypto( crypto ),
+	fAlgorithm( algorithm ),
+	fPath( path ),
+	fListener( listener ),
+	fDigest( crypto.NewDigest( algorithm ) ),
+	fDigestLen( crypto.GetDigestLength( algorithm ) ),
+	fData( NULL ),
+	fDataLen( 0 ),
+	fOffset( 0 ),
+	fIsError( false ),
+	fIsDone( false ),
+	fIsCancelled( false )
+{
+	// Mapping is done here, on the Lua thread, as some platforms keep
+	// bookkeeping for mapped views that is not thread safe
+	struct stat statbuf;
+	if ( 0 == Rtt_FileStatus( path, & statbuf ) && ! S_ISDIR( statbuf.st_mode ) )
+	{
+		// Hashing in one call is limited to messages whose length fits an int
+		bool isTooLarge = ( ! fDigest && (U64)statbuf.st_size > (U64)INT_MAX );
+		if ( ! isTooLarge )
+		{
+			fDataLen = (size_t)statbuf.st_size;
+			int fd = Rtt_FileDescriptorOpen( path, O_RDONLY, S_IRUSR );
+			if ( fd >= 0 )
+			{
+				fData = Rtt_FileMemoryMap( fd, 0, fDataLen, false );
+				Rtt_FileDescriptorClose( fd );
+			}
+		}
+		fIsError = isTooLarge || ( fDataLen > 0 && ! fData );
+	}
+	else
+	{
+		fIsError = true;
+	}
+
+	if ( fIsError )
+	{
+		fIsDone = true;
+	}
+	else if ( fDigest && fDigest->IsThreadSafe() )
+	{
+		fThread = std::thread( & DigestFileTask::Run, this );
+	}
+}
+
+DigestFileTask::~DigestFileTask()
+{
+	fIsCancelled = true;
+	if ( fThread.joinable() )
+	{
+		fThread.join();
+	}
+	Rtt_FileMemoryUnmap( fData, fDataLen );
+	delete fDigest;
+}
+
+void
+DigestFileTask::Run()
+{
+	const U8 *bytes = (const U8 *)fData;
+	size_t remaining = fDataLen;
+	while ( remaining > 0 && ! fIsCancelled )
+	{
+		size_t n = ( remaining > (size_t)kChunkSize ? (size_t)kChunkSize : remaining );
+		fDigest->Update( bytes, n );
+		bytes += n;
+		remaining -= n;
+	}
+	fDigest->Final( fMD );
+
+	fIsDone = true;
+}
+
+// Hashes the next chunk on the Lua thread
+void
+DigestFileTask::Step()
+{
+	if ( ! fDigest )
+	{
+		Rtt::Data<const char> data( (const char *)fData, (int)fDataLen );
+		fCrypto.CalculateDigest( fAlgorithm, data, fMD );
+		fIsDone = true;
+		return;
+	}
+
+	size_t remaining = fDataLen - fOffset;
+	size_t n = ( remaining > (size_t)kChunkSize ? (size_t)kChunkSize : remaining );
+	if ( n > 0 )
+	{
+		fDigest->Update( (const U8 *)fData + fOffset, n );
+		fOffset += n;
+	}
+
+	if ( fOffset >= fDataLen )
+	{
+		fDigest->Final( fMD );
+		fIsDone = true;
+	}
+}
+
+void
+DigestFileTask::operator()( Scheduler& sender )
+{
+	if ( ! fThread.joinable() && ! fIsDone )
+	{
+		Step();
+	}
+
+	if ( ! fIsDone )
+	{
+		return;
+	}
+
+	if ( fThread.joinable() )
+	{
+		fThread.join();
+	}
+
+	lua_State *L = sender.GetOwner().VMContext().L();
+
+	Lua::NewEvent( L, "digest" );
+	lua_pushboolean( L, fIsError );
+	lua_setfield( L, -2, "isError" );
+	lua_pushstring( L, fPath.c_str() );
+	lua_setfield( L, -2, "path" );
+	if ( ! fIsError )
+	{
+		PushDigest( L, fMD, (int) fDigestLen, false );
+		lua_setfield( L, -2, "digest" );
+	}
+	Lua::DispatchEvent( L, fListener, 0 );
+	Lua::DeleteRef( L, fListener );
+	fListener = NULL;
+
+	setKeepAlive( false );
+}
+
+// crypto.digestFile( path, algorithm, listener )
+//
+// The listener receives a "digest" event with event.digest as a hex string
+static int
+digestFile( lua_State *L )
+{
+	const char *path = luaL_checkstring( L, 1 );
+	S32 algorithm = EnumForUserdata( kAlgorithms, lua_touserdata( L, 2 ), MCrypto::kNumAlgorithms, -1 );
+
+	if ( algorithm < 0 )
+	{
+		CoronaLuaError( L, "crypto.digestFile() unknown message digest algorithm" );
+		return 0;
+	}
+
+	if ( ! Lua::IsListener( L, 3, "digest" ) )
+	{
+		CoronaLuaError( L, "crypto.digestFile() expected a listener as argument #3" );
+		return 0;
+	}
+
+	const MCrypto& crypto = LuaContext::GetPlatform( L ).GetCrypto();
+	Runtime *runtime = LuaContext::GetRuntime( L );
+
+	Lua::Ref listener = Lua::NewRef( L, 3 );
+	runtime->GetScheduler().Append(
+		Rtt_NEW( runtime->Allocator(), DigestFileTask( crypto, (MCrypto::Algorithm)algorithm, path, listener ) ) );
+
+	return 0;
+}
+
+// ----------------------------------------------------------------------------
+
 int
 LuaLibCrypto::Open( lua_State *L )
 {
@@ -116,6 +509,8 @@ LuaLibCrypto::Open( lua_State *L )
 	{
 		{ "digest", digest },
 		{ "hmac", hmac },
+		{ "newDigest", newDigest },
+		{ "digestFile", digestFile },
 
 		{ NULL, NULL }
 	};
@@ -0,0 +1,1680 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_LuaLibJSON.h"
+
+#include "Core/Rtt_Math.h"
+
+#include <locale.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Word-at-a-time byte tests (see "Bit Twiddling Hacks"). Strings are scanned
+// 8 bytes per step and only fall back to per-byte checks near a special byte.
+static const U64 kLowBits = 0x0101010101010101ULL;
+static const U64 kHighBits = 0x8080808080808080ULL;
+
+Rtt_FORCE_INLINE static U64
+HasZeroByte( U64 v )
+{
+	return ( v - kLowBits ) & ~v & kHighBits;
+}
+
+Rtt_FORCE_INLINE static U64
+HasByte( U64 v, U8 b )
+{
+	return HasZeroByte( v ^ ( kLowBits * b ) );
+}
+
+// Valid for n <= 128
+Rtt_FORCE_INLINE static U64
+HasByteLessThan( U64 v, U8 n )
+{
+	return ( v - kLowBits * n ) & ~v & kHighBits;
+}
+
+Rtt_FORCE_INLINE static U64
+LoadWord( const char *p )
+{
+	U64 result;
+	memcpy( & result, p, sizeof( result ) );
+	return result;
+}
+
+static char
+LocaleDecimalPoint()
+{
+	const struct lconv *conv = localeconv();
+	return ( conv && conv->decimal_point && conv->decimal_point[0] ? conv->decimal_point[0] : '.' );
+}
+
+// ----------------------------------------------------------------------------
+
+// Growable byte buffer backed by a userdata at a fixed stack slot, so
+// nothing leaks when a Lua error (e.g. from a __tojson handler) unwinds
+// through the encoder or decoder.
+class JSONBuffer
+{
+	Rtt_CLASS_NO_COPIES( JSONBuffer )
+
+	public:
+		JSONBuffer( lua_State *L, size_t capacity );
+
+	public:
+		char* Data() const { return fData; }
+		size_t Length() const { return fLength; }
+		void SetLength( size_t newValue ) { Rtt_ASSERT( newValue <= fCapacity ); fLength = newValue; }
+		size_t Capacity() const { return fCapacity; }
+
+		// Ensures room for 'n' more bytes
+		Rtt_FORCE_INLINE void Reserve( size_t n )
+		{
+			if ( fLength + n > fCapacity ) { Grow( fLength + n ); }
+		}
+
+		Rtt_FORCE_INLINE void Append( char c )
+		{
+			Reserve( 1 );
+			fData[fLength++] = c;
+		}
+
+		Rtt_FORCE_INLINE void Append( const char *s, size_t n )
+		{
+			Reserve( n );
+			memcpy( fData + fLength, s, n );
+			fLength += n;
+		}
+
+		void Clear() { fLength = 0; }
+		void Push() const { lua_pushlstring( fL, fData, fLength ); }
+
+	private:
+		void Grow( size_t minCapacity );
+
+	private:
+		lua_State *fL;
+		int fSlot;
+		char *fData;
+		size_t fLength;
+		size_t fCapacity;
+};
+
+JSONBuffer::JSONBuffer( lua_State *L, size_t capacity )
+:	fL( L ),
+	fSlot( 0 ),
+	fData( NULL ),
+	fLength( 0 ),
+	fCapacity( 0 )
+{
+	lua_pushnil( L );
+	fSlot = lua_gettop( L );
+	Grow( capacity );
+}
+
+void
+JSONBuffer::Grow( size_t minCapacity )
+{
+	size_t capacity = ( fCapacity > 0 ? fCapacity * 2 : 256 );
+	if ( capacity < minCapacity )
+	{
+		capacity = minCapacity;
+	}
+
+	char *data = (char*)lua_newuserdata( fL, capacity );
+	if ( fLength > 0 )
+	{
+		memcpy( data, fData, fLength );
+	}
+	lua_replace( fL, fSlot );
+
+	fData = data;
+	fCapacity = capacity;
+}
+
+// ----------------------------------------------------------------------------
+
+// Recursive descent parser that builds Lua tables directly. Accepts the same
+// grammar as dkjson's LPeg decoder (comments, BOM, trailing commas) and
+// reports the same error messages and positions.
+//
+// The input is either a complete string or a FILE* read in chunks. In the
+// latter case the window [fStart, fEnd) slides forward as input is consumed,
+// so all lookahead is expressed as offsets from fP.
+class JSONDecoder
+{
+	Rtt_CLASS_NO_COPIES( JSONDecoder )
+
+	public:
+		typedef enum _Result
+		{
+			kMatched = 0,
+			kNotMatched,		// No value here. Not an error by itself.
+			kFailed				// Error recorded in fError
+		}
+		Result;
+
+		static const size_t kChunkSize = 64 * 1024;
+		static const int kMaxDepth = 1000;
+
+	public:
+		// Stack indices of the null value and of the object and array
+		// metatables (0 for none)
+		JSONDecoder( lua_State *L, int nullIndex, int objectMetaIndex, int arrayMetaIndex );
+
+	public:
+		void SetSource( const char *data, size_t length, size_t offset );
+		void SetSource( FILE *file, size_t offset );
+
+		// On success, pushes the value. On failure, the stack above the
+		// decoder's own slots is unspecified.
+		bool Decode();
+
+		// 1-based position after the decoded value
+		size_t GetPosition() const { return Pos(); }
+
+		// 1-based position of the error, and its message
+		size_t GetErrorPosition() const { return fErrorPos; }
+		void PushError() const;
+
+	protected:
+		Rtt_FORCE_INLINE size_t Pos() const { return fOffset + ( fP - fStart ) + 1; }
+
+		bool Refill();
+		Rtt_FORCE_INLINE bool Ensure( size_t n )
+		{
+			while ( (size_t)( fEnd - fP ) < n )
+			{
+				if ( ! Refill() ) { return false; }
+			}
+			return true;
+		}
+
+		// Returns the next byte without consuming it, or -1 at the end
+		Rtt_FORCE_INLINE int Peek()
+		{
+			return ( fP < fEnd || Refill() ? (U8)*fP : -1 );
+		}
+
+		void Skip( size_t n );
+		void SkipSpace();
+		bool SkipBlockComment();
+
+		Result Error( const char *message );
+
+		Result ParseValue();
+		Result ParseObject();
+		Result ParseArray();
+		Result ParseString();
+		Result ParseEscape();
+		Result ParseNumber();
+		Result ParseLiteral( const char *word, size_t length );
+
+		void AppendUTF8( U32 value );
+		void SetMetatable( int index );
+
+	private:
+		lua_State *fL;
+		int fNullIndex;
+		int fObjectMetaIndex;
+		int fArrayMetaIndex;
+		FILE *fFile;
+		JSONBuffer fChunk;
+		JSONBuffer fString;
+		const char *fStart;
+		const char *fP;
+		const char *fEnd;
+		size_t fOffset;			// Input offset of fStart
+		size_t fLine;
+		size_t fLinePos;		// Position of the last newline consumed
+		const char *fError;
+		size_t fErrorPos;
+		size_t fErrorLine;
+		size_t fErrorLinePos;
+		int fDepth;
+		char fDecimalPoint;
+};
+
+JSONDecoder::JSONDecoder( lua_State *L, int nullIndex, int objectMetaIndex, int arrayMetaIndex )
+:	fL( L ),
+	fNullIndex( nullIndex ),
+	fObjectMetaIndex( objectMetaIndex ),
+	fArrayMetaIndex( arrayMetaIndex ),
+	fFile( NULL ),
+	fChunk( L, 0 ),
+	fString( L, 0 ),
+	fStart( NULL ),
+	fP( NULL ),
+	fEnd( NULL ),
+	fOffset( 0 ),
+	fLine( 1 ),
+	fLinePos( 0 ),
+	fError( NULL ),
+	fErrorPos( 0 ),
+	fErrorLine( 0 ),
+	fErrorLinePos( 0 ),
+	fDepth( 0 ),
+	fDecimalPoint( LocaleDecimalPoint() )
+{
+}
+
+void
+JSONDecoder::SetSource( const char *data, size_t length, size_t offset )
+{
+	fFile = NULL;
+	fStart = data;
+	fP = data;
+	fEnd = data + length;
+	fOffset = 0;
+
+	Skip( offset );
+}
+
+void
+JSONDecoder::SetSource( FILE *file, size_t offset )
+{
+	fFile = file;
+	fStart = fChunk.Data();
+	fP = fStart;
+	fEnd = fStart;
+	fOffset = 0;
+
+	Skip( offset );
+}
+
+bool
+JSONDecoder::Decode()
+{
+	Result result = ParseValue();
+	if ( kNotMatched == result )
+	{
+		Error( "value expected" );
+	}
+
+	return ( kMatched == result );
+}
+
+void
+JSONDecoder::PushError() const
+{
+	lua_pushfstring( fL, "%s at line %d, column %d",
+		fError, (int)fErrorLine, (int)( fErrorPos - fErrorLinePos ) );
+}
+
+bool
+JSONDecoder::Refill()
+{
+	if ( ! fFile )
+	{
+		return false;
+	}
+
+	// Keep the unconsumed bytes and append the next chunk. The window
+	// only grows past kChunkSize for lookahead (e.g. a long comment).
+	size_t remaining = fEnd - fP;
+	fOffset += fP - fStart;
+	memmove( fChunk.Data(), fP, remaining );
+	fChunk.SetLength( remaining );
+	fChunk.Reserve( kChunkSize );
+
+	char *data = fChunk.Data();
+	size_t numRead = fread( data + remaining, 1, fChunk.Capacity() - remaining, fFile );
+	fChunk.SetLength( remaining + numRead );
+
+	fStart = data;
+	fP = data;
+	fEnd = data + remaining + numRead;
+
+	return ( numRead > 0 );
+}
+
+void
+JSONDecoder::Skip( size_t n )
+{
+	// Newlines before the start position still count towards error lines
+	while ( n > 0 && ( fP < fEnd || Refill() ) )
+	{
+		if ( '\n' == *fP )
+		{
+			++fLine;
+			fLinePos = Pos();
+		}
+		++fP;
+		--n;
+	}
+}
+
+void
+JSONDecoder::SkipSpace()
+{
+	for ( ;; )
+	{
+		if ( fP >= fEnd && ! Refill() )
+		{
+			return;
+		}
+
+		switch ( *fP )
+		{
+			case ' ':
+			case '\t':
+			case '\r':
+				++fP;
+				break;
+			case '\n':
+				++fLine;
+				fLinePos = Pos();
+				++fP;
+				break;
+			case '/':
+				if ( ! Ensure( 2 ) )
+				{
+					return;
+				}
+				else if ( '/' == fP[1] )
+				{
+					// Line comment runs up to (not including) the line break
+					fP += 2;
+					for ( int c = Peek(); c >= 0 && '\n' != c && '\r' != c; c = Peek() )
+					{
+						++fP;
+					}
+				}
+				else if ( '*' != fP[1] || ! SkipBlockComment() )
+				{
+					return;
+				}
+				break;
+			case '\xEF':
+				// UTF-8 byte order mark
+				if ( Ensure( 3 ) && '\xBB' == fP[1] && '\xBF' == fP[2] )
+				{
+					fP += 3;
+					break;
+				}
+				return;
+			default:
+				return;
+		}
+	}
+}
+
+bool
+JSONDecoder::SkipBlockComment()
+{
+	// An unterminated comment is not whitespace, so look ahead for "*/"
+	// before consuming anything.
+	size_t length = 2;
+	for ( ;; )
+	{
+		if ( ! Ensure( length + 2 ) )
+		{
+			return false;
+		}
+		if ( '*' == fP[length] && '/' == fP[length + 1] )
+		{
+			length += 2;
+			break;
+		}
+		++length;
+	}
+
+	Skip( length );
+	return true;
+}
+
+JSONDecoder::Result
+JSONDecoder::Error( const char *message )
+{
+	if ( ! fError )
+	{
+		fError = message;
+		fErrorPos = Pos();
+		fErrorLine = fLine;
+		fErrorLinePos = fLinePos;
+	}
+
+	return kFailed;
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseValue()
+{
+	SkipSpace();
+
+	switch ( Peek() )
+	{
+		case '{':
+			return ParseObject();
+		case '[':
+			return ParseArray();
+		case '"':
+			return ParseString();
+		case '-':
+		case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+			return ParseNumber();
+		case 't':
+			return ParseLiteral( "true", 4 );
+		case 'f':
+			return ParseLiteral( "false", 5 );
+		case 'n':
+			return ParseLiteral( "null", 4 );
+		default:
+			return kNotMatched;
+	}
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseObject()
+{
+	if ( ++fDepth > kMaxDepth )
+	{
+		return Error( "too many nested objects or arrays" );
+	}
+	luaL_checkstack( fL, 4, "too many nested objects or arrays" );
+
+	++fP; // '{'
+	lua_newtable( fL );
+
+	for ( ;; )
+	{
+		SkipSpace();
+		if ( '"' != Peek() )
+		{
+			break;
+		}
+
+		if ( kFailed == ParseString() )
+		{
+			return kFailed;
+		}
+
+		SkipSpace();
+		if ( ':' != Peek() )
+		{
+			return Error( "colon expected" );
+		}
+		++fP;
+
+		Result result = ParseValue();
+		if ( kMatched != result )
+		{
+			return ( kFailed == result ? kFailed : Error( "value expected" ) );
+		}
+		lua_rawset( fL, -3 );
+
+		SkipSpace();
+		if ( ',' != Peek() )
+		{
+			break;
+		}
+		++fP;
+	}
+
+	SkipSpace();
+	if ( '}' != Peek() )
+	{
+		return Error( "'}' expected" );
+	}
+	++fP;
+
+	SetMetatable( fObjectMetaIndex );
+	--fDepth;
+
+	return kMatched;
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseArray()
+{
+	if ( ++fDepth > kMaxDepth )
+	{
+		return Error( "too many nested objects or arrays" );
+	}
+	luaL_checkstack( fL, 4, "too many nested objects or arrays" );
+
+	++fP; // '['
+	lua_newtable( fL );
+
+	for ( int i = 1; ; i++ )
+	{
+		Result result = ParseValue();
+		if ( kFailed == result )
+		{
+			return kFailed;
+		}
+		else if ( kNotMatched == result )
+		{
+			break;
+		}
+		lua_rawseti( fL, -2, i );
+
+		SkipSpace();
+		if ( ',' != Peek() )
+		{
+			break;
+		}
+		++fP;
+	}
+
+	SkipSpace();
+	if ( ']' != Peek() )
+	{
+		return Error( "']' expected" );
+	}
+	++fP;
+
+	SetMetatable( fArrayMetaIndex );
+	--fDepth;
+
+	return kMatched;
+}
+
+// Bytes that end a run of plain string characters
+static const U8 kStringStop[256] =
+{
+	// '\n', '\r', '"', '\\'
+	0,0,0,0,0,0,0,0,0,0,1,0,0,1,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,
+};
+
+static const char*
+ScanPlainChars( const char *p, const char *end )
+{
+	while ( end - p >= 8 )
+	{
+		U64 word = LoadWord( p );
+		if ( HasByte( word, '"' ) | HasByte( word, '\\' ) | HasByte( word, '\n' ) | HasByte( word, '\r' ) )
+		{
+			break;
+		}
+		p += 8;
+	}
+
+	while ( p < end && ! kStringStop[(U8)*p] )
+	{
+		++p;
+	}
+
+	return p;
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseString()
+{
+	++fP; // '"'
+	fString.Clear();
+
+	for ( ;; )
+	{
+		if ( fP >= fEnd && ! Refill() )
+		{
+			return Error( "unterminated string" );
+		}
+
+		const char *end = ScanPlainChars( fP, fEnd );
+		if ( end < fEnd && '"' == *end && 0 == fString.Length() )
+		{
+			// Common case: no escapes, so push straight from the input
+			lua_pushlstring( fL, fP, end - fP );
+			fP = end + 1;
+			return kMatched;
+		}
+
+		fString.Append( fP, end - fP );
+		fP = end;
+
+		if ( fP < fEnd )
+		{
+			switch ( *fP )
+			{
+				case '"':
+					++fP;
+					fString.Push();
+					return kMatched;
+				case '\\':
+					if ( kFailed == ParseEscape() )
+					{
+						return kFailed;
+					}
+					break;
+				default:
+					// Line breaks must be escaped
+					return Error( "unterminated string" );
+			}
+		}
+	}
+}
+
+static bool
+ParseHex4( const char *p, U32& outValue )
+{
+	U32 value = 0;
+	for ( int i = 0; i < 4; i++ )
+	{
+		char c = p[i];
+		if ( c >= '0' && c <= '9' ) { value = ( value << 4 ) | ( c - '0' ); }
+		else if ( c >= 'a' && c <= 'f' ) { value = ( value << 4 ) | ( c - 'a' + 10 ); }
+		else if ( c >= 'A' && c <= 'F' ) { value = ( value << 4 ) | ( c - 'A' + 10 ); }
+		else { return false; }
+	}
+
+	outValue = value;
+	return true;
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseEscape()
+{
+	char c = ( Ensure( 2 ) ? fP[1] : '\0' );
+	char value = '\0';
+	switch ( c )
+	{
+		case '"': value = '"'; break;
+		case '\\': value = '\\'; break;
+		case '/': value = '/'; break;
+		case 'b': value = '\b'; break;
+		case 'f': value = '\f'; break;
+		case 'n': value = '\n'; break;
+		case 'r': value = '\r'; break;
+		case 't': value = '\t'; break;
+		case 'u':
+		{
+			U32 high;
+			if ( Ensure( 6 ) && ParseHex4( fP + 2, high ) )
+			{
+				// Combine an escaped UTF-16 surrogate pair
+				U32 low;
+				if ( high >= 0xD800 && high <= 0xDBFF
+					 && Ensure( 12 ) && '\\' == fP[6] && 'u' == fP[7] && ParseHex4( fP + 8, low )
+					 && low >= 0xDC00 && low <= 0xDFFF )
+				{
+					AppendUTF8( ( ( high - 0xD800 ) << 10 ) + ( low - 0xDC00 ) + 0x10000 );
+					fP += 12;
+				}
+				else
+				{
+					AppendUTF8( high );
+					fP += 6;
+				}
+				return kMatched;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+
+	if ( '\0' == value )
+	{
+		++fP; // Error is reported after the backslash
+		return Error( "unsupported escape sequence" );
+	}
+
+	fString.Append( value );
+	fP += 2;
+	return kMatched;
+}
+
+void
+JSONDecoder::AppendUTF8( U32 value )
+{
+	char bytes[4];
+	size_t length = 0;
+	if ( value <= 0x7F )
+	{
+		bytes[length++] = (char)value;
+	}
+	else if ( value <= 0x7FF )
+	{
+		bytes[length++] = (char)( 0xC0 | ( value >> 6 ) );
+		bytes[length++] = (char)( 0x80 | ( value & 0x3F ) );
+	}
+	else if ( value <= 0xFFFF )
+	{
+		bytes[length++] = (char)( 0xE0 | ( value >> 12 ) );
+		bytes[length++] = (char)( 0x80 | ( ( value >> 6 ) & 0x3F ) );
+		bytes[length++] = (char)( 0x80 | ( value & 0x3F ) );
+	}
+	else
+	{
+		bytes[length++] = (char)( 0xF0 | ( value >> 18 ) );
+		bytes[length++] = (char)( 0x80 | ( ( value >> 12 ) & 0x3F ) );
+		bytes[length++] = (char)( 0x80 | ( ( value >> 6 ) & 0x3F ) );
+		bytes[length++] = (char)( 0x80 | ( value & 0x3F ) );
+	}
+	fString.Append( bytes, length );
+}
+
+Rtt_FORCE_INLINE static bool
+IsDigit( char c )
+{
+	return ( c >= '0' && c <= '9' );
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseNumber()
+{
+	// -?(0|[1-9][0-9]*)(\.[0-9]*)?([eE][+-]?[0-9]+)?
+	size_t length = ( '-' == *fP ? 1 : 0 );
+	if ( ! Ensure( length + 1 ) || ! IsDigit( fP[length] ) )
+	{
+		return kNotMatched;
+	}
+
+	bool isInteger = true;
+	if ( '0' == fP[length++] )
+	{
+		// No leading zeros
+	}
+	else
+	{
+		while ( Ensure( length + 1 ) && IsDigit( fP[length] ) ) { ++length; }
+	}
+
+	if ( Ensure( length + 1 ) && '.' == fP[length] )
+	{
+		isInteger = false;
+		++length;
+		while ( Ensure( length + 1 ) && IsDigit( fP[length] ) ) { ++length; }
+	}
+
+	if ( Ensure( length + 1 ) && ( 'e' == fP[length] || 'E' == fP[length] ) )
+	{
+		size_t exponent = length + 1;
+		if ( Ensure( exponent + 1 ) && ( '+' == fP[exponent] || '-' == fP[exponent] ) )
+		{
+			++exponent;
+		}
+		if ( Ensure( exponent + 1 ) && IsDigit( fP[exponent] ) )
+		{
+			isInteger = false;
+			length = exponent + 1;
+			while ( Ensure( length + 1 ) && IsDigit( fP[length] ) ) { ++length; }
+		}
+	}
+
+	lua_Number value;
+	bool isNegative = ( '-' == *fP );
+	size_t numDigits = length - ( isNegative ? 1 : 0 );
+	if ( isInteger && numDigits <= 15 )
+	{
+		// Exact in a double, so skip strtod
+		U64 digits = 0;
+		for ( size_t i = length - numDigits; i < length; i++ )
+		{
+			digits = digits * 10 + ( fP[i] - '0' );
+		}
+		value = ( isNegative ? -(lua_Number)digits : (lua_Number)digits );
+	}
+	else
+	{
+		// strtod honours the locale's decimal point
+		fString.Clear();
+		fString.Append( fP, length );
+		fString.Append( '\0' );
+		char *s = fString.Data();
+		char *point = (char*)memchr( s, '.', length );
+		if ( point )
+		{
+			*point = fDecimalPoint;
+		}
+		value = strtod( s, NULL );
+	}
+
+	fP += length;
+	lua_pushnumber( fL, value );
+	return kMatched;
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseLiteral( const char *word, size_t length )
+{
+	if ( ! Ensure( length ) || 0 != memcmp( fP, word, length ) )
+	{
+		return kNotMatched;
+	}
+	fP += length;
+
+	switch ( *word )
+	{
+		case 't':
+			lua_pushboolean( fL, 1 );
+			break;
+		case 'f':
+			lua_pushboolean( fL, 0 );
+			break;
+		default:
+			lua_pushvalue( fL, fNullIndex );
+			break;
+	}
+
+	return kMatched;
+}
+
+void
+JSONDecoder::SetMetatable( int index )
+{
+	if ( index )
+	{
+		lua_pushvalue( fL, index );
+		lua_setmetatable( fL, -2 );
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+// Mirrors dkjson's encoder, including the 'indent', 'level', 'keyorder',
+// 'tables' and 'exception' state fields and the __tojson, __jsontype and
+// __jsonorder metafields. The 'buffer' field is not supported (json.lua
+// uses dkjson for that), so __tojson handlers must return a string.
+class JSONEncoder
+{
+	Rtt_CLASS_NO_COPIES( JSONEncoder )
+
+	public:
+		// Pushes 3 values (key order, visited tables, output buffer)
+		JSONEncoder( lua_State *L, int stateIndex );
+
+	public:
+		void Encode( int index, int level );
+		void Push() const { fOut.Push(); }
+
+	protected:
+		bool PushToJSON( int index );
+		void EncodeCustom( int index );
+		void EncodeTable( int index, int level );
+		void EncodeArray( int index, int level, lua_Number length, bool hasMetatable );
+		void EncodeObject( int index, int level, bool hasMetatable );
+		void EncodePair( int keyIndex, int valueIndex, bool& ioHasPrevious, int level );
+		void Exception( int index, const char *reason, const char *message );
+
+		bool IsArray( int index, lua_Number& outLength );
+		bool IsVisited( int index );
+		void SetVisited( int index, bool newValue );
+
+		void AppendNewLine( int level );
+		void AppendNumber( lua_Number value );
+		void AppendString( const char *s, size_t length );
+
+	private:
+		lua_State *fL;
+		int fStateIndex;
+		int fKeyOrderIndex;
+		int fTablesIndex;
+		JSONBuffer fOut;
+		bool fIndent;
+		char fDecimalPoint;
+};
+
+JSONEncoder::JSONEncoder( lua_State *L, int stateIndex )
+:	fL( L ),
+	fStateIndex( stateIndex ),
+	fKeyOrderIndex( 0 ),
+	fTablesIndex( 0 ),
+	fOut( L, 1024 ),
+	fIndent( false ),
+	fDecimalPoint( LocaleDecimalPoint() )
+{
+	lua_getfield( L, stateIndex, "indent" );
+	fIndent = lua_toboolean( L, -1 );
+	lua_pop( L, 1 );
+
+	lua_getfield( L, stateIndex, "keyorder" );
+	fKeyOrderIndex = ( lua_toboolean( L, -1 ) ? lua_gettop( L ) : 0 );
+
+	lua_getfield( L, stateIndex, "tables" );
+	if ( ! lua_istable( L, -1 ) )
+	{
+		lua_pop( L, 1 );
+		lua_newtable( L );
+	}
+	fTablesIndex = lua_gettop( L );
+}
+
+void
+JSONEncoder::Encode( int index, int level )
+{
+	switch ( lua_type( fL, index ) )
+	{
+		case LUA_TNIL:
+			fOut.Append( "null", 4 );
+			break;
+		case LUA_TBOOLEAN:
+			if ( lua_toboolean( fL, index ) ) { fOut.Append( "true", 4 ); }
+			else { fOut.Append( "false", 5 ); }
+			break;
+		case LUA_TNUMBER:
+			AppendNumber( lua_tonumber( fL, index ) );
+			break;
+		case LUA_TSTRING:
+			{
+				size_t length;
+				const char *s = lua_tolstring( fL, index, & length );
+				AppendString( s, length );
+			}
+			break;
+		case LUA_TTABLE:
+			EncodeTable( index, level );
+			break;
+		case LUA_TUSERDATA:
+			if ( PushToJSON( index ) )
+			{
+				EncodeCustom( index );
+				break;
+			}
+			// Fall through
+		default:
+			lua_pushfstring( fL, "type '%s' is not supported by JSON.", luaL_typename( fL, index ) );
+			Exception( index, "unsupported type", lua_tostring( fL, -1 ) );
+			lua_pop( fL, 1 );
+			break;
+	}
+}
+
+// If the value's metatable has __tojson, pushes it and returns true
+bool
+JSONEncoder::PushToJSON( int index )
+{
+	bool result = false;
+
+	if ( lua_getmetatable( fL, index ) )
+	{
+		lua_getfield( fL, -1, "__tojson" );
+		result = ! lua_isnil( fL, -1 );
+		lua_remove( fL, -2 );
+		if ( ! result )
+		{
+			lua_pop( fL, 1 );
+		}
+	}
+
+	return result;
+}
+
+// Calls the __tojson handler on top of the stack and pops it
+void
+JSONEncoder::EncodeCustom( int index )
+{
+	if ( IsVisited( index ) )
+	{
+		lua_pop( fL, 1 );
+		Exception( index, "reference cycle", "reference cycle" );
+		return;
+	}
+
+	SetVisited( index, true );
+
+	lua_pushvalue( fL, index );
+	lua_pushvalue( fL, fStateIndex );
+	lua_call( fL, 2, 2 );
+
+	SetVisited( index, false );
+
+	if ( ! lua_toboolean( fL, -2 ) )
+	{
+		const char *message = lua_tostring( fL, -1 );
+		Exception( index, "custom encoder failed", message ? message : "custom encoder failed" );
+	}
+	else if ( LUA_TSTRING == lua_type( fL, -2 ) )
+	{
+		size_t length;
+		const char *s = lua_tolstring( fL, -2, & length );
+		fOut.Append( s, length );
+	}
+
+	lua_pop( fL, 2 );
+}
+
+void
+JSONEncoder::EncodeTable( int index, int level )
+{
+	if ( PushToJSON( index ) )
+	{
+		EncodeCustom( index );
+		return;
+	}
+
+	if ( IsVisited( index ) )
+	{
+		Exception( index, "reference cycle", "reference cycle" );
+		return;
+	}
+
+	luaL_checkstack( fL, 8, "too many nested tables" );
+
+	SetVisited( index, true );
+	++level;
+
+	bool hasMetatable = ( 0 != lua_getmetatable( fL, index ) );
+	if ( hasMetatable )
+	{
+		lua_pop( fL, 1 );
+	}
+
+	lua_Number length = 0;
+	bool isArray = IsArray( index, length );
+	if ( isArray && 0 == length && hasMetatable )
+	{
+		// Empty tables are arrays unless marked as objects
+		if ( luaL_getmetafield( fL, index, "__jsontype" ) )
+		{
+			const char *type = lua_tostring( fL, -1 );
+			isArray = ! ( type && 0 == strcmp( type, "object" ) );
+			lua_pop( fL, 1 );
+		}
+	}
+
+	if ( isArray )
+	{
+		EncodeArray( index, level, length, hasMetatable );
+	}
+	else
+	{
+		EncodeObject( index, level, hasMetatable );
+	}
+
+	SetVisited( index, false );
+}
+
+void
+JSONEncoder::EncodeArray( int index, int level, lua_Number length, bool hasMetatable )
+{
+	fOut.Append( '[' );
+	for ( lua_Number i = 1; i <= length; i++ )
+	{
+		if ( hasMetatable )
+		{
+			lua_pushnumber( fL, i );
+			lua_gettable( fL, index );
+		}
+		else
+		{
+			lua_rawgeti( fL, index, (int)i );
+		}
+
+		Encode( lua_gettop( fL ), level );
+		lua_pop( fL, 1 );
+
+		if ( i < length )
+		{
+			fOut.Append( ',' );
+		}
+	}
+	fOut.Append( ']' );
+}
+
+void
+JSONEncoder::EncodeObject( int index, int level, bool hasMetatable )
+{
+	fOut.Append( '{' );
+
+	bool hasPrevious = false;
+
+	int orderIndex = 0;
+	if ( hasMetatable && luaL_getmetafield( fL, index, "__jsonorder" ) )
+	{
+		if ( lua_toboolean( fL, -1 ) )
+		{
+			orderIndex = lua_gettop( fL );
+		}
+		else
+		{
+			lua_pop( fL, 1 );
+		}
+	}
+	if ( ! orderIndex && fKeyOrderIndex )
+	{
+		lua_pushvalue( fL, fKeyOrderIndex );
+		orderIndex = lua_gettop( fL );
+	}
+
+	int usedIndex = 0;
+	if ( orderIndex )
+	{
+		// Ordered keys first, then the rest in table order
+		lua_newtable( fL );
+		usedIndex = lua_gettop( fL );
+
+		for ( int i = 1, iMax = (int)lua_objlen( fL, orderIndex ); i <= iMax; i++ )
+		{
+			lua_rawgeti( fL, orderIndex, i );
+			int keyIndex = lua_gettop( fL );
+			lua_pushvalue( fL, keyIndex );
+			lua_gettable( fL, index );
+			if ( ! lua_isnil( fL, -1 ) )
+			{
+				lua_pushvalue( fL, keyIndex );
+				lua_pushboolean( fL, 1 );
+				lua_rawset( fL, usedIndex );
+
+				EncodePair( keyIndex, keyIndex + 1, hasPrevious, level );
+			}
+			lua_pop( fL, 2 );
+		}
+	}
+
+	lua_pushnil( fL );
+	while ( lua_next( fL, index ) )
+	{
+		int keyIndex = lua_gettop( fL ) - 1;
+
+		bool isUsed = false;
+		if ( usedIndex )
+		{
+			lua_pushvalue( fL, keyIndex );
+			lua_rawget( fL, usedIndex );
+			isUsed = lua_toboolean( fL, -1 );
+			lua_pop( fL, 1 );
+		}
+
+		if ( ! isUsed )
+		{
+			EncodePair( keyIndex, keyIndex + 1, hasPrevious, level );
+		}
+		lua_pop( fL, 1 );
+	}
+
+	if ( orderIndex )
+	{
+		lua_pop( fL, 2 ); // pop order, used
+	}
+
+	if ( fIndent )
+	{
+		AppendNewLine( level - 1 );
+	}
+	fOut.Append( '}' );
+}
+
+void
+JSONEncoder::EncodePair( int keyIndex, int valueIndex, bool& ioHasPrevious, int level )
+{
+	int keyType = lua_type( fL, keyIndex );
+	if ( LUA_TSTRING != keyType && LUA_TNUMBER != keyType )
+	{
+		luaL_error( fL, "type '%s' is not supported as a key by JSON.", lua_typename( fL, keyType ) );
+	}
+
+	if ( ioHasPrevious )
+	{
+		fOut.Append( ',' );
+	}
+	ioHasPrevious = true;
+
+	if ( fIndent )
+	{
+		AppendNewLine( level );
+	}
+
+	// Convert a copy so lua_next() still sees the original key
+	lua_pushvalue( fL, keyIndex );
+	size_t length;
+	const char *key = lua_tolstring( fL, -1, & length );
+	AppendString( key, length );
+	lua_pop( fL, 1 );
+
+	fOut.Append( ':' );
+	Encode( valueIndex, level );
+}
+
+void
+JSONEncoder::Exception( int index, const char *reason, const char *message )
+{
+	lua_getfield( fL, fStateIndex, "exception" );
+	if ( lua_isnil( fL, -1 ) )
+	{
+		luaL_error( fL, "%s", message );
+	}
+
+	lua_pushstring( fL, reason );
+	lua_pushvalue( fL, index );
+	lua_pushvalue( fL, fStateIndex );
+	lua_pushstring( fL, message );
+	lua_call( fL, 4, 2 );
+
+	if ( ! lua_toboolean( fL, -2 ) )
+	{
+		const char *error = lua_tostring( fL, -1 );
+		luaL_error( fL, "%s", error ? error : message );
+	}
+	else if ( LUA_TSTRING == lua_type( fL, -2 ) )
+	{
+		size_t length;
+		const char *s = lua_tolstring( fL, -2, & length );
+		fOut.Append( s, length );
+	}
+
+	lua_pop( fL, 2 );
+}
+
+// Same rules as dkjson: positive integer keys (plus an optional numeric 'n'),
+// and not too sparse
+bool
+JSONEncoder::IsArray( int index, lua_Number& outLength )
+{
+	lua_Number max = 0;
+	lua_Number count = 0;
+	lua_Number arrayLength = 0;
+
+	lua_pushnil( fL );
+	while ( lua_next( fL, index ) )
+	{
+		int keyType = lua_type( fL, -2 );
+		if ( LUA_TSTRING == keyType && LUA_TNUMBER == lua_type( fL, -1 ) )
+		{
+			size_t length;
+			const char *key = lua_tolstring( fL, -2, & length );
+			if ( 1 == length && 'n' == key[0] )
+			{
+				arrayLength = lua_tonumber( fL, -1 );
+				max = Max( max, arrayLength );
+				lua_pop( fL, 1 );
+				continue;
+			}
+		}
+
+		lua_Number key = ( LUA_TNUMBER == keyType ? lua_tonumber( fL, -2 ) : 0 );
+		if ( key < 1 || floor( key ) != key )
+		{
+			lua_pop( fL, 2 );
+			return false;
+		}
+
+		max = Max( max, key );
+		++count;
+		lua_pop( fL, 1 );
+	}
+
+	if ( max > 10 && max > arrayLength && max > count * 2 )
+	{
+		// Don't create an array with too many holes
+		return false;
+	}
+
+	outLength = max;
+	return true;
+}
+
+bool
+JSONEncoder::IsVisited( int index )
+{
+	lua_pushvalue( fL, index );
+	lua_rawget( fL, fTablesIndex );
+	bool result = lua_toboolean( fL, -1 );
+	lua_pop( fL, 1 );
+
+	return result;
+}
+
+void
+JSONEncoder::SetVisited( int index, bool newValue )
+{
+	lua_pushvalue( fL, index );
+	if ( newValue )
+	{
+		lua_pushboolean( fL, 1 );
+	}
+	else
+	{
+		lua_pushnil( fL );
+	}
+	lua_rawset( fL, fTablesIndex );
+}
+
+void
+JSONEncoder::AppendNewLine( int level )
+{
+	size_t length = 1 + 2 * Max( level, 0 );
+	fOut.Reserve( length );
+	char *p = fOut.Data() + fOut.Length();
+	p[0] = '\n';
+	memset( p + 1, ' ', length - 1 );
+	fOut.SetLength( fOut.Length() + length );
+}
+
+void
+JSONEncoder::AppendNumber( lua_Number value )
+{
+	if ( value != value || value >= HUGE_VAL || -value >= HUGE_VAL )
+	{
+		fOut.Append( "null", 4 );
+		return;
+	}
+
+	char buffer[LUAI_MAXNUMBER2STR];
+	char *end = buffer + sizeof( buffer );
+	char *p = end;
+
+	if ( floor( value ) == value && fabs( value ) < 1e14 )
+	{
+		// Same digits as LUA_NUMBER_FMT for integers of up to 14 digits
+		bool isNegative = ( value < 0 || ( 0 == value && 1 / value < 0 ) );
+		U64 digits = (U64)fabs( value );
+		do
+		{
+			*--p = (char)( '0' + digits % 10 );
+			digits /= 10;
+		}
+		while ( digits );
+
+		if ( isNegative )
+		{
+			*--p = '-';
+		}
+	}
+	else
+	{
+		int length = snprintf( buffer, sizeof( buffer ), LUA_NUMBER_FMT, value );
+		p = buffer;
+		end = buffer + Min( length, (int)sizeof( buffer ) - 1 );
+
+		if ( '.' != fDecimalPoint )
+		{
+			char *point = (char*)memchr( buffer, fDecimalPoint, end - buffer );
+			if ( point )
+			{
+				*point = '.';
+			}
+		}
+	}
+
+	fOut.Append( p, end - p );
+}
+
+// Bytes that need a closer look when quoting:
+// 1 = escape (control characters, '"', '\\', DEL), 2 = possible UTF-8 lead
+// byte of a sequence that dkjson escapes (see quotestring())
+static const U8 kQuoteClass[256] =
+{
+	1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+	0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,2,0,0,0,2,0,0,0,
+	0,2,2,0,0,0,0,0,0,0,0,0,0,0,0,2, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+};
+
+// Length of the UTF-8 sequence at p that dkjson escapes as \uXXXX, or 0.
+// These are invisible or line-breaking characters (e.g. U+2028) that some
+// JavaScript parsers reject.
+static size_t
+EscapedSequenceLength( const U8 *p, size_t available )
+{
+	U8 b1 = ( available > 1 ? p[1] : 0 );
+	U8 b2 = ( available > 2 ? p[2] : 0 );
+	switch ( p[0] )
+	{
+		case 0xC2: return ( ( b1 >= 0x80 && b1 <= 0x9F ) || 0xAD == b1 ? 2 : 0 );
+		case 0xD8: return ( b1 >= 0x80 && b1 <= 0x84 ? 2 : 0 );
+		case 0xDC: return ( 0x8F == b1 ? 2 : 0 );
+		case 0xE1: return ( 0x9E == b1 && ( 0xB4 == b2 || 0xB5 == b2 ) ? 3 : 0 );
+		case 0xE2:
+			if ( 0x80 == b1 ) { return ( ( b2 >= 0x8C && b2 <= 0x8F ) || ( b2 >= 0xA8 && b2 <= 0xAF ) ? 3 : 0 ); }
+			if ( 0x81 == b1 ) { return ( b2 >= 0xA0 && b2 <= 0xAF ? 3 : 0 ); }
+			return 0;
+		case 0xEF:
+			if ( 0xBB == b1 ) { return ( 0xBF == b2 ? 3 : 0 ); }
+			if ( 0xBF == b1 ) { return ( b2 >= 0xB0 && b2 <= 0xBF ? 3 : 0 ); }
+			return 0;
+		default:
+			return 0;
+	}
+}
+
+void
+JSONEncoder::AppendString( const char *s, size_t length )
+{
+	static const char kHexDigits[] = "0123456789abcdef";
+
+	fOut.Reserve( length + 2 );
+	fOut.Append( '"' );
+
+	const char *p = s;
+	const char *end = s + length;
+	const char *run = p; // Start of bytes not yet copied
+	while ( p < end )
+	{
+		// Skip 8 plain ASCII bytes at a time
+		while ( end - p >= 8 )
+		{
+			U64 word = LoadWord( p );
+			if ( HasByteLessThan( word, 0x20 ) | HasByte( word, '"' ) | HasByte( word, '\\' )
+				 | HasByte( word, 0x7F ) | ( word & kHighBits ) )
+			{
+				break;
+			}
+			p += 8;
+		}
+		if ( p >= end )
+		{
+			break;
+		}
+
+		U8 c = (U8)*p;
+		U8 type = kQuoteClass[c];
+		if ( 0 == type )
+		{
+			++p;
+			continue;
+		}
+
+		U32 value = c;
+		size_t sequenceLength = 1;
+		if ( 2 == type )
+		{
+			sequenceLength = EscapedSequenceLength( (const U8*)p, end - p );
+			if ( 0 == sequenceLength )
+			{
+				++p;
+				continue;
+			}
+
+			const U8 *u = (const U8*)p;
+			value = ( 2 == sequenceLength
+				? ( ( u[0] & 0x1F ) << 6 ) | ( u[1] & 0x3F )
+				: ( ( u[0] & 0x0F ) << 12 ) | ( ( u[1] & 0x3F ) << 6 ) | ( u[2] & 0x3F ) );
+		}
+
+		fOut.Append( run, p - run );
+
+		char escape[6] = { '\\', 0, 0, 0, 0, 0 };
+		size_t escapeLength = 2;
+		switch ( value )
+		{
+			case '"': escape[1] = '"'; break;
+			case '\\': escape[1] = '\\'; break;
+			case '\b': escape[1] = 'b'; break;
+			case '\f': escape[1] = 'f'; break;
+			case '\n': escape[1] = 'n'; break;
+			case '\r': escape[1] = 'r'; break;
+			case '\t': escape[1] = 't'; break;
+			default:
+				escape[1] = 'u';
+				escape[2] = kHexDigits[( value >> 12 ) & 0xF];
+				escape[3] = kHexDigits[( value >> 8 ) & 0xF];
+				escape[4] = kHexDigits[( value >> 4 ) & 0xF];
+				escape[5] = kHexDigits[value & 0xF];
+				escapeLength = 6;
+				break;
+		}
+		fOut.Append( escape, escapeLength );
+
+		p += sequenceLength;
+		run = p;
+	}
+
+	fOut.Append( run, end - run );
+	fOut.Append( '"' );
+}
+
+// ----------------------------------------------------------------------------
+
+// Converts a 1-based start position to an offset, like lpeg.match's init
+static size_t
+StartOffset( lua_State *L, int index, size_t length )
+{
+	lua_Integer position = luaL_optinteger( L, index, 1 );
+	if ( position > 0 )
+	{
+		return Min( (size_t)( position - 1 ), length );
+	}
+	else if ( (size_t)( -position ) <= length )
+	{
+		return length - (size_t)( -position );
+	}
+	return 0;
+}
+
+// Normalizes the arguments to (source, pos, nullval, objectmeta, arraymeta).
+// Like dkjson, default metatables are only used when no metatable
+// arguments are passed at all.
+static void
+PrepareDecodeArguments( lua_State *L, int& outObjectMetaIndex, int& outArrayMetaIndex )
+{
+	bool hasMetatables = ( lua_gettop( L ) > 3 );
+	lua_settop( L, 5 );
+
+	if ( ! hasMetatables )
+	{
+		lua_createtable( L, 0, 1 );
+		lua_pushliteral( L, "object" );
+		lua_setfield( L, -2, "__jsontype" );
+		lua_replace( L, 4 );
+
+		lua_createtable( L, 0, 1 );
+		lua_pushliteral( L, "array" );
+		lua_setfield( L, -2, "__jsontype" );
+		lua_replace( L, 5 );
+	}
+
+	outObjectMetaIndex = ( lua_istable( L, 4 ) ? 4 : 0 );
+	outArrayMetaIndex = ( lua_istable( L, 5 ) ? 5 : 0 );
+}
+
+static int
+PushDecodeResults( lua_State *L, JSONDecoder& decoder )
+{
+	int top = lua_gettop( L );
+	if ( decoder.Decode() )
+	{
+		lua_pushinteger( L, decoder.GetPosition() );
+		return 2;
+	}
+
+	lua_settop( L, top );
+	lua_pushnil( L );
+	lua_pushinteger( L, decoder.GetErrorPosition() );
+	decoder.PushError();
+	return 3;
+}
+
+// json_native.decode( str [, pos [, nullval [, objectmeta [, arraymeta]]]] )
+static int
+decode( lua_State *L )
+{
+	size_t length;
+	const char *str = luaL_checklstring( L, 1, & length );
+	size_t offset = StartOffset( L, 2, length );
+
+	int objectMetaIndex, arrayMetaIndex;
+	PrepareDecodeArguments( L, objectMetaIndex, arrayMetaIndex );
+
+	JSONDecoder decoder( L, 3, objectMetaIndex, arrayMetaIndex );
+	decoder.SetSource( str, length, offset );
+
+	return PushDecodeResults( L, decoder );
+}
+
+// json_native.decodeFile( file [, pos [, nullval [, objectmeta [, arraymeta]]]] )
+// Decodes from an open io file handle in chunks instead of reading the
+// whole file into a Lua string first.
+static int
+decodeFile( lua_State *L )
+{
+	FILE **pf = (FILE **)luaL_checkudata( L, 1, LUA_FILEHANDLE );
+	if ( NULL == *pf )
+	{
+		luaL_error( L, "attempt to use a closed file" );
+	}
+
+	lua_Integer position = luaL_optinteger( L, 2, 1 );
+	size_t offset = ( position > 1 ? (size_t)( position - 1 ) : 0 );
+
+	int objectMetaIndex, arrayMetaIndex;
+	PrepareDecodeArguments( L, objectMetaIndex, arrayMetaIndex );
+
+	JSONDecoder decoder( L, 3, objectMetaIndex, arrayMetaIndex );
+	decoder.SetSource( *pf, offset );
+
+	return PushDecodeResults( L, decoder );
+}
+
+// json_native.encode( value [, state] )
+static int
+encode( lua_State *L )
+{
+	lua_settop( L, 2 );
+	if ( lua_isnil( L, 2 ) )
+	{
+		lua_newtable( L );
+		lua_replace( L, 2 );
+	}
+	luaL_checktype( L, 2, LUA_TTABLE );
+
+	lua_getfield( L, 2, "level" );
+	int level = (int)lua_tointeger( L, -1 );
+	lua_pop( L, 1 );
+
+	JSONEncoder encoder( L, 2 );
+	encoder.Encode( 1, level );
+	encoder.Push();
+
+	return 1;
+}
+
+// ----------------------------------------------------------------------------
+
+int
+LuaLibJSON::Open( lua_State *L )
+{
+	const luaL_Reg kVTable[] =
+	{
+		{ "decode", decode },
+		{ "decodeFile", decodeFile },
+		{ "encode", encode },
+
+		{ NULL, NULL }
+	};
+
+	lua_createtable( L, 0, 3 );
+	luaL_register( L, NULL, kVTable );
+
+	return 1;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,40 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef __Rtt_LuaLibJSON__
+#define __Rtt_LuaLibJSON__
+
+#include "Rtt_Lua.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Native encode/decode for the "json" module (see json.lua). Output and
+// error messages match dkjson's, so json.lua falls back to dkjson wherever
+// this library is not registered.
+class LuaLibJSON
+{
+	public:
+		typedef LuaLibJSON Self;
+
+	public:
+		static int Open( lua_State *L );
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // __Rtt_LuaLibJSON__
@@ -1720,26 +1720,37 @@ InitializeFixtureUsing_ArbitraryPolygonalShape( lua_State *L,
 
 			TesselatorPolygon *tesselator_polygon = (TesselatorPolygon *)path.GetTesselator();
 
-			b2Vec2Vector vertexList;
-			_ArrayVertex2_to_b2Vec2Vector( tesselator_polygon->GetContour(),
-											vertexList,
-											center_in_pixels,
-											meter_per_pixels_scale );
+			// One loop for the outline, and one for each hole.
+			ArrayVertex2 ring( tesselator_polygon->GetContour().Allocator() );
+			for( S32 i = 0, iMax = tesselator_polygon->GetRingCount(); i < iMax; i++ )
+			{
+				tesselator_polygon->GetRing( i, ring );
+				if( ring.Length() < 3 )
+				{
+					continue;
+				}
 
-			b2FixtureDef fixtureDef;
+				b2Vec2Vector vertexList;
+				_ArrayVertex2_to_b2Vec2Vector( ring,
+												vertexList,
+												center_in_pixels,
+												meter_per_pixels_scale );
 
-			b2ChainShape chainDef;
-			chainDef.CreateLoop( &vertexList[ 0 ],
-									(int)vertexList.size() );
+				b2FixtureDef fixtureDef;
 
-			InitializeFixtureFromLua( L,
-										fixtureDef,
-										&chainDef,
-										lua_arg_index );
+				b2ChainShape chainDef;
+				chainDef.CreateLoop( &vertexList[ 0 ],
+										(int)vertexList.size() );
 
-			_FixtureCreator( body,
-								&fixtureDef,
-								fixtureIndex );
+				InitializeFixtureFromLua( L,
+											fixtureDef,
+											&chainDef,
+											lua_arg_index );
+
+				_FixtureCreator( body,
+									&fixtureDef,
+									fixtureIndex );
+			}
 
 			return true;
 		}
@@ -14,8 +14,19 @@
 #include "Rtt_LuaLibSQLite.h"
 
 #include "Rtt_LuaContext.h"
+#include "Rtt_Runtime.h"
+#include "Rtt_Scheduler.h"
 
-//#include <sqlite3.h>
+#include <sqlite3.h>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 // ----------------------------------------------------------------------------
 
@@ -27,20 +38,836 @@ namespace Rtt
 {
 
 // ----------------------------------------------------------------------------
-	
+
+// A value bound to, or read from, a statement. Owned by C++ so it can cross
+// between the Lua thread and a worker.
+struct SQLiteValue
+{
+	SQLiteValue() : fType( SQLITE_NULL ), fInteger( 0 ), fFloat( 0.0 ) {}
+
+	int fType;
+	sqlite3_int64 fInteger;
+	double fFloat;
+	std::string fText; // SQLITE_TEXT and SQLITE_BLOB
+};
+
+// Parameters for one execution of a statement. A parameter with a name is
+// bound by name (":name", "$name" or "@name"), otherwise by position.
+typedef std::vector< std::pair< std::string, SQLiteValue > > SQLiteParams;
+
+struct SQLiteJob
+{
+	SQLiteJob()
+	:	fIsQuery( false ),
+		fListener( NULL ),
+		fResult( SQLITE_OK ),
+		fChanges( 0 ),
+		fLastInsertRowid( 0 ),
+		fNumRows( 0 )
+	{
+	}
+
+	// Request
+	std::string fSQL;
+	bool fIsQuery;
+	std::vector< SQLiteParams > fParams;
+	Lua::Ref fListener;
+
+	// Result
+	int fResult;
+	std::string fErrorMessage;
+	int fChanges;
+	sqlite3_int64 fLastInsertRowid;
+	std::vector< std::string > fColumnNames;
+	std::vector< std::vector< SQLiteValue > > fColumns;
+	size_t fNumRows;
+};
+
+// ----------------------------------------------------------------------------
+
+// Runs the async calls made on one database object, in order, on its own
+// thread and its own connection to the database file.
+//
+// The connection uses WAL journaling so the Lua thread's connection can keep
+// reading while the worker writes. Prepared statements are cached by SQL text.
+class SQLiteWorker
+{
+	Rtt_CLASS_NO_COPIES( SQLiteWorker )
+
+	public:
+		enum
+		{
+			kMaxCachedStatements = 32,
+			kBusyTimeoutMs = 5000
+		};
+
+	public:
+		SQLiteWorker( const char *filename );
+		~SQLiteWorker();
+
+	public:
+		// Called on the Lua thread
+		void Submit( SQLiteJob *job );
+		void TakeCompleted( std::vector< SQLiteJob * >& outJobs );
+		void Close();
+		bool IsFinished() const;
+
+	protected:
+		void Run();
+		void Execute( SQLiteJob& job );
+		void Step( SQLiteJob& job, sqlite3_stmt *statement, bool collectRows );
+		bool Bind( SQLiteJob& job, sqlite3_stmt *statement, const SQLiteParams& params );
+		sqlite3_stmt *Prepare( const std::string& sql, bool& outIsCached );
+		void FinalizeStatements();
+
+	private:
+		std::string fFilename;
+		sqlite3 *fDB;
+		std::map< std::string, sqlite3_stmt * > fStatements;
+
+		mutable std::mutex fMutex;
+		std::condition_variable fCondition;
+		std::deque< SQLiteJob * > fPending;
+		std::vector< SQLiteJob * > fCompleted;
+		U32 fNumOutstanding;
+		bool fIsClosed;
+
+		std::thread fThread;
+};
+
+SQLiteWorker::SQLiteWorker( const char *filename )
+:	fFilename( filename ),
+	fDB( NULL ),
+	fNumOutstanding( 0 ),
+	fIsClosed( false )
+{
+	fThread = std::thread( & SQLiteWorker::Run, this );
+}
+
+SQLiteWorker::~SQLiteWorker()
+{
+	Close();
+	fThread.join();
+
+	// Listeners of undelivered results go away with the Lua state
+	for ( size_t i = 0; i < fCompleted.size(); i++ )
+	{
+		delete fCompleted[i];
+	}
+}
+
+void
+SQLiteWorker::Submit( SQLiteJob *job )
+{
+	{
+		std::lock_guard< std::mutex > lock( fMutex );
+		fPending.push_back( job );
+		++fNumOutstanding;
+	}
+	fCondition.notify_one();
+}
+
+void
+SQLiteWorker::TakeCompleted( std::vector< SQLiteJob * >& outJobs )
+{
+	std::lock_guard< std::mutex > lock( fMutex );
+	outJobs.swap( fCompleted );
+	fNumOutstanding -= (U32)outJobs.size();
+}
+
+void
+SQLiteWorker::Close()
+{
+	{
+		std::lock_guard< std::mutex > lock( fMutex );
+		fIsClosed = true;
+	}
+	fCondition.notify_one();
+}
+
+bool
+SQLiteWorker::IsFinished() const
+{
+	std::lock_guard< std::mutex > lock( fMutex );
+	return fIsClosed && 0 == fNumOutstanding;
+}
+
+void
+SQLiteWorker::Run()
+{
+	for ( ;; )
+	{
+		SQLiteJob *job = NULL;
+		{
+			std::unique_lock< std::mutex > lock( fMutex );
+			fCondition.wait( lock, [this]{ return fIsClosed || ! fPending.empty(); } );
+
+			// Calls made before Close() still run
+			if ( fPending.empty() )
+			{
+				break;
+			}
+			job = fPending.front();
+			fPending.pop_front();
+		}
+
+		Execute( * job );
+
+		std::lock_guard< std::mutex > lock( fMutex );
+		fCompleted.push_back( job );
+	}
+
+	FinalizeStatements();
+	if ( fDB )
+	{
+		sqlite3_close( fDB );
+		fDB = NULL;
+	}
+}
+
+void
+SQLiteWorker::Execute( SQLiteJob& job )
+{
+	if ( ! fDB )
+	{
+		int result = sqlite3_open_v2( fFilename.c_str(), & fDB, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX, NULL );
+		if ( SQLITE_OK != result )
+		{
+			job.fResult = result;
+			job.fErrorMessage = fDB ? sqlite3_errmsg( fDB ) : sqlite3_errstr( result );
+			sqlite3_close( fDB );
+			fDB = NULL;
+			return;
+		}
+
+		sqlite3_busy_timeout( fDB, kBusyTimeoutMs );
+		sqlite3_exec( fDB, "PRAGMA journal_mode=WAL", NULL, NULL, NULL );
+	}
+
+	int totalChanges = sqlite3_total_changes( fDB );
+
+	// Many rows of parameters are bound in a single transaction
+	bool isBatch = job.fParams.size() > 1 && sqlite3_get_autocommit( fDB );
+	if ( isBatch )
+	{
+		sqlite3_exec( fDB, "BEGIN IMMEDIATE", NULL, NULL, NULL );
+	}
+
+	// Only a single statement can take parameters or be cached; other SQL
+	// is run one statement at a time
+	const char *sql = job.fSQL.c_str();
+	while ( SQLITE_OK == job.fResult && * sql )
+	{
+		sqlite3_stmt *statement = NULL;
+		const char *tail = NULL;
+		bool isCached = false;
+
+		if ( sql == job.fSQL.c_str() )
+		{
+			statement = Prepare( job.fSQL, isCached );
+			tail = isCached ? sql + job.fSQL.length() : NULL;
+		}
+
+		if ( ! statement && ! isCached )
+		{
+			job.fResult = sqlite3_prepare_v2( fDB, sql, -1, & statement, & tail );
+			if ( SQLITE_OK != job.fResult )
+			{
+				break;
+			}
+			if ( ! statement )
+			{
+				// Whitespace or a comment
+				sql = tail;
+				continue;
+			}
+			if ( ! job.fParams.empty() && tail && * tail )
+			{
+				job.fResult = SQLITE_MISUSE;
+				job.fErrorMessage = "parameters can only be bound to a single SQL statement";
+				sqlite3_finalize( statement );
+				break;
+			}
+		}
+
+		bool collectRows = job.fIsQuery && job.fColumnNames.empty() && sqlite3_column_count( statement ) > 0;
+		if ( collectRows )
+		{
+			int numColumns = sqlite3_column_count( statement );
+			job.fColumns.resize( numColumns );
+			for ( int i = 0; i < numColumns; i++ )
+			{
+				const char *name = sqlite3_column_name( statement, i );
+				job.fColumnNames.push_back( name ? name : "" );
+			}
+		}
+
+		if ( job.fParams.empty() )
+		{
+			Step( job, statement, collectRows );
+		}
+		else
+		{
+			for ( size_t i = 0; i < job.fParams.size() && SQLITE_OK == job.fResult; i++ )
+			{
+				if ( Bind( job, statement, job.fParams[i] ) )
+				{
+					Step( job, statement, collectRows );
+				}
+				sqlite3_clear_bindings( statement );
+			}
+		}
+
+		if ( isCached )
+		{
+			sqlite3_reset( statement );
+			sqlite3_clear_bindings( statement );
+		}
+		else
+		{
+			sqlite3_finalize( statement );
+		}
+
+		sql = tail ? tail : "";
+	}
+
+	if ( isBatch )
+	{
+		sqlite3_exec( fDB, SQLITE_OK == job.fResult ? "COMMIT" : "ROLLBACK", NULL, NULL, NULL );
+	}
+
+	if ( SQLITE_OK != job.fResult && job.fErrorMessage.empty() )
+	{
+		job.fErrorMessage = sqlite3_errmsg( fDB );
+	}
+
+	job.fChanges = sqlite3_total_changes( fDB ) - totalChanges;
+	job.fLastInsertRowid = sqlite3_last_insert_rowid( fDB );
+}
+
+void
+SQLiteWorker::Step( SQLiteJob& job, sqlite3_stmt *statement, bool collectRows )
+{
+	int result;
+	while ( SQLITE_ROW == ( result = sqlite3_step( statement ) ) )
+	{
+		if ( ! collectRows )
+		{
+			continue;
+		}
+
+		for ( size_t i = 0; i < job.fColumns.size(); i++ )
+		{
+			SQLiteValue value;
+			value.fType = sqlite3_column_type( statement, (int)i );
+			switch ( value.fType )
+			{
+				case SQLITE_INTEGER:
+					value.fInteger = sqlite3_column_int64( statement, (int)i );
+					break;
+				case SQLITE_FLOAT:
+					value.fFloat = sqlite3_column_double( statement, (int)i );
+					break;
+				case SQLITE_TEXT:
+				case SQLITE_BLOB:
+				{
+					const void *bytes = ( SQLITE_BLOB == value.fType )
+						? sqlite3_column_blob( statement, (int)i )
+						: (const void *)sqlite3_column_text( statement, (int)i );
+					int numBytes = sqlite3_column_bytes( statement, (int)i );
+					if ( bytes )
+					{
+						value.fText.assign( (const char *)bytes, numBytes );
+					}
+					break;
+				}
+				default:
+					break;
+			}
+			job.fColumns[i].push_back( value );
+		}
+		++job.fNumRows;
+	}
+
+	if ( SQLITE_DONE != result )
+	{
+		job.fResult = result;
+		job.fErrorMessage = sqlite3_errmsg( fDB );
+	}
+	sqlite3_reset( statement );
+}
+
+bool
+SQLiteWorker::Bind( SQLiteJob& job, sqlite3_stmt *statement, const SQLiteParams& params )
+{
+	int position = 0;
+	for ( size_t i = 0; i < params.size(); i++ )
+	{
+		const std::string& name = params[i].first;
+		const SQLiteValue& value = params[i].second;
+
+		int index;
+		if ( name.empty() )
+		{
+			index = ++position;
+		}
+		else
+		{
+			// Accept any of the prefixes SQLite allows
+			static const char kPrefixes[] = ":$@";
+			index = 0;
+			for ( int p = 0; p < 3 && 0 == index; p++ )
+			{
+				std::string prefixed = kPrefixes[p] + name;
+				index = sqlite3_bind_parameter_index( statement, prefixed.c_str() );
+			}
+			if ( 0 == index )
+			{
+				continue;
+			}
+		}
+
+		int result;
+		switch ( value.fType )
+		{
+			case SQLITE_INTEGER:
+				result = sqlite3_bind_int64( statement, index, value.fInteger );
+				break;
+			case SQLITE_FLOAT:
+				result = sqlite3_bind_double( statement, index, value.fFloat );
+				break;
+			case SQLITE_TEXT:
+				result = sqlite3_bind_text( statement, index, value.fText.c_str(), (int)value.fText.length(), SQLITE_STATIC );
+				break;
+			case SQLITE_BLOB:
+				result = sqlite3_bind_blob( statement, index, value.fText.data(), (int)value.fText.length(), SQLITE_STATIC );
+				break;
+			default:
+				result = sqlite3_bind_null( statement, index );
+				break;
+		}
+
+		if ( SQLITE_OK != result )
+		{
+			job.fResult = result;
+			job.fErrorMessage = sqlite3_errmsg( fDB );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+sqlite3_stmt *
+SQLiteWorker::Prepare( const std::string& sql, bool& outIsCached )
+{
+	outIsCached = false;
+
+	std::map< std::string, sqlite3_stmt * >::iterator iter = fStatements.find( sql );
+	if ( iter != fStatements.end() )
+	{
+		outIsCached = true;
+		return iter->second;
+	}
+
+	sqlite3_stmt *statement = NULL;
+	const char *tail = NULL;
+	if ( SQLITE_OK != sqlite3_prepare_v2( fDB, sql.c_str(), -1, & statement, & tail ) || ! statement )
+	{
+		return NULL;
+	}
+
+	// Only SQL that is exactly one statement is worth keeping
+	while ( * tail == ' ' || * tail == '\t' || * tail == '\r' || * tail == '\n' || * tail == ';' )
+	{
+		++tail;
+	}
+	if ( * tail )
+	{
+		sqlite3_finalize( statement );
+		return NULL;
+	}
+
+	if ( fStatements.size() >= kMaxCachedStatements )
+	{
+		FinalizeStatements();
+	}
+
+	fStatements[sql] = statement;
+	outIsCached = true;
+	return statement;
+}
+
+void
+SQLiteWorker::FinalizeStatements()
+{
+	for ( std::map< std::string, sqlite3_stmt * >::iterator iter = fStatements.begin(); iter != fStatements.end(); ++iter )
+	{
+		sqlite3_finalize( iter->second );
+	}
+	fStatements.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+// Hands completed jobs back to their listeners on the Lua thread. Lives until
+// the database object is collected and every job has been delivered.
+class SQLiteCompletionTask : public Task
+{
+	public:
+		typedef Task Super;
+
+	public:
+		SQLiteCompletionTask( const std::shared_ptr< SQLiteWorker >& worker )
+		:	Super( true ),
+			fWorker( worker )
+		{
+		}
+
+	public:
+		virtual void operator()( Scheduler& sender );
+
+	protected:
+		static void PushValue( lua_State *L, const SQLiteValue& value );
+		static void Dispatch( lua_State *L, SQLiteJob& job );
+
+	private:
+		std::shared_ptr< SQLiteWorker > fWorker;
+		std::vector< SQLiteJob * > fJobs;
+};
+
+void
+SQLiteCompletionTask::operator()( Scheduler& sender )
+{
+	lua_State *L = sender.GetOwner().VMContext().L();
+
+	fWorker->TakeCompleted( fJobs );
+	for ( size_t i = 0; i < fJobs.size(); i++ )
+	{
+		SQLiteJob *job = fJobs[i];
+		if ( job->fListener )
+		{
+			Dispatch( L, * job );
+			Lua::DeleteRef( L, job->fListener );
+		}
+		delete job;
+	}
+	fJobs.clear();
+
+	if ( fWorker->IsFinished() )
+	{
+		setKeepAlive( false );
+	}
+}
+
+void
+SQLiteCompletionTask::PushValue( lua_State *L, const SQLiteValue& value )
+{
+	switch ( value.fType )
+	{
+		case SQLITE_INTEGER:
+			lua_pushnumber( L, (lua_Number)value.fInteger );
+			break;
+		case SQLITE_FLOAT:
+			lua_pushnumber( L, value.fFloat );
+			break;
+		case SQLITE_TEXT:
+		case SQLITE_BLOB:
+			lua_pushlstring( L, value.fText.data(), value.fText.length() );
+			break;
+		default:
+			lua_pushnil( L );
+			break;
+	}
+}
+
+void
+SQLiteCompletionTask::Dispatch( lua_State *L, SQLiteJob& job )
+{
+	bool isError = ( SQLITE_OK != job.fResult );
+
+	Lua::NewEvent( L, "sqlite" );
+
+	lua_pushboolean( L, isError );
+	lua_setfield( L, -2, "isError" );
+	lua_pushinteger( L, job.fResult );
+	lua_setfield( L, -2, "errorCode" );
+	if ( isError )
+	{
+		lua_pushstring( L, job.fErrorMessage.c_str() );
+		lua_setfield( L, -2, "errorMessage" );
+	}
+	lua_pushinteger( L, job.fChanges );
+	lua_setfield( L, -2, "changes" );
+	lua_pushnumber( L, (lua_Number)job.fLastInsertRowid );
+	lua_setfield( L, -2, "lastInsertRowid" );
+
+	if ( job.fIsQuery )
+	{
+		// Columnar results: event.columns[name][row], in event.columnNames order
+		int numColumns = (int)job.fColumnNames.size();
+		lua_createtable( L, numColumns, 0 );
+		lua_createtable( L, 0, numColumns );
+		for ( int c = 0; c < numColumns; c++ )
+		{
+			lua_pushstring( L, job.fColumnNames[c].c_str() );
+			lua_rawseti( L, -3, c + 1 );
+
+			const std::vector< SQLiteValue >& values = job.fColumns[c];
+			lua_createtable( L, (int)values.size(), 0 );
+			for ( size_t r = 0; r < values.size(); r++ )
+			{
+				PushValue( L, values[r] );
+				lua_rawseti( L, -2, (int)r + 1 );
+			}
+			lua_setfield( L, -2, job.fColumnNames[c].c_str() );
+		}
+		lua_setfield( L, -3, "columns" );
+		lua_setfield( L, -2, "columnNames" );
+
+		lua_pushinteger( L, (lua_Integer)job.fNumRows );
+		lua_setfield( L, -2, "numRows" );
+	}
+
+	Lua::DispatchEvent( L, job.fListener, 0 );
+}
+
+// ----------------------------------------------------------------------------
+
+static const char kWorkerMetatable[] = "SQLiteWorker";
+static const char kWorkersKey[] = "SQLiteWorkers";
+
+static int
+WorkerFinalizer( lua_State *L )
+{
+	std::shared_ptr< SQLiteWorker > *worker = (std::shared_ptr< SQLiteWorker > *)luaL_checkudata( L, 1, kWorkerMetatable );
+
+	// Pending calls still run and report back through the completion task
+	(*worker)->Close();
+	worker->~shared_ptr();
+	return 0;
+}
+
+// Returns the worker for the database object at index 1, creating it on first use
+static SQLiteWorker&
+GetWorker( lua_State *L )
+{
+	// registry[kWorkersKey] is keyed weakly by database object
+	lua_getfield( L, LUA_REGISTRYINDEX, kWorkersKey );
+	if ( lua_isnil( L, -1 ) )
+	{
+		lua_pop( L, 1 );
+		lua_newtable( L );
+		lua_createtable( L, 0, 1 );
+		lua_pushstring( L, "k" );
+		lua_setfield( L, -2, "__mode" );
+		lua_setmetatable( L, -2 );
+		lua_pushvalue( L, -1 );
+		lua_setfield( L, LUA_REGISTRYINDEX, kWorkersKey );
+	}
+
+	lua_pushvalue( L, 1 );
+	lua_rawget( L, -2 );
+	std::shared_ptr< SQLiteWorker > *worker = (std::shared_ptr< SQLiteWorker > *)lua_touserdata( L, -1 );
+	lua_pop( L, 1 );
+
+	if ( ! worker )
+	{
+		// Also verifies that index 1 is an open database
+		lua_getfield( L, 1, "get_ptr" );
+		lua_pushvalue( L, 1 );
+		lua_call( L, 1, 1 );
+		sqlite3 *db = (sqlite3 *)lua_touserdata( L, -1 );
+		lua_pop( L, 1 );
+
+		const char *filename = db ? sqlite3_db_filename( db, "main" ) : NULL;
+		if ( ! filename || '\0' == * filename )
+		{
+			luaL_error( L, "async calls need a database stored in a file" );
+		}
+
+		worker = (std::shared_ptr< SQLiteWorker > *)lua_newuserdata( L, sizeof( std::shared_ptr< SQLiteWorker > ) );
+		new ( worker ) std::shared_ptr< SQLiteWorker >( new SQLiteWorker( filename ) );
+		if ( luaL_newmetatable( L, kWorkerMetatable ) )
+		{
+			lua_pushcfunction( L, & WorkerFinalizer );
+			lua_setfield( L, -2, "__gc" );
+		}
+		lua_setmetatable( L, -2 );
+
+		lua_pushvalue( L, 1 );
+		lua_pushvalue( L, -2 );
+		lua_rawset( L, -4 );
+		lua_pop( L, 1 );
+
+		Runtime *runtime = LuaContext::GetRuntime( L );
+		runtime->GetScheduler().Append( Rtt_NEW( runtime->Allocator(), SQLiteCompletionTask( * worker ) ) );
+	}
+
+	lua_pop( L, 1 );
+	return ** worker;
+}
+
+static void
+ToValue( lua_State *L, int index, SQLiteValue& outValue )
+{
+	switch ( lua_type( L, index ) )
+	{
+		case LUA_TNUMBER:
+		{
+			lua_Number n = lua_tonumber( L, index );
+			sqlite3_int64 i = (sqlite3_int64)n;
+			if ( (lua_Number)i == n )
+			{
+				outValue.fType = SQLITE_INTEGER;
+				outValue.fInteger = i;
+			}
+			else
+			{
+				outValue.fType = SQLITE_FLOAT;
+				outValue.fFloat = n;
+			}
+			break;
+		}
+		case LUA_TBOOLEAN:
+			outValue.fType = SQLITE_INTEGER;
+			outValue.fInteger = lua_toboolean( L, index );
+			break;
+		case LUA_TSTRING:
+		{
+			size_t length = 0;
+			const char *s = lua_tolstring( L, index, & length );
+			outValue.fType = SQLITE_TEXT;
+			outValue.fText.assign( s, length );
+			break;
+		}
+		default:
+			outValue.fType = SQLITE_NULL;
+			break;
+	}
+}
+
+// Reads one set of parameters: an array binds by position, other keys by name
+static void
+ToParams( lua_State *L, int index, SQLiteParams& outParams )
+{
+	index = ( index < 0 ? lua_gettop( L ) + index + 1 : index );
+
+	int length = (int)lua_objlen( L, index );
+	for ( int i = 1; i <= length; i++ )
+	{
+		lua_rawgeti( L, index, i );
+		outParams.push_back( std::make_pair( std::string(), SQLiteValue() ) );
+		ToValue( L, -1, outParams.back().second );
+		lua_pop( L, 1 );
+	}
+
+	for ( lua_pushnil( L ); lua_next( L, index ); lua_pop( L, 1 ) )
+	{
+		if ( LUA_TSTRING == lua_type( L, -2 ) )
+		{
+			outParams.push_back( std::make_pair( std::string( lua_tostring( L, -2 ) ), SQLiteValue() ) );
+			ToValue( L, -1, outParams.back().second );
+		}
+	}
+}
+
+// db:execAsync( sql [, params] [, listener] )
+// db:rowsAsync( sql [, params], listener )
+//
+// params is one table of parameters, or an array of them to run the
+// statement once per entry in a single transaction
+static int
+SubmitAsync( lua_State *L, bool isQuery )
+{
+	luaL_checkstring( L, 2 );
+	SQLiteWorker& worker = GetWorker( L );
+
+	SQLiteJob *job = new SQLiteJob;
+	job->fIsQuery = isQuery;
+	job->fSQL = lua_tostring( L, 2 );
+
+	int listenerIndex = 3;
+	if ( lua_istable( L, 3 ) && ! Lua::IsListener( L, 3, "sqlite" ) )
+	{
+		listenerIndex = 4;
+
+		lua_rawgeti( L, 3, 1 );
+		bool isBulk = lua_istable( L, -1 );
+		lua_pop( L, 1 );
+
+		if ( isBulk )
+		{
+			int numRows = (int)lua_objlen( L, 3 );
+			job->fParams.resize( numRows );
+			for ( int i = 1; i <= numRows; i++ )
+			{
+				lua_rawgeti( L, 3, i );
+				if ( lua_istable( L, -1 ) )
+				{
+					ToParams( L, -1, job->fParams[i - 1] );
+				}
+				lua_pop( L, 1 );
+			}
+		}
+		else
+		{
+			job->fParams.resize( 1 );
+			ToParams( L, 3, job->fParams[0] );
+		}
+	}
+
+	if ( Lua::IsListener( L, listenerIndex, "sqlite" ) )
+	{
+		job->fListener = Lua::NewRef( L, listenerIndex );
+	}
+	else if ( isQuery )
+	{
+		delete job;
+		return luaL_argerror( L, listenerIndex, "listener expected" );
+	}
+
+	worker.Submit( job );
+	return 0;
+}
+
+static int
+execAsync( lua_State *L )
+{
+	return SubmitAsync( L, false );
+}
+
+static int
+rowsAsync( lua_State *L )
+{
+	return SubmitAsync( L, true );
+}
+
+// ----------------------------------------------------------------------------
+
 int
 LuaLibSQLite::Open( lua_State *L )
 {
 	int result = luaopen_lsqlite3(L);
 
+	// Add the async methods to database objects
+	luaL_getmetatable( L, ":sqlite3" );
+	if ( lua_istable( L, -1 ) )
+	{
+		lua_pushcfunction( L, & execAsync );
+		lua_setfield( L, -2, "execAsync" );
+		lua_pushcfunction( L, & rowsAsync );
+		lua_setfield( L, -2, "rowsAsync" );
+	}
+	lua_pop( L, 1 );
+
 	return result;
 }
 
 // ----------------------------------------------------------------------------
-	
+
 } // namespace Rtt
 
 // ----------------------------------------------------------------------------
 
 #endif // Rtt_SQLITE
-
@@ -13,6 +13,7 @@
 
 #include "Display/Rtt_Display.h"
 #include "Display/Rtt_TextureFactory.h"
+#include "Rtt_LuaAllocator.h"
 #include "Rtt_LuaContext.h"
 #include "Display/Rtt_LuaLibDisplay.h"
 #include "Rtt_LuaProxy.h"
@@ -181,11 +182,65 @@ LuaLibSystem::getInfo( lua_State *L )
 		TextureFactory& factory = LuaContext::GetRuntime( L )->GetDisplay().GetTextureFactory();
 		lua_pushinteger( L, factory.GetTextureMemoryUsed() );
 	}
+	else if ( Rtt_StringCompare( key, "resourceMemory" ) == 0 )
+	{
+		TextureFactory& factory = LuaContext::GetRuntime( L )->GetDisplay().GetTextureFactory();
+		const RenderTargetPool& pool = factory.GetRenderTargetPool();
+
+		// Texture bytes by category. The ones in "textures" include "cachedTextures".
+		size_t renderTargetBytes = pool.GetBytesAllocated();
+		lua_createtable( L, 0, 5 );
+		lua_pushnumber( L, (lua_Number)( factory.GetTextureMemoryUsed() - renderTargetBytes ) );
+		lua_setfield( L, -2, "textures" );
+		lua_pushnumber( L, (lua_Number)factory.GetCachedTextureMemory() );
+		lua_setfield( L, -2, "cachedTextures" );
+		lua_pushnumber( L, (lua_Number)renderTargetBytes );
+		lua_setfield( L, -2, "renderTargets" );
+		lua_pushnumber( L, (lua_Number)pool.GetStatistics().fBytesFree );
+		lua_setfield( L, -2, "freeRenderTargets" );
+		lua_pushnumber( L, (lua_Number)factory.GetMemoryBudget() );
+		lua_setfield( L, -2, "budget" );
+	}
 	else if ( Rtt_StringCompare( key, "maxTextureSize" ) == 0 )
 	{
 		Runtime *runtime = LuaContext::GetRuntime( L );
 		lua_pushinteger( L, runtime->GetDisplay().GetMaxTextureSize() );
 	}
+	else if ( Rtt_StringCompare( key, "luaMemory" ) == 0 )
+	{
+		const LuaAllocator& allocator = LuaContext::GetLuaAllocator( L );
+
+		LuaAllocator::Statistics stats;
+		allocator.GetStatistics( stats );
+
+		lua_createtable( L, 0, 5 );
+		lua_pushinteger( L, (lua_Integer)stats.fSmallBytes );
+		lua_setfield( L, -2, "smallBytes" );
+		lua_pushinteger( L, (lua_Integer)stats.fPageBytes );
+		lua_setfield( L, -2, "pageBytes" );
+		lua_pushinteger( L, (lua_Integer)stats.fLargeBytes );
+		lua_setfield( L, -2, "largeBytes" );
+		lua_pushinteger( L, stats.fLargeBlocks );
+		lua_setfield( L, -2, "largeBlocks" );
+
+		lua_createtable( L, LuaAllocator::kNumSizeClasses, 0 );
+		for ( S32 i = 0; i < LuaAllocator::kNumSizeClasses; i++ )
+		{
+			const LuaAllocator::SizeClassStatistics& classStats = allocator.GetSizeClassStatistics( i );
+
+			lua_createtable( L, 0, 4 );
+			lua_pushinteger( L, classStats.fBlockSize );
+			lua_setfield( L, -2, "blockSize" );
+			lua_pushinteger( L, classStats.fBlocksUsed );
+			lua_setfield( L, -2, "blocksUsed" );
+			lua_pushinteger( L, classStats.fBlocksFree );
+			lua_setfield( L, -2, "blocksFree" );
+			lua_pushinteger( L, classStats.fPageCount );
+			lua_setfield( L, -2, "pages" );
+			lua_rawseti( L, -2, i + 1 );
+		}
+		lua_setfield( L, -2, "sizeClasses" );
+	}
 	
 #ifdef OLD_GRAPHICS
     else if ( Rtt_StringCompare( key, "maxTextureUnits" ) == 0 )
@@ -30,6 +30,7 @@
 #include "Display/Rtt_ShaderFactory.h"
 #include "Display/Rtt_ShapeObject.h"
 #include "Display/Rtt_SnapshotObject.h"
+#include "Display/Rtt_SpriteBatchObject.h"
 #include "Display/Rtt_SpriteObject.h"
 #include "Display/Rtt_StageObject.h"
 #include "Display/Rtt_TextObject.h"
@@ -48,6 +49,7 @@
 #include "Core/Rtt_StringHash.h"
 
 #include <string.h>
+#include <vector>
 
 #include "Rtt_Lua.h"
 #include "Rtt_Profiling.h"
@@ -389,9 +391,7 @@ removeSelf( lua_State *L )
 
             if (parent != NULL)
             {
-                S32 index = parent->Find( *o );
-
-                LuaDisplayObjectProxyVTable::PushAndRemove( L, parent, index );
+                LuaDisplayObjectProxyVTable::PushAndRemove( L, parent, o );
 
                 result = 1;
             }
@@ -3930,12 +3930,12 @@ LuaGroupObjectProxyVTable::insert( lua_State *L )
     return Insert( L, parent );
 }
 
-// Removes child at index from parent and pushes onto the stack. Pushes nil
-// if index is invalid.
+// Removes child from parent and pushes onto the stack. Pushes nil
+// if child is NULL.
 void
-LuaDisplayObjectProxyVTable::PushAndRemove( lua_State *L, GroupObject* parent, S32 index )
+LuaDisplayObjectProxyVTable::PushAndRemove( lua_State *L, GroupObject* parent, DisplayObject* child )
 {
-    if ( index >= 0 )
+    if ( child )
     {
         Rtt_ASSERT( parent );
 
@@ -3948,9 +3948,8 @@ LuaDisplayObjectProxyVTable::PushAndRemove( lua_State *L, GroupObject* parent, S
 
 			SUMMED_TIMING( par1, "Object: PushAndRemove (release)" );
 
-            DisplayObject* child = parent->Release( index );
+            parent->ReleaseChild( * child );
 
-            if (child != NULL)
             {
 				SUMMED_TIMING( par2, "Object: PushAndRemove (rest)" );
 
@@ -4020,16 +4019,18 @@ LuaGroupObjectProxyVTable::Remove( lua_State *L, GroupObject *parent )
 {
     Rtt_ASSERT( ! lua_isnil( L, 1 ) );
 
-    S32 index = -1;
+    DisplayObject* target = NULL;
     if ( lua_istable( L, 2 ) )
     {
         DisplayObject* child = (DisplayObject*)LuaProxy::GetProxyableObject( L, 2 );
         if ( child )
         {
-            index = parent->Find( * child );
-
+            if ( parent == child->GetParent() )
+            {
+                target = child;
+            }
 #if defined( Rtt_DEBUG ) || defined( Rtt_AUTHORING_SIMULATOR )
-            if (index < 0)
+            else
             {
                 CoronaLuaWarning(L, "objectGroup:remove(): invalid object reference (most likely object is not in group)");
             }
@@ -4039,17 +4040,21 @@ LuaGroupObjectProxyVTable::Remove( lua_State *L, GroupObject *parent )
     else
     {
         // Lua indices start at 1
-        index = (int) lua_tointeger( L, 2 ) - 1;
+        S32 index = (int) lua_tointeger( L, 2 ) - 1;
 
+        if ( index >= 0 && index < parent->NumChildren() )
+        {
+            target = & parent->ChildAt( index );
+        }
 #if defined( Rtt_DEBUG ) || defined( Rtt_AUTHORING_SIMULATOR )
-        if (index < 0 || index > parent->NumChildren())
+        else
         {
             CoronaLuaWarning(L, "objectGroup:remove(): index of %ld out of range (should be 1 to %d)", lua_tointeger( L, 2 ), parent->NumChildren());
         }
 #endif
     }
 
-    PushAndRemove( L, parent, index );
+    PushAndRemove( L, parent, target );
 
     return 1;
 }
@@ -4063,6 +4068,58 @@ LuaGroupObjectProxyVTable::Remove( lua_State *L )
     return Remove( L, parent );
 }
 
+// group:sortChildren( [key] )
+// Orders the children by ascending value of the numeric property 'key', which
+// defaults to "y", so children with larger values are drawn on top
+int
+LuaGroupObjectProxyVTable::sortChildren( lua_State *L )
+{
+    Rtt_WARN_SIM_PROXY_TYPE( L, 1, GroupObject );
+    GroupObject *o = (GroupObject*)LuaProxy::GetProxyableObject( L, 1 );
+
+    if ( o && o->NumChildren() > 1 )
+    {
+        const char *key = ( lua_type( L, 2 ) == LUA_TSTRING ? lua_tostring( L, 2 ) : "y" );
+
+        // Positions are read directly, anything else through the child's table
+        enum { kOther = -1 };
+        int property = kOther;
+        if ( 0 == strcmp( key, "x" ) ) { property = kOriginX; }
+        else if ( 0 == strcmp( key, "y" ) ) { property = kOriginY; }
+
+        const S32 numChildren = o->NumChildren();
+        std::vector< Real > keys( numChildren );
+
+        for ( S32 i = 0; i < numChildren; i++ )
+        {
+            const DisplayObject& child = o->ChildAt( i );
+
+            if ( kOther != property )
+            {
+                keys[i] = child.GetGeometricProperty( (GeometricProperty)property );
+            }
+            else
+            {
+                LuaProxy *proxy = child.GetProxy();
+                if ( proxy && proxy->PushTable( L ) )
+                {
+                    lua_getfield( L, -1, key );
+                    keys[i] = Rtt_FloatToReal( (float)lua_tonumber( L, -1 ) );
+                    lua_pop( L, 2 );
+                }
+                else
+                {
+                    keys[i] = Rtt_REAL_0;
+                }
+            }
+        }
+
+        o->SortChildren( & keys[0] );
+    }
+
+    return 0;
+}
+
 int
 LuaGroupObjectProxyVTable::PushChild( lua_State *L, const GroupObject& o )
 {
@@ -4098,10 +4155,12 @@ LuaGroupObjectProxyVTable::PushMethod( lua_State *L, const GroupObject& o, const
 		"insert",			// 0
 		"remove",			// 1
 		"numChildren",		// 2
-		"anchorChildren"	// 3
+		"anchorChildren",	// 3
+		"cacheAsBitmap",	// 4
+		"sortChildren"		// 5
 	};
     static const int numKeys = sizeof( keys ) / sizeof( const char * );
-	static StringHash sHash( *LuaContext::GetAllocator( L ), keys, numKeys, 4, 0, 1, __FILE__, __LINE__ );
+	static StringHash sHash( *LuaContext::GetAllocator( L ), keys, numKeys, 6, 1, 1, __FILE__, __LINE__ );
 	StringHash *hash = &sHash;
 
 	int index = hash->Lookup( key );
@@ -4132,6 +4191,26 @@ LuaGroupObjectProxyVTable::PushMethod( lua_State *L, const GroupObject& o, const
 			result = 1;
 		}
 		break;
+	case 4:
+		{
+			BitmapCache::Mode mode = o.GetCacheMode();
+			if ( BitmapCache::kAuto == mode )
+			{
+				lua_pushstring( L, "auto" );
+			}
+			else
+			{
+				lua_pushboolean( L, BitmapCache::kNone != mode );
+			}
+			result = 1;
+		}
+		break;
+	case 5:
+		{
+			Lua::PushCachedFunction( L, Self::sortChildren );
+			result = 1;
+		}
+		break;
 	default:
 		{
             result = 0;
@@ -4203,6 +4282,23 @@ LuaGroupObjectProxyVTable::SetValueForKey( lua_State *L, MLuaProxyable& object,
         }
 #endif
     }
+    else if ( 0 == strcmp( key, "cacheAsBitmap" ) )
+    {
+        GroupObject& o = static_cast< GroupObject& >( object );
+
+        // true, false or "auto"
+        BitmapCache::Mode mode = BitmapCache::kNone;
+        if ( lua_type( L, valueIndex ) == LUA_TSTRING )
+        {
+            mode = BitmapCache::ModeForString( lua_tostring( L, valueIndex ) );
+        }
+        else if ( lua_toboolean( L, valueIndex ) )
+        {
+            mode = BitmapCache::kAlways;
+        }
+
+        o.SetCacheMode( mode );
+    }
     else
     {
         result = Super::SetValueForKey( L, object, key, valueIndex );
@@ -5172,6 +5268,347 @@ LuaSpriteObjectProxyVTable::Parent() const
 
 // ----------------------------------------------------------------------------
 
+const LuaSpriteBatchObjectProxyVTable&
+LuaSpriteBatchObjectProxyVTable::Constant()
+{
+	static const Self kVTable;
+	return kVTable;
+}
+
+// Converts the 1-based frame at index to a valid 0-based frame of the batch's sheet
+static S32
+ToSpriteBatchFrame( lua_State *L, int index, const SpriteBatchObject& o, const char *method )
+{
+	S32 numFrames = o.GetSheet()->GetNumFrames();
+	S32 frame = (S32) lua_tointeger( L, index );
+	if ( frame < 1 || frame > numFrames )
+	{
+		S32 clamped = Clamp( frame, (S32)1, numFrames );
+		CoronaLuaWarning( L, "spriteBatch:%s() given invalid frame (%d). Using frame %d instead", method, frame, clamped );
+		frame = clamped;
+	}
+
+	return frame - 1; // Lua is 1-based
+}
+
+// Reads ( frame, x, y [, rotation, xScale, yScale] ) starting at index
+static void
+ToSpriteBatchInstance( lua_State *L, int index, const SpriteBatchObject& o, const char *method, SpriteBatchObject::Instance& instance )
+{
+	instance.fFrame = ToSpriteBatchFrame( L, index, o, method );
+	instance.fX = luaL_toreal( L, index + 1 );
+	instance.fY = luaL_toreal( L, index + 2 );
+	instance.fRotation = ( lua_isnumber( L, index + 3 ) ? luaL_toreal( L, index + 3 ) : Rtt_REAL_0 );
+	instance.fXScale = ( lua_isnumber( L, index + 4 ) ? luaL_toreal( L, index + 4 ) : Rtt_REAL_1 );
+	instance.fYScale = ( lua_isnumber( L, index + 5 ) ? luaL_toreal( L, index + 5 ) : Rtt_REAL_1 );
+}
+
+// spriteBatch:add( frame, x, y [, rotation, xScale, yScale] )
+int
+LuaSpriteBatchObjectProxyVTable::add( lua_State *L )
+{
+	SpriteBatchObject *o = (SpriteBatchObject*)LuaProxy::GetProxyableObject( L, 1 );
+
+	Rtt_WARN_SIM_PROXY_TYPE( L, 1, SpriteBatchObject );
+
+	if ( o )
+	{
+		SpriteBatchObject::Instance instance;
+		ToSpriteBatchInstance( L, 2, *o, "add", instance );
+		instance.fTint = ColorWhite();
+
+		if ( o->Append( instance ) )
+		{
+			lua_pushinteger( L, o->GetNumInstances() ); // Lua is 1-based
+			return 1;
+		}
+
+		CoronaLuaWarning( L, "spriteBatch:add() failed. The batch is full (capacity is %d)", o->GetCapacity() );
+	}
+
+	return 0;
+}
+
+// spriteBatch:set( index, frame, x, y [, rotation, xScale, yScale] )
+int
+LuaSpriteBatchObjectProxyVTable::set( lua_State *L )
+{
+	SpriteBatchObject *o = (SpriteBatchObject*)LuaProxy::GetProxyableObject( L, 1 );
+
+	Rtt_WARN_SIM_PROXY_TYPE( L, 1, SpriteBatchObject );
+
+	if ( o )
+	{
+		U32 index = (U32) lua_tointeger( L, 2 ) - 1U; // Lua is 1-based
+		if ( index < o->GetNumInstances() )
+		{
+			SpriteBatchObject::Instance instance;
+			ToSpriteBatchInstance( L, 3, *o, "set", instance );
+			instance.fTint = o->GetInstance( index ).fTint;
+
+			o->Set( index, instance );
+		}
+		else
+		{
+			CoronaLuaWarning( L, "spriteBatch:set() given invalid index (%d)", (int) lua_tointeger( L, 2 ) );
+		}
+	}
+
+	return 0;
+}
+
+// spriteBatch:setTint( index, r, g, b [, a] )
+int
+LuaSpriteBatchObjectProxyVTable::setTint( lua_State *L )
+{
+	SpriteBatchObject *o = (SpriteBatchObject*)LuaProxy::GetProxyableObject( L, 1 );
+
+	Rtt_WARN_SIM_PROXY_TYPE( L, 1, SpriteBatchObject );
+
+	if ( o )
+	{
+		U32 index = (U32) lua_tointeger( L, 2 ) - 1U; // Lua is 1-based
+		Color c = LuaLibDisplay::toColor( L, 3, o->IsByteColorRange() );
+		if ( ! o->SetTint( index, c ) )
+		{
+			CoronaLuaWarning( L, "spriteBatch:setTint() given invalid index (%d)", (int) lua_tointeger( L, 2 ) );
+		}
+	}
+
+	return 0;
+}
+
+// spriteBatch:setInstances( values [, startIndex] )
+//
+// values is an array of records of 6 numbers: frame, x, y, rotation, xScale, yScale
+int
+LuaSpriteBatchObjectProxyVTable::setInstances( lua_State *L )
+{
+	SpriteBatchObject *o = (SpriteBatchObject*)LuaProxy::GetProxyableObject( L, 1 );
+
+	Rtt_WARN_SIM_PROXY_TYPE( L, 1, SpriteBatchObject );
+
+	U32 numWritten = 0;
+
+	if ( o && lua_istable( L, 2 ) )
+	{
+		const U32 kValuesPerInstance = SpriteBatchObject::kValuesPerInstance;
+
+		U32 start = ( lua_isnumber( L, 3 ) ? (U32) lua_tointeger( L, 3 ) - 1U : 0U ); // Lua is 1-based
+		if ( start > o->GetNumInstances() )
+		{
+			CoronaLuaWarning( L, "spriteBatch:setInstances() given invalid start index (%d)", (int) lua_tointeger( L, 3 ) );
+			return 0;
+		}
+
+		U32 numValues = (U32) lua_objlen( L, 2 );
+		U32 count = numValues / kValuesPerInstance;
+		if ( count * kValuesPerInstance != numValues )
+		{
+			CoronaLuaWarning( L, "spriteBatch:setInstances() expects %d values per instance. Ignoring the last %d value(s)",
+				kValuesPerInstance, numValues - count * kValuesPerInstance );
+		}
+
+		// Copy the table through a fixed buffer, so no allocation is needed
+		const U32 kChunkSize = 64;
+		Real values[kChunkSize * kValuesPerInstance];
+		S32 maxFrame = o->GetSheet()->GetNumFrames() - 1;
+
+		for ( U32 i = 0; i < count; )
+		{
+			U32 n = Min( kChunkSize, count - i );
+			for ( U32 j = 0, jMax = n * kValuesPerInstance; j < jMax; j++ )
+			{
+				lua_rawgeti( L, 2, i * kValuesPerInstance + j + 1 ); // Lua is 1-based
+				values[j] = luaL_toreal( L, -1 );
+				lua_pop( L, 1 );
+			}
+
+			for ( U32 j = 0; j < n; j++ )
+			{
+				Real& frame = values[j * kValuesPerInstance];
+				frame = Clamp( frame - Rtt_REAL_1, Rtt_REAL_0, Rtt_IntToReal( maxFrame ) ); // Lua is 1-based
+			}
+
+			U32 written = o->SetInstances( start + i, values, n );
+			numWritten += written;
+			i += n;
+
+			if ( written < n )
+			{
+				CoronaLuaWarning( L, "spriteBatch:setInstances() stopped after %d instance(s). The batch is full (capacity is %d)",
+					numWritten, o->GetCapacity() );
+				break;
+			}
+		}
+	}
+
+	lua_pushinteger( L, numWritten );
+	return 1;
+}
+
+// spriteBatch:remove( index )
+int
+LuaSpriteBatchObjectProxyVTable::remove( lua_State *L )
+{
+	SpriteBatchObject *o = (SpriteBatchObject*)LuaProxy::GetProxyableObject( L, 1 );
+
+	Rtt_WARN_SIM_PROXY_TYPE( L, 1, SpriteBatchObject );
+
+	if ( o )
+	{
+		U32 index = (U32) lua_tointeger( L, 2 ) - 1U; // Lua is 1-based
+		if ( index < o->GetNumInstances() )
+		{
+			o->Remove( index );
+		}
+		else
+		{
+			CoronaLuaWarning( L, "spriteBatch:remove() given invalid index (%d)", (int) lua_tointeger( L, 2 ) );
+		}
+	}
+
+	return 0;
+}
+
+// spriteBatch:removeAll()
+int
+LuaSpriteBatchObjectProxyVTable::removeAll( lua_State *L )
+{
+	SpriteBatchObject *o = (SpriteBatchObject*)LuaProxy::GetProxyableObject( L, 1 );
+
+	Rtt_WARN_SIM_PROXY_TYPE( L, 1, SpriteBatchObject );
+
+	if ( o )
+	{
+		o->RemoveAll();
+	}
+
+	return 0;
+}
+
+int
+LuaSpriteBatchObjectProxyVTable::ValueForKey( lua_State *L, const MLuaProxyable& object, const char key[], bool overrideRestriction /* = false */ ) const
+{
+	if ( ! key ) { return 0; }
+
+	int result = 1;
+
+	static const char * keys[] =
+	{
+		// Read-only properties
+		"numInstances",		// 0
+		"capacity",			// 1
+
+		// Methods
+		"add",				// 2
+		"set",				// 3
+		"setTint",			// 4
+		"setInstances",		// 5
+		"remove",			// 6
+		"removeAll"			// 7
+	};
+	static const int numKeys = sizeof( keys ) / sizeof( const char * );
+	static StringHash sHash( *LuaContext::GetAllocator( L ), keys, numKeys, 8, 1, 7, __FILE__, __LINE__ );
+	StringHash *hash = &sHash;
+
+	int index = hash->Lookup( key );
+
+	const SpriteBatchObject& o = static_cast< const SpriteBatchObject& >( object );
+	Rtt_WARN_SIM_PROXY_TYPE( L, 1, SpriteBatchObject );
+
+	switch ( index )
+	{
+	case 0:
+		{
+			lua_pushinteger( L, o.GetNumInstances() );
+		}
+		break;
+	case 1:
+		{
+			lua_pushinteger( L, o.GetCapacity() );
+		}
+		break;
+	case 2:
+		{
+			Lua::PushCachedFunction( L, Self::add );
+		}
+		break;
+	case 3:
+		{
+			Lua::PushCachedFunction( L, Self::set );
+		}
+		break;
+	case 4:
+		{
+			Lua::PushCachedFunction( L, Self::setTint );
+		}
+		break;
+	case 5:
+		{
+			Lua::PushCachedFunction( L, Self::setInstances );
+		}
+		break;
+	case 6:
+		{
+			Lua::PushCachedFunction( L, Self::remove );
+		}
+		break;
+	case 7:
+		{
+			Lua::PushCachedFunction( L, Self::removeAll );
+		}
+		break;
+	default:
+		{
+			result = Super::ValueForKey( L, object, key, overrideRestriction );
+		}
+		break;
+	}
+
+	// If we retrieved the "_properties" key from the super, merge it with the local properties
+	if ( result == 1 && strcmp( key, "_properties" ) == 0 )
+	{
+		String batchProperties(LuaContext::GetRuntime( L )->Allocator());
+
+		DumpObjectProperties( L, object, keys, numKeys, batchProperties );
+
+		lua_pushfstring( L, "{ %s, %s }", batchProperties.GetString(), lua_tostring( L, -1 ) );
+		lua_remove( L, -2 ); // pop super properties
+		result = 1;
+	}
+
+	return result;
+}
+
+bool
+LuaSpriteBatchObjectProxyVTable::SetValueForKey( lua_State *L, MLuaProxyable& object, const char key[], int valueIndex ) const
+{
+	if ( ! key ) { return false; }
+
+	bool result = true;
+
+	if ( 0 == strcmp( key, "numInstances" ) || 0 == strcmp( key, "capacity" ) )
+	{
+		// Read-only properties
+		// no-op
+	}
+	else
+	{
+		result = Super::SetValueForKey( L, object, key, valueIndex );
+	}
+
+	return result;
+}
+
+const LuaProxyVTable&
+LuaSpriteBatchObjectProxyVTable::Parent() const
+{
+	return Super::Constant();
+}
+
+// ----------------------------------------------------------------------------
+
 } // namespace Rtt
 
 // ----------------------------------------------------------------------------
@@ -99,10 +99,10 @@ class LuaDisplayObjectProxyVTable : public LuaProxyVTable
 		virtual int ValueForKey( lua_State *L, const MLuaProxyable& object, const char key[], bool overrideRestriction = false ) const;
 		virtual bool SetValueForKey( lua_State *L, MLuaProxyable& object, const char key[], int valueIndex ) const;
 		
-		// Removes child at index from parent and pushes onto the stack. Pushes nil
-		// if index is invalid. If isOrphan is false, converts object into plain Lua table,
+		// Removes child from parent and pushes onto the stack. Pushes nil
+		// if child is NULL. If isOrphan is false, converts object into plain Lua table,
 		// freeing underlying DisplayObject. If true, no conversion takes place.
-		static void PushAndRemove( lua_State *L, GroupObject* parent, S32 index );
+		static void PushAndRemove( lua_State *L, GroupObject* parent, DisplayObject* child );
 };
 
 class LuaLineObjectProxyVTable : public LuaDisplayObjectProxyVTable
@@ -261,6 +261,7 @@ class LuaGroupObjectProxyVTable : public LuaDisplayObjectProxyVTable
 		static int insert( lua_State *L );
 		static int Remove( lua_State *L, GroupObject *parent );
 		static int Remove( lua_State *L );
+		static int sortChildren( lua_State *L );
 		static int PushChild( lua_State *L, const GroupObject& o );
 
 	protected:
@@ -442,6 +443,32 @@ class LuaSpriteObjectProxyVTable : public LuaShapeObjectProxyVTable
 		virtual bool SetValueForKey( lua_State *L, MLuaProxyable& object, const char key[], int valueIndex ) const;
 		virtual const LuaProxyVTable& Parent() const;
 };
+
+class LuaSpriteBatchObjectProxyVTable : public LuaDisplayObjectProxyVTable
+{
+	public:
+		typedef LuaSpriteBatchObjectProxyVTable Self;
+		typedef LuaDisplayObjectProxyVTable Super;
+
+	public:
+		static const Self& Constant();
+
+	public:
+		static int add( lua_State *L );
+		static int set( lua_State *L );
+		static int setTint( lua_State *L );
+		static int setInstances( lua_State *L );
+		static int remove( lua_State *L );
+		static int removeAll( lua_State *L );
+
+	protected:
+		LuaSpriteBatchObjectProxyVTable() {}
+
+	public:
+		virtual int ValueForKey( lua_State *L, const MLuaProxyable& object, const char key[], bool overrideRestriction = false ) const;
+		virtual bool SetValueForKey( lua_State *L, MLuaProxyable& object, const char key[], int valueIndex ) const;
+		virtual const LuaProxyVTable& Parent() const;
+};
 	
 // ----------------------------------------------------------------------------
 
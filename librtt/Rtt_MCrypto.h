@@ -41,10 +41,31 @@ class MCrypto
 			kMaxDigestSize = 64  // longest known SHA512
 		};
 
+		// Hashes a message supplied in pieces. Unless IsThreadSafe() is false,
+		// an instance may be used from any thread, but only by one thread at
+		// a time; otherwise only from the Lua thread.
+		class Digest
+		{
+			public:
+				virtual ~Digest() {}
+
+			public:
+				virtual void Update( const void *data, size_t length ) = 0;
+
+				// Writes GetDigestLength() bytes to md. No further updates are allowed.
+				virtual void Final( U8 *md ) = 0;
+
+				virtual bool IsThreadSafe() const { return true; }
+		};
+
 	public:
 		virtual size_t GetDigestLength( Algorithm algorithm ) const = 0;
 		virtual void CalculateDigest( Algorithm algorithm, const Rtt::Data<const char> & data, U8 *md ) const = 0;
 		virtual void CalculateHMAC( Algorithm algorithm, const Rtt::Data<const char> & key, const Rtt::Data<const char> & data, U8 *outMac ) const = 0;
+
+		// Returns a new incremental digest owned by the caller, or NULL if the
+		// platform does not support one for the algorithm
+		virtual Digest *NewDigest( Algorithm algorithm ) const { return NULL; }
 };
 
 // ----------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 #include "Rtt_Matrix.h"
 
 #include "Renderer/Rtt_Geometry_Renderer.h"
+#include "Renderer/Rtt_VertexKernels.h"
 
 #include <Box2D/Common/b2Math.h>
 
@@ -271,26 +272,20 @@ Matrix::Apply( Vertex2& v ) const
 void
 Matrix::Apply( Vertex2 vertices[], S32 numVertices ) const
 {
-	if ( ! IsIdentity() )
+	if ( ! IsIdentity() && numVertices > 0 )
 	{
-		const Real* Rtt_RESTRICT row0 = fRow0;
-		const Real* Rtt_RESTRICT row1 = fRow1;
-		for ( S32 i = 0; i < numVertices; i++ )
-		{
-			Private::MatrixApply( vertices[i], row0, row1 );
-		}
+		VertexKernels::TransformPoints( fRow0, fRow1, & vertices[0].x, sizeof( Vertex2 ), numVertices );
 	}
 }
 
 void
-Matrix::Apply( Geometry& geometry ) const
+Matrix::Apply( Geometry& geometry, U32 startIndex ) const
 {
-	Geometry::Vertex *data = geometry.GetVertexData();
-
-	for ( int i = 0, iMax = geometry.GetVerticesUsed(); i < iMax; i++ )
+	U32 numVertices = geometry.GetVerticesUsed();
+	if ( ! IsIdentity() && startIndex < numVertices )
 	{
-		Vertex2 *v = (Vertex2 *)(data + i);
-		Apply( * v );
+		Geometry::Vertex *data = geometry.GetVertexData() + startIndex;
+		VertexKernels::TransformPoints( fRow0, fRow1, & data->x, sizeof( Geometry::Vertex ), numVertices - startIndex );
 	}
 }
 
@@ -55,7 +55,7 @@ class Matrix
 		void Apply( Rect& r ) const;
 		void Apply( Vertex2& v ) const;
 		void Apply( Vertex2 vertices[], S32 numVertices ) const;
-		void Apply( Geometry& geometry ) const;
+		void Apply( Geometry& geometry, U32 startIndex = 0 ) const;
 		void ApplyTranslation( Vertex2& v ) const;
 		void ApplyScale( Real& value ) const;
 
@@ -16,11 +16,15 @@
 #include "Core/Rtt_String.h"
 #include "Display/Rtt_Display.h"
 #include "Display/Rtt_GroupObject.h"
+#include "Display/Rtt_Scene.h"
 #include "Display/Rtt_SpritePlayer.h"
 #include "Display/Rtt_StageObject.h"
+#include "Display/Rtt_TextureFactory.h"
 #include "Rtt_Archive.h"
 #include "Display/Rtt_BufferBitmap.h"
 #include "Rtt_Event.h"
+#include "Rtt_EventPool.h"
+#include "Rtt_GCScheduler.h"
 #include "Rtt_LuaContext.h"
 #include "Rtt_LuaFile.h"
 #include "Rtt_LuaProxy.h"
@@ -165,6 +169,8 @@ Runtime::Runtime(const MPlatform& platform, MCallback* viewCallback)
 	fVMContext(LuaContext::New(Allocator(), platform, this)),
 	fTimer(platform.CreateTimerWithCallback(viewCallback ? *viewCallback : *this)),
 	fScheduler(Rtt_NEW(&fAllocator, Scheduler(*this))),
+	fGCScheduler(Rtt_NEW(&fAllocator, GCScheduler(*this))),
+	fEventPool(Rtt_NEW(&fAllocator, EventPool(&fAllocator))),
 	fArchive(NULL),
 	fPhysicsWorld(Rtt_NEW(&fAllocator, PhysicsWorld(fAllocator))),
 	fBackend("glBackend"),
@@ -183,6 +189,7 @@ Runtime::Runtime(const MPlatform& platform, MCallback* viewCallback)
 	fDownloadablePluginsCount(0),
 	fDelegate(NULL),
 	fShowingTrialMessages(false),
+	fIsOverMemoryBudget(false),
 #ifdef Rtt_AUTHORING_SIMULATOR
 	m_fAsyncListener(nullptr),
 	m_fAsyncResultStr(nullptr),
@@ -232,6 +239,7 @@ Runtime::~Runtime()
 
 	Rtt_DELETE( fArchive );
 	Rtt_DELETE( fScheduler );
+	Rtt_DELETE( fGCScheduler );
 	fTimer->Stop();
 	Rtt_DELETE( fTimer );
 	
@@ -246,6 +254,9 @@ Runtime::~Runtime()
 	// display list from unnecessarily removing themselves from a bogus cache!
 	fVMContext = NULL;
 
+	// Pooled event tables lived in the Lua VM, so this goes with it
+	Rtt_DELETE( fEventPool );
+
 	// Lua VM no longer exists, so Corona app is technically no longer executing.
 	// This also stops TextureFactory::GetTextureMemoryUsed() from going negative,
 	// since it will count images loaded by shell.lua as being removed.
@@ -919,6 +930,46 @@ Runtime::ReadConfig( lua_State *L )
 		SetProperty( kUseExitOnErrorHandler, true );
 	}
 	lua_pop( L, 1 );
+
+	// Max ms per frame spent deleting orphaned display objects and stepping the Lua GC
+	lua_getfield( L, -1, "gcFrameBudget" );
+	if ( lua_isnumber( L, -1 ) )
+	{
+		fGCScheduler->SetFrameBudget( Rtt_FloatToReal( (float)lua_tonumber( L, -1 ) ) );
+	}
+	lua_pop( L, 1 );
+
+	lua_getfield( L, -1, "gcStepSize" );
+	if ( lua_isnumber( L, -1 ) )
+	{
+		fGCScheduler->SetStepSize( (S32)lua_tointeger( L, -1 ) );
+	}
+	lua_pop( L, 1 );
+
+	// Reuse the Lua tables of high-frequency events (enterFrame, collision, etc)
+	lua_getfield( L, -1, "reuseEventTables" );
+	if ( lua_isboolean( L, -1 ) )
+	{
+		fEventPool->SetEnabled( lua_toboolean( L, -1 ) );
+	}
+	lua_pop( L, 1 );
+
+	// Don't advance sprites that were culled on the last render
+	lua_getfield( L, -1, "skipOffscreenSprites" );
+	if ( lua_isboolean( L, -1 ) )
+	{
+		fDisplay->GetSpritePlayer().SetSkippingOffScreen( lua_toboolean( L, -1 ) );
+	}
+	lua_pop( L, 1 );
+
+	// Texture memory budget in MB; unreferenced resource images stay cached up to it
+	lua_getfield( L, -1, "memoryBudget" );
+	if ( lua_isnumber( L, -1 ) && lua_tonumber( L, -1 ) > 0 )
+	{
+		size_t numBytes = (size_t)( lua_tonumber( L, -1 ) * 1024 * 1024 );
+		fDisplay->GetTextureFactory().SetMemoryBudget( numBytes );
+	}
+	lua_pop( L, 1 );
 	
 #ifdef Rtt_USE_ALMIXER
 	lua_getfield( L, -1, "audioPlayFrequency" );
@@ -1683,7 +1734,9 @@ Runtime::DispatchEvent( const MEvent& e )
 {
 	RuntimeGuard guard( * this );
 
-	e.Dispatch( fVMContext->L(), * this );
+	lua_State *L = fVMContext->L();
+	EventPool::Scope scope( * fEventPool, L, e );
+	e.Dispatch( L, * this );
 }
 
 double
@@ -1719,6 +1772,46 @@ Runtime::Collect()
 
 	// Display objects
 	GroupObject::CollectUnreachables( vm.L(), GetDisplay().GetScene(), * GetDisplay().Orphanage() );
+	GetDisplay().GetScene().DestroyUnreachables();
+
+	// Unreferenced cached textures and free render targets
+	GetDisplay().GetTextureFactory().Trim( (size_t)-1 );
+}
+
+void
+Runtime::CheckMemoryBudget()
+{
+	TextureFactory& factory = fDisplay->GetTextureFactory();
+
+	size_t budget = factory.GetMemoryBudget();
+	if ( 0 == budget )
+	{
+		return;
+	}
+
+	size_t numBytesUsed = (size_t)factory.GetTextureMemoryUsed();
+	if ( numBytesUsed <= budget )
+	{
+		fIsOverMemoryBudget = false;
+		return;
+	}
+
+	// Let the app release what it can before anything is evicted. Warn once
+	// each time usage goes over budget, not every frame it stays there.
+	if ( ! fIsOverMemoryBudget )
+	{
+		fIsOverMemoryBudget = true;
+
+		MemoryWarningEvent e( numBytesUsed, budget );
+		DispatchEvent( e );
+
+		numBytesUsed = (size_t)factory.GetTextureMemoryUsed();
+	}
+
+	if ( numBytesUsed > budget )
+	{
+		factory.Trim( numBytesUsed - budget );
+	}
 }
 
 void
@@ -1966,6 +2059,11 @@ Runtime::operator()()
 		return;
 	}
 
+	fGCScheduler->BeginFrame();
+	fEventPool->BeginFrame();
+
+	CheckMemoryBudget();
+
 	const bool wasSuspended = IsSuspended();
 	fScheduler->Run();
 	const bool isSuspended = IsSuspended();
@@ -1990,6 +2088,7 @@ Runtime::operator()()
 	if ( ! IsProperty( kRenderAsync ) )
 	{
 		fDisplay->Render();
+		fGCScheduler->Step();
 	}
 	
 }
@@ -2004,6 +2103,7 @@ Runtime::Render()
 	}
 
 	fDisplay->Render();
+	fGCScheduler->Step();
 }
 
 void
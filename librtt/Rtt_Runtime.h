@@ -39,6 +39,8 @@ class MPlatform;
 class Archive;
 class Display;
 class DisplayObject;
+class EventPool;
+class GCScheduler;
 class LuaContext;
 class MRuntimeDelegate;
 class RenderingStream;
@@ -156,6 +158,8 @@ class Runtime : public MCallback,
 		Rtt_INLINE Display& GetDisplay() { return * fDisplay; }
 		Rtt_INLINE const Display& GetDisplay() const { return * fDisplay; }
 		Rtt_INLINE Scheduler& GetScheduler() const { return * fScheduler; }
+		Rtt_INLINE GCScheduler& GetGCScheduler() const { return * fGCScheduler; }
+		Rtt_INLINE EventPool& GetEventPool() const { return * fEventPool; }
 		Rtt_INLINE const MPlatform& Platform() const { return fPlatform; }
 
 		Rtt_INLINE bool IsVMContextValid() const { return NULL != fVMContext; }
@@ -192,6 +196,10 @@ class Runtime : public MCallback,
 		void ReadConfig( lua_State *L ); // call before fDisplay is instantiated
 		void PopAndClearConfig( lua_State *L );
 
+		// Warns the app, then trims cached resources, when over the memory
+		// budget set in config.lua
+		void CheckMemoryBudget();
+
 	protected:
 		void AddDownloadablePlugin(
 				lua_State *L, const char *pluginName, const char *publisherId,
@@ -372,6 +380,8 @@ class Runtime : public MCallback,
 		LuaContext* fVMContext;
 		PlatformTimer* fTimer;
 		Scheduler* fScheduler;
+		GCScheduler* fGCScheduler;
+		EventPool* fEventPool;
 		Archive* fArchive;
 		PhysicsWorld *fPhysicsWorld;
 		const char * fBackend;
@@ -392,6 +402,7 @@ class Runtime : public MCallback,
 		int fDownloadablePluginsCount;
 		const MRuntimeDelegate *fDelegate;
 		mutable bool fShowingTrialMessages;
+		bool fIsOverMemoryBudget;
 
 	private:
 		friend class LoadMainTask;
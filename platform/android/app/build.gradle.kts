@@ -486,7 +486,7 @@ android.applicationVariants.all {
             exec {
                 workingDir = file(compiledDir)
                 standardInput = StringInputStream(toArchive.joinToString("\n"))
-                commandLine(coronaBuilder, "car", "-f", "-", compiledLuaArchive)
+                commandLine(coronaBuilder, "car", "-z", "-f", "-", compiledLuaArchive)
             }
         }
     }
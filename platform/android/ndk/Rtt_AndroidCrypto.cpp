@@ -36,6 +36,59 @@ static const char kHmacSHA384AlgorithmParam[] = "HmacSHA384";
 static const char kHmacSHA512AlgorithmParam[] = "HmacSHA512";
 static const char kHmacSHA224AlgorithmParam[] = "HmacSHA224";
 
+// Wraps a Java MessageDigest. JNI calls are made on the calling thread's
+// environment, so the digest is only used on the Lua thread.
+class AndroidDigest : public MCrypto::Digest
+{
+	public:
+		enum
+		{
+			// Bounds the size of each Java byte array
+			kMaxUpdateSize = 1024 * 1024
+		};
+
+	public:
+		AndroidDigest( NativeToJavaBridge *ntjb, jobject digest )
+		:	fNativeToJavaBridge( ntjb ),
+			fDigest( digest )
+		{
+		}
+
+		virtual ~AndroidDigest()
+		{
+			fNativeToJavaBridge->CryptoDeleteDigest( fDigest );
+		}
+
+	public:
+		virtual void Update( const void *data, size_t length )
+		{
+			const char *bytes = (const char *)data;
+			while ( length > 0 )
+			{
+				size_t n = ( length > (size_t)kMaxUpdateSize ? (size_t)kMaxUpdateSize : length );
+				fNativeToJavaBridge->CryptoDigestUpdate( fDigest, bytes, (int)n );
+				bytes += n;
+				length -= n;
+			}
+		}
+
+		virtual void Final( U8 *md )
+		{
+			fNativeToJavaBridge->CryptoDigestFinal( fDigest, md );
+		}
+
+		virtual bool IsThreadSafe() const
+		{
+			return false;
+		}
+
+	private:
+		NativeToJavaBridge *fNativeToJavaBridge;
+		jobject fDigest;
+};
+
+// ----------------------------------------------------------------------------
+
 AndroidCrypto::AndroidCrypto( NativeToJavaBridge *ntjb)
 : fNativeToJavaBridge(ntjb)
 {
@@ -154,6 +207,44 @@ AndroidCrypto::CalculateHMAC( Algorithm algorithm, const Rtt::Data<const char> &
 	fNativeToJavaBridge->CryptoCalculateHMAC( algorithmParam, key, data, digest );
 }
 
+MCrypto::Digest *
+AndroidCrypto::NewDigest( Algorithm algorithm ) const
+{
+	const char * algorithmParam = NULL;
+
+	switch ( algorithm )
+	{
+	case MCrypto::kMD4Algorithm:
+		algorithmParam = kMD4AlgorithmParam;
+		break;
+	case MCrypto::kMD5Algorithm:
+		algorithmParam = kMD5AlgorithmParam;
+		break;
+	case MCrypto::kSHA1Algorithm:
+		algorithmParam = kSHA1AlgorithmParam;
+		break;
+	case MCrypto::kSHA256Algorithm:
+		algorithmParam = kSHA256lgorithmParam;
+		break;
+	case MCrypto::kSHA384Algorithm:
+		algorithmParam = kSHA384AlgorithmParam;
+		break;
+	case MCrypto::kSHA512Algorithm:
+		algorithmParam = kSHA512AlgorithmParam;
+		break;
+	case MCrypto::kSHA224Algorithm:
+		algorithmParam = kSHA224AlgorithmParam;
+		break;
+	default:
+		Rtt_ASSERT_NOT_REACHED();
+		break;
+	}
+
+	jobject digest = ( algorithmParam ? fNativeToJavaBridge->CryptoNewDigest( algorithmParam ) : NULL );
+
+	return digest ? new AndroidDigest( fNativeToJavaBridge, digest ) : NULL;
+}
+
 // ----------------------------------------------------------------------------
 
 } // namespace Rtt
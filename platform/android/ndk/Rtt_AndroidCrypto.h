@@ -31,6 +31,7 @@ class AndroidCrypto : public MCrypto
 		virtual size_t GetDigestLength( Algorithm algorithm ) const;
 		virtual void CalculateDigest( Algorithm algorithm, const Rtt::Data<const char> & data, U8 *md ) const;
 		virtual void CalculateHMAC( Algorithm algorithm, const Rtt::Data<const char> & key, const Rtt::Data<const char> & data, U8 *outMac ) const;
+		virtual Digest *NewDigest( Algorithm algorithm ) const;
 
 	private:
 		NativeToJavaBridge *fNativeToJavaBridge;
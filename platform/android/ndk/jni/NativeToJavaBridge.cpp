@@ -3807,6 +3807,90 @@ NativeToJavaBridge::CryptoCalculateHMAC( const char * algorithm, const Rtt::Data
 	}
 }
 
+jobject
+NativeToJavaBridge::CryptoNewDigest( const char * algorithm )
+{
+	NativeTrace trace( "NativeToJavaBridge::CryptoNewDigest" );
+	jobject result = NULL;
+	jclassInstance bridge( GetJNIEnv(), kNativeToJavaBridge );
+
+	if ( bridge.isValid() )
+	{
+		jmethodID mid = bridge.getEnv()->GetStaticMethodID(
+							bridge.getClass(), "callCryptoNewDigest", "(Ljava/lang/String;)Ljava/lang/Object;" );
+		if ( mid != NULL )
+		{
+			jstringParam algorithmJ( bridge.getEnv(), algorithm );
+			jobject jo = bridge.getEnv()->CallStaticObjectMethod( bridge.getClass(), mid, algorithmJ.getValue() );
+			HandleJavaException();
+			if (jo)
+			{
+				// Outlives this call, so it needs a global reference
+				result = bridge.getEnv()->NewGlobalRef( jo );
+				bridge.getEnv()->DeleteLocalRef( jo );
+			}
+		}
+	}
+
+	return result;
+}
+
+void
+NativeToJavaBridge::CryptoDigestUpdate( jobject digest, const char * data, int length )
+{
+	NativeTrace trace( "NativeToJavaBridge::CryptoDigestUpdate" );
+	jclassInstance bridge( GetJNIEnv(), kNativeToJavaBridge );
+
+	if ( bridge.isValid() )
+	{
+		jmethodID mid = bridge.getEnv()->GetStaticMethodID(
+							bridge.getClass(), "callCryptoDigestUpdate", "(Ljava/lang/Object;[B)V" );
+		if ( mid != NULL )
+		{
+			jbyteArrayParam dataJ( bridge.getEnv(), length );
+			dataJ.setArray( data, 0, length );
+
+			bridge.getEnv()->CallStaticVoidMethod( bridge.getClass(), mid, digest, dataJ.getValue() );
+			HandleJavaException();
+		}
+	}
+}
+
+void
+NativeToJavaBridge::CryptoDigestFinal( jobject digest, U8 * md )
+{
+	NativeTrace trace( "NativeToJavaBridge::CryptoDigestFinal" );
+	jclassInstance bridge( GetJNIEnv(), kNativeToJavaBridge );
+
+	if ( bridge.isValid() )
+	{
+		jmethodID mid = bridge.getEnv()->GetStaticMethodID(
+							bridge.getClass(), "callCryptoDigestFinal", "(Ljava/lang/Object;)[B" );
+		if ( mid != NULL )
+		{
+			jobject jo = bridge.getEnv()->CallStaticObjectMethod( bridge.getClass(), mid, digest );
+			HandleJavaException();
+			if (jo)
+			{
+				jbyteArrayResult jbytes( bridge.getEnv(), (jbyteArray) jo );
+				memcpy( md, (const char *) jbytes.getValues(), jbytes.getLength() );
+				jbytes.release();
+				bridge.getEnv()->DeleteLocalRef(jo);
+			}
+		}
+	}
+}
+
+void
+NativeToJavaBridge::CryptoDeleteDigest( jobject digest )
+{
+	JNIEnv *env = GetJNIEnv();
+	if ( env && digest )
+	{
+		env->DeleteGlobalRef( digest );
+	}
+}
+
 bool
 NativeToJavaBridge::WebPopupShouldLoadUrl( int id, const char * url )
 {
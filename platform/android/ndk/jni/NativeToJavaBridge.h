@@ -265,6 +265,13 @@ class NativeToJavaBridge
 		void CryptoCalculateDigest( const char * algorithm, const Rtt::Data<const char> & data, U8 * digest );
 		void CryptoCalculateHMAC( const char * algorithm, const Rtt::Data<const char> & key, const Rtt::Data<const char> & data, 
 			U8 * digest );
+
+		// Incremental digests. The digest is a global reference to a Java
+		// MessageDigest, released by CryptoDeleteDigest().
+		jobject CryptoNewDigest( const char * algorithm );
+		void CryptoDigestUpdate( jobject digest, const char * data, int length );
+		void CryptoDigestFinal( jobject digest, U8 * md );
+		void CryptoDeleteDigest( jobject digest );
 	
 		void ExternalizeResource( const char * assetName, Rtt::String * result );
 
@@ -58,6 +58,17 @@ public class Crypto {
 		return result;
 	}
 
+	public static MessageDigest NewDigest( String algorithm ) {
+		MessageDigest result = null;
+		try {
+			result = MessageDigest.getInstance( algorithm );
+		}
+		catch (Exception ex) {
+			ex.printStackTrace();
+		}
+		return result;
+	}
+
 	public static byte[] CalculateHMAC( String algorithm, byte[] key, byte[] data ) {
 		byte[] result = null;
 		try {
@@ -2769,6 +2769,18 @@ public class NativeToJavaBridge {
 		return Crypto.CalculateHMAC(algorithm, key, data);
 	}
 
+	protected static Object callCryptoNewDigest( String algorithm ) {
+		return Crypto.NewDigest(algorithm);
+	}
+
+	protected static void callCryptoDigestUpdate( Object digest, byte[] data ) {
+		((java.security.MessageDigest)digest).update(data);
+	}
+
+	protected static byte[] callCryptoDigestFinal( Object digest ) {
+		return ((java.security.MessageDigest)digest).digest();
+	}
+
 	protected static void callRequestNearestAddressFromCoordinates(CoronaRuntime runtime, long luaStateMemoryAddress) {
 		// Throw an exception if this application does not have the following permission.
 		android.content.Context context = CoronaEnvironment.getApplicationContext();
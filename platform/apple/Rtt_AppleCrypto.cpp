@@ -23,6 +23,132 @@ template class Rtt::Data<const char>;
 
 // ----------------------------------------------------------------------------
 
+class AppleDigest : public MCrypto::Digest
+{
+	public:
+		AppleDigest( MCrypto::Algorithm algorithm );
+
+	public:
+		virtual void Update( const void *data, size_t length );
+		virtual void Final( U8 *md );
+
+	private:
+		MCrypto::Algorithm fAlgorithm;
+		union
+		{
+			CC_MD4_CTX md4;
+			CC_MD5_CTX md5;
+			CC_SHA1_CTX sha1;
+			CC_SHA256_CTX sha256; // also SHA-224
+			CC_SHA512_CTX sha512; // also SHA-384
+		}
+		fContext;
+};
+
+AppleDigest::AppleDigest( MCrypto::Algorithm algorithm )
+:	fAlgorithm( algorithm )
+{
+	switch ( algorithm )
+	{
+		case MCrypto::kMD4Algorithm:
+			CC_MD4_Init( & fContext.md4 );
+			break;
+		case MCrypto::kMD5Algorithm:
+			CC_MD5_Init( & fContext.md5 );
+			break;
+		case MCrypto::kSHA1Algorithm:
+			CC_SHA1_Init( & fContext.sha1 );
+			break;
+		case MCrypto::kSHA224Algorithm:
+			CC_SHA224_Init( & fContext.sha256 );
+			break;
+		case MCrypto::kSHA256Algorithm:
+			CC_SHA256_Init( & fContext.sha256 );
+			break;
+		case MCrypto::kSHA384Algorithm:
+			CC_SHA384_Init( & fContext.sha512 );
+			break;
+		case MCrypto::kSHA512Algorithm:
+			CC_SHA512_Init( & fContext.sha512 );
+			break;
+		default:
+			Rtt_ASSERT_NOT_REACHED();
+			break;
+	}
+}
+
+void
+AppleDigest::Update( const void *data, size_t length )
+{
+	// The CC_*_Update() functions take a 32-bit length
+	const U8 *bytes = (const U8 *)data;
+	while ( length > 0 )
+	{
+		CC_LONG n = (CC_LONG)( length > 0x40000000 ? 0x40000000 : length );
+		switch ( fAlgorithm )
+		{
+			case MCrypto::kMD4Algorithm:
+				CC_MD4_Update( & fContext.md4, bytes, n );
+				break;
+			case MCrypto::kMD5Algorithm:
+				CC_MD5_Update( & fContext.md5, bytes, n );
+				break;
+			case MCrypto::kSHA1Algorithm:
+				CC_SHA1_Update( & fContext.sha1, bytes, n );
+				break;
+			case MCrypto::kSHA224Algorithm:
+				CC_SHA224_Update( & fContext.sha256, bytes, n );
+				break;
+			case MCrypto::kSHA256Algorithm:
+				CC_SHA256_Update( & fContext.sha256, bytes, n );
+				break;
+			case MCrypto::kSHA384Algorithm:
+				CC_SHA384_Update( & fContext.sha512, bytes, n );
+				break;
+			case MCrypto::kSHA512Algorithm:
+				CC_SHA512_Update( & fContext.sha512, bytes, n );
+				break;
+			default:
+				break;
+		}
+		bytes += n;
+		length -= n;
+	}
+}
+
+void
+AppleDigest::Final( U8 *md )
+{
+	switch ( fAlgorithm )
+	{
+		case MCrypto::kMD4Algorithm:
+			CC_MD4_Final( md, & fContext.md4 );
+			break;
+		case MCrypto::kMD5Algorithm:
+			CC_MD5_Final( md, & fContext.md5 );
+			break;
+		case MCrypto::kSHA1Algorithm:
+			CC_SHA1_Final( md, & fContext.sha1 );
+			break;
+		case MCrypto::kSHA224Algorithm:
+			CC_SHA224_Final( md, & fContext.sha256 );
+			break;
+		case MCrypto::kSHA256Algorithm:
+			CC_SHA256_Final( md, & fContext.sha256 );
+			break;
+		case MCrypto::kSHA384Algorithm:
+			CC_SHA384_Final( md, & fContext.sha512 );
+			break;
+		case MCrypto::kSHA512Algorithm:
+			CC_SHA512_Final( md, & fContext.sha512 );
+			break;
+		default:
+			break;
+	}
+}
+
+// ----------------------------------------------------------------------------
+
 size_t
 AppleCrypto::GetDigestLength( Algorithm algorithm ) const
 {
@@ -131,6 +257,12 @@ exit_gracefully:
 	(void)0; // Need a no-op after the label; otherwise compiler error occurs.
 }
 
+MCrypto::Digest *
+AppleCrypto::NewDigest( Algorithm algorithm ) const
+{
+	return ( algorithm >= 0 && algorithm < kNumAlgorithms ) ? new AppleDigest( algorithm ) : NULL;
+}
+
 // ----------------------------------------------------------------------------
 
 } // namespace Rtt
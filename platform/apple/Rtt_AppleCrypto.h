@@ -25,6 +25,7 @@ class AppleCrypto : public MCrypto
 		virtual size_t GetDigestLength( Algorithm algorithm ) const;
 		virtual void CalculateDigest( Algorithm algorithm, const Rtt::Data<const char> & data, U8 *md ) const;
 		virtual void CalculateHMAC( Algorithm algorithm, const Rtt::Data<const char> & key, const Rtt::Data<const char> & data, U8 *outMac ) const;
+		virtual Digest *NewDigest( Algorithm algorithm ) const;
 };
 
 // ----------------------------------------------------------------------------
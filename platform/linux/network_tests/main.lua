@@ -0,0 +1,167 @@
+------------------------------------------------------------------------------
+--
+-- This file is part of the Corona game engine.
+-- For overview and more information on licensing please refer to README.md
+-- Home page: https://github.com/coronalabs/corona
+-- Contact: support@coronalabs.com
+--
+------------------------------------------------------------------------------
+
+-- Tests for the Linux network library against a local HTTP stand-in.
+-- Start the stand-in first, then run this project in the simulator:
+--   python3 server.py &
+--   Solar2DSimulator main.lua
+-- Prints PASS/FAIL per test and exits with the number of failures.
+
+local kBaseURL = "http://127.0.0.1:8765"
+
+local tests = {}
+local failures = 0
+
+local function readFile( filename )
+	local path = system.pathForFile( filename, system.TemporaryDirectory )
+	local file = io.open( path, "rb" )
+	if not file then
+		return nil
+	end
+	local contents = file:read( "*a" )
+	file:close()
+	return contents
+end
+
+local function removeFile( filename )
+	os.remove( system.pathForFile( filename, system.TemporaryDirectory ) )
+end
+
+local function isEnded( event )
+	return "ended" == event.phase or nil == event.phase
+end
+
+tests[#tests + 1] = { "get bytes", function( done )
+	network.request( kBaseURL .. "/hello", "GET", function( event )
+		if isEnded( event ) then
+			done( not event.isError and 200 == event.status and "hello world" == event.response, event.response )
+		end
+	end )
+end }
+
+tests[#tests + 1] = { "post echoes body", function( done )
+	network.request( kBaseURL .. "/echo", "POST", function( event )
+		if isEnded( event ) then
+			done( 200 == event.status and "ping" == event.response, event.response )
+		end
+	end, { body = "ping" } )
+end }
+
+tests[#tests + 1] = { "redirect is followed", function( done )
+	network.request( kBaseURL .. "/redirect", "GET", function( event )
+		if isEnded( event ) then
+			done( 200 == event.status and "hello world" == event.response, tostring( event.status ) )
+		end
+	end )
+end }
+
+tests[#tests + 1] = { "download to file", function( done )
+	removeFile( "hello.txt" )
+	network.download( kBaseURL .. "/hello", "GET", function( event )
+		if isEnded( event ) then
+			local contents = readFile( "hello.txt" )
+			done( 200 == event.status and "table" == type( event.response ) and "hello world" == contents, contents )
+		end
+	end, {}, "hello.txt", system.TemporaryDirectory )
+end }
+
+tests[#tests + 1] = { "download empty body creates file", function( done )
+	removeFile( "empty.txt" )
+	network.download( kBaseURL .. "/empty", "GET", function( event )
+		if isEnded( event ) then
+			local contents = readFile( "empty.txt" )
+			done( 200 == event.status and "" == contents, tostring( contents ) )
+		end
+	end, {}, "empty.txt", system.TemporaryDirectory )
+end }
+
+tests[#tests + 1] = { "failed download leaves no file", function( done )
+	removeFile( "missing.txt" )
+	network.download( kBaseURL .. "/missing", "GET", function( event )
+		if isEnded( event ) then
+			local contents = readFile( "missing.txt" )
+			local partial = readFile( "missing.txt.download" )
+			done( 404 == event.status and nil == contents and nil == partial, tostring( event.status ) )
+		end
+	end, {}, "missing.txt", system.TemporaryDirectory )
+end }
+
+tests[#tests + 1] = { "download progress", function( done )
+	local numProgress = 0
+	network.request( kBaseURL .. "/large", "GET", function( event )
+		if "progress" == event.phase then
+			numProgress = numProgress + 1
+		elseif isEnded( event ) then
+			done( 200 == event.status and numProgress > 1 and 1024 * 1024 == event.bytesTransferred,
+				numProgress .. " progress events, " .. tostring( event.bytesTransferred ) .. " bytes" )
+		end
+	end, { progress = "download" } )
+end }
+
+tests[#tests + 1] = { "concurrent requests", function( done )
+	local kCount = 8
+	local numDone = 0
+	local isOk = true
+	for i = 1, kCount do
+		network.request( kBaseURL .. "/hello", "GET", function( event )
+			if isEnded( event ) then
+				isOk = isOk and 200 == event.status and "hello world" == event.response
+				numDone = numDone + 1
+				if kCount == numDone then
+					done( isOk )
+				end
+			end
+		end )
+	end
+end }
+
+tests[#tests + 1] = { "cancel", function( done )
+	local isCalled = false
+	local id = network.request( kBaseURL .. "/slow", "GET", function( event )
+		if isEnded( event ) then
+			isCalled = true
+		end
+	end )
+	timer.performWithDelay( 100, function()
+		network.cancel( id )
+		-- The stand-in answers after 5 s; a cancelled request never reports
+		timer.performWithDelay( 6000, function()
+			done( not isCalled )
+		end )
+	end )
+end }
+
+local function run( index )
+	local test = tests[index]
+	if not test then
+		print( string.format( "%d of %d tests failed", failures, #tests ) )
+		os.exit( failures )
+	end
+
+	local isFinished = false
+	local function done( isOk, detail )
+		if isFinished then
+			return
+		end
+		isFinished = true
+		if isOk then
+			print( "PASS " .. test[1] )
+		else
+			failures = failures + 1
+			print( "FAIL " .. test[1] .. ( detail and ( ": " .. tostring( detail ) ) or "" ) )
+		end
+		timer.performWithDelay( 1, function() run( index + 1 ) end )
+	end
+
+	-- Guards against a listener that is never called
+	timer.performWithDelay( 15000, function() done( false, "timed out" ) end )
+	test[2]( done )
+end
+
+run( 1 )
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+#
+# This file is part of the Corona game engine.
+# For overview and more information on licensing please refer to README.md
+# Home page: https://github.com/coronalabs/corona
+# Contact: support@coronalabs.com
+#
+#-----------------------------------------------------------------------------
+
+# Local HTTP stand-in for the network tests in main.lua.
+# Usage: python3 server.py [port]   (default port 8765)
+
+import sys
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+kLargeSize = 1024 * 1024
+
+class Handler(BaseHTTPRequestHandler):
+	protocol_version = "HTTP/1.1"
+
+	def reply(self, status, body, headers=None):
+		self.send_response(status)
+		self.send_header("Content-Type", "text/plain")
+		self.send_header("Content-Length", str(len(body)))
+		for key, value in (headers or {}).items():
+			self.send_header(key, value)
+		self.end_headers()
+		self.wfile.write(body)
+
+	def do_GET(self):
+		if self.path == "/hello":
+			self.reply(200, b"hello world")
+		elif self.path == "/empty":
+			self.reply(200, b"")
+		elif self.path == "/missing":
+			self.reply(404, b"not found")
+		elif self.path == "/redirect":
+			self.reply(302, b"moved", { "Location": "/hello" })
+		elif self.path == "/large":
+			# Sent in pieces so the client sees several progress events
+			self.send_response(200)
+			self.send_header("Content-Type", "application/octet-stream")
+			self.send_header("Content-Length", str(kLargeSize))
+			self.end_headers()
+			chunk = b"x" * (64 * 1024)
+			for i in range(kLargeSize // len(chunk)):
+				self.wfile.write(chunk)
+				self.wfile.flush()
+				time.sleep(0.01)
+		elif self.path == "/slow":
+			time.sleep(5)
+			self.reply(200, b"too late")
+		else:
+			self.reply(404, b"unknown")
+
+	def do_POST(self):
+		length = int(self.headers.get("Content-Length", 0))
+		body = self.rfile.read(length)
+		if self.path == "/echo":
+			self.reply(200, body)
+		else:
+			self.reply(404, b"unknown")
+
+	def log_message(self, format, *args):
+		pass
+
+if __name__ == "__main__":
+	port = int(sys.argv[1]) if len(sys.argv) > 1 else 8765
+	ThreadingHTTPServer(("127.0.0.1", port), Handler).serve_forever()
@@ -36,12 +36,273 @@ int NetworkCompletionEvent::Push( lua_State *L ) const
 	return 1;
 }
 
-// curl callback
+// curl_multi_poll() and curl_multi_wakeup() need curl 7.68; older versions
+// fall back to curl_multi_wait() and pick up new requests after a short wait
+#if LIBCURL_VERSION_NUM >= 0x074400
+	#define NETWORK_HAS_MULTI_POLL 1
+#endif
+
+static const int kPollTimeoutMs = 1000;
+static const int kWaitTimeoutMs = 50;
+
+// curl callback, called on the I/O thread
 static size_t curlWriteData(void *buffer, size_t size, size_t nmemb, void *arg)
 {
-	membuf* response = (membuf*) arg;
-	response->append(buffer, size * nmemb);
-	return size * nmemb;
+	NetworkTransfer* transfer = (NetworkTransfer*) arg;
+	size_t nbytes = size * nmemb;
+
+	// Redirect bodies are skipped by curl, so the first write belongs to the
+	// final response. Only successful downloads go to the response file.
+	if (!transfer->fHasResponseBody)
+	{
+		transfer->fHasResponseBody = true;
+
+		long status = 0;
+		curl_easy_getinfo(transfer->fCURL, CURLINFO_RESPONSE_CODE, &status);
+		if (status == 200 && !transfer->fDownloadPath.empty())
+		{
+			UTF8String tempPath = transfer->fDownloadPath + ".download";
+			transfer->fDownloadFile = fopen(tempPath.c_str(), "wb");
+			if (transfer->fDownloadFile == NULL)
+			{
+				return 0; // aborts the transfer with CURLE_WRITE_ERROR
+			}
+		}
+	}
+
+	if (transfer->fDownloadFile != NULL)
+	{
+		nbytes = fwrite(buffer, 1, nbytes, transfer->fDownloadFile);
+	}
+	else
+	{
+		transfer->fResponse.append(buffer, nbytes);
+	}
+
+	if (transfer->fProgressDirection != Upload)
+	{
+		transfer->fBytesTransferred += nbytes;
+	}
+	return nbytes;
+}
+
+// curl callback, called on the I/O thread
+static int curlProgress(void *arg, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow)
+{
+	NetworkTransfer* transfer = (NetworkTransfer*) arg;
+	if (transfer->fProgressDirection == Upload)
+	{
+		transfer->fBytesEstimated = ultotal;
+		transfer->fBytesTransferred = ulnow;
+	}
+	else if (dltotal > 0)
+	{
+		transfer->fBytesEstimated = dltotal;
+	}
+
+	// Non-zero aborts a cancelled transfer without waiting for the next poll
+	return transfer->fIsCancelled ? 1 : 0;
+}
+
+NetworkTransfer::NetworkTransfer(ProgressDirection progressDirection)
+	: fCURL(NULL)
+	, fRequestHeaders(NULL)
+	, fUploadFile(NULL)
+	, fProgressDirection(progressDirection)
+	, fDownloadFile(NULL)
+	, fHasResponseBody(false)
+	, fStatus(0)
+	, fResult(CURLE_OK)
+	, fBytesTransferred(0)
+	, fBytesEstimated(0)
+	, fIsCancelled(false)
+	, fIsDone(false)
+{
+}
+
+NetworkTransfer::~NetworkTransfer()
+{
+	close(false);
+}
+
+void NetworkTransfer::close(bool keepDownload)
+{
+	if (fCURL != NULL)
+	{
+		curl_easy_cleanup(fCURL);
+		fCURL = NULL;
+	}
+
+	if (fRequestHeaders != NULL)
+	{
+		curl_slist_free_all(fRequestHeaders);
+		fRequestHeaders = NULL;
+	}
+
+	if (fUploadFile != NULL)
+	{
+		fclose(fUploadFile);
+		fUploadFile = NULL;
+	}
+
+	if (fDownloadFile != NULL)
+	{
+		UTF8String tempPath = fDownloadPath + ".download";
+		bool isWritten = (fclose(fDownloadFile) == 0);
+		fDownloadFile = NULL;
+
+		if (!(keepDownload && isWritten && rename(tempPath.c_str(), fDownloadPath.c_str()) == 0))
+		{
+			remove(tempPath.c_str());
+		}
+	}
+}
+
+NetworkIOThread::NetworkIOThread()
+	: fMultiCURL(curl_multi_init())
+	, fIsQuitting(false)
+{
+	// Requests to the same host share connections, and with HTTP/2 a single one
+	curl_multi_setopt(fMultiCURL, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+	fThread = std::thread(&NetworkIOThread::run, this);
+}
+
+NetworkIOThread::~NetworkIOThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fIsQuitting = true;
+	}
+	wakeup();
+
+	if (fThread.joinable())
+	{
+		fThread.join();
+	}
+
+	curl_multi_cleanup(fMultiCURL);
+}
+
+void NetworkIOThread::submit(const std::shared_ptr<NetworkTransfer>& transfer)
+{
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fPending.push_back(transfer);
+	}
+	wakeup();
+}
+
+void NetworkIOThread::cancel(const std::shared_ptr<NetworkTransfer>& transfer)
+{
+	transfer->fIsCancelled = true;
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fCancelled.push_back(transfer);
+	}
+	wakeup();
+}
+
+void NetworkIOThread::wakeup()
+{
+#ifdef NETWORK_HAS_MULTI_POLL
+	curl_multi_wakeup(fMultiCURL);
+#endif
+}
+
+void NetworkIOThread::finish(const std::shared_ptr<NetworkTransfer>& transfer, CURLcode result)
+{
+	curl_multi_remove_handle(fMultiCURL, transfer->fCURL);
+	curl_easy_getinfo(transfer->fCURL, CURLINFO_RESPONSE_CODE, &transfer->fStatus);
+	transfer->fResult = result;
+
+	bool isSuccess = (result == CURLE_OK && transfer->fStatus == 200 && !transfer->fIsCancelled);
+
+	// An empty body never reaches curlWriteData(), but the response file is still reported
+	if (isSuccess && !transfer->fHasResponseBody && !transfer->fDownloadPath.empty())
+	{
+		FILE *file = fopen(transfer->fDownloadPath.c_str(), "wb");
+		if (file == NULL || fclose(file) != 0)
+		{
+			transfer->fResult = CURLE_WRITE_ERROR;
+			isSuccess = false;
+		}
+	}
+	transfer->close(isSuccess);
+
+	// Hands the transfer back to the Lua thread
+	transfer->fIsDone.store(true, std::memory_order_release);
+}
+
+void NetworkIOThread::run()
+{
+	std::vector<std::shared_ptr<NetworkTransfer> > pending;
+	std::vector<std::shared_ptr<NetworkTransfer> > cancelled;
+
+	for (;;)
+	{
+		{
+			std::lock_guard<std::mutex> lock(fMutex);
+			if (fIsQuitting)
+			{
+				break;
+			}
+			pending.swap(fPending);
+			cancelled.swap(fCancelled);
+		}
+
+		for (size_t i = 0; i < pending.size(); i++)
+		{
+			const std::shared_ptr<NetworkTransfer>& transfer = pending[i];
+			curl_multi_add_handle(fMultiCURL, transfer->fCURL);
+			fActive[transfer->fCURL] = transfer;
+		}
+		pending.clear();
+
+		for (size_t i = 0; i < cancelled.size(); i++)
+		{
+			auto it = fActive.find(cancelled[i]->fCURL);
+			if (it != fActive.end() && it->second == cancelled[i])
+			{
+				fActive.erase(it);
+				finish(cancelled[i], CURLE_ABORTED_BY_CALLBACK);
+			}
+		}
+		cancelled.clear();
+
+		int stillRunning = 0;
+		curl_multi_perform(fMultiCURL, &stillRunning);
+
+		int msgsInQueue = 0;
+		while (CURLMsg* msg = curl_multi_info_read(fMultiCURL, &msgsInQueue))
+		{
+			if (msg->msg == CURLMSG_DONE)
+			{
+				CURLcode result = msg->data.result;
+				auto it = fActive.find(msg->easy_handle);
+				if (it != fActive.end())
+				{
+					std::shared_ptr<NetworkTransfer> transfer = it->second;
+					fActive.erase(it);
+					finish(transfer, result);
+				}
+			}
+		}
+
+#ifdef NETWORK_HAS_MULTI_POLL
+		curl_multi_poll(fMultiCURL, NULL, 0, kPollTimeoutMs, NULL);
+#else
+		curl_multi_wait(fMultiCURL, NULL, 0, kWaitTimeoutMs, NULL);
+#endif
+	}
+
+	// Anything still in flight is dropped along with the library
+	for (auto it = fActive.begin(); it != fActive.end(); ++it)
+	{
+		it->second->fIsCancelled = true;
+		finish(it->second, CURLE_ABORTED_BY_CALLBACK);
+	}
+	fActive.clear();
 }
 
 void NetworkNotifierTask::operator()( Scheduler & sender )
@@ -49,57 +310,57 @@ void NetworkNotifierTask::operator()( Scheduler & sender )
 	// sanity check
 	if (fRequestParams != NULL && fRequestState != NULL)
 	{
-		int still_running = 0;
-		long status = 0;
-		CURLM* cm = fRequestParams->getMultiCURL();
-		CURL* curl = fRequestParams->getCURL();
-		if (cm && curl) // not cancelled ?
+		NetworkTransfer* transfer = fTransfer.get();
+		if (!transfer->isDone())
 		{
-			curl_multi_perform(cm, &still_running);
-			if (still_running > 0)
+			// At most one progress event per frame, and only when bytes moved
+			long long bytesTransferred = transfer->fBytesTransferred;
+			if (fRequestParams->getProgressDirection() != None && !transfer->fIsCancelled && bytesTransferred != fLastBytesTransferred)
 			{
-				return;
+				fLastBytesTransferred = bytesTransferred;
+				fRequestState->setPhase("progress");
+				fRequestState->setBytesEstimated(transfer->fBytesEstimated);
+				fRequestState->setBytesTransferred(bytesTransferred);
+				fRequestParams->getLuaCallback()->callWithNetworkRequestState(fRequestState);
+				fRequestState->setPhase("ended");
 			}
+			return;
+		}
 
-
-			CURLcode rc = curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+		if (!transfer->fIsCancelled)
+		{
+			long status = transfer->fStatus;
 
 			// It is worth noting that browsers report a status of 0 in case of XMLHttpRequest errors too.
 			if (status != 200)
 			{
-				UTF8String *message = new  UTF8String(curl_easy_strerror(rc));
+				UTF8String *message = new  UTF8String(curl_easy_strerror(transfer->fResult));
 				fRequestState->setError(message);
 			}
 
 			// Set responseHeaders
-			fRequestState->setResponseHeaders(fRequestParams->fResponseHeaders.c_str());
+			fRequestState->setResponseHeaders(transfer->fResponseHeaders.c_str());
 
+			long long bytesTransferred = transfer->fBytesTransferred;
 			CoronaFileSpec *responseFile = fRequestParams->getResponseFile();
 			if (responseFile != NULL)
 			{
-				if (status == 200)
+				// The I/O thread has already moved the download into place
+				if (status == 200 && transfer->fResult == CURLE_OK)
 				{
 					fRequestState->fResponseBody.bodyType = TYPE_FILE;
 					fRequestState->fResponseBody.bodyFile = new CoronaFileSpec(responseFile);
-					UTF8String responseFileFullPath = responseFile->getFullPath();
-
-					FILE* f = fopen(responseFileFullPath.c_str(), "wb");
-					if (f)
-					{
-						fwrite(fRequestParams->fResponse.data(), 1, fRequestParams->fResponse.size(), f);
-						fclose(f);
-						fRequestState->setBytesEstimated(fRequestParams->fResponse.size());
-						fRequestState->setBytesTransferred(fRequestParams->fResponse.size());
-					}
+					fRequestState->setBytesEstimated(bytesTransferred);
+					fRequestState->setBytesTransferred(bytesTransferred);
 				}
 			}
-			else if (fRequestParams->fResponse.size() > 0)
+			else if (transfer->fResponse.size() > 0)
 			{
 				fRequestState->fResponseBody.bodyType = TYPE_BYTES;
-				const uint8_t* buf = (const uint8_t*) fRequestParams->fResponse.data();
-				fRequestState->fResponseBody.bodyBytes = new ByteVector(buf, buf + fRequestParams->fResponse.size());
-				fRequestState->setBytesEstimated(fRequestParams->fResponse.size());
-				fRequestState->setBytesTransferred(fRequestParams->fResponse.size());
+				const uint8_t* buf = (const uint8_t*) transfer->fResponse.data();
+				fRequestState->fResponseBody.bodyBytes = new ByteVector(buf, buf + transfer->fResponse.size());
+				fRequestState->setBytesEstimated(transfer->fResponse.size());
+				fRequestState->setBytesTransferred(transfer->fResponse.size());
 			}
 
 			fRequestState->setStatus(status);
@@ -109,11 +370,16 @@ void NetworkNotifierTask::operator()( Scheduler & sender )
 		}
 
 		// delete from queue
-		fNetworkLibrary->fRequests.erase(fRequestParams->getID());
+		auto it = fNetworkLibrary->fRequests.find(fRequestParams->getID());
+		if (it != fNetworkLibrary->fRequests.end() && it->second == fTransfer)
+		{
+			fNetworkLibrary->fRequests.erase(it);
+		}
 
 		// delete request
 		fRequestParams = NULL;
 		fRequestState = NULL;
+		fTransfer.reset();
 
 		// delete task fron chain
 		setKeepAlive(false);
@@ -244,13 +510,11 @@ int	NetworkLibrary::sendRequest(lua_State *L)
 	{
 		const std::string& url = requestParams->getRequestUrl();
 
-		CURLM* curlMulti = curl_multi_init();
+		std::shared_ptr<NetworkTransfer> transfer = std::make_shared<NetworkTransfer>(requestParams->getProgressDirection());
 		CURL* curl = curl_easy_init();
-		curl_multi_add_handle(curlMulti, curl);
-
-		requestParams->setCURL(curlMulti, curl);
-		// const std::string& method = requestParams->getRequestMethod();
+		transfer->fCURL = curl;
 
+		// Body data is copied so the transfer does not depend on requestParams
 		CURLcode rc;
 		const Body* body = requestParams->getRequestBody();
 		std::string fileSize = "";
@@ -259,18 +523,16 @@ int	NetworkLibrary::sendRequest(lua_State *L)
 			case TYPE_STRING:
 			{
 				Rtt_ASSERT(body->bodyString);
-				UTF8String postParams = *body->bodyString;
-				const char* buf = (const char*)body->bodyString->c_str();
-				rc = curl_easy_setopt(curl, CURLOPT_POSTFIELDS, buf);
+				rc = curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)body->bodyString->size());
+				rc = curl_easy_setopt(curl, CURLOPT_COPYPOSTFIELDS, body->bodyString->c_str());
 				break;
 			}
 			case TYPE_BYTES:
 			{
 				Rtt_ASSERT(body->bodyBytes);
-				unsigned char* buf = &body->bodyBytes->operator[](0);
 				long buflen = body->bodyBytes->size();
-				rc = curl_easy_setopt(curl, CURLOPT_POSTFIELDS, buf);
 				rc = curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, buflen);
+				rc = curl_easy_setopt(curl, CURLOPT_COPYPOSTFIELDS, buflen > 0 ? (const char*)body->bodyBytes->data() : "");
 				break;
 			}
 			case TYPE_FILE:
@@ -281,7 +543,7 @@ int	NetworkLibrary::sendRequest(lua_State *L)
 					break;
 				}
 				// Record the file handle, to be cleaned up together with curl.
-				requestParams->setFileHandle(uploadFile);
+				transfer->fUploadFile = uploadFile;
 				rc = curl_easy_setopt(curl, CURLOPT_READDATA, uploadFile);
 				// Get and set the file size.
 				long size = fseek(uploadFile, 0, SEEK_END) ? -1 : ftell(uploadFile);
@@ -314,13 +576,15 @@ int	NetworkLibrary::sendRequest(lua_State *L)
 			}
 			// Set the size of the file to be uploaded.
 			if (!fileSize.empty()) {
-				curl_slist_append(headers, fileSize.c_str());
+				headers = curl_slist_append(headers, fileSize.c_str());
 			}
+			transfer->fRequestHeaders = headers;
 			rc = curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 		} else {
 			// Set the size of the file to be uploaded.
 			if (!fileSize.empty()) {
-				rc = curl_easy_setopt(curl, CURLOPT_HTTPHEADER, curl_slist_append(NULL, fileSize.c_str()));
+				transfer->fRequestHeaders = curl_slist_append(NULL, fileSize.c_str());
+				rc = curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer->fRequestHeaders);
 			}
 		}
 
@@ -333,13 +597,31 @@ int	NetworkLibrary::sendRequest(lua_State *L)
 
 		// Set the callback function for response headers.
 		rc = curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curlHeaderCallback);
-		rc = curl_easy_setopt(curl, CURLOPT_HEADERDATA, &requestParams->fResponseHeaders);
+		rc = curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transfer->fResponseHeaders);
 
-		rc = curl_easy_setopt(curl, CURLOPT_WRITEDATA, &requestParams->fResponse);
+		// Downloads are written straight to the response file by the I/O thread
+		CoronaFileSpec *responseFile = requestParams->getResponseFile();
+		if (responseFile != NULL)
+		{
+			transfer->fDownloadPath = responseFile->getFullPath();
+		}
+		rc = curl_easy_setopt(curl, CURLOPT_WRITEDATA, transfer.get());
 		rc = curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlWriteData);
+		rc = curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+		rc = curl_easy_setopt(curl, CURLOPT_XFERINFODATA, transfer.get());
+		rc = curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, curlProgress);
 		rc = curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
 		rc = curl_easy_setopt(curl, CURLOPT_TIMEOUT, requestParams->getTimeout());
 
+		// Signals are not thread safe; the transfer runs on the I/O thread
+		rc = curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+		// Let the shared multi handle keep the connection open for later
+		// requests, and prefer HTTP/2 over TLS so they can share it
+		rc = curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+		rc = curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+		rc = curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+
 		long status = 0;
 		smart_ptr<NetworkRequestState> requestState = new NetworkRequestState();
 		requestState->fResponseBody.bodyType = TYPE_NONE;
@@ -347,18 +629,17 @@ int	NetworkLibrary::sendRequest(lua_State *L)
 		requestState->setURL(requestParams->getRequestUrl());
 		requestState->setStatus(status);
 		requestState->setPhase("ended");
-		requestState->setBytesEstimated(requestParams->fResponse.size());
-		requestState->setBytesTransferred(requestParams->fResponse.size());
-		int still_running = 0;
-		CURLM* cm = requestParams->getMultiCURL();
-		curl_multi_perform(cm, &still_running);
+		requestState->setBytesEstimated(0);
+		requestState->setBytesTransferred(0);
+
+		fIOThread.submit(transfer);
 
-		// onEnterFrame
+		// onEnterFrame, only picks up progress and completion
 		Runtime* runtime = LuaContext::GetRuntime(L);
-		NetworkNotifierTask* task = Rtt_NEW(runtime->Allocator(), NetworkNotifierTask(requestParams, requestState, this));
+		NetworkNotifierTask* task = Rtt_NEW(runtime->Allocator(), NetworkNotifierTask(requestParams, requestState, transfer, this));
 		runtime->GetScheduler().Append( task );
 
-		fRequests[requestParams->getID()] = requestParams;
+		fRequests[requestParams->getID()] = transfer;
 		lua_pushnumber(L, requestParams->getID());
 
 		return 1; // pushed values
@@ -375,9 +656,8 @@ int	NetworkLibrary::cancel(lua_State *L)
 	auto it = thiz->fRequests.find(requestID);
 	if (it != thiz->fRequests.end())
 	{
-		NetworkRequestParameters* requestParams = it->second;
 		rc = true;
-		requestParams->cancel();
+		thiz->fIOThread.cancel(it->second);
 		thiz->fRequests.erase(it);
 	}
 	lua_pushboolean(L, rc);
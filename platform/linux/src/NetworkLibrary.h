@@ -10,7 +10,10 @@
 #ifndef _NetworkLibrary_H__
 #define _NetworkLibrary_H__
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include "Corona/CoronaLua.h"
 #include "Corona/CoronaMacros.h"
@@ -44,6 +47,73 @@ namespace Rtt
 			smart_ptr<NetworkRequestState> fRequestState;
 	};
 
+	// One network.request() transfer. Set up on the Lua thread, then owned by
+	// the I/O thread until isDone() returns true; after that only the Lua thread
+	// reads it. fIsCancelled and the byte counts may be read at any time.
+	class NetworkTransfer
+	{
+	public:
+
+		NetworkTransfer(ProgressDirection progressDirection);
+		~NetworkTransfer();
+
+		bool isDone() const { return fIsDone.load(std::memory_order_acquire); }
+		void close(bool keepDownload);
+
+		CURL* fCURL;
+		struct curl_slist* fRequestHeaders;
+		FILE* fUploadFile;
+		ProgressDirection fProgressDirection;
+
+		// Successful downloads are streamed to a temporary file next to
+		// fDownloadPath and renamed once the transfer is complete
+		UTF8String fDownloadPath;
+		FILE* fDownloadFile;
+		bool fHasResponseBody;
+
+		membuf fResponse;
+		UTF8String fResponseHeaders;
+		long fStatus;
+		CURLcode fResult;
+
+		std::atomic<long long> fBytesTransferred;
+		std::atomic<long long> fBytesEstimated;
+		std::atomic<bool> fIsCancelled;
+		std::atomic<bool> fIsDone;
+	};
+
+	// Runs every transfer on one background thread that drives a single curl
+	// multi handle, so connections are kept alive and reused across requests
+	// and multiplexed over HTTP/2 where the server allows it
+	class NetworkIOThread
+	{
+	public:
+
+		NetworkIOThread();
+		~NetworkIOThread();
+
+		void submit(const std::shared_ptr<NetworkTransfer>& transfer);
+		void cancel(const std::shared_ptr<NetworkTransfer>& transfer);
+
+	private:
+
+		void run();
+		void wakeup();
+		void finish(const std::shared_ptr<NetworkTransfer>& transfer, CURLcode result);
+
+		CURLM* fMultiCURL;
+		std::thread fThread;
+
+		// Guarded by fMutex
+		std::mutex fMutex;
+		std::vector<std::shared_ptr<NetworkTransfer> > fPending;
+		std::vector<std::shared_ptr<NetworkTransfer> > fCancelled;
+		bool fIsQuitting;
+
+		// Only used by the I/O thread
+		std::map<CURL*, std::shared_ptr<NetworkTransfer> > fActive;
+	};
+
 	class NetworkLibrary
 	{
 	public:
@@ -75,18 +145,21 @@ namespace Rtt
 
 		int sendRequest(lua_State *L);
 
-		std::map<unsigned int, smart_ptr<NetworkRequestParameters> > fRequests;
+		NetworkIOThread fIOThread;
+		std::map<unsigned int, std::shared_ptr<NetworkTransfer> > fRequests;
 	};
 
 	class NetworkNotifierTask : public Task
 	{
 	public:
 
-		NetworkNotifierTask(NetworkRequestParameters* requestParams, NetworkRequestState* requestState, NetworkLibrary* lib)
+		NetworkNotifierTask(NetworkRequestParameters* requestParams, NetworkRequestState* requestState, const std::shared_ptr<NetworkTransfer>& transfer, NetworkLibrary* lib)
 			: Task(true)
 			, fRequestParams(requestParams)
 			, fRequestState(requestState)
+			, fTransfer(transfer)
 			, fNetworkLibrary(lib)
+			, fLastBytesTransferred(0)
 		{
 		}
 
@@ -94,7 +167,9 @@ namespace Rtt
 
 		smart_ptr<NetworkRequestParameters> fRequestParams;
 		smart_ptr<NetworkRequestState> fRequestState;
+		std::shared_ptr<NetworkTransfer> fTransfer;
 		NetworkLibrary* fNetworkLibrary;
+		long long fLastBytesTransferred;
 	};
 // }
 #endif // _NetworkLibrary_H__
@@ -565,9 +565,6 @@ NetworkRequestParameters::NetworkRequestParameters( lua_State *luaState)
 	fRequestBodySize = 0;
 	fResponseFile = NULL;
 	fLuaCallback = NULL;
-    fFileHandle = NULL;
-	fCURL = NULL;
-	fMultiCURL = NULL;
 
 	int arg = 1;
 	// First argument - url (required)
@@ -1015,28 +1012,8 @@ NetworkRequestParameters::NetworkRequestParameters( lua_State *luaState)
 	fIsValid = !isInvalid;
 }
 
-void NetworkRequestParameters::cancel()
-{
-	if (fCURL != 0 && fMultiCURL != NULL)
-	{
-		curl_multi_remove_handle(fMultiCURL, fCURL);
-		curl_easy_cleanup(fCURL);
-		curl_multi_cleanup(fMultiCURL);
-
-        if (fFileHandle != NULL) {
-            fclose(fFileHandle);
-        }
-
-		// to prevent multiple calls
-		fMultiCURL = NULL;
-		fCURL = NULL;
-        fFileHandle = NULL;
-	}
-}
-
 NetworkRequestParameters::~NetworkRequestParameters()
 {
-	cancel();
 	switch (fRequestBody.bodyType)
 	{
 		case TYPE_STRING:
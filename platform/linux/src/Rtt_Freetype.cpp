@@ -68,7 +68,8 @@ namespace Rtt
 	}
 
 	glyph_freetype_provider::glyph_freetype_provider(const char* pathToApp)
-		: m_scale(0)
+		: m_glyph_bytes(0)
+		, m_scale(0)
 	{
 		m_base_dir = pathToApp;
 		int	error = FT_Init_FreeType(&m_lib);
@@ -89,6 +90,13 @@ namespace Rtt
 
 	glyph_freetype_provider::~glyph_freetype_provider()
 	{
+#ifdef _DEBUG
+		Rtt_Log("Font caches: faces %u/%u, glyphs %u/%u, measurements %u/%u (hits/misses)\n",
+			m_statistics.m_face_hits, m_statistics.m_face_misses,
+			m_statistics.m_glyph_hits, m_statistics.m_glyph_misses,
+			m_statistics.m_measure_hits, m_statistics.m_measure_misses);
+#endif
+
 		m_face_entity.clear();
 
 		int error = FT_Done_FreeType(m_lib);
@@ -99,14 +107,9 @@ namespace Rtt
 		m_lib = NULL;
 	}
 
-	face_entity* glyph_freetype_provider::get_face_entity(const std::string& fontname, bool is_bold, bool is_italic)
+	FT_Face glyph_freetype_provider::open_face(const std::string& fontname, bool* is_fallback)
 	{
-		// first try to find from hash
-		auto it = m_face_entity.find(fontname);
-		if (it != m_face_entity.end())
-		{
-			return it->second;
-		}
+		*is_fallback = false;
 
 		FT_Face face = NULL;
 		std::string url = m_base_dir + fontname;
@@ -124,6 +127,7 @@ namespace Rtt
 				if (face == NULL)
 				{
 					// try default
+					*is_fallback = true;
 					url = m_base_dir + "default.ttf";
 					FT_New_Face(m_lib, url.c_str(), 0, &face);
 					if (face == NULL)
@@ -138,6 +142,31 @@ namespace Rtt
 				}
 			}
 		}
+		return face;
+	}
+
+	face_entity* glyph_freetype_provider::get_face_entity(const std::string& fontname, bool is_bold, bool is_italic)
+	{
+		// first try to find from hash
+		std::string key = fontname;
+		key += '\0';
+		key += is_bold ? 'b' : '-';
+		key += is_italic ? 'i' : '-';
+
+		auto it = m_face_entity.find(key);
+		if (it != m_face_entity.end())
+		{
+			m_statistics.m_face_hits++;
+			return it->second;
+		}
+		m_statistics.m_face_misses++;
+
+		bool is_fallback = false;
+		FT_Face face = open_face(fontname, &is_fallback);
+		if (face == NULL)
+		{
+			return NULL;
+		}
 
 		if (is_bold)
 		{
@@ -149,55 +178,98 @@ namespace Rtt
 			face->style_flags |= FT_STYLE_FLAG_ITALIC;
 		}
 
-		face_entity* fe = new face_entity(face);
-		m_face_entity[fontname] = fe;
+		face_entity* fe = new face_entity(face, is_fallback);
+		m_face_entity[key] = fe;
 		return fe;
 	}
 
-	glyph_entity* glyph_freetype_provider::load_char_image(face_entity* fe, Uint16 code, int fontsize, float xscale)
+	void glyph_freetype_provider::trim_glyphs()
 	{
-		// form hash key
-		U64 xs = (Uint32)(xscale * 0x10000);
-		U64 key = (xs << 32) | (fontsize << 16) | code;
+		if (m_glyph_bytes <= kMaxGlyphBytes)
+		{
+			return;
+		}
+
+		// most text reuses few glyphs, so starting over is cheaper than tracking their use
+		for (auto it = m_face_entity.begin(); it != m_face_entity.end(); ++it)
+		{
+			it->second->clear_glyphs();
+		}
+		m_glyph_bytes = 0;
+	}
+
+	glyph_entity* glyph_freetype_provider::load_char_image(face_entity* fe, Uint32 code, int fontsize, float xscale)
+	{
+		glyph_key key(code, fontsize, xscale);
 
 		// try to find stored image
-		glyph_entity* ge = NULL;
-		FT_GlyphSlot  slot = fe->m_face->glyph;
 		auto it = fe->m_ge.find(key);
-		if (it == fe->m_ge.end())
+		if (it != fe->m_ge.end())
 		{
-			FT_Matrix transform = { (FT_Fixed)(xscale * 0x10000), 0, 0, 0x10000 };
-			FT_Set_Transform(fe->m_face, &transform, NULL);
+			m_statistics.m_glyph_hits++;
+			return it->second;
+		}
+		m_statistics.m_glyph_misses++;
+
+		glyph_entity* ge = NULL;
+		FT_GlyphSlot  slot = fe->m_face->glyph;
+		FT_Matrix transform = { (FT_Fixed)(xscale * 0x10000), 0, 0, 0x10000 };
+		FT_Set_Transform(fe->m_face, &transform, NULL);
 
-			if (FT_Load_Char(fe->m_face, code, FT_LOAD_RENDER) == 0)
+		if (FT_Load_Char(fe->m_face, code, FT_LOAD_RENDER) == 0)
+		{
+			ge = new glyph_entity();
+			ge->m_width = slot->bitmap.width;
+			ge->m_height = slot->bitmap.rows;
+			ge->m_image = (Uint8*)malloc(ge->m_width * ge->m_height);
+			ge->m_left = slot->bitmap_left;
+			ge->m_top = slot->bitmap_top;
+			ge->m_advance = slot->advance.x >> 6;
+
+			// rows of the rendered bitmap may be padded
+			for (int y = 0; y < ge->m_height; y++)
 			{
-				ge = new glyph_entity();
-				ge->m_width = fe->m_face->glyph->bitmap.width;
-				ge->m_height = fe->m_face->glyph->bitmap.rows;
-				ge->m_image = (Uint8*)malloc(ge->m_width * ge->m_height);
-				ge->m_left = slot->bitmap_left;
-				ge->m_top = slot->bitmap_top;
-				ge->m_advance = slot->advance.x >> 6;
-
-				memcpy(ge->m_image, fe->m_face->glyph->bitmap.buffer, ge->m_width * ge->m_height);
-
-				// keep image
-				fe->m_ge[key] = ge;
+				memcpy(ge->m_image + y * ge->m_width, slot->bitmap.buffer + y * slot->bitmap.pitch, ge->m_width);
 			}
+
+			// keep image
+			fe->m_ge[key] = ge;
+			m_glyph_bytes += sizeof(glyph_entity) + ge->m_width * ge->m_height;
 		}
 		return ge;
 	}
 
-	glyph_entity* glyph_freetype_provider::get_glyph_entity(face_entity* fe, Uint16 code, int fontsize, float xscale)
+	glyph_entity* glyph_freetype_provider::get_glyph_entity(face_entity* fe, Uint32 code, int fontsize, float xscale)
 	{
-		// form hash key
-		U64 xs = (Uint32)(xscale * 0x10000);
-		U64 key = (xs << 32) | (fontsize << 16) | code;
-
-		auto it = fe->m_ge.find(key);
+		auto it = fe->m_ge.find(glyph_key(code, fontsize, xscale));
 		return it == fe->m_ge.end() ? NULL : it->second;
 	}
 
+	glyph_freetype_provider::rect glyph_freetype_provider::measure(face_entity* fe, const std::string& str, std::vector<Uint32>& ch, int fontsize, int vertAdvance, float xscale, int boxw, int boxh)
+	{
+		// the layout depends on the face, its size, the box width and the text
+		char prefix[64];
+		snprintf(prefix, sizeof(prefix), "%p:%d:%d:%08x:%d:", (void*)fe, fontsize, vertAdvance, (Uint32)(xscale * 0x10000), boxw);
+		std::string key(prefix);
+		key += str;
+
+		auto it = m_measurements.find(key);
+		if (it != m_measurements.end())
+		{
+			m_statistics.m_measure_hits++;
+			return it->second;
+		}
+		m_statistics.m_measure_misses++;
+
+		rect r = getBoundingBox(fe, ch, fontsize, vertAdvance, xscale, boxw, boxh);
+		if (m_measurements.size() >= kMaxMeasurements)
+		{
+			m_measurements.clear();
+		}
+		m_measurements.insert(std::make_pair(key, r));
+		return r;
+	}
+
 	glyph_freetype_provider::rect glyph_freetype_provider::getBoundingBox(face_entity* fe, std::vector<Uint32>& ch, int fontsize, int vertAdvance, float xscale, int boxw, int boxh)
 	{
 		rect r(0, vertAdvance);
@@ -369,6 +441,9 @@ namespace Rtt
 			return NULL;
 		}
 
+		// only between strings, since glyphs loaded below must stay until drawn
+		trim_glyphs();
+
 		FT_Face face = fe->m_face;
 		FT_Error rc = FT_Set_Pixel_Sizes(face, 0, fontsize);
 
@@ -407,7 +482,7 @@ namespace Rtt
 
 		multiline = true;
 
-		rect r = getBoundingBox(fe, ch, fontsize, vertAdvance, xscale, boxw, boxh);
+		rect r = measure(fe, str, ch, fontsize, vertAdvance, xscale, boxw, boxh);
 		if (boxw == 0)
 		{
 			boxw = r.width;
@@ -625,15 +700,13 @@ namespace Rtt
 	const char* glyph_freetype_provider::getFace(const char* path)
 	{
 		static std::string res;
-		FT_Face face = NULL;
-		std::string url = m_base_dir + path;
-		FT_New_Face(m_lib, url.c_str(), 0, &face);
-		if (face)
+		face_entity* fe = get_face_entity(path, false, false);
+		if (fe && !fe->m_is_fallback)
 		{
+			FT_Face face = fe->m_face;
 			res = face->family_name;
 			res += ' ';
 			res += face->style_name;
-			FT_Done_Face(face);
 			return res.c_str();
 		}
 		return NULL;
@@ -641,20 +714,14 @@ namespace Rtt
 
 	bool glyph_freetype_provider::getMetrics(const char* path, float size, float* ascent, float* descent, float* height, float* leading)
 	{
-		FT_Face face = NULL;
-		std::string url = m_base_dir + path;
-		FT_New_Face(m_lib, url.c_str(), 0, &face);
-		if (face == NULL)
-		{
-			url += ".ttf";
-			FT_New_Face(m_lib, url.c_str(), 0, &face);
-		}
-
-		if (face == NULL)
+		face_entity* fe = get_face_entity(path, false, false);
+		if (fe == NULL || fe->m_is_fallback)
 		{
 			return false;
 		}
 
+		// render_string() sets the size it needs, so changing it here is harmless
+		FT_Face face = fe->m_face;
 		FT_Set_Pixel_Sizes(face, 0, size);
 
 		*ascent = face->size->metrics.ascender >> 6;
@@ -662,7 +729,6 @@ namespace Rtt
 		*height = face->size->metrics.height >> 6;
 		*leading = *height - *ascent - *descent;
 
-		FT_Done_Face(face);
 		return true;
 	}
 
@@ -73,13 +73,39 @@ namespace Rtt
 		int m_advance;
 	};
 
+	// a rendered glyph is identified by its code point, pixel size and horizontal scale
+	struct glyph_key
+	{
+		glyph_key(Uint32 code, int fontsize, float xscale)
+			: m_code(code)
+			, m_fontsize(fontsize)
+			, m_xscale((Uint32)(xscale * 0x10000))
+		{
+		}
+
+		bool operator<(const glyph_key &rhs) const
+		{
+			if (m_code != rhs.m_code) return m_code < rhs.m_code;
+			if (m_fontsize != rhs.m_fontsize) return m_fontsize < rhs.m_fontsize;
+			return m_xscale < rhs.m_xscale;
+		}
+
+		Uint32 m_code;
+		int m_fontsize;
+		Uint32 m_xscale;
+	};
+
 	struct face_entity : public ref_counted
 	{
 		FT_Face m_face;
-		std::map<U64, glyph_entity*> m_ge;	// <code, glyph_entity>
+		std::map<glyph_key, glyph_entity*> m_ge;
 
-		face_entity(FT_Face face) :
-			m_face(face)
+		// true if the requested font was not found and this is the default font
+		bool m_is_fallback;
+
+		face_entity(FT_Face face, bool is_fallback) :
+			m_face(face),
+			m_is_fallback(is_fallback)
 		{
 			assert(face);
 		}
@@ -87,13 +113,37 @@ namespace Rtt
 		~face_entity()
 		{
 			FT_Done_Face(m_face);
-			for (std::map<U64, glyph_entity*>::iterator it = m_ge.begin(); it != m_ge.end(); ++it)
+			clear_glyphs();
+		}
+
+		void clear_glyphs()
+		{
+			for (std::map<glyph_key, glyph_entity*>::iterator it = m_ge.begin(); it != m_ge.end(); ++it)
 			{
 				delete it->second;
 			}
+			m_ge.clear();
 		}
 	};
 
+	// hit counts of the glyph provider's caches
+	struct glyph_cache_statistics
+	{
+		glyph_cache_statistics()
+			: m_face_hits(0), m_face_misses(0)
+			, m_glyph_hits(0), m_glyph_misses(0)
+			, m_measure_hits(0), m_measure_misses(0)
+		{
+		}
+
+		U32 m_face_hits;
+		U32 m_face_misses;
+		U32 m_glyph_hits;
+		U32 m_glyph_misses;
+		U32 m_measure_hits;
+		U32 m_measure_misses;
+	};
+
 	struct glyph_freetype_provider  : public ref_counted
 	{
 		glyph_freetype_provider(const char *pathToApp);
@@ -106,7 +156,15 @@ namespace Rtt
 		const char *getFace(const char *path);
 		bool getMetrics(const char *path, float size, float *ascent, float *descent, float *height, float *leading);
 
+		const glyph_cache_statistics &get_statistics() const { return m_statistics; }
+
 	private:
+		// rendered glyphs of all faces are dropped once they take more than this
+		static const size_t kMaxGlyphBytes = 8 * 1024 * 1024;
+
+		// number of text layouts whose size is remembered
+		static const size_t kMaxMeasurements = 1024;
+
 		struct rect
 		{
 			rect(int w, int h) : width(w), height(h) {}
@@ -114,13 +172,19 @@ namespace Rtt
 			int height;
 		};
 
-		glyph_entity *load_char_image(face_entity *fe, Uint16 code, int fontsize, float xscale);
-		glyph_entity *get_glyph_entity(face_entity *fe, Uint16 code, int fontsize, float xscale);
+		glyph_entity *load_char_image(face_entity *fe, Uint32 code, int fontsize, float xscale);
+		glyph_entity *get_glyph_entity(face_entity *fe, Uint32 code, int fontsize, float xscale);
 		rect getBoundingBox(face_entity *fe, std::vector<Uint32> &ch, int fontsize, int vertAdvance, float xscale, int boxw, int boxh);
+		rect measure(face_entity *fe, const std::string &str, std::vector<Uint32> &ch, int fontsize, int vertAdvance, float xscale, int boxw, int boxh);
 		int draw_line(alpha *im, face_entity *fe, const std::vector<Uint32> &ch, int i1, int i2, int *pen_x, int pen_y, const char *alignment, int boxw, int fontsize, float xscale);
 		face_entity* get_face_entity(const std::string& fontname,	bool is_bold, bool is_italic);
+		FT_Face open_face(const std::string &fontname, bool *is_fallback);
+		void trim_glyphs();
 		Uint32	decode_next_unicode_character(const char **utf8_buffer);
-		std::map<std::string, smart_ptr<face_entity>> m_face_entity;
+		std::map<std::string, smart_ptr<face_entity>> m_face_entity;	// <fontname and style, face_entity>
+		std::map<std::string, rect> m_measurements;	// <face, size, bounds and text, text size>
+		size_t m_glyph_bytes;
+		glyph_cache_statistics m_statistics;
 		FT_Library	m_lib;
 		float m_scale;
 		std::string m_base_dir;
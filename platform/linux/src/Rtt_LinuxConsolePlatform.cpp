@@ -57,6 +57,7 @@ namespace Rtt
 		fTemporaryDir.Set(temporaryDir);
 		fCachesDir.Set(cachesDir);
 		fSystemCachesDir.Set(systemCachesDir);
+		fPreferenceStore.Initialize(systemCachesDir);
 		fSkinDir.Set(skinDir);
 		fInstallDir.Set(installDir);
 	}
@@ -325,94 +326,17 @@ namespace Rtt
 
 	Preference::ReadValueResult LinuxConsolePlatform::GetPreference(const char *categoryName, const char *keyName) const
 	{
-		// add category name as prefix
-		std::string key(categoryName);
-
-		if (strlen(keyName) > 0)
-		{
-			key += '.';
-			key += keyName;
-		}
-		char val[1024];
-
-		// maybe it would be better to use sqlite3 ??
-		std::string path = fSystemCachesDir.GetString();
-		path += '/';
-		path += key;
-		FILE *f = fopen(path.c_str(), "rb");
-		bool rc = false;
-
-		if (f)
-		{
-			int n = fread(val, 1, sizeof(val) - 1, f);
-			val[n] = '\0';
-			fclose(f);
-			rc = true;
-		}
-
-		return rc == false ? Preference::ReadValueResult::kPreferenceNotFound : Preference::ReadValueResult::SucceededWith(val);
+		return fPreferenceStore.Fetch(categoryName, keyName);
 	}
 
 	OperationResult LinuxConsolePlatform::SetPreferences(const char *categoryName, const PreferenceCollection &preferences) const
 	{
-		bool rc = true;
-
-		for (int index = preferences.GetCount() - 1; index >= 0 && rc == true; index--)
-		{
-			// Fetch the next preference to write to the database.
-			auto preferencePointer = preferences.GetByIndex(index);
-
-			if (preferencePointer != NULL)
-			{
-				// add category name as prefix
-				std::string key(categoryName);
-				key += '.';
-				key += preferencePointer->GetKeyName();
-
-				PreferenceValue pval = preferencePointer->GetValue();
-
-				// Insert the preference value as string.
-				PreferenceValue::StringResult strval = pval.ToString();
-				const char *val = strval.GetValue()->c_str();
-
-				// maybe it would be better to use sqlite3 ??
-				std::string path = fSystemCachesDir.GetString();
-				path += '/';
-				path += key;
-				FILE *f = fopen(path.c_str(), "wb");
-
-				if (f)
-				{
-					fwrite(val, 1, strlen(val), f);
-					fclose(f);
-					rc = true;
-				}
-			}
-		}
-
-		return rc == false ? OperationResult::FailedWith("This API is not supported on this platform.") : Rtt::OperationResult::kSucceeded;
+		return fPreferenceStore.UpdateWith(categoryName, preferences);
 	}
 
 	OperationResult LinuxConsolePlatform::DeletePreferences(const char *categoryName, const char **keyNameArray, U32 keyNameCount) const
 	{
-		bool rc = true;
-
-		for (int i = 0; i < keyNameCount && keyNameArray && rc; i++)
-		{
-			// Fetch the next preference key, add category name as prefix
-			std::string key(categoryName);
-			key += '.';
-			key += keyNameArray[i];
-
-			// maybe it would be better to use sqlite3 ??
-			std::string path = fSystemCachesDir.GetString();
-			path += '/';
-			path += key;
-			int n = Rtt_DeleteFile(path.c_str());
-			rc = n == 0 ? true : false;
-		}
-
-		return rc == false ? OperationResult::FailedWith("This API is not supported on this platform.") : Rtt::OperationResult::kSucceeded;
+		return fPreferenceStore.Delete(categoryName, keyNameArray, keyNameCount);
 	}
 
 	int LinuxConsolePlatform::PushSystemInfo(lua_State *L, const char *key) const
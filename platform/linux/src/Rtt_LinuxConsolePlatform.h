@@ -12,6 +12,7 @@
 #include "Rtt_LinuxDevice.h"
 #include "Rtt_MPlatform.h"
 #include "Rtt_LinuxCrypto.h"
+#include "Rtt_LinuxPreferenceStore.h"
 #include "Core/Rtt_String.h"
 #include "Rtt_PlatformSimulator.h"
 
@@ -155,5 +156,6 @@ namespace Rtt
 		String fInstallDir;
 		String fSkinDir;
 		LinuxCrypto fCrypto;
+		mutable LinuxPreferenceStore fPreferenceStore;
 	};
 }; // namespace Rtt
@@ -9,6 +9,7 @@
 
 #include "Core/Rtt_Build.h"
 #include "Rtt_LinuxCrypto.h"
+#include "openssl/evp.h"
 #include "openssl/hmac.h"
 #include "openssl/md4.h"
 #include "openssl/md5.h"
@@ -16,6 +17,33 @@
 
 namespace Rtt
 {
+	class LinuxDigest : public MCrypto::Digest
+	{
+	public:
+		LinuxDigest(EVP_MD_CTX *context)
+			: fContext(context)
+		{
+		}
+
+		virtual ~LinuxDigest()
+		{
+			EVP_MD_CTX_free(fContext);
+		}
+
+		virtual void Update(const void *data, size_t length)
+		{
+			EVP_DigestUpdate(fContext, data, length);
+		}
+
+		virtual void Final(U8 *md)
+		{
+			EVP_DigestFinal_ex(fContext, md, NULL);
+		}
+
+	private:
+		EVP_MD_CTX *fContext;
+	};
+
 	size_t LinuxCrypto::GetDigestLength(Algorithm algorithm) const
 	{
 		// Return the byte length of the hash for the given algorithm.
@@ -85,6 +113,47 @@ namespace Rtt
 		}
 	}
 
+	MCrypto::Digest *LinuxCrypto::NewDigest(Algorithm algorithm) const
+	{
+		const EVP_MD *md = NULL;
+		switch (algorithm)
+		{
+			case kMD4Algorithm:
+				md = EVP_md4();
+				break;
+			case kMD5Algorithm:
+				md = EVP_md5();
+				break;
+			case kSHA1Algorithm:
+				md = EVP_sha1();
+				break;
+			case kSHA224Algorithm:
+				md = EVP_sha224();
+				break;
+			case kSHA256Algorithm:
+				md = EVP_sha256();
+				break;
+			case kSHA384Algorithm:
+				md = EVP_sha384();
+				break;
+			case kSHA512Algorithm:
+				md = EVP_sha512();
+				break;
+			default:
+				break;
+		}
+
+		// MD4 may be unavailable, e.g. outside OpenSSL 3's legacy provider
+		EVP_MD_CTX *context = md ? EVP_MD_CTX_new() : NULL;
+		if (context && EVP_DigestInit_ex(context, md, NULL) != 1)
+		{
+			EVP_MD_CTX_free(context);
+			context = NULL;
+		}
+
+		return context ? new LinuxDigest(context) : NULL;
+	}
+
 	void LinuxCrypto::CalculateHMAC(Algorithm algorithm, const Rtt::Data<const char> &key, const Rtt::Data<const char> &data, U8 *digest) const
 	{
 		Rtt_LogException("todo: CalculateHMAC\n");
@@ -66,6 +66,7 @@ namespace Rtt
 		fTemporaryDir.Set(temporaryDir);
 		fCachesDir.Set(cachesDir);
 		fSystemCachesDir.Set(systemCachesDir);
+		fPreferenceStore.Initialize(systemCachesDir);
 		fSkinDir.Set(skinDir);
 		fInstallDir.Set(installDir);
 		fStatusBarMode = MPlatform::StatusBarMode::kDefaultStatusBar;
@@ -237,6 +238,10 @@ namespace Rtt
 		// Initialize result to an empty string in case the file was not found.
 		result.Set(NULL);
 
+		// Set by the resource directory cases, which already know whether the file exists
+		bool isExistenceKnown = false;
+		bool doesExist = false;
+
 		// Fetch the path for the given file.
 		if (filename && strstr(filename, "://"))
 		{
@@ -251,11 +256,14 @@ namespace Rtt
 			{
 			case MPlatform::kResourceDir:
 			{
+				// Existence is answered from fResourceIndex, not the disk
 				PathForFile(filename, fResourceDir.GetString(), result);
 				String result1;
 				String result2;
+				isExistenceKnown = (filename != NULL);
+				doesExist = isExistenceKnown && fResourceIndex.Exists(fResourceDir.GetString(), filename);
 
-				if (filename != NULL && FileExists(result.GetString()) == false)
+				if (filename != NULL && doesExist == false)
 				{
 					result1.Set(result);
 					// look for Resources dir
@@ -264,12 +272,15 @@ namespace Rtt
 					resDir.Append("/Resources");
 					PathForFile(filename, resDir.GetString(), result);
 					result2.Set(result);
+					doesExist = fResourceIndex.Exists(resDir.GetString(), filename);
 				}
 
-				if (filename != NULL && FileExists(result.GetString()) == false)
+				if (filename != NULL && doesExist == false)
 				{
-					PathForFile(filename, GetPluginsPath().c_str(), result);
-					Rtt_WARN_SIM(!filename || FileExists(result.GetString()), ("WARNING: Cannot create path for resource file '%s (%s || %s || %s)'. File does not exist.\n\n", filename, result1.GetString(), result2.GetString(), result.GetString()));
+					std::string pluginsPath = GetPluginsPath();
+					PathForFile(filename, pluginsPath.c_str(), result);
+					doesExist = fResourceIndex.Exists(pluginsPath.c_str(), filename);
+					Rtt_WARN_SIM(doesExist, ("WARNING: Cannot create path for resource file '%s (%s || %s || %s)'. File does not exist.\n\n", filename, result1.GetString(), result2.GetString(), result.GetString()));
 				}
 				break;
 			}
@@ -277,15 +288,18 @@ namespace Rtt
 			case MPlatform::kSystemResourceDir:
 			{
 				PathForFile(filename, fResourceDir.GetString(), result);
+				isExistenceKnown = (filename != NULL);
+				doesExist = isExistenceKnown && fResourceIndex.Exists(fResourceDir.GetString(), filename);
 
-				if (filename != NULL && FileExists(result.GetString()) == false)
+				if (filename != NULL && doesExist == false)
 				{
 					// look for Resources dir
 					String resDir;
 					resDir.Append(fInstallDir);
 					resDir.Append("/Resources");
 					PathForFile(filename, resDir.GetString(), result);
-					Rtt_WARN_SIM(!filename || FileExists(result.GetString()), ("WARNING: Cannot create path for resource file '%s (%s)'. File does not exist.\n\n", filename, result.GetString()));
+					doesExist = fResourceIndex.Exists(resDir.GetString(), filename);
+					Rtt_WARN_SIM(doesExist, ("WARNING: Cannot create path for resource file '%s (%s)'. File does not exist.\n\n", filename, result.GetString()));
 				}
 				break;
 			}
@@ -340,7 +354,7 @@ namespace Rtt
 		// Result will be set to an empty string if the file could not be found.
 		if (flags & MPlatform::kTestFileExists)
 		{
-			if (FileExists(result.GetString()) == false)
+			if ((isExistenceKnown ? doesExist : FileExists(result.GetString())) == false)
 			{
 				result.Set(NULL);
 			}
@@ -350,6 +364,7 @@ namespace Rtt
 	void LinuxPlatform::SetProjectResourceDirectory(const char* filename)
 	{
 		fResourceDir.Set(filename);
+		fResourceIndex.Clear();
 	}
 
 	void LinuxPlatform::SetSkinResourceDirectory(const char* filename)
@@ -1034,92 +1049,17 @@ namespace Rtt
 
 	Preference::ReadValueResult LinuxPlatform::GetPreference(const char* categoryName, const char* keyName) const
 	{
-		// add category name as prefix
-		std::string key(categoryName);
-
-		if (strlen(keyName) > 0)
-		{
-			key += '.';
-			key += keyName;
-		}
-		char val[1024];
-
-		// maybe it would be better to use sqlite3 ??
-		std::string path = fSystemCachesDir.GetString();
-		path += '/';
-		path += key;
-		FILE* f = fopen(path.c_str(), "rb");
-		bool rc = false;
-
-		if (f)
-		{
-			int n = fread(val, 1, sizeof(val) - 1, f);
-			val[n] = '\0';
-			fclose(f);
-			rc = true;
-		}
-
-		return rc == false ? Preference::ReadValueResult::kPreferenceNotFound : Preference::ReadValueResult::SucceededWith(val);
+		return fPreferenceStore.Fetch(categoryName, keyName);
 	}
 
 	OperationResult LinuxPlatform::SetPreferences(const char* categoryName, const PreferenceCollection& preferences) const
 	{
-		bool rc = true;
-
-		for (int index = preferences.GetCount() - 1; index >= 0 && rc == true; index--)
-		{
-			// Fetch the next preference to write to the database.
-			auto preferencePointer = preferences.GetByIndex(index);
-
-			if (preferencePointer != NULL)
-			{
-				// add category name as prefix
-				std::string key(categoryName);
-				key += '.';
-				key += preferencePointer->GetKeyName();
-
-				PreferenceValue pval = preferencePointer->GetValue();
-
-				// Insert the preference value as string.
-				PreferenceValue::StringResult strval = pval.ToString();
-				const char* val = strval.GetValue()->c_str();
-
-				// maybe it would be better to use sqlite3 ??
-				std::string path = fSystemCachesDir.GetString();
-				path += '/';
-				path += key;
-				FILE* f = fopen(path.c_str(), "wb");
-
-				if (f)
-				{
-					fwrite(val, 1, strlen(val), f);
-					fclose(f);
-					rc = true;
-				}
-			}
-		}
-		return rc == false ? OperationResult::FailedWith("SetPreferences failed") : Rtt::OperationResult::kSucceeded;
+		return fPreferenceStore.UpdateWith(categoryName, preferences);
 	}
 
 	OperationResult LinuxPlatform::DeletePreferences(const char* categoryName, const char** keyNameArray, U32 keyNameCount) const
 	{
-		bool rc = true;
-
-		for (int i = 0; i < keyNameCount && keyNameArray && rc; i++)
-		{
-			// Fetch the next preference key, add category name as prefix
-			std::string key(categoryName);
-			key += '.';
-			key += keyNameArray[i];
-
-			// maybe it would be better to use sqlite3 ??
-			std::string path = fSystemCachesDir.GetString();
-			path += '/';
-			path += key;
-			int n = Rtt_DeleteFile(path.c_str());
-			rc = n == 0 ? true : false;
-		}
-		return rc == false ? OperationResult::FailedWith("DeletePreferences failed") : Rtt::OperationResult::kSucceeded;
+		return fPreferenceStore.Delete(categoryName, keyNameArray, keyNameCount);
 	}
 
 	void LinuxPlatform::Suspend() const
@@ -12,6 +12,8 @@
 #include "Rtt_LinuxDevice.h"
 #include "Rtt_MPlatform.h"
 #include "Rtt_LinuxCrypto.h"
+#include "Rtt_LinuxPreferenceStore.h"
+#include "Rtt_LinuxResourceIndex.h"
 #include "Core/Rtt_String.h"
 #include "Rtt_PlatformTimer.h"
 #include "Rtt_PlatformSimulator.h"
@@ -188,6 +190,8 @@ namespace Rtt
 		String fSkinDir;
 		mutable MPlatform::StatusBarMode fStatusBarMode;
 		LinuxCrypto fCrypto;
+		mutable LinuxPreferenceStore fPreferenceStore;
+		mutable LinuxResourceIndex fResourceIndex;
 		mutable PlatformStoreProvider *fStoreProvider;
 		mutable PlatformFBConnect *fFBConnect;
 		mutable LinuxScreenSurface *fScreenSurface;
@@ -0,0 +1,397 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+#include "Core/Rtt_FileSystem.h"
+#include "Rtt_LinuxPreferenceStore.h"
+#include "sqlite3.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace Rtt
+{
+	static const char kDatabaseFileName[] = "CoronaPreferences.sqlite";
+
+	LinuxPreferenceStore::LinuxPreferenceStore()
+		: fDatabase(NULL)
+	{
+	}
+
+	LinuxPreferenceStore::~LinuxPreferenceStore()
+	{
+		if (fDatabase)
+		{
+			sqlite3_close(fDatabase);
+			fDatabase = NULL;
+		}
+	}
+
+	void LinuxPreferenceStore::Initialize(const char *directory)
+	{
+		fDirectory = directory ? directory : "";
+	}
+
+	Preference::ReadValueResult LinuxPreferenceStore::Fetch(const char *categoryName, const char *keyName)
+	{
+		OperationResult openResult = Open();
+		if (openResult.HasFailed())
+		{
+			return Preference::ReadValueResult::FailedWith(openResult.GetUtf8Message());
+		}
+
+		std::string key = KeyFor(categoryName, keyName);
+		Preference *preferencePointer = fCache.GetByKey(key.c_str());
+		if (!preferencePointer && ImportLegacyFile(key))
+		{
+			preferencePointer = fCache.GetByKey(key.c_str());
+		}
+
+		if (!preferencePointer)
+		{
+			return Preference::ReadValueResult::kPreferenceNotFound;
+		}
+		return Preference::ReadValueResult::SucceededWith(preferencePointer->GetValue());
+	}
+
+	OperationResult LinuxPreferenceStore::UpdateWith(const char *categoryName, const PreferenceCollection &preferences)
+	{
+		if (preferences.GetCount() <= 0)
+		{
+			return OperationResult::kSucceeded;
+		}
+
+		// Prefix every key with its category
+		PreferenceCollection prefixedPreferences;
+		for (int index = 0; index < preferences.GetCount(); index++)
+		{
+			Preference *preferencePointer = preferences.GetByIndex(index);
+			if (preferencePointer)
+			{
+				std::string key = KeyFor(categoryName, preferencePointer->GetKeyName());
+				prefixedPreferences.Add(key.c_str(), preferencePointer->GetValue());
+			}
+		}
+		return Write(prefixedPreferences);
+	}
+
+	OperationResult LinuxPreferenceStore::Delete(const char *categoryName, const char **keyNameArray, U32 keyNameCount)
+	{
+		if (!keyNameArray || keyNameCount <= 0)
+		{
+			return OperationResult::kSucceeded;
+		}
+
+		OperationResult openResult = Open();
+		if (openResult.HasFailed())
+		{
+			return openResult;
+		}
+
+		if (sqlite3_exec(fDatabase, "BEGIN TRANSACTION", NULL, NULL, NULL) != SQLITE_OK)
+		{
+			return FailedWithLastError("Failed to delete preferences.");
+		}
+
+		bool wasSuccessful = false;
+		sqlite3_stmt *statement = NULL;
+		sqlite3_prepare_v2(fDatabase, "DELETE FROM preference WHERE key = ?", -1, &statement, NULL);
+		if (statement)
+		{
+			wasSuccessful = true;
+			for (U32 index = 0; index < keyNameCount && wasSuccessful; index++)
+			{
+				if (!keyNameArray[index])
+				{
+					continue;
+				}
+
+				std::string key = KeyFor(categoryName, keyNameArray[index]);
+				sqlite3_bind_text(statement, 1, key.c_str(), (int)key.length(), SQLITE_TRANSIENT);
+				int errorCode = sqlite3_step(statement);
+				wasSuccessful = (SQLITE_DONE == errorCode) || (SQLITE_OK == errorCode);
+				sqlite3_reset(statement);
+			}
+			sqlite3_finalize(statement);
+		}
+
+		OperationResult result = wasSuccessful ? OperationResult::kSucceeded : FailedWithLastError("Failed to delete preferences.");
+		if (sqlite3_exec(fDatabase, wasSuccessful ? "END TRANSACTION" : "ROLLBACK", NULL, NULL, NULL) != SQLITE_OK && wasSuccessful)
+		{
+			result = FailedWithLastError("Failed to delete preferences.");
+			wasSuccessful = false;
+		}
+
+		if (wasSuccessful)
+		{
+			for (U32 index = 0; index < keyNameCount; index++)
+			{
+				if (keyNameArray[index])
+				{
+					// A leftover file from the old store would otherwise be imported again
+					std::string key = KeyFor(categoryName, keyNameArray[index]);
+					fCache.RemoveByKey(key.c_str());
+					Rtt_DeleteFile(LegacyPathFor(key).c_str());
+				}
+			}
+		}
+		return result;
+	}
+
+	OperationResult LinuxPreferenceStore::Open()
+	{
+		if (fDatabase)
+		{
+			return OperationResult::kSucceeded;
+		}
+
+		std::string path = fDirectory + '/' + kDatabaseFileName;
+		for (int attemptCount = 1; attemptCount <= 2; attemptCount++)
+		{
+			int errorCode = sqlite3_open_v2(path.c_str(), &fDatabase, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, NULL);
+			if (errorCode == SQLITE_OK)
+			{
+				// Detects files that are not SQLite databases, too
+				errorCode = sqlite3_exec(fDatabase, "CREATE TABLE IF NOT EXISTS preference (key TEXT PRIMARY KEY NOT NULL, value VARIANT)", NULL, NULL, NULL);
+			}
+			if (errorCode == SQLITE_OK)
+			{
+				break;
+			}
+
+			OperationResult result = FailedWithLastError("Failed to open preferences database.");
+			sqlite3_close(fDatabase);
+			fDatabase = NULL;
+
+			// Replace a corrupted file once, otherwise give up
+			if (attemptCount > 1 || ((SQLITE_NOTADB != errorCode) && (SQLITE_CORRUPT != errorCode)) || !Rtt_DeleteFile(path.c_str()))
+			{
+				return result;
+			}
+		}
+
+		// Load every preference so reads never touch the file
+		fCache.Clear();
+		sqlite3_stmt *statement = NULL;
+		sqlite3_prepare_v2(fDatabase, "SELECT key, value FROM preference", -1, &statement, NULL);
+		if (statement)
+		{
+			while (sqlite3_step(statement) == SQLITE_ROW)
+			{
+				const char *key = (const char *)sqlite3_column_text(statement, 0);
+				if (!key)
+				{
+					continue;
+				}
+
+				switch (sqlite3_column_type(statement, 1))
+				{
+					case SQLITE_INTEGER:
+						fCache.Add(key, PreferenceValue((S64)sqlite3_column_int64(statement, 1)));
+						break;
+					case SQLITE_FLOAT:
+						fCache.Add(key, PreferenceValue(sqlite3_column_double(statement, 1)));
+						break;
+					case SQLITE_BLOB:
+					{
+						const char *bytes = (const char *)sqlite3_column_blob(statement, 1);
+						int byteCount = sqlite3_column_bytes(statement, 1);
+						fCache.Add(key, PreferenceValue(Rtt_MakeSharedConstStdStringPtr(bytes ? bytes : "", (size_t)byteCount)));
+						break;
+					}
+					case SQLITE_NULL:
+						fCache.Add(key, PreferenceValue(""));
+						break;
+					default:
+						fCache.Add(key, PreferenceValue((const char *)sqlite3_column_text(statement, 1)));
+						break;
+				}
+			}
+			sqlite3_finalize(statement);
+		}
+
+		return OperationResult::kSucceeded;
+	}
+
+	OperationResult LinuxPreferenceStore::Write(const PreferenceCollection &preferences)
+	{
+		OperationResult openResult = Open();
+		if (openResult.HasFailed())
+		{
+			return openResult;
+		}
+
+		// One transaction per collection: a single sync, and all or nothing
+		if (sqlite3_exec(fDatabase, "BEGIN TRANSACTION", NULL, NULL, NULL) != SQLITE_OK)
+		{
+			return FailedWithLastError("Failed to write preferences.");
+		}
+
+		PreferenceValue::TypeSet supportedTypes;
+		supportedTypes.Add(PreferenceValue::kTypeSignedInt32);
+		supportedTypes.Add(PreferenceValue::kTypeSignedInt64);
+		supportedTypes.Add(PreferenceValue::kTypeFloatDouble);
+		supportedTypes.Add(PreferenceValue::kTypeString);
+
+		std::string errorMessage;
+		bool wasSuccessful = false;
+		sqlite3_stmt *statement = NULL;
+		sqlite3_prepare_v2(fDatabase, "INSERT OR REPLACE INTO preference (key, value) VALUES (?, ?)", -1, &statement, NULL);
+		if (statement)
+		{
+			wasSuccessful = true;
+			for (int index = 0; index < preferences.GetCount() && wasSuccessful; index++)
+			{
+				Preference *preferencePointer = preferences.GetByIndex(index);
+				if (!preferencePointer)
+				{
+					continue;
+				}
+
+				auto conversionResult = preferencePointer->GetValue().ToClosestValueTypeIn(supportedTypes);
+				if (conversionResult.HasFailed())
+				{
+					errorMessage = conversionResult.GetUtf8Message() ? conversionResult.GetUtf8Message() : "";
+					wasSuccessful = false;
+					break;
+				}
+
+				sqlite3_bind_text(statement, 1, preferencePointer->GetKeyName(), -1, SQLITE_TRANSIENT);
+
+				PreferenceValue value = conversionResult.GetValue();
+				switch (value.GetType())
+				{
+					case PreferenceValue::kTypeSignedInt32:
+						sqlite3_bind_int(statement, 2, value.ToSignedInt32().GetValue());
+						break;
+					case PreferenceValue::kTypeSignedInt64:
+						sqlite3_bind_int64(statement, 2, value.ToSignedInt64().GetValue());
+						break;
+					case PreferenceValue::kTypeFloatDouble:
+						sqlite3_bind_double(statement, 2, value.ToFloatDouble().GetValue());
+						break;
+					default:
+					{
+						auto stringPointer = value.ToString().GetValue();
+						if (stringPointer.IsNull())
+						{
+							sqlite3_bind_null(statement, 2);
+						}
+						else if (memchr(stringPointer->c_str(), '\0', stringPointer->length()))
+						{
+							// Keeps embedded null characters
+							sqlite3_bind_blob(statement, 2, stringPointer->c_str(), (int)stringPointer->length(), SQLITE_TRANSIENT);
+						}
+						else
+						{
+							sqlite3_bind_text(statement, 2, stringPointer->c_str(), (int)stringPointer->length(), SQLITE_TRANSIENT);
+						}
+						break;
+					}
+				}
+
+				int errorCode = sqlite3_step(statement);
+				wasSuccessful = (SQLITE_DONE == errorCode) || (SQLITE_OK == errorCode);
+				if (!wasSuccessful)
+				{
+					errorMessage = sqlite3_errmsg(fDatabase);
+				}
+				sqlite3_clear_bindings(statement);
+				sqlite3_reset(statement);
+			}
+			sqlite3_finalize(statement);
+		}
+		else
+		{
+			errorMessage = sqlite3_errmsg(fDatabase);
+		}
+
+		if (sqlite3_exec(fDatabase, wasSuccessful ? "END TRANSACTION" : "ROLLBACK", NULL, NULL, NULL) != SQLITE_OK && wasSuccessful)
+		{
+			errorMessage = sqlite3_errmsg(fDatabase);
+			wasSuccessful = false;
+		}
+
+		if (!wasSuccessful)
+		{
+			return OperationResult::FailedWith(errorMessage.empty() ? "Failed to write preferences." : errorMessage.c_str());
+		}
+
+		// Only update the in-memory copy once the file has them
+		for (int index = 0; index < preferences.GetCount(); index++)
+		{
+			Preference *preferencePointer = preferences.GetByIndex(index);
+			if (preferencePointer)
+			{
+				Preference *cachedPreferencePointer = fCache.GetByKey(preferencePointer->GetKeyName());
+				if (cachedPreferencePointer)
+				{
+					cachedPreferencePointer->SetValue(preferencePointer->GetValue());
+				}
+				else
+				{
+					fCache.Add(*preferencePointer);
+				}
+			}
+		}
+		return OperationResult::kSucceeded;
+	}
+
+	OperationResult LinuxPreferenceStore::FailedWithLastError(const char *defaultMessage) const
+	{
+		const char *message = fDatabase ? sqlite3_errmsg(fDatabase) : NULL;
+		return OperationResult::FailedWith(message ? message : defaultMessage);
+	}
+
+	std::string LinuxPreferenceStore::KeyFor(const char *categoryName, const char *keyName) const
+	{
+		std::string key(categoryName ? categoryName : "");
+		if (keyName && strlen(keyName) > 0)
+		{
+			key += '.';
+			key += keyName;
+		}
+		return key;
+	}
+
+	std::string LinuxPreferenceStore::LegacyPathFor(const std::string &key) const
+	{
+		return fDirectory + '/' + key;
+	}
+
+	bool LinuxPreferenceStore::ImportLegacyFile(const std::string &key)
+	{
+		// Older versions stored each preference's string value in its own file
+		std::string path = LegacyPathFor(key);
+		FILE *f = fopen(path.c_str(), "rb");
+		if (!f)
+		{
+			return false;
+		}
+
+		std::string value;
+		char buffer[4096];
+		size_t byteCount;
+		while ((byteCount = fread(buffer, 1, sizeof(buffer), f)) > 0)
+		{
+			value.append(buffer, byteCount);
+		}
+		fclose(f);
+
+		PreferenceCollection preferences;
+		preferences.Add(key.c_str(), PreferenceValue(Rtt_MakeSharedConstStdStringPtr(value.c_str(), value.length())));
+		if (Write(preferences).HasFailed())
+		{
+			return false;
+		}
+
+		Rtt_DeleteFile(path.c_str());
+		return true;
+	}
+
+}; // namespace Rtt
@@ -0,0 +1,56 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Core/Rtt_Types.h"
+#include "Core/Rtt_OperationResult.h"
+#include "Rtt_Preference.h"
+#include "Rtt_PreferenceCollection.h"
+#include <string>
+
+struct sqlite3;
+
+namespace Rtt
+{
+	// Stores the preferences of all categories in one SQLite database file.
+	// Keys are "<category>.<key>", the names the old one-file-per-key store
+	// used, and such files are imported the first time their key is read.
+	// All rows are read into memory when the database is opened, and each
+	// collection is written in a single transaction.
+	class LinuxPreferenceStore
+	{
+		Rtt_CLASS_NO_COPIES(LinuxPreferenceStore)
+
+	public:
+		LinuxPreferenceStore();
+		~LinuxPreferenceStore();
+
+		// Sets the directory holding the database; it is opened on first use
+		void Initialize(const char *directory);
+
+		Preference::ReadValueResult Fetch(const char *categoryName, const char *keyName);
+		OperationResult UpdateWith(const char *categoryName, const PreferenceCollection &preferences);
+		OperationResult Delete(const char *categoryName, const char **keyNameArray, U32 keyNameCount);
+
+	private:
+		OperationResult Open();
+		OperationResult Write(const PreferenceCollection &preferences);
+		OperationResult FailedWithLastError(const char *defaultMessage) const;
+		std::string KeyFor(const char *categoryName, const char *keyName) const;
+		std::string LegacyPathFor(const std::string &key) const;
+		bool ImportLegacyFile(const std::string &key);
+
+	private:
+		std::string fDirectory;
+		sqlite3 *fDatabase;
+		PreferenceCollection fCache;
+	};
+
+}; // namespace Rtt
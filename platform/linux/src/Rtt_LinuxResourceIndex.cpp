@@ -0,0 +1,205 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+#include "Core/Rtt_String.h"
+#include "Rtt_LinuxResourceIndex.h"
+#include <dirent.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef Rtt_SIMULATOR
+	#include <sys/inotify.h>
+#endif
+
+namespace Rtt
+{
+	// Guards against symlink cycles
+	static const int kMaxDepth = 32;
+
+	static bool IsIndexable(const char *filename)
+	{
+		// Absolute paths and ones that step out of, or back into, a directory
+		// do not match the relative paths in a listing
+		if (filename[0] == '/' || strstr(filename, "..") || strstr(filename, "//"))
+		{
+			return false;
+		}
+		return (strncmp(filename, "./", 2) != 0) && (strstr(filename, "/./") == NULL);
+	}
+
+	LinuxResourceIndex::LinuxResourceIndex()
+		: fNotifyFD(-1)
+	{
+	}
+
+	LinuxResourceIndex::~LinuxResourceIndex()
+	{
+		Clear();
+	}
+
+	bool LinuxResourceIndex::Exists(const char *directory, const char *filename)
+	{
+		if (Rtt_StringIsEmpty(directory) || Rtt_StringIsEmpty(filename))
+		{
+			return false;
+		}
+
+		std::string root(directory);
+		if (root.length() > 1 && root[root.length() - 1] == '/')
+		{
+			root.erase(root.length() - 1);
+		}
+
+		ProcessChanges();
+
+		Listing *listing = NULL;
+		if (IsIndexable(filename))
+		{
+			auto iter = fListings.find(root);
+			if (iter == fListings.end())
+			{
+#ifdef Rtt_SIMULATOR
+				if (fNotifyFD < 0)
+				{
+					fNotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+				}
+#endif
+				listing = & fListings[root];
+				listing->fIsComplete = true;
+				List(root, std::string(), *listing, 0);
+			}
+			else
+			{
+				listing = & iter->second;
+			}
+		}
+
+		if (listing && listing->fIsComplete)
+		{
+			std::string path(filename);
+			if (path.length() > 1 && path[path.length() - 1] == '/')
+			{
+				path.erase(path.length() - 1);
+			}
+			return listing->fPaths.count(path) > 0;
+		}
+
+		// Same test as LinuxPlatform::FileExists()
+		std::string path = root + '/' + filename;
+		FILE *file = fopen(path.c_str(), "r");
+		if (file)
+		{
+			fclose(file);
+			return true;
+		}
+		return false;
+	}
+
+	void LinuxResourceIndex::Clear()
+	{
+		fListings.clear();
+
+#ifdef Rtt_SIMULATOR
+		// Closing the descriptor drops every watch
+		if (fNotifyFD >= 0)
+		{
+			close(fNotifyFD);
+			fNotifyFD = -1;
+		}
+#endif
+	}
+
+	void LinuxResourceIndex::List(const std::string& root, const std::string& relativePath, Listing& listing, int depth)
+	{
+		std::string path = relativePath.empty() ? root : root + '/' + relativePath;
+
+#ifdef Rtt_SIMULATOR
+		const uint32_t kMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+		if (fNotifyFD < 0 || inotify_add_watch(fNotifyFD, path.c_str(), kMask) < 0)
+		{
+			// Without a watch, changes here would go unnoticed
+			if (errno != ENOENT)
+			{
+				listing.fIsComplete = false;
+			}
+		}
+#endif
+
+		DIR *dir = opendir(path.c_str());
+		if (dir == NULL)
+		{
+			// A missing root is simply empty; any other gap means the listing
+			// cannot be trusted
+			if (!(depth == 0 && errno == ENOENT))
+			{
+				listing.fIsComplete = false;
+			}
+			return;
+		}
+
+		while (struct dirent *entry = readdir(dir))
+		{
+			if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+			{
+				continue;
+			}
+
+			std::string entryPath = relativePath.empty() ? entry->d_name : relativePath + '/' + entry->d_name;
+			listing.fPaths.insert(entryPath);
+
+			bool isDirectory = (entry->d_type == DT_DIR);
+			if (entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN)
+			{
+				struct stat info;
+				isDirectory = (stat((root + '/' + entryPath).c_str(), &info) == 0) && S_ISDIR(info.st_mode);
+			}
+
+			if (isDirectory)
+			{
+				if (depth + 1 < kMaxDepth)
+				{
+					List(root, entryPath, listing, depth + 1);
+				}
+				else
+				{
+					listing.fIsComplete = false;
+				}
+			}
+		}
+		closedir(dir);
+	}
+
+	void LinuxResourceIndex::ProcessChanges()
+	{
+#ifdef Rtt_SIMULATOR
+		if (fNotifyFD < 0)
+		{
+			return;
+		}
+
+		// Any change invalidates every listing; they are rebuilt on demand.
+		// Edits to existing files do not generate events.
+		char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+		bool hasChanged = false;
+		while (read(fNotifyFD, buffer, sizeof(buffer)) > 0)
+		{
+			hasChanged = true;
+		}
+
+		if (hasChanged)
+		{
+			Clear();
+		}
+#endif
+	}
+
+}; // namespace Rtt
@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Core/Rtt_Types.h"
+#include <map>
+#include <string>
+#include <unordered_set>
+
+namespace Rtt
+{
+	// Answers "does this file exist" for read-only directories, such as the
+	// project's resources and plugins, from an in-memory list of the paths
+	// under them. A directory is listed in full the first time it is queried.
+	//
+	// In the simulator, where projects are edited while they run, listed
+	// directories are watched with inotify and listed again after any entry
+	// under them is created, deleted or renamed.
+	class LinuxResourceIndex
+	{
+		Rtt_CLASS_NO_COPIES(LinuxResourceIndex)
+
+	public:
+		LinuxResourceIndex();
+		~LinuxResourceIndex();
+
+		// Whether filename, relative to directory, names an existing file or
+		// subdirectory. Names the index cannot resolve, e.g. ones containing
+		// "..", are checked on disk.
+		bool Exists(const char *directory, const char *filename);
+
+		// Forgets all listings
+		void Clear();
+
+	private:
+		struct Listing
+		{
+			Listing() : fIsComplete(false) {}
+
+			std::unordered_set<std::string> fPaths;
+
+			// False if the tree could not be listed (or watched) in full
+			bool fIsComplete;
+		};
+
+		void List(const std::string& root, const std::string& relativePath, Listing& listing, int depth);
+		void ProcessChanges();
+
+	private:
+		std::map<std::string, Listing> fListings;
+		int fNotifyFD;
+	};
+
+}; // namespace Rtt
@@ -15,9 +15,27 @@ local dkjson = require "dkjson"
 -- Give ourselves a different version
 dkjson.version = dkjson.version .. "-1"
 
-local decode_base = dkjson.decode
+-- Native encoder/decoder (Rtt_LuaLibJSON.cpp) with the same output and
+-- error messages as dkjson. Not registered on every platform.
+local has_native, native = pcall(require, "json_native")
+if not has_native then
+	native = nil
+end
+
+local decode_base = native and native.decode or dkjson.decode
 local encode_base = dkjson.encode
 
+if native then
+	local dkjson_encode = dkjson.encode
+	encode_base = function(value, state)
+		-- The native encoder returns a string, so leave output buffers to dkjson
+		if state and state.buffer then
+			return dkjson_encode(value, state)
+		end
+		return native.encode(value, state)
+	end
+end
+
 local function decode_override(str, pos, nullval, ...)
 	-- Check for common error that gives an inscrutable message and
 	-- provide a better one
@@ -86,9 +104,15 @@ local function json_decode_file(filename, pos, nullval, ...)
 		return nil, 0, "Cannot open file "..tostring(fileOpenErrorMsg)
 	else
 		local lineno, errorMsg
-		local str = fp:read( '*a' )
-		fp:close()
-		decodedData, lineno, errorMsg = decode_override( str, pos, nullval, ... )
+		if native then
+			-- Parse straight from the file rather than reading it into a string first
+			decodedData, lineno, errorMsg = native.decodeFile( fp, pos, nullval, ... )
+			fp:close()
+		else
+			local str = fp:read( '*a' )
+			fp:close()
+			decodedData, lineno, errorMsg = decode_override( str, pos, nullval, ... )
+		end
 		if errorMsg ~= nil then
 			return nil, lineno, errorMsg
 		end
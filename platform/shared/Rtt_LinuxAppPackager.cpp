@@ -24,6 +24,7 @@
 #include <time.h>
 #include <dirent.h>
 #include <sys/stat.h>
+#include <chrono>
 
 #if defined(Rtt_LINUX_ENV)
 #	include <pwd.h>
@@ -73,6 +74,8 @@ namespace Rtt
 		// Package build settings parameters.
 		Rtt::AppPackagerParams params(p->GetAppName(), p->GetVersion(), p->GetIdentity(), NULL, srcDir, dstDir, NULL, p->GetTargetPlatform(), NULL, 0, 0, NULL, NULL, NULL, true);
 		params.SetStripDebug(p->IsStripDebug());
+		params.SetBuildCacheDir(p->GetBuildCacheDir());
+		params.SetNumBuildThreads(p->GetNumBuildThreads());
 
 		bool rc = CompileScriptsInDirectory(L, params, dstDir, srcDir);
 
@@ -113,7 +116,15 @@ namespace Rtt
 				}
 
 				// Create the "resource.car" archive file containing the files fetched up above.
-				Archive::Serialize(resourceCarPath.GetString(), fileToIncludeCount, sourceFilePathArray);
+				std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+				Archive::SerializeOptions options;
+				options.numThreads = params.GetNumBuildThreads();
+#if defined( Rtt_ARCHIVE_ZLIB )
+				options.compress = true;
+#endif
+				Archive::Serialize(resourceCarPath.GetString(), fileToIncludeCount, sourceFilePathArray, options);
+				long long elapsedMs = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+				Rtt_Log("Archived %d files in %lld ms\n", fileToIncludeCount, elapsedMs);
 
 				// Clean up memory allocated up above.
 				delete[] sourceFilePathArray;
@@ -47,9 +47,14 @@
 
 #include "Rtt_MCrypto.h"
 #include "Rtt_FileSystem.h"
+#include "Core/Rtt_Version.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <string.h>
+#include <thread>
 #include <time.h>
 #include <dirent.h>
 #include <sys/stat.h>
@@ -73,6 +78,7 @@ static const char *kCustomId = "customBuildId";
 static const char *kAppSettingsLuaFile = "AppSettings.lua";
 	
 Rtt_EXPORT int Rtt_LuaCompile( lua_State *L, int numSources, const char** sources, const char* dstFile, int stripDebug );
+Rtt_EXPORT int Rtt_LuaBytecodeHeader( char* header, int headerSize );
 
 #if defined(Rtt_WIN_ENV) && ( _MSC_VER >= 1800 ) && !defined(Rtt_LINUX_ENV)
 /// <remarks>
@@ -83,6 +89,11 @@ Rtt_EXPORT int Rtt_LuaCompile(lua_State *L, int numSources, const char** sources
 {
 	return lua_compile_files(L, numSources, sources, dstFile, stripDebug);
 }
+
+Rtt_EXPORT int Rtt_LuaBytecodeHeader(char* header, int headerSize)
+{
+	return lua_bytecode_header(header, headerSize);
+}
 #endif
 
 // ----------------------------------------------------------------------------
@@ -110,7 +121,8 @@ AppPackagerParams::AppPackagerParams( const char* appName,
 	fIsStripDebug( true ),
 	fDeviceBuildData( NULL ),
 	fIncludeBuildSettings( false )
-,   fLiveBuild( false )
+,   fLiveBuild( false ),
+	fNumBuildThreads( 0 )
 {
 	fAppName.Set(appName);
 	fVersion.Set(version);
@@ -489,8 +501,15 @@ IsDirectory( const char *path )
 	return result;
 }
 
-bool
-CompileScriptsInDirectory( lua_State *L, AppPackagerParams& params, const char *dstDir, const char *srcDir )
+struct ScriptCompileJob
+{
+	std::string srcPath;
+	std::string dstPath;
+};
+
+// Finds the scripts under srcDir and where each compiles to, without compiling them
+static bool
+CollectScriptsInDirectory( AppPackagerParams& params, const char *dstDir, const char *srcDir, std::vector< ScriptCompileJob >& rJobs )
 {
 	const char *baseDir = params.GetSrcDir(); // this is the project directory
 	bool isDirectory = false;
@@ -571,10 +590,10 @@ CompileScriptsInDirectory( lua_State *L, AppPackagerParams& params, const char *
 					// Create a path to the file/directory.
 					snprintf( srcPath, srcPathSize, "%s" LUA_DIRSEP "%s", srcDir, filename );
 
-					// If the next item is a directory, then recursively compile the files under that directory.
+					// If the next item is a directory, then recursively collect the files under that directory.
 					if ( IsDirectory( srcPath ) )
 					{
-						result = CompileScriptsInDirectory( L, params, dstDir, srcPath );
+						result = CollectScriptsInDirectory( params, dstDir, srcPath, rJobs );
 						continue;
 					}
 
@@ -619,33 +638,11 @@ CompileScriptsInDirectory( lua_State *L, AppPackagerParams& params, const char *
 						{
 							strncpy( dstPath + ( dstPathLen - kScriptSuffixLen ), kObjectSuffix, kObjectSuffixSize );
 						}
-						
-						// Compile the file.
-						const char *sources = srcPath;
-						int status = Rtt_LuaCompile( L, 1, & sources, dstPath, params.IsStripDebug() );
-						result = Rtt_VERIFY( 0 == status ) ? true : false;
-						if ( ! result )
-						{
-							String tmpString;
-							tmpString.Set("ERROR: Could not complete build because there were compile errors in Lua file: ");
-							tmpString.Append(srcPath);
-							Rtt_TRACE_SIM( ("%s", tmpString.GetString()) );
-							tmpString.Append("\n\nCheck Simulator console for error messages.");
-							params.SetBuildMessage(tmpString.GetString());
-						}
-
-#if defined(Rtt_WIN_ENV) && !defined( Rtt_NO_GUI ) && !defined(Rtt_LINUX_ENV)
-						CSimulatorApp *pApp = ((CSimulatorApp *)AfxGetApp());
-						if (pApp != NULL && pApp->IsStopBuildRequested())
-						{
-							// A request to stop the build was made while the Java was running
-							result = false;
-
-							params.SetBuildMessage("Build stopped");
-						}
-#endif
-
 
+						ScriptCompileJob job;
+						job.srcPath = srcPath;
+						job.dstPath = dstPath;
+						rJobs.push_back( job );
 					}
 				}
 
@@ -672,6 +669,213 @@ CompileScriptsInDirectory( lua_State *L, AppPackagerParams& params, const char *
 	return result;
 }
 
+// 64-bit FNV-1a
+static U64
+HashScriptBytes( U64 hash, const void *bytes, size_t numBytes )
+{
+	const U8 *p = (const U8 *)bytes;
+	for ( size_t i = 0; i < numBytes; i++ )
+	{
+		hash ^= p[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+// Path of the job's compiled script in the build cache. The key covers everything
+// the output depends on: the source bytes, whether debug info is stripped, the
+// bytecode header and the build of the compiler, whose format may change without
+// the Lua version changing. The source path is only embedded in unstripped
+// bytecode, so stripped scripts with the same bytes share an entry across projects.
+static bool
+GetCachedScriptPath( const char *cacheDir, const ScriptCompileJob& job, bool stripDebug, std::string& rPath )
+{
+	FILE *src = Rtt_FileOpen( job.srcPath.c_str(), "rb" );
+	if ( ! src )
+	{
+		return false;
+	}
+
+	char header[32];
+	int headerSize = Rtt_LuaBytecodeHeader( header, sizeof( header ) );
+	Rtt_ASSERT( headerSize <= (int)sizeof( header ) );
+
+	U64 hash = 0xcbf29ce484222325ULL;
+	hash = HashScriptBytes( hash, LUA_RELEASE, sizeof( LUA_RELEASE ) );
+	hash = HashScriptBytes( hash, header, Min( headerSize, (int)sizeof( header ) ) );
+	hash = HashScriptBytes( hash, Rtt_STRING_BUILD, sizeof( Rtt_STRING_BUILD ) );
+	hash = HashScriptBytes( hash, stripDebug ? "s" : "d", 1 );
+	if ( ! stripDebug )
+	{
+		hash = HashScriptBytes( hash, job.srcPath.c_str(), job.srcPath.length() + 1 );
+	}
+
+	char buffer[16 * 1024];
+	size_t numBytes = 0;
+	while ( ( numBytes = Rtt_FileRead( buffer, 1, sizeof( buffer ), src ) ) > 0 )
+	{
+		hash = HashScriptBytes( hash, buffer, numBytes );
+	}
+	bool result = ( 0 == Rtt_FileError( src ) );
+	Rtt_FileClose( src );
+
+	char name[32];
+	snprintf( name, sizeof( name ), "%016llx." Rtt_LUA_OBJECT_FILE_EXTENSION, (unsigned long long)hash );
+	rPath = cacheDir;
+	rPath += LUA_DIRSEP;
+	rPath += name;
+
+	return result;
+}
+
+// Compiles one script, or copies it from the build cache when its source is unchanged.
+// Separate threads may call this at once as long as each passes its own lua_State.
+static int
+CompileScriptJob( lua_State *L, const ScriptCompileJob& job, const char *cacheDir, bool stripDebug, bool& rWasCached )
+{
+	rWasCached = false;
+
+	std::string cachedPath;
+	bool isCacheable = ( cacheDir && GetCachedScriptPath( cacheDir, job, stripDebug, cachedPath ) );
+	if ( isCacheable
+		 && Rtt_FileExists( cachedPath.c_str() )
+		 && Rtt_CopyFile( cachedPath.c_str(), job.dstPath.c_str() ) )
+	{
+		rWasCached = true;
+		return 0;
+	}
+
+	const char *sources = job.srcPath.c_str();
+	int status = Rtt_LuaCompile( L, 1, & sources, job.dstPath.c_str(), stripDebug );
+
+	if ( 0 == status && isCacheable )
+	{
+		// Publish with a rename so other builds sharing the cache never see a partial file
+		char suffix[32];
+		snprintf( suffix, sizeof( suffix ), ".%lld.tmp", (long long)std::chrono::steady_clock::now().time_since_epoch().count() );
+		std::string tmpPath = cachedPath + suffix;
+		if ( ! Rtt_CopyFile( job.dstPath.c_str(), tmpPath.c_str() )
+			 || 0 != rename( tmpPath.c_str(), cachedPath.c_str() ) )
+		{
+			Rtt_DeleteFile( tmpPath.c_str() );
+		}
+	}
+
+	return status;
+}
+
+bool
+CompileScriptsInDirectory( lua_State *L, AppPackagerParams& params, const char *dstDir, const char *srcDir )
+{
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	std::vector< ScriptCompileJob > jobs;
+	bool result = CollectScriptsInDirectory( params, dstDir, srcDir, jobs );
+	if ( ! result || jobs.empty() )
+	{
+		return result;
+	}
+
+	// Compile in a fixed order so the first error reported does not depend on the file system
+	std::sort( jobs.begin(), jobs.end(), []( const ScriptCompileJob& a, const ScriptCompileJob& b )
+	{
+		return a.srcPath < b.srcPath;
+	} );
+
+	const char *cacheDir = params.GetBuildCacheDir();
+	if ( cacheDir && ! Rtt_IsDirectory( cacheDir ) && ! Rtt_MakeDirectory( cacheDir ) )
+	{
+		Rtt_LogException( "WARNING: Cannot create build cache directory '%s', scripts will not be cached\n", cacheDir );
+		cacheDir = NULL;
+	}
+
+	const bool stripDebug = params.IsStripDebug();
+	std::vector< int > statuses( jobs.size(), 0 );
+	std::atomic< size_t > next( 0 );
+	std::atomic< int > numCached( 0 );
+	std::atomic< bool > isStopped( false );
+
+	// Jobs are claimed in order, so every job before a failed one still completes
+	auto compileJobs = [&]( lua_State *jobL, bool isMainThread )
+	{
+		for ( size_t i = next++; i < jobs.size() && ! isStopped; i = next++ )
+		{
+			bool wasCached = false;
+			statuses[i] = CompileScriptJob( jobL, jobs[i], cacheDir, stripDebug, wasCached );
+			if ( 0 != statuses[i] )
+			{
+				isStopped = true;
+			}
+			else if ( wasCached )
+			{
+				++numCached;
+			}
+
+#if defined(Rtt_WIN_ENV) && !defined( Rtt_NO_GUI ) && !defined(Rtt_LINUX_ENV)
+			CSimulatorApp *pApp = ( isMainThread ? ((CSimulatorApp *)AfxGetApp()) : NULL );
+			if (pApp != NULL && pApp->IsStopBuildRequested())
+			{
+				// A request to stop the build was made while the Java was running
+				isStopped = true;
+			}
+#else
+			Rtt_UNUSED( isMainThread );
+#endif
+		}
+	};
+
+	size_t numThreads = ( params.GetNumBuildThreads() > 0 ? (size_t)params.GetNumBuildThreads() : std::thread::hardware_concurrency() );
+	numThreads = Min( Max( numThreads, (size_t)1 ), jobs.size() );
+
+	// The caller's state compiles alongside one new state per extra thread
+	std::vector< std::thread > threads;
+	for ( size_t i = 1; i < numThreads; i++ )
+	{
+		threads.push_back( std::thread( [&]()
+		{
+			lua_State *jobL = luaL_newstate();
+			if ( jobL )
+			{
+				compileJobs( jobL, false );
+				lua_close( jobL );
+			}
+		} ) );
+	}
+	compileJobs( L, true );
+	for ( size_t i = 0; i < threads.size(); i++ )
+	{
+		threads[i].join();
+	}
+
+	for ( size_t i = 0; i < jobs.size() && result; i++ )
+	{
+		if ( 0 != statuses[i] )
+		{
+			result = false;
+
+			String tmpString;
+			tmpString.Set("ERROR: Could not complete build because there were compile errors in Lua file: ");
+			tmpString.Append(jobs[i].srcPath.c_str());
+			Rtt_TRACE_SIM( ("%s", tmpString.GetString()) );
+			tmpString.Append("\n\nCheck Simulator console for error messages.");
+			params.SetBuildMessage(tmpString.GetString());
+		}
+	}
+
+	if ( result && isStopped )
+	{
+		result = false;
+
+		params.SetBuildMessage("Build stopped");
+	}
+
+	long long elapsedMs = (long long)std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - startTime ).count();
+	Rtt_Log( "Compiled %d Lua files (%d from cache) in %lld ms on %d threads\n",
+		(int)jobs.size(), (int)numCached, elapsedMs, (int)numThreads );
+
+	return result;
+}
+
 static std::string GenerateUUID()
 {
 #ifdef Rtt_MAC_ENV
@@ -1027,7 +1231,16 @@ PlatformAppPackager::ArchiveDirectoryTree(
 	}
 
 	// Create the "resource.car" archive file containing the files fetched up above.
-	Archive::Serialize( destinationFilePath, (int)sourceFilePathCollection.size(), sourceFilePathArray );
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	Archive::SerializeOptions options;
+	options.numThreads = params->GetNumBuildThreads();
+#if defined( Rtt_ARCHIVE_ZLIB )
+	// Deflated startup entries are inflated on worker threads while the runtime starts
+	options.compress = true;
+#endif
+	Archive::Serialize( destinationFilePath, (int)sourceFilePathCollection.size(), sourceFilePathArray, options );
+	long long elapsedMs = (long long)std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - startTime ).count();
+	Rtt_Log( "Archived %d files in %lld ms\n", (int)sourceFilePathCollection.size(), elapsedMs );
 
 	// Clean up memory allocated up above.
 	delete[] sourceFilePathArray;
@@ -60,6 +60,8 @@ class AppPackagerParams
 		bool fLiveBuild;
         bool fIncludeStandardResources = true;
 		String fCoronaUser;
+		String fBuildCacheDir;
+		S32 fNumBuildThreads;
 
 	public:
 		AppPackagerParams( const char* appName,
@@ -116,6 +118,15 @@ class AppPackagerParams
 		const char * GetCoronaUser() const { return fCoronaUser.GetString(); }
 		void SetCoronaUser(const char* user) { fCoronaUser.Set(user); }
 
+		// Directory of compiled scripts reused across builds, keyed by the hash of their source.
+		// Caching is off when empty.
+		const char * GetBuildCacheDir() const { return fBuildCacheDir.IsEmpty() ? NULL : fBuildCacheDir.GetString(); }
+		void SetBuildCacheDir( const char *newValue ) { fBuildCacheDir.Set( newValue ); }
+
+		// Number of threads used to compile scripts and build the archive. 0 means one per core.
+		S32 GetNumBuildThreads() const { return fNumBuildThreads; }
+		void SetNumBuildThreads( S32 newValue ) { fNumBuildThreads = newValue; }
+
 	public:
 		void SetBuildSettingsPath( const char *path ) { fBuildSettingsPath.Set( path ); }
 		const char *GetBuildSettingsPath() { return fBuildSettingsPath.GetString(); }
@@ -295,6 +306,9 @@ class PlatformAppPackager
 };
 
 Rtt_EXPORT int Rtt_LuaCompile( lua_State *L, int numSources, const char** sources, const char* dstFile, int stripDebug );
+
+// Writes the header that starts compiled Lua files, if it fits, and returns its size
+Rtt_EXPORT int Rtt_LuaBytecodeHeader( char* header, int headerSize );
 	
 // ----------------------------------------------------------------------------
 
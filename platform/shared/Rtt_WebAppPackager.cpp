@@ -154,7 +154,11 @@ namespace Rtt
 				}
 
 				// Create the "resource.car" archive file containing the files fetched up above.
-				Archive::Serialize(resourceCarPath.GetString(), fileToIncludeCount, sourceFilePathArray);
+				Archive::SerializeOptions options;
+#if defined( Rtt_ARCHIVE_ZLIB )
+				options.compress = true;
+#endif
+				Archive::Serialize(resourceCarPath.GetString(), fileToIncludeCount, sourceFilePathArray, options);
 
 				// Clean up memory allocated up above.
 				delete[] sourceFilePathArray;
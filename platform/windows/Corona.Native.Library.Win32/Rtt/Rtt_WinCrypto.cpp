@@ -23,6 +23,38 @@
 namespace Rtt
 {
 
+#pragma region WinDigest Class
+/// Incremental digest over any of the Crypto++ hash algorithms.
+class WinDigest : public MCrypto::Digest
+{
+	public:
+		WinDigest(CryptoPP::HashTransformation *hash)
+		:	fHash(hash)
+		{
+		}
+
+		virtual ~WinDigest()
+		{
+			delete fHash;
+		}
+
+		virtual void Update(const void *data, size_t length)
+		{
+			fHash->Update((const byte*)data, length);
+		}
+
+		virtual void Final(U8 *md)
+		{
+			fHash->Final(md);
+		}
+
+	private:
+		CryptoPP::HashTransformation *fHash;
+};
+
+#pragma endregion
+
+
 #pragma region Public Methods
 size_t WinCrypto::GetDigestLength(Algorithm algorithm) const
 {
@@ -92,6 +124,22 @@ void WinCrypto::CalculateDigest(Algorithm algorithm, const Rtt::Data<const char>
 	}
 }
 
+MCrypto::Digest* WinCrypto::NewDigest(Algorithm algorithm) const
+{
+	CryptoPP::HashTransformation *hash = nullptr;
+	switch (algorithm)
+	{
+		case kMD4Algorithm:			hash = new CryptoPP::Weak1::MD4(); break;
+		case kMD5Algorithm:			hash = new CryptoPP::Weak1::MD5(); break;
+		case kSHA1Algorithm:		hash = new CryptoPP::SHA1(); break;
+		case kSHA224Algorithm:		hash = new CryptoPP::SHA224(); break;
+		case kSHA256Algorithm:		hash = new CryptoPP::SHA256(); break;
+		case kSHA384Algorithm:		hash = new CryptoPP::SHA384(); break;
+		case kSHA512Algorithm:		hash = new CryptoPP::SHA512(); break;
+	}
+	return hash ? new WinDigest(hash) : nullptr;
+}
+
 void WinCrypto::CalculateHMAC(
 	Algorithm algorithm, const Rtt::Data<const char> &key, const Rtt::Data<const char> &data, U8 *digest) const
 {
@@ -23,6 +23,7 @@ class WinCrypto : public MCrypto
 		virtual void CalculateHMAC(
 						Algorithm algorithm, const Rtt::Data<const char> & key,
 						const Rtt::Data<const char> & data, U8 *outMac) const;
+		virtual Digest *NewDigest(Algorithm algorithm) const;
 };
 
 }	// namespace Rtt
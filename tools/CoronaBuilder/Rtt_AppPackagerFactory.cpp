@@ -10,6 +10,7 @@
 #include "Core/Rtt_Build.h"
 
 #include "Rtt_AppPackagerFactory.h"
+#include "Rtt_PlatformAppPackager.h"
 
 #if defined(CORONABUILDER_ANDROID)
 #include "Rtt_AndroidAppPackager.h"
@@ -105,6 +106,8 @@ static const char kSdkPathKey[] = "sdkPath";
 //static const char kDeviceOSVersionKey[] = "deviceOSVersion";
 static const char kTemplateIdKey[] = "customBuildId";
 static const char kTemplateTypeKey[] = "targetDevice";
+static const char kBuildCacheDirKey[] = "buildCacheDir";
+static const char kBuildThreadsKey[] = "buildThreads";
 
 AppPackagerParams*
 AppPackagerFactory::CreatePackagerParams( lua_State *L, int index, TargetDevice::Platform targetPlatform ) const
@@ -159,7 +162,7 @@ AppPackagerFactory::CreatePackagerParams( lua_State *L, int index, TargetDevice:
 
 	// WARNING: Change value to lua_checkstack
 	// if you increase the number of lua_getfield() calls!!!
-	lua_checkstack( L, 11 );
+	lua_checkstack( L, 13 );
 	int top = lua_gettop( L );
 
 	// See if the build spec overrides the default platform version
@@ -311,6 +314,23 @@ AppPackagerFactory::CreatePackagerParams( lua_State *L, int index, TargetDevice:
 		fprintf(stderr, "CoronaBuilder: building for %s is not supported on this operating system\n", TargetDevice::StringForPlatform(targetPlatform));
 	}
 
+	if ( result )
+	{
+		// Optional: reuse compiled scripts from earlier builds
+		lua_getfield( L, index, kBuildCacheDirKey );
+		const char *buildCacheDir = lua_tostring( L, -1 );
+		if ( buildCacheDir )
+		{
+			result->SetBuildCacheDir( buildCacheDir );
+		}
+
+		lua_getfield( L, index, kBuildThreadsKey );
+		if ( lua_isnumber( L, -1 ) )
+		{
+			result->SetNumBuildThreads( (S32)lua_tointeger( L, -1 ) );
+		}
+	}
+
 	lua_settop( L, top );
 
 	return result;
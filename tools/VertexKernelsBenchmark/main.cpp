@@ -0,0 +1,229 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+// Micro-benchmarks for Renderer/Rtt_VertexKernels. Each kernel is timed
+// against the per-vertex code it replaced, and both results are compared.
+//
+// Usage: VertexKernelsBenchmark [numVertices] [numIterations]
+// Exits with 1 if any kernel's result differs from the per-vertex code.
+
+#include "Core/Rtt_Build.h"
+
+#include "Renderer/Rtt_VertexKernels.h"
+
+#include "Renderer/Rtt_RenderTypes.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace Rtt;
+
+// ----------------------------------------------------------------------------
+
+typedef void (*VertexWriter)( void *dst, const void *src, U32 n );
+
+static void
+CopyWriter( void *dst, const void *src, U32 n )
+{
+	memcpy( dst, src, n * sizeof( Geometry::Vertex ) );
+}
+
+// Called through a pointer, like the Renderer's geometry writers
+static volatile VertexWriter sWriter = & CopyWriter;
+
+static void
+TransformPointsPerVertex( const Real row0[3], const Real row1[3], Geometry::Vertex *vertices, U32 count )
+{
+	for ( U32 i = 0; i < count; i++ )
+	{
+		Geometry::Vertex& v = vertices[i];
+
+		Real x = row0[2] + row0[0] * v.x;
+		x += row0[1] * v.y;
+
+		Real y = row1[2] + row1[0] * v.x;
+		y += row1[1] * v.y;
+
+		v.x = x;
+		v.y = y;
+	}
+}
+
+static void
+ScaleColorsPerVertex( Geometry::Vertex *vertices, const U32 *colors, U32 count, U32 scale )
+{
+	const U8 *s = reinterpret_cast< const U8 * >( & scale );
+
+	for ( U32 i = 0; i < count; i++ )
+	{
+		const U8 *c = reinterpret_cast< const U8 * >( colors + i );
+		Geometry::Vertex& v = vertices[i];
+
+		v.rs = (U8)( ( (U16)c[0] * s[0] ) >> 8U );
+		v.gs = (U8)( ( (U16)c[1] * s[1] ) >> 8U );
+		v.bs = (U8)( ( (U16)c[2] * s[2] ) >> 8U );
+		v.as = (U8)( ( (U16)c[3] * s[3] ) >> 8U );
+	}
+}
+
+static void
+InterleaveVerticesPerVertex( Geometry::Vertex *dst, const Geometry::Vertex *vertices, const Geometry::Vertex *extra, U32 count, U32 extraCount )
+{
+	for ( U32 i = 0; i < count; i++ )
+	{
+		sWriter( dst, vertices + i, 1 );
+		sWriter( dst + 1, extra + i * extraCount, extraCount );
+
+		dst += 1 + extraCount;
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+typedef std::chrono::steady_clock Clock;
+
+static double
+NanosecondsPerVertex( Clock::time_point start, U32 numVertices, U32 numIterations )
+{
+	double ns = (double)std::chrono::duration_cast< std::chrono::nanoseconds >( Clock::now() - start ).count();
+
+	return ns / ( (double)numVertices * numIterations );
+}
+
+static bool
+Report( const char *name, double perVertex, double kernel, const void *expected, const void *actual, size_t numBytes )
+{
+	bool isSame = ( 0 == memcmp( expected, actual, numBytes ) );
+
+	printf( "%-20s %8.3f ns %8.3f ns %6.2fx %s\n",
+		name, perVertex, kernel, kernel > 0.0 ? perVertex / kernel : 0.0, isSame ? "" : "MISMATCH" );
+
+	return isSame;
+}
+
+static void
+FillVertices( std::vector< Geometry::Vertex >& vertices )
+{
+	for ( size_t i = 0; i < vertices.size(); i++ )
+	{
+		Geometry::Vertex& v = vertices[i];
+		memset( & v, 0, sizeof( v ) );
+		v.x = (Real)( rand() % 2048 ) * 0.5f;
+		v.y = (Real)( rand() % 2048 ) * 0.25f;
+		v.u = (Real)( rand() % 256 ) / 255.0f;
+		v.v = (Real)( rand() % 256 ) / 255.0f;
+		v.ux = (Real)i;
+	}
+}
+
+int
+main( int argc, const char *argv[] )
+{
+	U32 numVertices = ( argc > 1 ? (U32)atoi( argv[1] ) : 4096 );
+	U32 numIterations = ( argc > 2 ? (U32)atoi( argv[2] ) : 2000 );
+	if ( 0 == numVertices || 0 == numIterations )
+	{
+		fprintf( stderr, "Usage: %s [numVertices] [numIterations]\n", argv[0] );
+		return 1;
+	}
+
+	bool isSame = true;
+
+	std::vector< Geometry::Vertex > source( numVertices );
+	FillVertices( source );
+
+	printf( "%u vertices, %u iterations\n", numVertices, numIterations );
+	printf( "%-20s %11s %11s %7s\n", "kernel", "per-vertex", "batched", "speedup" );
+
+	// TransformPoints
+	{
+		const Real row0[3] = { 0.8f, -0.6f, 12.0f };
+		const Real row1[3] = { 0.6f, 0.8f, -7.5f };
+
+		std::vector< Geometry::Vertex > expected( source ), actual( source );
+
+		Clock::time_point start = Clock::now();
+		for ( U32 i = 0; i < numIterations; i++ )
+		{
+			TransformPointsPerVertex( row0, row1, expected.data(), numVertices );
+		}
+		double perVertex = NanosecondsPerVertex( start, numVertices, numIterations );
+
+		start = Clock::now();
+		for ( U32 i = 0; i < numIterations; i++ )
+		{
+			VertexKernels::TransformPoints( row0, row1, & actual[0].x, sizeof( Geometry::Vertex ), numVertices );
+		}
+		double kernel = NanosecondsPerVertex( start, numVertices, numIterations );
+
+		isSame = Report( "TransformPoints", perVertex, kernel, expected.data(), actual.data(), numVertices * sizeof( Geometry::Vertex ) ) && isSame;
+	}
+
+	// ScaleColors
+	{
+		std::vector< U32 > colors( numVertices );
+		for ( U32 i = 0; i < numVertices; i++ )
+		{
+			colors[i] = (U32)rand() * 2654435761U;
+		}
+		const U32 scale = 0x80FF40C0;
+
+		std::vector< Geometry::Vertex > expected( source ), actual( source );
+
+		Clock::time_point start = Clock::now();
+		for ( U32 i = 0; i < numIterations; i++ )
+		{
+			ScaleColorsPerVertex( expected.data(), colors.data(), numVertices, scale );
+		}
+		double perVertex = NanosecondsPerVertex( start, numVertices, numIterations );
+
+		start = Clock::now();
+		for ( U32 i = 0; i < numIterations; i++ )
+		{
+			VertexKernels::ScaleColors( actual.data(), colors.data(), numVertices, scale );
+		}
+		double kernel = NanosecondsPerVertex( start, numVertices, numIterations );
+
+		isSame = Report( "ScaleColors", perVertex, kernel, expected.data(), actual.data(), numVertices * sizeof( Geometry::Vertex ) ) && isSame;
+	}
+
+	// InterleaveVertices, for the extra vertex counts of typical extensions
+	for ( U32 extraCount = 1; extraCount <= 2; extraCount++ )
+	{
+		std::vector< Geometry::Vertex > extra( numVertices * extraCount );
+		FillVertices( extra );
+
+		std::vector< Geometry::Vertex > expected( numVertices * ( 1 + extraCount ) ), actual( expected.size() );
+
+		Clock::time_point start = Clock::now();
+		for ( U32 i = 0; i < numIterations; i++ )
+		{
+			InterleaveVerticesPerVertex( expected.data(), source.data(), extra.data(), numVertices, extraCount );
+		}
+		double perVertex = NanosecondsPerVertex( start, numVertices, numIterations );
+
+		start = Clock::now();
+		for ( U32 i = 0; i < numIterations; i++ )
+		{
+			VertexKernels::InterleaveVertices( actual.data(), source.data(), extra.data(), 0, numVertices, extraCount );
+		}
+		double kernel = NanosecondsPerVertex( start, numVertices, numIterations );
+
+		char name[32];
+		snprintf( name, sizeof( name ), "InterleaveVertices/%u", (unsigned int)extraCount );
+		isSame = Report( name, perVertex, kernel, expected.data(), actual.data(), expected.size() * sizeof( Geometry::Vertex ) ) && isSame;
+	}
+
+	return isSame ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
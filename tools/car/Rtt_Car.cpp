@@ -17,6 +17,8 @@
 #include <string.h>
 #include <time.h>
 #include <fcntl.h>
+#include <string>
+#include <vector>
 
 #include "Rtt_Car.h"
  
@@ -28,10 +30,18 @@ static void
 Usage( const char* arg0 )
 {
 	fprintf(stderr, "Usage:\n");
-	fprintf(stderr, "  %s {-a|--add} dest.car srcfile0 [srcfile1 ...]\n", arg0);
-	fprintf(stderr, "  %s {-f|--filelist} filelist dest.car\n", arg0);
+	fprintf(stderr, "  %s [options] {-a|--add} dest.car srcfile0 [srcfile1 ...]\n", arg0);
+	fprintf(stderr, "  %s [options] {-f|--filelist} filelist dest.car\n", arg0);
 	fprintf(stderr, "  %s {-x|--extract} src.car destdir\n", arg0);
 	fprintf(stderr, "  %s {-l|--list} src.car\n", arg0);
+	fprintf(stderr, "  %s {-v|--verify} src.car\n", arg0);
+	fprintf(stderr, "Options:\n");
+	fprintf(stderr, "  {-z|--compress}               deflate entries that get smaller\n");
+	fprintf(stderr, "  {-s|--strip}                  strip Lua debug info, writing line info to dest.car.lines\n");
+	fprintf(stderr, "                                errors then read file:<first line>+pc N; look N up in dest.car.lines\n");
+	fprintf(stderr, "  {-L|--lazy}                   load nested Lua functions on first call\n");
+	fprintf(stderr, "  {-p|--preload} name[,name...] modules to prepare at startup (default: main,config)\n");
+	fprintf(stderr, "  {-j|--jobs} count             threads used to prepare entries (default: one per core)\n");
 }
 
 // ----------------------------------------------------------------------------
@@ -40,10 +50,72 @@ Rtt_EXPORT int
 Rtt_CarMain( int argc, const char *argv[] )
 {
 	int result = 0;
+	const char *arg0 = argv[0];
+
+	// Options for adding files come first
+	Archive::SerializeOptions options;
+	std::vector< std::string > preloadNames;
+	int numOptionArgs = 0;
+	while ( numOptionArgs + 1 < argc )
+	{
+		const char *arg = argv[numOptionArgs + 1];
+		if (0 == strcmp(arg, "-z") || 0 == strcmp(arg, "--compress"))
+		{
+			options.compress = true;
+			numOptionArgs += 1;
+		}
+		else if (0 == strcmp(arg, "-s") || 0 == strcmp(arg, "--strip"))
+		{
+			options.stripDebug = true;
+			numOptionArgs += 1;
+		}
+		else if (0 == strcmp(arg, "-L") || 0 == strcmp(arg, "--lazy"))
+		{
+			options.lazyLoad = true;
+			numOptionArgs += 1;
+		}
+		else if ((0 == strcmp(arg, "-p") || 0 == strcmp(arg, "--preload")) && numOptionArgs + 2 < argc)
+		{
+			std::string names(argv[numOptionArgs + 2]);
+			for (size_t start = 0, end = 0; start <= names.length(); start = end + 1)
+			{
+				end = names.find(',', start);
+				if (end == std::string::npos)
+				{
+					end = names.length();
+				}
+				if (end > start)
+				{
+					preloadNames.push_back(names.substr(start, end - start));
+				}
+			}
+			numOptionArgs += 2;
+		}
+		else if ((0 == strcmp(arg, "-j") || 0 == strcmp(arg, "--jobs")) && numOptionArgs + 2 < argc)
+		{
+			options.numThreads = atoi(argv[numOptionArgs + 2]);
+			numOptionArgs += 2;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	std::vector< const char * > preloadNameArray;
+	for (size_t i = 0; i < preloadNames.size(); i++)
+	{
+		preloadNameArray.push_back(preloadNames[i].c_str());
+	}
+	options.numPreloadNames = (int)preloadNameArray.size();
+	options.preloadNames = preloadNameArray.empty() ? NULL : & preloadNameArray[0];
+
+	argc -= numOptionArgs;
+	argv += numOptionArgs;
 
 	if ( argc < 3 )
 	{
-		Usage( argv[0] );
+		Usage( arg0 );
 		result = -1;
 	}
 	else
@@ -52,7 +124,7 @@ Rtt_CarMain( int argc, const char *argv[] )
 		{
 			if ( argc < 4 )
 			{
-				Usage( argv[0] );
+				Usage( arg0 );
 				result = -1;
 			}
 			else
@@ -60,11 +132,15 @@ Rtt_CarMain( int argc, const char *argv[] )
 				Archive::Deserialize( argv[3], argv[2] );
 			}
 		}
+		else if (0 == strcmp(argv[1], "-v") || 0 == strcmp(argv[1], "--verify"))
+		{
+			result = ( 0 == Archive::Verify(argv[2]) ) ? 0 : -1;
+		}
 		else if (0 == strcmp(argv[1], "-l") || 0 == strcmp(argv[1], "--list"))
 		{
 			if (argc < 3)
 			{
-				Usage(argv[0]);
+				Usage(arg0);
 				result = -1;
 			}
 			else
@@ -76,7 +152,7 @@ Rtt_CarMain( int argc, const char *argv[] )
 		{
 			if ( argc != 4 )
 			{
-				Usage( argv[0] );
+				Usage( arg0 );
 				result = -1;
 			}
 			else
@@ -92,7 +168,7 @@ Rtt_CarMain( int argc, const char *argv[] )
 				{
 					if ((inFile = fopen(argv[2], "r")) == NULL)
 					{
-						fprintf(stderr, "%s: cannot open '%s' for reading\n", argv[0], argv[2]);
+						fprintf(stderr, "%s: cannot open '%s' for reading\n", arg0, argv[2]);
 						
 						return -1;
 					}
@@ -107,7 +183,7 @@ Rtt_CarMain( int argc, const char *argv[] )
 				
 				if (srcPaths == NULL)
 				{
-					fprintf(stderr, "%s: out of memory allocating %d filenames\n", argv[0], numAlloced);
+					fprintf(stderr, "%s: out of memory allocating %d filenames\n", arg0, numAlloced);
 					
 					return -1;
 				}
@@ -131,14 +207,14 @@ Rtt_CarMain( int argc, const char *argv[] )
 					
 					if (srcPaths == NULL)
 					{
-						fprintf(stderr, "%s: out of memory allocating %d filenames\n", argv[0], numAlloced);
+						fprintf(stderr, "%s: out of memory allocating %d filenames\n", arg0, numAlloced);
 						
 						return -1;
 					}
 					
 					if ((srcPaths[numSrcPaths++] = strdup(buf)) == NULL)
 					{
-						fprintf(stderr, "%s: out of memory after processing %d filenames\n", argv[0], numSrcPaths);
+						fprintf(stderr, "%s: out of memory after processing %d filenames\n", arg0, numSrcPaths);
 						
 						return -1;
 					}
@@ -150,7 +226,7 @@ Rtt_CarMain( int argc, const char *argv[] )
 				
 				fclose( inFile );
 				
-				Archive::Serialize( argv[3], numSrcPaths, srcPaths );
+				Archive::Serialize( argv[3], numSrcPaths, srcPaths, options );
 				
 				// Free the memory we allocated
 				for (int i = 0; i < numSrcPaths; i++)
@@ -171,7 +247,7 @@ Rtt_CarMain( int argc, const char *argv[] )
 					printf( "argv[%d] = %s\n", i, argv[i] );
 				}
 			#endif
-			Archive::Serialize( argv[argOffset+1], numSrcPaths, srcPaths );
+			Archive::Serialize( argv[argOffset+1], numSrcPaths, srcPaths, options );
 		}
 	}
 